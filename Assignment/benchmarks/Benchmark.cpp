@@ -0,0 +1,1007 @@
+#include "Benchmark.hpp"
+#include "GLWindow.hpp"
+#include "GpuResourceTracker.hpp"
+#include "TextureManager.hpp"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+/**
+ * @file Benchmark.cpp
+ * @brief Implementation of the benchmark harness and the entry point of the Benchmarks executable.
+ *
+ * Usage: Benchmarks [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]
+ *                   [--benchmark_repetitions=<n>] [--benchmark_out=<file.json>]
+ *                   [--benchmark_format=<console|json>] [--benchmark_gl=<auto|off>]
+ *                   [--benchmark_perf_counters=<all|cycles,instructions,...>]
+ *                   [--benchmark_list_tests]
+ *
+ * --benchmark_perf_counters counts hardware events of the benchmark thread
+ * through perf_event_open (Linux only; work done on job system workers is not
+ * included) and reports them per iteration, with IPC and the misses per item
+ * for cases that set SetItemsProcessed. Events that cannot be counted, e.g.
+ * in a container or a virtual machine without a PMU, are left out with a warning.
+ *
+ * GL cases run in a headless context created on first use (EGL, falling back
+ * to OSMesa), so they work under llvmpipe without a display; if no context can
+ * be created they are reported as skipped. Asset paths are relative to the
+ * build directory, as for the other executables.
+ */
+
+namespace graf
+{
+    namespace bench
+    {
+        namespace
+        {
+            const size_t MAX_ITERATIONS = 1000000000; ///< Upper bound of the calibrated iteration count.
+
+            /**
+             * @brief Gets the registered families, in registration order.
+             * @return The registry.
+             */
+            vector<unique_ptr<Benchmark>>& Registry()
+            {
+                static vector<unique_ptr<Benchmark>> benchmarks;
+                return benchmarks;
+            }
+
+            /**
+             * @brief Converts an interval of process CPU time to seconds.
+             * @param start Clock at the start.
+             * @param end Clock at the end.
+             * @return Seconds of CPU time used by all threads.
+             */
+            double CpuSeconds(clock_t start, clock_t end)
+            {
+                return static_cast<double>(end - start) / CLOCKS_PER_SEC;
+            }
+
+            /**
+             * @brief Gets the symbol of a time unit.
+             * @param unit The unit.
+             * @return "ns", "us" or "ms".
+             */
+            const char* UnitName(TimeUnit unit)
+            {
+                switch (unit)
+                {
+                    case TimeUnit::Microsecond: return "us";
+                    case TimeUnit::Millisecond: return "ms";
+                    default:                    return "ns";
+                }
+            }
+
+            /**
+             * @brief Converts seconds to a time unit.
+             * @param seconds The duration.
+             * @param unit The unit.
+             * @return The duration in the unit.
+             */
+            double FromSeconds(double seconds, TimeUnit unit)
+            {
+                switch (unit)
+                {
+                    case TimeUnit::Microsecond: return seconds * 1e6;
+                    case TimeUnit::Millisecond: return seconds * 1e3;
+                    default:                    return seconds * 1e9;
+                }
+            }
+
+            /**
+             * @brief Formats a rate with a decimal or binary prefix.
+             * @param value Units per second.
+             * @param binary Whether to use 1024-based prefixes.
+             * @param suffix Unit appended after the prefix.
+             * @return The text, e.g. "12.3M/s".
+             */
+            string FormatRate(double value, bool binary, const char* suffix)
+            {
+                const char* prefixes[] = { "", "k", "M", "G", "T" };
+                double base = binary ? 1024.0 : 1000.0;
+                size_t prefix = 0;
+                while (value >= base && prefix < 4)
+                {
+                    value /= base;
+                    ++prefix;
+                }
+
+                std::ostringstream text;
+                text << std::setprecision(3) << value << prefixes[prefix];
+                if (binary && prefix > 0)
+                    text << "i";
+                text << suffix << "/s";
+                return text.str();
+            }
+        }
+
+        /**
+         * @struct RunResult
+         * @brief Measurement of one run, or an aggregate over the repetitions.
+         */
+        struct RunResult
+        {
+            string      name;                   ///< Instance name, e.g. "BM_Sort/1000".
+            size_t      familyIndex = 0;        ///< Index of the family in the registry.
+            size_t      instanceIndex = 0;      ///< Index of the argument set within the family.
+            size_t      repetitions = 1;        ///< Repetitions of the instance.
+            size_t      repetitionIndex = 0;    ///< Index of this run among them.
+            string      aggregate;              ///< "mean", "median" or "stddev"; empty for a run.
+            size_t      iterations = 0;         ///< Loop iterations.
+            double      realSeconds = 0.0;      ///< Wall time per iteration.
+            double      cpuSeconds = 0.0;       ///< CPU time per iteration.
+            double      itemsPerSecond = 0.0;   ///< Item rate, 0 if not reported.
+            double      bytesPerSecond = 0.0;   ///< Byte rate, 0 if not reported.
+            TimeUnit    unit = TimeUnit::Nanosecond; ///< Reporting unit.
+            string      label;                  ///< Label set by the case.
+            string      error;                  ///< Error message, empty on success.
+            double      counters[PERF_COUNTER_COUNT] = {}; ///< Hardware events per iteration.
+            uint32_t    counterMask = 0;        ///< Events counted, 0 without counters.
+            double      itemsPerIteration = 0.0; ///< Items per iteration, 0 if not reported.
+
+            /**
+             * @brief Gets an event count per iteration.
+             * @param counter The event.
+             * @return The count.
+             */
+            double getCounter(PerfCounter counter) const
+            {
+                return counters[static_cast<size_t>(counter)];
+            }
+
+            /**
+             * @brief Gets the instructions per cycle.
+             * @return The ratio, 0 unless both were counted; also 0 for the stddev aggregate.
+             */
+            double getIpc() const
+            {
+                uint32_t needed = PerfCounterBit(PerfCounter::Cycles) | PerfCounterBit(PerfCounter::Instructions);
+                return (counterMask & needed) == needed && getCounter(PerfCounter::Cycles) > 0.0 && aggregate != "stddev"
+                    ? getCounter(PerfCounter::Instructions) / getCounter(PerfCounter::Cycles)
+                    : 0.0;
+            }
+        };
+
+        /**
+         * @class Runner
+         * @brief Calibrates, repeats and reports the selected benchmarks.
+         */
+        class Runner
+        {
+        public:
+            double          minTime = 0.5;          ///< Minimum duration of a run in seconds.
+            size_t          repetitions = 1;        ///< Runs per instance.
+            bool            glEnabled = true;       ///< Whether GL cases may create a context.
+            vector<RunResult> results;              ///< Runs and aggregates, in order.
+
+            /**
+             * @brief Opens the hardware counters counted in every run.
+             * @param counters Mask of the wanted events.
+             * @return True if at least one event is counted.
+             */
+            bool OpenPerfCounters(uint32_t counters)
+            {
+                return m_perf.Open(counters);
+            }
+
+            /**
+             * @brief Gets the hardware counters.
+             * @return The counters, open only after a successful OpenPerfCounters.
+             */
+            const PerfCounters& getPerfCounters() const
+            {
+                return m_perf;
+            }
+
+            /**
+             * @brief Runs one instance: calibrates, repeats and aggregates.
+             * @param familyIndex Index of the family.
+             * @param instanceIndex Index of the argument set.
+             * @param name Instance name.
+             * @param benchmark The family.
+             * @param args The arguments.
+             * @param out Console output.
+             */
+            void RunInstance(size_t familyIndex, size_t instanceIndex, const string& name,
+                             const Benchmark& benchmark, const vector<int64_t>& args, ostream* out)
+            {
+                RunResult base;
+                base.name = name;
+                base.familyIndex = familyIndex;
+                base.instanceIndex = instanceIndex;
+                base.repetitions = repetitions;
+                base.unit = benchmark.getUnit();
+
+                if (benchmark.IsGL() && !EnsureGL())
+                {
+                    base.error = "no OpenGL context: " + m_glError;
+                    Report(base, out);
+                    return;
+                }
+
+                double runMinTime = benchmark.getMinTime() > 0.0 ? benchmark.getMinTime() : minTime;
+                vector<RunResult> runs;
+
+                size_t iterations = 1;
+                while (true)
+                {
+                    RunResult run = RunOnce(base, benchmark, args, iterations);
+                    if (!run.error.empty())
+                    {
+                        Report(run, out);
+                        return;
+                    }
+
+                    double seconds = run.realSeconds * iterations;
+                    if (seconds >= runMinTime || iterations >= MAX_ITERATIONS)
+                    {
+                        runs.push_back(run);
+                        break;
+                    }
+
+                    double multiplier = runMinTime * 1.4 / std::max(seconds, 1e-9);
+                    if (seconds / runMinTime <= 0.1)
+                        multiplier = std::min(multiplier, 10.0); ///< Too short to extrapolate from
+                    size_t next = static_cast<size_t>(iterations * multiplier);
+                    iterations = std::min(std::max(next, iterations + 1), MAX_ITERATIONS);
+                }
+
+                for (size_t r = 1; r < repetitions; ++r)
+                {
+                    RunResult run = RunOnce(base, benchmark, args, iterations);
+                    if (!run.error.empty())
+                    {
+                        Report(run, out);
+                        return;
+                    }
+                    run.repetitionIndex = r;
+                    runs.push_back(run);
+                }
+
+                for (const auto& run : runs)
+                    Report(run, out);
+                if (runs.size() > 1)
+                    ReportAggregates(runs, out);
+            }
+
+            /**
+             * @brief Gets the renderer of the GL context, if one was created.
+             * @return The GL_RENDERER string, empty without a context.
+             */
+            string getGLRenderer() const
+            {
+                return m_glRenderer;
+            }
+
+            /**
+             * @brief Releases what the GL cases left behind and reports leaked objects.
+             */
+            void ReleaseGL()
+            {
+                if (!m_window)
+                    return;
+
+                TextureManager::sRelease();
+                m_window->GetFrameBuffer().Release();
+                size_t leaks = GpuResourceTracker::sReportLeaks(std::cerr);
+                if (leaks > 0)
+                    std::cerr << leaks << " GPU objects leaked by the benchmarks" << std::endl;
+            }
+
+        private:
+            /**
+             * @brief Creates the headless GL context on first use.
+             * @return True if a context is current.
+             */
+            bool EnsureGL()
+            {
+                if (!glEnabled)
+                {
+                    m_glError = "disabled by --benchmark_gl=off";
+                    return false;
+                }
+                if (m_glTried)
+                    return m_window != nullptr;
+
+                m_glTried = true;
+                try
+                {
+                    auto window = std::make_unique<GLWindow>();
+                    window->createHeadless(256, 256);
+                    m_window = std::move(window);
+                    const GLubyte* renderer = glGetString(GL_RENDERER);
+                    m_glRenderer = renderer ? reinterpret_cast<const char*>(renderer) : "";
+                }
+                catch (const std::exception& e)
+                {
+                    m_glError = e.what();
+                }
+                return m_window != nullptr;
+            }
+
+            /**
+             * @brief Runs the case once with a fixed iteration count.
+             * @param base Identity of the instance.
+             * @param benchmark The family.
+             * @param args The arguments.
+             * @param iterations Loop iterations.
+             * @return The per-iteration measurement.
+             */
+            RunResult RunOnce(const RunResult& base, const Benchmark& benchmark, const vector<int64_t>& args,
+                              size_t iterations)
+            {
+                RunResult run = base;
+                State state(iterations, args);
+                if (m_perf.IsOpen())
+                {
+                    m_perf.Reset();
+                    state.m_counters = &m_perf;
+                }
+                try
+                {
+                    benchmark.getFunction()(state);
+                }
+                catch (const std::exception& e)
+                {
+                    state.m_error = e.what();
+                }
+
+                if (state.m_error.empty() && !state.m_finished)
+                    state.m_error = "the case did not complete its timed loop";
+
+                run.error = state.m_error;
+                run.label = state.m_label;
+                run.iterations = iterations;
+                run.realSeconds = state.m_realSeconds / iterations;
+                run.cpuSeconds = state.m_cpuSeconds / iterations;
+                if (state.m_realSeconds > 0.0)
+                {
+                    run.itemsPerSecond = state.m_items / state.m_realSeconds;
+                    run.bytesPerSecond = state.m_bytes / state.m_realSeconds;
+                }
+                run.itemsPerIteration = static_cast<double>(state.m_items) / iterations;
+
+                PerfCounterSample sample;
+                if (state.m_counters && m_perf.Read(sample))
+                {
+                    run.counterMask = sample.mask;
+                    for (size_t c = 0; c < PERF_COUNTER_COUNT; ++c)
+                        run.counters[c] = static_cast<double>(sample.values[c]) / iterations;
+                }
+                return run;
+            }
+
+            /**
+             * @brief Adds the mean, median and standard deviation of the repetitions.
+             * @param runs The repetitions.
+             * @param out Console output.
+             */
+            void ReportAggregates(const vector<RunResult>& runs, ostream* out)
+            {
+                auto aggregate = [&](const string& kind, auto reduce) {
+                    RunResult result = runs.front();
+                    result.name = runs.front().name + "_" + kind;
+                    result.aggregate = kind;
+                    result.realSeconds = reduce([](const RunResult& r) { return r.realSeconds; });
+                    result.cpuSeconds = reduce([](const RunResult& r) { return r.cpuSeconds; });
+                    result.itemsPerSecond = reduce([](const RunResult& r) { return r.itemsPerSecond; });
+                    result.bytesPerSecond = reduce([](const RunResult& r) { return r.bytesPerSecond; });
+                    for (size_t c = 0; c < PERF_COUNTER_COUNT; ++c)
+                        result.counters[c] = reduce([c](const RunResult& r) { return r.counters[c]; });
+                    Report(result, out);
+                };
+
+                auto values = [&](auto field) {
+                    vector<double> v;
+                    for (const auto& run : runs)
+                        v.push_back(field(run));
+                    return v;
+                };
+                auto mean = [&](auto field) {
+                    vector<double> v = values(field);
+                    double sum = 0.0;
+                    for (double x : v)
+                        sum += x;
+                    return sum / v.size();
+                };
+
+                aggregate("mean", mean);
+                aggregate("median", [&](auto field) {
+                    vector<double> v = values(field);
+                    std::sort(v.begin(), v.end());
+                    size_t mid = v.size() / 2;
+                    return v.size() % 2 ? v[mid] : (v[mid - 1] + v[mid]) / 2.0;
+                });
+                aggregate("stddev", [&](auto field) {
+                    vector<double> v = values(field);
+                    double m = mean(field);
+                    double squares = 0.0;
+                    for (double x : v)
+                        squares += (x - m) * (x - m);
+                    return std::sqrt(squares / (v.size() - 1)); ///< Sample standard deviation
+                });
+            }
+
+            /**
+             * @brief Records a result and prints it.
+             * @param result The result.
+             * @param out Console output, or nullptr.
+             */
+            void Report(const RunResult& result, ostream* out)
+            {
+                results.push_back(result);
+                if (!out)
+                    return;
+
+                *out << std::left << std::setw(48) << result.name << std::right;
+                if (!result.error.empty())
+                {
+                    *out << " ERROR: " << result.error << std::endl;
+                    return;
+                }
+
+                const char* unit = UnitName(result.unit);
+                *out << std::fixed << std::setprecision(1)
+                     << std::setw(12) << FromSeconds(result.realSeconds, result.unit) << " " << unit
+                     << std::setw(12) << FromSeconds(result.cpuSeconds, result.unit) << " " << unit;
+                out->unsetf(std::ios::fixed);
+                *out << std::setw(12) << (result.aggregate.empty() ? std::to_string(result.iterations) : "");
+                if (result.itemsPerSecond > 0.0)
+                    *out << " items_per_second=" << FormatRate(result.itemsPerSecond, false, "");
+                if (result.bytesPerSecond > 0.0)
+                    *out << " bytes_per_second=" << FormatRate(result.bytesPerSecond, true, "B");
+                if (result.counterMask != 0)
+                    *out << FormatCounters(result);
+                if (!result.label.empty())
+                    *out << " " << result.label;
+                *out << std::endl;
+            }
+
+        private:
+            /**
+             * @brief Formats the hardware counters of a result for the console.
+             *
+             * Shows IPC and, per item where the case reports items and per iteration
+             * otherwise, the cycles and misses.
+             *
+             * @param result The result.
+             * @return The text, starting with a space.
+             */
+            static string FormatCounters(const RunResult& result)
+            {
+                std::ostringstream text;
+                text << std::setprecision(3);
+                if (result.getIpc() > 0.0)
+                    text << " IPC=" << result.getIpc();
+
+                bool perItem = result.itemsPerIteration > 0.0;
+                double divisor = perItem ? result.itemsPerIteration : 1.0;
+                for (PerfCounter counter : {PerfCounter::Cycles, PerfCounter::L1DMisses, PerfCounter::LLCMisses,
+                                            PerfCounter::BranchMisses})
+                {
+                    if (result.counterMask & PerfCounterBit(counter))
+                        text << " " << PerfCounters::GetCounterName(counter) << (perItem ? "/item=" : "/iter=")
+                             << result.getCounter(counter) / divisor;
+                }
+                return text.str();
+            }
+
+        private:
+            PerfCounters            m_perf;             ///< Hardware counters of the runs, if opened.
+            unique_ptr<GLWindow>    m_window;           ///< Headless context of the GL cases.
+            bool                    m_glTried = false;  ///< Whether context creation was attempted.
+            string                  m_glError;          ///< Why no context is available.
+            string                  m_glRenderer;       ///< GL_RENDERER of the context.
+        };
+
+        /**
+         * @brief Constructs a run.
+         * @param iterations Number of loop iterations.
+         * @param args Arguments of the benchmark instance.
+         */
+        State::State(size_t iterations, const vector<int64_t>& args)
+            : m_iterations(iterations), m_args(args)
+        {
+        }
+
+        /**
+         * @brief Starts the timer and the loop.
+         * @return The iterator at the first iteration.
+         */
+        State::Iterator State::begin()
+        {
+            ResumeTiming();
+            return Iterator(this, m_iterations);
+        }
+
+        /**
+         * @brief Gets the end of the loop.
+         * @return The end iterator.
+         */
+        State::Iterator State::end()
+        {
+            return Iterator(nullptr, 0);
+        }
+
+        /**
+         * @brief Gets an argument of the benchmark instance.
+         * @param index Index of the argument.
+         * @return The argument, or 0 if there are fewer.
+         */
+        int64_t State::getRange(size_t index) const
+        {
+            return index < m_args.size() ? m_args[index] : 0;
+        }
+
+        /**
+         * @brief Gets the number of loop iterations of this run.
+         * @return The iteration count.
+         */
+        size_t State::getIterations() const
+        {
+            return m_iterations;
+        }
+
+        /**
+         * @brief Stops the timer, e.g. around per-iteration setup.
+         */
+        void State::PauseTiming()
+        {
+            if (!m_running)
+                return;
+
+            if (m_counters)
+                m_counters->Stop(); ///< First, so the timer reads are not counted
+            clock_t cpuEnd = std::clock();
+            m_realSeconds += chrono::duration<double>(Clock::now() - m_realStart).count();
+            m_cpuSeconds += CpuSeconds(m_cpuStart, cpuEnd);
+            m_running = false;
+        }
+
+        /**
+         * @brief Restarts the timer after PauseTiming.
+         */
+        void State::ResumeTiming()
+        {
+            if (m_running)
+                return;
+
+            m_running = true;
+            m_cpuStart = std::clock();
+            m_realStart = Clock::now();
+            if (m_counters)
+                m_counters->Start();
+        }
+
+        /**
+         * @brief Reports the number of items processed by the whole run.
+         * @param items The item count.
+         */
+        void State::SetItemsProcessed(int64_t items)
+        {
+            m_items = items;
+        }
+
+        /**
+         * @brief Reports the number of bytes processed by the whole run.
+         * @param bytes The byte count.
+         */
+        void State::SetBytesProcessed(int64_t bytes)
+        {
+            m_bytes = bytes;
+        }
+
+        /**
+         * @brief Attaches a label to the reported run.
+         * @param label The label.
+         */
+        void State::SetLabel(const string& label)
+        {
+            m_label = label;
+        }
+
+        /**
+         * @brief Marks the run as failed; call before the loop and return without iterating.
+         * @param message The reason.
+         */
+        void State::SkipWithError(const string& message)
+        {
+            m_error = message;
+        }
+
+        /**
+         * @brief Stops the timer once the loop has finished.
+         */
+        void State::FinishLoop()
+        {
+            PauseTiming();
+            m_finished = true;
+        }
+
+        /**
+         * @brief Constructs a benchmark family.
+         * @param name Name of the family.
+         * @param function The case.
+         */
+        Benchmark::Benchmark(const string& name, BenchmarkFunction function)
+            : m_name(name), m_function(function)
+        {
+        }
+
+        /**
+         * @brief Adds an instance with one argument.
+         * @param arg The argument.
+         * @return This benchmark.
+         */
+        Benchmark* Benchmark::Arg(int64_t arg)
+        {
+            m_argSets.push_back({arg});
+            return this;
+        }
+
+        /**
+         * @brief Adds an instance with several arguments.
+         * @param args The arguments.
+         * @return This benchmark.
+         */
+        Benchmark* Benchmark::Args(const vector<int64_t>& args)
+        {
+            m_argSets.push_back(args);
+            return this;
+        }
+
+        /**
+         * @brief Adds instances for the powers of a multiplier between two bounds.
+         * @param low Smallest argument.
+         * @param high Largest argument, always included.
+         * @param multiplier Factor between two arguments.
+         * @return This benchmark.
+         */
+        Benchmark* Benchmark::Range(int64_t low, int64_t high, int64_t multiplier)
+        {
+            for (int64_t arg = std::max<int64_t>(low, 1); arg < high; arg *= std::max<int64_t>(multiplier, 2))
+                m_argSets.push_back({arg});
+            m_argSets.push_back({high});
+            return this;
+        }
+
+        /**
+         * @brief Sets the unit of the reported times.
+         * @param unit The unit.
+         * @return This benchmark.
+         */
+        Benchmark* Benchmark::Unit(TimeUnit unit)
+        {
+            m_unit = unit;
+            return this;
+        }
+
+        /**
+         * @brief Sets the minimum duration of a run, overriding the command line.
+         * @param seconds The duration.
+         * @return This benchmark.
+         */
+        Benchmark* Benchmark::MinTime(double seconds)
+        {
+            m_minTime = seconds;
+            return this;
+        }
+
+        /**
+         * @brief Marks the case as needing a current OpenGL context.
+         * @return This benchmark.
+         */
+        Benchmark* Benchmark::RequiresGL()
+        {
+            m_gl = true;
+            return this;
+        }
+
+        /**
+         * @brief Gets the name of the family.
+         * @return The name.
+         */
+        const string& Benchmark::getName() const
+        {
+            return m_name;
+        }
+
+        /**
+         * @brief Gets the case.
+         * @return The function.
+         */
+        BenchmarkFunction Benchmark::getFunction() const
+        {
+            return m_function;
+        }
+
+        /**
+         * @brief Gets the argument sets; a family without arguments has one empty set.
+         * @return The argument sets.
+         */
+        vector<vector<int64_t>> Benchmark::getArgSets() const
+        {
+            return m_argSets.empty() ? vector<vector<int64_t>>(1) : m_argSets;
+        }
+
+        /**
+         * @brief Gets the unit of the reported times.
+         * @return The unit.
+         */
+        TimeUnit Benchmark::getUnit() const
+        {
+            return m_unit;
+        }
+
+        /**
+         * @brief Gets the minimum run duration.
+         * @return Seconds, or 0 to use the command line value.
+         */
+        double Benchmark::getMinTime() const
+        {
+            return m_minTime;
+        }
+
+        /**
+         * @brief Checks whether the case needs an OpenGL context.
+         * @return True for GL cases.
+         */
+        bool Benchmark::IsGL() const
+        {
+            return m_gl;
+        }
+
+        /**
+         * @brief Registers a benchmark family; used through GRAF_BENCHMARK.
+         * @param name Name of the family.
+         * @param function The case.
+         * @return The family, owned by the registry.
+         */
+        Benchmark* RegisterBenchmark(const char* name, BenchmarkFunction function)
+        {
+            Registry().push_back(std::make_unique<Benchmark>(name, function));
+            return Registry().back().get();
+        }
+
+        namespace
+        {
+            /**
+             * @brief Builds the JSON report in Google Benchmark's schema.
+             * @param runner The runner holding the results.
+             * @param executable Path of the executable.
+             * @return The report.
+             */
+            json BuildJsonReport(const Runner& runner, const string& executable)
+            {
+                json context;
+                std::time_t now = std::time(nullptr);
+                char date[32];
+                std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+                context["date"] = date;
+                char host[256] = "";
+#ifndef _WIN32
+                gethostname(host, sizeof(host) - 1);
+#endif
+                context["host_name"] = host;
+                context["executable"] = executable;
+                context["num_cpus"] = std::thread::hardware_concurrency();
+#ifdef NDEBUG
+                context["library_build_type"] = "release";
+#else
+                context["library_build_type"] = "debug";
+#endif
+                context["gl_renderer"] = runner.getGLRenderer();
+                if (runner.getPerfCounters().IsOpen())
+                    context["perf_counters"] = PerfCounters::FormatCounterList(runner.getPerfCounters().GetOpenCounters());
+                if (!runner.getPerfCounters().GetError().empty())
+                    context["perf_counters_error"] = runner.getPerfCounters().GetError();
+                context["json_schema_version"] = 1;
+
+                json benchmarks = json::array();
+                for (const auto& result : runner.results)
+                {
+                    json entry;
+                    entry["name"] = result.name;
+                    entry["family_index"] = result.familyIndex;
+                    entry["per_family_instance_index"] = result.instanceIndex;
+                    entry["run_name"] = result.aggregate.empty()
+                        ? result.name
+                        : result.name.substr(0, result.name.size() - result.aggregate.size() - 1);
+                    entry["run_type"] = result.aggregate.empty() ? "iteration" : "aggregate";
+                    entry["repetitions"] = result.repetitions;
+                    entry["threads"] = 1;
+                    if (result.aggregate.empty())
+                    {
+                        entry["repetition_index"] = result.repetitionIndex;
+                    }
+                    else
+                    {
+                        entry["aggregate_name"] = result.aggregate;
+                        entry["aggregate_unit"] = "time";
+                    }
+
+                    if (!result.error.empty())
+                    {
+                        entry["error_occurred"] = true;
+                        entry["error_message"] = result.error;
+                        benchmarks.push_back(entry);
+                        continue;
+                    }
+
+                    entry["iterations"] = result.iterations;
+                    entry["real_time"] = FromSeconds(result.realSeconds, result.unit);
+                    entry["cpu_time"] = FromSeconds(result.cpuSeconds, result.unit);
+                    entry["time_unit"] = UnitName(result.unit);
+                    if (result.itemsPerSecond > 0.0)
+                        entry["items_per_second"] = result.itemsPerSecond;
+                    if (result.bytesPerSecond > 0.0)
+                        entry["bytes_per_second"] = result.bytesPerSecond;
+                    if (!result.label.empty())
+                        entry["label"] = result.label;
+                    for (size_t c = 0; c < PERF_COUNTER_COUNT; ++c)
+                    {
+                        if (!(result.counterMask & (1u << c)))
+                            continue;
+                        string name = PerfCounters::GetCounterName(static_cast<PerfCounter>(c));
+                        entry[name] = result.counters[c]; ///< Per iteration, like Google Benchmark's perf counters
+                        if (result.itemsPerIteration > 0.0)
+                            entry[name + "_per_item"] = result.counters[c] / result.itemsPerIteration;
+                    }
+                    if (result.getIpc() > 0.0)
+                        entry["ipc"] = result.getIpc();
+                    benchmarks.push_back(entry);
+                }
+
+                return json{{"context", context}, {"benchmarks", benchmarks}};
+            }
+
+            /**
+             * @brief Builds the name of an instance from its family and arguments.
+             * @param family The family name.
+             * @param args The arguments.
+             * @return The name, e.g. "BM_Sort/1000".
+             */
+            string InstanceName(const string& family, const vector<int64_t>& args)
+            {
+                string name = family;
+                for (int64_t arg : args)
+                    name += "/" + std::to_string(arg);
+                return name;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Benchmark entry point.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit status: 0 for success, -1 for invalid arguments or failed cases.
+ */
+int main(int argc, char** argv)
+{
+    using namespace graf::bench;
+
+    Runner runner;
+    std::string filter = ".";
+    std::string outFile;
+    std::string format = "console";
+    uint32_t perfCounters = 0;
+    bool listOnly = false;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string option = argv[i];
+            size_t equals = option.find('=');
+            std::string key = option.substr(0, equals);
+            std::string value = equals == std::string::npos ? "" : option.substr(equals + 1);
+
+            if (key == "--benchmark_filter")
+                filter = value;
+            else if (key == "--benchmark_min_time")
+                runner.minTime = std::stod(value);
+            else if (key == "--benchmark_repetitions")
+                runner.repetitions = std::max<size_t>(std::stoul(value), 1);
+            else if (key == "--benchmark_out")
+                outFile = value;
+            else if (key == "--benchmark_format" && (value == "console" || value == "json"))
+                format = value;
+            else if (key == "--benchmark_gl" && (value == "auto" || value == "off"))
+                runner.glEnabled = value == "auto";
+            else if (key == "--benchmark_perf_counters")
+                perfCounters = graf::PerfCounters::ParseCounterList(value);
+            else if (key == "--benchmark_list_tests")
+                listOnly = true;
+            else
+                throw std::invalid_argument(option);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Invalid argument: " << e.what() << "\n"
+                  << "Usage: " << argv[0] << " [--benchmark_filter=<regex>] [--benchmark_min_time=<seconds>]"
+                  << " [--benchmark_repetitions=<n>] [--benchmark_out=<file.json>]"
+                  << " [--benchmark_format=<console|json>] [--benchmark_gl=<auto|off>]"
+                  << " [--benchmark_perf_counters=<all|cycles,instructions,l1d_misses,llc_misses,branch_misses>]"
+                  << " [--benchmark_list_tests]"
+                  << std::endl;
+        return -1;
+    }
+
+    if (perfCounters != 0 && !listOnly)
+    {
+        if (!runner.OpenPerfCounters(perfCounters))
+            std::cerr << "Hardware counters unavailable, timing only: " << runner.getPerfCounters().GetError() << std::endl;
+        else if (!runner.getPerfCounters().GetError().empty())
+            std::cerr << "Hardware counters: " << runner.getPerfCounters().GetError() << std::endl;
+    }
+
+    bool negate = !filter.empty() && filter[0] == '-';
+    std::regex pattern(negate ? filter.substr(1) : filter);
+    std::ostream* console = format == "console" ? &std::cout : nullptr;
+
+    std::vector<std::unique_ptr<Benchmark>>& registry = Registry();
+    for (size_t f = 0; f < registry.size(); ++f)
+    {
+        const Benchmark& benchmark = *registry[f];
+        std::vector<std::vector<int64_t>> argSets = benchmark.getArgSets();
+        for (size_t a = 0; a < argSets.size(); ++a)
+        {
+            std::string name = InstanceName(benchmark.getName(), argSets[a]);
+            if (std::regex_search(name, pattern) == negate)
+                continue;
+
+            if (listOnly)
+                std::cout << name << (benchmark.IsGL() ? " (GL)" : "") << std::endl;
+            else
+                runner.RunInstance(f, a, name, benchmark, argSets[a], console);
+        }
+    }
+
+    if (listOnly)
+        return 0;
+
+    runner.ReleaseGL();
+
+    json report = BuildJsonReport(runner, argv[0]);
+    if (format == "json")
+        std::cout << report.dump(2) << std::endl;
+    if (!outFile.empty())
+    {
+        std::ofstream file(outFile);
+        file << report.dump(2) << std::endl;
+        if (!file)
+        {
+            std::cerr << "Failed to write benchmark results: " << outFile << std::endl;
+            return -1;
+        }
+    }
+
+    for (const auto& result : runner.results)
+    {
+        if (!result.error.empty() && result.error.rfind("no OpenGL context", 0) != 0)
+            return -1; ///< A case failed; missing GL only skips
+    }
+    return 0;
+}
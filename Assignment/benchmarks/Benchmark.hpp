@@ -0,0 +1,380 @@
+#pragma once
+
+#include "PerfCounters.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+/**
+ * @file Benchmark.hpp
+ * @brief A small microbenchmark harness modelled on Google Benchmark.
+ *
+ * Cases are plain functions registered with GRAF_BENCHMARK and timed through a
+ * State that they iterate over:
+ *
+ * @code
+ * void BM_Example(graf::bench::State& state)
+ * {
+ *     std::vector<int> data(state.getRange(0));
+ *     for (auto _ : state)
+ *         graf::bench::DoNotOptimize(std::accumulate(data.begin(), data.end(), 0));
+ *     state.SetItemsProcessed(state.getIterations() * data.size());
+ * }
+ * GRAF_BENCHMARK(BM_Example)->Arg(1000)->Arg(100000);
+ * @endcode
+ *
+ * Only the loop is timed; setup before it and teardown after it are not. The
+ * runner grows the iteration count until a run lasts the minimum time, repeats
+ * it, and reports the runs and their mean, median and standard deviation on
+ * the console and as JSON in Google Benchmark's format, so existing comparison
+ * tools can track results across builds. Hardware counters can be collected
+ * alongside; they run and pause with the timer.
+ */
+
+namespace graf
+{
+    namespace bench
+    {
+        using namespace std;
+
+        /**
+         * @enum TimeUnit
+         * @brief Unit in which a benchmark's times are reported.
+         */
+        enum class TimeUnit
+        {
+            Nanosecond,  ///< ns
+            Microsecond, ///< us
+            Millisecond  ///< ms
+        };
+
+        /**
+         * @class State
+         * @brief Runs the timed loop of one benchmark run and collects its counters.
+         */
+        class State
+        {
+        public:
+            /**
+             * @struct Value
+             * @brief Dummy value of the timed loop.
+             *
+             * The user-provided constructor and destructor make the value non-trivial,
+             * so the compiler treats the loop variable as used.
+             */
+            struct Value
+            {
+                /**
+                 * @brief Constructs the value.
+                 */
+                Value()
+                {
+                }
+
+                /**
+                 * @brief Destroys the value.
+                 */
+                ~Value()
+                {
+                }
+            };
+
+            /**
+             * @class Iterator
+             * @brief Counts down the iterations of the timed loop.
+             */
+            class Iterator
+            {
+            public:
+                /**
+                 * @brief Constructs an iterator.
+                 * @param state The run, or nullptr for the end iterator.
+                 * @param remaining Iterations left.
+                 */
+                Iterator(State* state, size_t remaining)
+                    : m_state(state), m_remaining(remaining)
+                {
+                }
+
+                /**
+                 * @brief Gets the dummy loop value.
+                 * @return An empty value.
+                 */
+                Value operator*() const
+                {
+                    return Value();
+                }
+
+                /**
+                 * @brief Advances to the next iteration.
+                 * @return This iterator.
+                 */
+                Iterator& operator++()
+                {
+                    --m_remaining;
+                    return *this;
+                }
+
+                /**
+                 * @brief Checks whether the loop continues; stops the timer after the last iteration.
+                 * @return True while iterations are left.
+                 */
+                bool operator!=(const Iterator&)
+                {
+                    if (m_remaining != 0)
+                        return true;
+                    m_state->FinishLoop();
+                    return false;
+                }
+
+            private:
+                State* m_state;     ///< The run.
+                size_t m_remaining; ///< Iterations left.
+            };
+
+            /**
+             * @brief Constructs a run.
+             * @param iterations Number of loop iterations.
+             * @param args Arguments of the benchmark instance.
+             */
+            State(size_t iterations, const vector<int64_t>& args);
+
+            /**
+             * @brief Starts the timer and the loop.
+             * @return The iterator at the first iteration.
+             */
+            Iterator begin();
+
+            /**
+             * @brief Gets the end of the loop.
+             * @return The end iterator.
+             */
+            Iterator end();
+
+            /**
+             * @brief Gets an argument of the benchmark instance.
+             * @param index Index of the argument.
+             * @return The argument, or 0 if there are fewer.
+             */
+            int64_t getRange(size_t index = 0) const;
+
+            /**
+             * @brief Gets the number of loop iterations of this run.
+             * @return The iteration count.
+             */
+            size_t getIterations() const;
+
+            /**
+             * @brief Stops the timer, e.g. around per-iteration setup.
+             */
+            void PauseTiming();
+
+            /**
+             * @brief Restarts the timer after PauseTiming.
+             */
+            void ResumeTiming();
+
+            /**
+             * @brief Reports the number of items processed by the whole run.
+             * @param items The item count.
+             */
+            void SetItemsProcessed(int64_t items);
+
+            /**
+             * @brief Reports the number of bytes processed by the whole run.
+             * @param bytes The byte count.
+             */
+            void SetBytesProcessed(int64_t bytes);
+
+            /**
+             * @brief Attaches a label to the reported run.
+             * @param label The label.
+             */
+            void SetLabel(const string& label);
+
+            /**
+             * @brief Marks the run as failed; call before the loop and return without iterating.
+             * @param message The reason.
+             */
+            void SkipWithError(const string& message);
+
+        private:
+            friend class Runner;
+
+            /**
+             * @brief Stops the timer once the loop has finished.
+             */
+            void FinishLoop();
+
+        private:
+            using Clock = chrono::steady_clock;
+
+            size_t              m_iterations;           ///< Loop iterations.
+            vector<int64_t>     m_args;                 ///< Arguments of the instance.
+            bool                m_running = false;      ///< Whether the timer runs.
+            bool                m_finished = false;     ///< Whether the loop has completed.
+            Clock::time_point   m_realStart;            ///< Wall time at the last start.
+            clock_t             m_cpuStart = 0;         ///< Process CPU time at the last start.
+            double              m_realSeconds = 0.0;    ///< Accumulated wall time.
+            double              m_cpuSeconds = 0.0;     ///< Accumulated process CPU time.
+            int64_t             m_items = 0;            ///< Items processed, 0 if not reported.
+            int64_t             m_bytes = 0;            ///< Bytes processed, 0 if not reported.
+            string              m_label;                ///< Label of the run.
+            string              m_error;                ///< Error message, empty on success.
+            PerfCounters*       m_counters = nullptr;   ///< Counters run with the timer, or nullptr.
+        };
+
+        using BenchmarkFunction = void (*)(State&); ///< A benchmark case.
+
+        /**
+         * @class Benchmark
+         * @brief A registered benchmark family and its argument sets.
+         *
+         * The setters return the benchmark so they can be chained after GRAF_BENCHMARK.
+         */
+        class Benchmark
+        {
+        public:
+            /**
+             * @brief Constructs a benchmark family.
+             * @param name Name of the family.
+             * @param function The case.
+             */
+            Benchmark(const string& name, BenchmarkFunction function);
+
+            /**
+             * @brief Adds an instance with one argument.
+             * @param arg The argument.
+             * @return This benchmark.
+             */
+            Benchmark* Arg(int64_t arg);
+
+            /**
+             * @brief Adds an instance with several arguments.
+             * @param args The arguments.
+             * @return This benchmark.
+             */
+            Benchmark* Args(const vector<int64_t>& args);
+
+            /**
+             * @brief Adds instances for the powers of a multiplier between two bounds.
+             * @param low Smallest argument.
+             * @param high Largest argument, always included.
+             * @param multiplier Factor between two arguments.
+             * @return This benchmark.
+             */
+            Benchmark* Range(int64_t low, int64_t high, int64_t multiplier = 8);
+
+            /**
+             * @brief Sets the unit of the reported times.
+             * @param unit The unit.
+             * @return This benchmark.
+             */
+            Benchmark* Unit(TimeUnit unit);
+
+            /**
+             * @brief Sets the minimum duration of a run, overriding the command line.
+             * @param seconds The duration.
+             * @return This benchmark.
+             */
+            Benchmark* MinTime(double seconds);
+
+            /**
+             * @brief Marks the case as needing a current OpenGL context.
+             * @return This benchmark.
+             */
+            Benchmark* RequiresGL();
+
+            /**
+             * @brief Gets the name of the family.
+             * @return The name.
+             */
+            const string& getName() const;
+
+            /**
+             * @brief Gets the case.
+             * @return The function.
+             */
+            BenchmarkFunction getFunction() const;
+
+            /**
+             * @brief Gets the argument sets; a family without arguments has one empty set.
+             * @return The argument sets.
+             */
+            vector<vector<int64_t>> getArgSets() const;
+
+            /**
+             * @brief Gets the unit of the reported times.
+             * @return The unit.
+             */
+            TimeUnit getUnit() const;
+
+            /**
+             * @brief Gets the minimum run duration.
+             * @return Seconds, or 0 to use the command line value.
+             */
+            double getMinTime() const;
+
+            /**
+             * @brief Checks whether the case needs an OpenGL context.
+             * @return True for GL cases.
+             */
+            bool IsGL() const;
+
+        private:
+            string                      m_name;                         ///< Family name.
+            BenchmarkFunction           m_function;                     ///< The case.
+            vector<vector<int64_t>>     m_argSets;                      ///< Arguments of each instance.
+            TimeUnit                    m_unit = TimeUnit::Nanosecond;  ///< Reporting unit.
+            double                      m_minTime = 0.0;                ///< Minimum run duration, 0 for the default.
+            bool                        m_gl = false;                   ///< Whether a GL context is needed.
+        };
+
+        /**
+         * @brief Registers a benchmark family; used through GRAF_BENCHMARK.
+         * @param name Name of the family.
+         * @param function The case.
+         * @return The family, owned by the registry.
+         */
+        Benchmark* RegisterBenchmark(const char* name, BenchmarkFunction function);
+
+        /**
+         * @brief Keeps the compiler from optimizing away the computation of a value.
+         * @param value The value.
+         */
+        template <typename T>
+        inline void DoNotOptimize(const T& value)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : "r,m"(value) : "memory");
+#else
+            static volatile const void* sink;
+            sink = &value;
+#endif
+        }
+
+        /**
+         * @brief Forces all pending writes to memory to be considered observable.
+         */
+        inline void ClobberMemory()
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : : "memory");
+#else
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+        }
+    }
+}
+
+#define GRAF_BENCHMARK_CONCAT_INNER(a, b) a##b
+#define GRAF_BENCHMARK_CONCAT(a, b) GRAF_BENCHMARK_CONCAT_INNER(a, b)
+
+/// Registers a benchmark case; argument setters can be chained onto the result.
+#define GRAF_BENCHMARK(function)                                                          \
+    static ::graf::bench::Benchmark* GRAF_BENCHMARK_CONCAT(s_benchmark_, __LINE__) [[maybe_unused]] = \
+        ::graf::bench::RegisterBenchmark(#function, function)
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Scene.hpp"
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @file BenchmarkScene.hpp
+ * @brief Seeded object lists shared by the benchmark cases.
+ */
+
+namespace graf
+{
+    namespace bench
+    {
+        /**
+         * @brief Texture files used by the benchmark scenes, relative to the build directory.
+         * @return The file names.
+         */
+        inline const std::vector<std::string>& BenchmarkTextures()
+        {
+            static const std::vector<std::string> textures = {
+                "../images/container.jpg",
+                "../images/container2.jpg",
+                "../images/container3.jpg",
+                "../images/container4.jpg"
+            };
+            return textures;
+        }
+
+        /**
+         * @brief Builds a reproducible list of objects spread in front of the default camera.
+         *
+         * About half the objects lie outside the view so culling has work to do.
+         *
+         * @param count Number of objects.
+         * @param seed Seed of the generator.
+         * @return The objects.
+         */
+        inline std::vector<ObjectData> MakeBenchmarkObjects(size_t count, uint32_t seed = 42)
+        {
+            std::mt19937 gen(seed);
+            std::uniform_real_distribution<float> spread(-40.0f, 40.0f);
+            std::uniform_real_distribution<float> depth(-60.0f, -2.0f);
+            std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+            std::uniform_int_distribution<int> shape(0, static_cast<int>(ShapeTypes::Frustum));
+            std::uniform_int_distribution<size_t> texture(0, BenchmarkTextures().size() - 1);
+
+            std::vector<ObjectData> objects(count);
+            for (auto& obj : objects)
+            {
+                obj.position = glm::vec3(spread(gen), spread(gen), depth(gen));
+                obj.angle = angle(gen);
+                obj.shape = static_cast<ShapeTypes>(shape(gen));
+                obj.texture = BenchmarkTextures()[texture(gen)];
+            }
+            return objects;
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#include "Benchmark.hpp"
+#include "ShapeFactoryManager.hpp"
+
+/**
+ * @file FactoryBenchmarks.cpp
+ * @brief Microbenchmarks of mesh generation and upload by the shape factories.
+ */
+
+namespace
+{
+    using namespace graf;
+    using namespace graf::bench;
+
+    /**
+     * @brief Times repeated mesh generation by a factory.
+     * @param state The benchmark state.
+     * @param factory The factory to run.
+     */
+    void RunGenerateMesh(State& state, ShapeFactory& factory)
+    {
+        VertexList vertices;
+        IndexList indices;
+        for (auto _ : state)
+        {
+            factory.generateMesh(vertices, indices);
+            DoNotOptimize(vertices.data());
+            DoNotOptimize(indices.data());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.getIterations() * vertices.size())); ///< Vertices generated
+    }
+
+    /**
+     * @brief Square mesh generation.
+     */
+    void BM_GenerateSquare(State& state)
+    {
+        SquareFactory factory;
+        RunGenerateMesh(state, factory);
+    }
+    GRAF_BENCHMARK(BM_GenerateSquare);
+
+    /**
+     * @brief Cube mesh generation.
+     */
+    void BM_GenerateCube(State& state)
+    {
+        CubeFactory factory;
+        RunGenerateMesh(state, factory);
+    }
+    GRAF_BENCHMARK(BM_GenerateCube);
+
+    /**
+     * @brief Pyramid mesh generation.
+     */
+    void BM_GeneratePyramid(State& state)
+    {
+        PyramidFactory factory;
+        RunGenerateMesh(state, factory);
+    }
+    GRAF_BENCHMARK(BM_GeneratePyramid);
+
+    /**
+     * @brief Frustum mesh generation.
+     */
+    void BM_GenerateFrustum(State& state)
+    {
+        FrustumFactory factory;
+        RunGenerateMesh(state, factory);
+    }
+    GRAF_BENCHMARK(BM_GenerateFrustum);
+
+    /**
+     * @brief Circle generation; the argument is the segment angle in degrees.
+     */
+    void BM_GenerateCircle(State& state)
+    {
+        CircleFactory factory(static_cast<int>(state.getRange(0)));
+        RunGenerateMesh(state, factory);
+    }
+    GRAF_BENCHMARK(BM_GenerateCircle)->Arg(45)->Arg(10)->Arg(1);
+
+    /**
+     * @brief Mesh generation plus VAO, VBO and IBO creation and deletion for a cube.
+     */
+    void BM_UploadCube(State& state)
+    {
+        CubeFactory factory;
+        VertexList vertices;
+        IndexList indices;
+        factory.generateMesh(vertices, indices);
+
+        for (auto _ : state)
+        {
+            VertexArrayObject vao = factory.createVAOFromData(vertices, indices);
+            DoNotOptimize(vao.getId());
+        }
+        state.SetBytesProcessed(static_cast<int64_t>(state.getIterations() *
+                                (vertices.size() * sizeof(Vertex) + indices.size() * sizeof(unsigned int))));
+    }
+    GRAF_BENCHMARK(BM_UploadCube)->RequiresGL()->Unit(TimeUnit::Microsecond);
+}
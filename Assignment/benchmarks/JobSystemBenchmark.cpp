@@ -0,0 +1,143 @@
+#include "JobSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+/**
+ * @file JobSystemBenchmark.cpp
+ * @brief Measures how the job system's parallel-for scales from 1 to N cores.
+ * 
+ * The workload composes a world-view-projection matrix for every object of a
+ * large synthetic scene, which is what the simulation thread does per frame.
+ * The single-core case runs the loop serially; every other case uses a job
+ * system with one worker less than the core count, as the calling thread helps.
+ */
+
+namespace
+{
+    /**
+     * @brief Per-object input of the benchmark workload.
+     */
+    struct BenchObject
+    {
+        glm::vec3 position; ///< World position.
+        float angle;        ///< Rotation around the Y-axis in degrees.
+    };
+
+    /**
+     * @brief Builds the transforms of a range of objects.
+     * @param objects The objects to transform.
+     * @param transforms Output transforms, one per object.
+     * @param viewProjection The combined projection and view matrix.
+     * @param begin First object index.
+     * @param end One past the last object index.
+     */
+    void TransformRange(const std::vector<BenchObject>& objects, std::vector<glm::mat4>& transforms,
+                        const glm::mat4& viewProjection, size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            glm::mat4 world = glm::translate(glm::mat4(1), objects[i].position);
+            world = glm::rotate(world, glm::radians(objects[i].angle), glm::vec3(0.0f, 1.0f, 0.0f));
+            transforms[i] = viewProjection * world;
+        }
+    }
+
+    /**
+     * @brief Returns the median of a list of timings.
+     * @param samples Timings in milliseconds (reordered).
+     * @return The median timing.
+     */
+    double Median(std::vector<double>& samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+}
+
+/**
+ * @brief Benchmark entry point.
+ * 
+ * Usage: JobSystemBenchmark [objectCount] [maxCores]
+ * 
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit status: 0 for success, -1 on bad arguments.
+ */
+int main(int argc, char** argv)
+{
+    size_t objectCount = 1000000;
+    unsigned int maxCores = std::max(1u, std::thread::hardware_concurrency());
+    try
+    {
+        if (argc > 3)
+            throw std::invalid_argument("Too many arguments");
+        if (argc > 1)
+            objectCount = std::stoul(argv[1]);
+        if (argc > 2)
+            maxCores = static_cast<unsigned int>(std::stoul(argv[2]));
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [objectCount] [maxCores]" << std::endl;
+        return -1;
+    }
+
+    const int repetitions = 15;
+    const size_t grainSize = 4096;
+
+    std::vector<BenchObject> objects(objectCount);
+    for (size_t i = 0; i < objectCount; ++i)
+        objects[i] = {glm::vec3(float(i % 100), float((i / 100) % 100), -float(i / 10000)), float(i % 360)};
+
+    std::vector<glm::mat4> transforms(objectCount);
+    glm::mat4 viewProjection = glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 100.0f);
+
+    std::cout << "objects=" << objectCount << " grain=" << grainSize << " repetitions=" << repetitions << std::endl;
+    std::cout << std::setw(6) << "cores" << std::setw(14) << "median_ms" << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << std::endl;
+
+    double serialMs = 0.0;
+    for (unsigned int cores = 1; cores <= maxCores; ++cores)
+    {
+        std::unique_ptr<graf::JobSystem> jobs;
+        if (cores > 1)
+            jobs = std::make_unique<graf::JobSystem>(cores - 1);
+
+        std::vector<double> samples;
+        for (int rep = 0; rep < repetitions; ++rep)
+        {
+            auto start = std::chrono::steady_clock::now();
+            if (jobs)
+            {
+                jobs->ParallelFor(0, objectCount, grainSize, [&](size_t begin, size_t end) {
+                    TransformRange(objects, transforms, viewProjection, begin, end);
+                });
+            }
+            else
+                TransformRange(objects, transforms, viewProjection, 0, objectCount);
+
+            samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        double medianMs = Median(samples);
+        if (cores == 1)
+            serialMs = medianMs;
+
+        double speedup = serialMs / medianMs;
+        std::cout << std::setw(6) << cores
+                  << std::setw(14) << std::fixed << std::setprecision(3) << medianMs
+                  << std::setw(10) << std::setprecision(2) << speedup
+                  << std::setw(12) << std::setprecision(2) << speedup / cores << std::endl;
+    }
+
+    return 0;
+}
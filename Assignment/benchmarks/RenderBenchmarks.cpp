@@ -0,0 +1,135 @@
+#include "Benchmark.hpp"
+#include "BenchmarkScene.hpp"
+#include "SceneRenderer.hpp"
+#include "TextureManager.hpp"
+
+#include <glad/glad.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+/**
+ * @file RenderBenchmarks.cpp
+ * @brief Microbenchmarks of the GL side of a frame: uniforms, frame packets and scene submission.
+ *
+ * All cases need the headless context the harness creates.
+ */
+
+namespace
+{
+    using namespace graf;
+    using namespace graf::bench;
+
+    /**
+     * @brief Builds the program used by the interactive view.
+     * @param program The program to build.
+     */
+    void BuildSceneProgram(ShaderProgram& program)
+    {
+        program.Create();
+        program.AttachShader("../shaders/vertex.glsl", GL_VERTEX_SHADER);
+        program.AttachShader("../shaders/fragment.glsl", GL_FRAGMENT_SHADER);
+        program.Link();
+        program.AddUniform("uWorldTransform");
+    }
+
+    /**
+     * @brief Gets the projection and view used by the render cases.
+     * @return The combined matrix.
+     */
+    glm::mat4 RenderViewProjection()
+    {
+        glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 100.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        return projection * view;
+    }
+
+    /**
+     * @brief Setting the transform through ShaderProgram::SetMat4, which looks the name up.
+     */
+    void BM_SetUniformByName(State& state)
+    {
+        ShaderProgram program;
+        BuildSceneProgram(program);
+        program.Use();
+
+        glm::mat4 transform(1.0f);
+        for (auto _ : state)
+        {
+            transform[3][0] += 1e-6f;
+            program.SetMat4("uWorldTransform", transform);
+        }
+        glFinish();
+    }
+    GRAF_BENCHMARK(BM_SetUniformByName)->RequiresGL();
+
+    /**
+     * @brief Setting the transform through a location resolved once, as SceneRenderer does.
+     */
+    void BM_SetUniformByLocation(State& state)
+    {
+        ShaderProgram program;
+        BuildSceneProgram(program);
+        program.Use();
+        int location = program.GetUniformLocation("uWorldTransform");
+
+        glm::mat4 transform(1.0f);
+        for (auto _ : state)
+        {
+            transform[3][0] += 1e-6f;
+            glUniformMatrix4fv(location, 1, GL_FALSE, &transform[0][0]);
+        }
+        glFinish();
+    }
+    GRAF_BENCHMARK(BM_SetUniformByLocation)->RequiresGL();
+
+    /**
+     * @brief Culling and transforming a scene into a frame packet, with texture handle lookups.
+     */
+    void BM_BuildFramePacket(State& state)
+    {
+        JobSystem jobs;
+        TextureManager::sAddTexturesFromFiles(BenchmarkTextures(), jobs);
+        std::vector<ObjectData> objects = MakeBenchmarkObjects(static_cast<size_t>(state.getRange(0)));
+        glm::mat4 viewProjection = RenderViewProjection();
+
+        FramePacket packet;
+        for (auto _ : state)
+        {
+            BuildFramePacket(objects, viewProjection, 1.0f, packet, jobs);
+            DoNotOptimize(packet.items.data());
+        }
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.getIterations() * objects.size()));
+        state.SetLabel("visible=" + std::to_string(packet.items.size()));
+    }
+    GRAF_BENCHMARK(BM_BuildFramePacket)->RequiresGL()->Arg(1000)->Arg(10000)->Unit(TimeUnit::Microsecond);
+
+    /**
+     * @brief Sorting, recording and replaying a frame packet, waiting for the GPU to finish.
+     */
+    void BM_RenderScene(State& state)
+    {
+        JobSystem jobs;
+        ShapeFactoryManager shapes;
+        shapes.Preload(jobs);
+        ShaderProgram program;
+        BuildSceneProgram(program);
+        TextureManager::sAddTexturesFromFiles(BenchmarkTextures(), jobs);
+
+        std::vector<ObjectData> objects = MakeBenchmarkObjects(static_cast<size_t>(state.getRange(0)));
+        FramePacket packet;
+        BuildFramePacket(objects, RenderViewProjection(), 1.0f, packet, jobs);
+
+        SceneRenderer renderer(program, shapes, jobs);
+        for (auto _ : state)
+        {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            renderer.Render(packet);
+            glFinish(); ///< Include the GPU work, so software and hardware drivers compare
+        }
+
+        const SceneStats& stats = renderer.getLastFrameStats();
+        state.SetItemsProcessed(static_cast<int64_t>(state.getIterations() * stats.drawCalls));
+        state.SetLabel("draws=" + std::to_string(stats.drawCalls) + " triangles=" + std::to_string(stats.triangles));
+    }
+    GRAF_BENCHMARK(BM_RenderScene)->RequiresGL()->Arg(100)->Arg(1000)->Arg(10000)->Unit(TimeUnit::Millisecond);
+}
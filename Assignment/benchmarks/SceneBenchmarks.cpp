@@ -0,0 +1,198 @@
+#include "Benchmark.hpp"
+#include "BenchmarkScene.hpp"
+#include "Frustum.hpp"
+#include "SceneRenderer.hpp"
+#include "SlotMap.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <glm/gtc/matrix_transform.hpp>
+
+/**
+ * @file SceneBenchmarks.cpp
+ * @brief Microbenchmarks of the CPU side of the scene: matrices, culling, queue sorting, the object slot map and JSON.
+ */
+
+namespace
+{
+    using namespace graf;
+    using namespace graf::bench;
+
+    /**
+     * @brief Gets the projection and view used by the scene cases.
+     * @return The combined matrix.
+     */
+    glm::mat4 BenchmarkViewProjection()
+    {
+        glm::mat4 projection = glm::perspective(glm::radians(90.0f), 4.0f / 3.0f, 1.0f, 100.0f);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 3.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        return projection * view;
+    }
+
+    /**
+     * @brief Gets a scratch file for the JSON cases.
+     * @return The path in the temporary directory.
+     */
+    std::string ScratchScenePath()
+    {
+        return (std::filesystem::temp_directory_path() / "graf_benchmark_scene.json").string();
+    }
+
+    /**
+     * @brief World and clip transforms of every object, as BuildFramePacket composes them.
+     */
+    void BM_ComposeTransforms(State& state)
+    {
+        std::vector<ObjectData> objects = MakeBenchmarkObjects(static_cast<size_t>(state.getRange(0)));
+        std::vector<glm::mat4> transforms(objects.size());
+        glm::mat4 viewProjection = BenchmarkViewProjection();
+
+        for (auto _ : state)
+        {
+            for (size_t i = 0; i < objects.size(); ++i)
+                transforms[i] = viewProjection * BuildWorldMatrix(objects[i].position, objects[i].angle, 1.0f);
+            DoNotOptimize(transforms.data());
+            ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.getIterations() * objects.size()));
+    }
+    GRAF_BENCHMARK(BM_ComposeTransforms)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(TimeUnit::Microsecond);
+
+    /**
+     * @brief Bounding sphere tests against the view frustum, including extracting its planes.
+     */
+    void BM_FrustumCull(State& state)
+    {
+        std::vector<ObjectData> objects = MakeBenchmarkObjects(static_cast<size_t>(state.getRange(0)));
+        glm::mat4 viewProjection = BenchmarkViewProjection();
+
+        size_t visible = 0;
+        for (auto _ : state)
+        {
+            Frustum frustum(viewProjection);
+            visible = 0;
+            for (const auto& obj : objects)
+                visible += frustum.IntersectsSphere(obj.position, 1.0f);
+            DoNotOptimize(visible);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.getIterations() * objects.size()));
+        state.SetLabel("visible=" + std::to_string(visible));
+    }
+    GRAF_BENCHMARK(BM_FrustumCull)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(TimeUnit::Microsecond);
+
+    /**
+     * @brief Building and sorting the render queue by shape and texture.
+     */
+    void BM_SortRenderQueue(State& state)
+    {
+        std::vector<ObjectData> objects = MakeBenchmarkObjects(static_cast<size_t>(state.getRange(0)));
+        FramePacket packet;
+        packet.items.resize(objects.size());
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            packet.items[i].shape = objects[i].shape;
+            packet.items[i].texture = static_cast<unsigned int>(1 + i % 4); ///< Stand-ins for texture handles
+        }
+
+        std::vector<SceneRenderer::QueueEntry> queue(packet.items.size());
+        for (auto _ : state)
+        {
+            SceneRenderer::BuildQueue(packet, queue.data());
+            DoNotOptimize(queue.data());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.getIterations() * objects.size()));
+    }
+    GRAF_BENCHMARK(BM_SortRenderQueue)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(TimeUnit::Microsecond);
+
+    /**
+     * @brief Erasing a tenth of the scene objects by handle and inserting as many new ones.
+     */
+    void BM_SlotMapChurn(State& state)
+    {
+        std::vector<ObjectData> objects = MakeBenchmarkObjects(static_cast<size_t>(state.getRange(0)));
+        SlotMap<ObjectData> map;
+        std::vector<SlotHandle> handles;
+        map.Insert(objects.begin(), objects.end(), &handles);
+
+        size_t churn = std::max<size_t>(objects.size() / 10, 1);
+        size_t cursor = 0;
+        for (auto _ : state)
+        {
+            for (size_t i = 0; i < churn; ++i)
+            {
+                size_t victim = (cursor + i * 7919) % handles.size(); ///< Scattered over the scene
+                map.Erase(handles[victim]);
+                handles[victim] = map.Insert(objects[victim]);
+            }
+            cursor = (cursor + 1) % handles.size();
+            DoNotOptimize(map.GetValues().data());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.getIterations() * churn));
+    }
+    GRAF_BENCHMARK(BM_SlotMapChurn)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(TimeUnit::Microsecond);
+
+    /**
+     * @brief Resolving handles to scene objects in random order.
+     */
+    void BM_SlotMapLookup(State& state)
+    {
+        std::vector<ObjectData> objects = MakeBenchmarkObjects(static_cast<size_t>(state.getRange(0)));
+        SlotMap<ObjectData> map;
+        std::vector<SlotHandle> handles;
+        map.Insert(objects.begin(), objects.end(), &handles);
+        std::shuffle(handles.begin(), handles.end(), std::mt19937(7));
+
+        float sum = 0.0f;
+        for (auto _ : state)
+        {
+            for (const SlotHandle& handle : handles)
+                sum += map.Get(handle)->angle;
+            DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.getIterations() * handles.size()));
+    }
+    GRAF_BENCHMARK(BM_SlotMapLookup)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(TimeUnit::Microsecond);
+
+    /**
+     * @brief Writing the object list to JSON.
+     */
+    void BM_SaveSceneJson(State& state)
+    {
+        std::vector<ObjectData> objects = MakeBenchmarkObjects(static_cast<size_t>(state.getRange(0)));
+        std::string path = ScratchScenePath();
+
+        for (auto _ : state)
+            saveObjectsToJson(objects, path);
+
+        state.SetItemsProcessed(static_cast<int64_t>(state.getIterations() * objects.size()));
+        state.SetBytesProcessed(static_cast<int64_t>(state.getIterations() * std::filesystem::file_size(path)));
+        std::remove(path.c_str());
+    }
+    GRAF_BENCHMARK(BM_SaveSceneJson)->Arg(100)->Arg(1000)->Arg(10000)->Unit(TimeUnit::Microsecond);
+
+    /**
+     * @brief Reading the object list from JSON, converted on the job system.
+     */
+    void BM_LoadSceneJson(State& state)
+    {
+        std::vector<ObjectData> objects = MakeBenchmarkObjects(static_cast<size_t>(state.getRange(0)));
+        std::string path = ScratchScenePath();
+        saveObjectsToJson(objects, path);
+        JobSystem jobs;
+
+        size_t loaded = 0;
+        for (auto _ : state)
+        {
+            loaded = loadObjectsFromJson(path, jobs).size();
+            DoNotOptimize(loaded);
+        }
+
+        if (loaded != objects.size())
+            state.SetLabel("loaded " + std::to_string(loaded) + " of " + std::to_string(objects.size()));
+        state.SetItemsProcessed(static_cast<int64_t>(state.getIterations() * objects.size()));
+        state.SetBytesProcessed(static_cast<int64_t>(state.getIterations() * std::filesystem::file_size(path)));
+        std::remove(path.c_str());
+    }
+    GRAF_BENCHMARK(BM_LoadSceneJson)->Arg(100)->Arg(1000)->Arg(10000)->Unit(TimeUnit::Microsecond);
+}
@@ -0,0 +1,567 @@
+#define GLFW_INCLUDE_NONE
+
+#include "GLWindow.hpp"
+#include "GpuResourceTracker.hpp"
+#include "RollingStats.hpp"
+#include "SceneGenerator.hpp"
+#include "SceneRenderer.hpp"
+#include "TextureManager.hpp"
+#include "Exceptions.hpp"
+#include "ErrorCheck.hpp"
+
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <glm/gtc/matrix_transform.hpp>
+#include <nlohmann/json.hpp>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+/**
+ * @file SceneMacrobenchmark.cpp
+ * @brief End-to-end frame benchmark of a generated scene along a fixed camera path.
+ *
+ * Generates a scene, then for every render mode renders the same headless frames:
+ * animating the moving objects, building the frame packet, submitting it and waiting
+ * for the GPU. The workload depends only on the options, so runs of two commits
+ * with the same options are directly comparable.
+ *
+ * Usage:
+ *   SceneMacrobenchmark [--objects N] [--shapes cube=1,pyramid=1,...] [--textures N]
+ *                       [--distribution uniform|clustered|grid] [--extent F] [--motion F]
+ *                       [--seed N] [--frames N] [--warmup N] [--size WxH]
+ *                       [--modes immediate,serial,parallel] [--out results.json]
+ *
+ * Modes: "immediate" draws the packet in scene order with every bind issued;
+ * "serial" sorts it and records one command buffer; "parallel" is the
+ * SceneRenderer default of command buffers recorded on the job system.
+ * The JSON output uses the schema of the Benchmarks executable, one entry per mode.
+ */
+
+namespace
+{
+    using namespace graf;
+
+    const double ANIMATION_RATE = 60.0; ///< Animation frames per second of scene time, independent of the frame rate.
+
+    /**
+     * @enum RenderMode
+     * @brief Ways of drawing a frame packet compared by the benchmark.
+     */
+    enum class RenderMode
+    {
+        Immediate,  ///< Unsorted, every bind issued, straight on the GL thread.
+        Serial,     ///< Sorted and recorded into a single command buffer.
+        Parallel    ///< Sorted and recorded in chunks on the job system.
+    };
+
+    /**
+     * @brief Gets the command-line name of a render mode.
+     * @param mode The mode.
+     * @return The name.
+     */
+    const char* RenderModeName(RenderMode mode)
+    {
+        switch (mode)
+        {
+        case RenderMode::Immediate: return "immediate";
+        case RenderMode::Serial:    return "serial";
+        case RenderMode::Parallel:  return "parallel";
+        }
+        return "";
+    }
+
+    /**
+     * @brief Parses a comma-separated list of render modes.
+     * @param list The list, e.g. "serial,parallel".
+     * @return The modes in the given order.
+     * @exception std::invalid_argument Thrown for an unknown mode.
+     */
+    std::vector<RenderMode> ParseRenderModes(const std::string& list)
+    {
+        std::vector<RenderMode> modes;
+        std::stringstream stream(list);
+        std::string name;
+        while (std::getline(stream, name, ','))
+        {
+            if (name == "immediate")     modes.push_back(RenderMode::Immediate);
+            else if (name == "serial")   modes.push_back(RenderMode::Serial);
+            else if (name == "parallel") modes.push_back(RenderMode::Parallel);
+            else throw std::invalid_argument("Unknown render mode: " + name);
+        }
+        return modes;
+    }
+
+    /**
+     * @struct Options
+     * @brief Command-line options of the benchmark.
+     */
+    struct Options
+    {
+        SceneGeneratorSettings  scene;                  ///< Generated scene.
+        size_t                  frames = 600;           ///< Measured frames per mode.
+        size_t                  warmup = 60;            ///< Unmeasured frames before them.
+        unsigned int            width = 800;            ///< Render target width.
+        unsigned int            height = 800;           ///< Render target height.
+        std::vector<RenderMode> modes = {RenderMode::Immediate, RenderMode::Serial, RenderMode::Parallel}; ///< Modes to run.
+        std::string             outFile;                ///< JSON results file, empty for none.
+    };
+
+    /**
+     * @struct ModeResult
+     * @brief Measurements of one render mode.
+     */
+    struct ModeResult
+    {
+        RenderMode   mode = RenderMode::Parallel;   ///< The mode.
+        RollingStats frameTimes;                    ///< Whole frame in milliseconds, GPU included.
+        double       cpuMs = 0.0;                   ///< Mean of animation, packet building and submission in milliseconds.
+        double       visible = 0.0;                 ///< Mean items drawn per frame.
+        double       drawCalls = 0.0;               ///< Mean draw calls per frame.
+        double       triangles = 0.0;               ///< Mean triangles per frame.
+        double       stateChanges = 0.0;            ///< Mean VAO and texture binds per frame.
+        int64_t      gpuBytes = 0;                  ///< Live tracked GPU memory after the run.
+        int64_t      processBytes = 0;              ///< Resident process memory after the run.
+    };
+
+    /**
+     * @brief Gets the resident memory of the process.
+     *
+     * Where the current value is not available, the peak is returned instead.
+     *
+     * @return The size in bytes, 0 if unknown.
+     */
+    int64_t ProcessMemoryBytes()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return static_cast<int64_t>(counters.WorkingSetSize);
+        return 0;
+#else
+        std::ifstream statm("/proc/self/statm");
+        int64_t totalPages = 0, residentPages = 0;
+        if (statm >> totalPages >> residentPages)
+            return residentPages * static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<int64_t>(usage.ru_maxrss);           ///< Bytes on macOS
+#else
+        return static_cast<int64_t>(usage.ru_maxrss) * 1024;    ///< Kilobytes elsewhere
+#endif
+#endif
+    }
+
+    /**
+     * @brief Gets the live GPU memory of all tracked objects.
+     * @return The size in bytes.
+     */
+    int64_t GpuMemoryBytes()
+    {
+        int64_t bytes = 0;
+        for (size_t type = 0; type < static_cast<size_t>(GpuResourceType::Count); ++type)
+            bytes += GpuResourceTracker::sGetLiveBytes(static_cast<GpuResourceType>(type));
+        return bytes;
+    }
+
+    /**
+     * @brief Gets the camera of a frame of the fixed path.
+     *
+     * The camera circles the scene centre once over the measured frames at 60% of
+     * the extent, looking along the path, so the visible set changes every frame.
+     *
+     * @param frame Frame index on the path.
+     * @param frameCount Frames of one full circle.
+     * @param extent Half width of the scene.
+     * @param aspect Width over height of the render target.
+     * @return The combined projection and view matrix.
+     */
+    glm::mat4 CameraPath(size_t frame, size_t frameCount, float extent, float aspect)
+    {
+        float angle = 6.2831853f * static_cast<float>(frame) / static_cast<float>(std::max<size_t>(frameCount, 1));
+        glm::vec3 eye = glm::vec3(std::cos(angle), 0.0f, std::sin(angle)) * (0.6f * extent) + glm::vec3(0.0f, 0.1f * extent, 0.0f);
+        glm::vec3 forward(-std::sin(angle), -0.1f, std::cos(angle));
+
+        glm::mat4 projection = glm::perspective(glm::radians(90.0f), aspect, 0.5f, 2.5f * extent);
+        glm::mat4 view = glm::lookAt(eye, eye + forward, glm::vec3(0.0f, 1.0f, 0.0f));
+        return projection * view;
+    }
+
+    /**
+     * @brief Draws a packet in item order, binding the VAO and texture of every item.
+     * @param packet The packet to draw.
+     * @param program The scene program.
+     * @param transformLocation Location of its transform uniform.
+     * @param shapes The cached shapes.
+     * @param stats Receives the submitted work.
+     */
+    void DrawImmediate(const FramePacket& packet, ShaderProgram& program, int transformLocation,
+                       const ShapeFactoryManager& shapes, SceneStats& stats)
+    {
+        stats = SceneStats();
+        stats.items = packet.items.size();
+        program.Use();
+        for (const DrawItem& item : packet.items)
+        {
+            const VertexArrayObject* vao = shapes.getCachedShape(item.shape);
+            if (!vao)
+                continue;
+
+            glBindVertexArray(vao->getId());
+            glBindTexture(GL_TEXTURE_2D, item.texture);
+            glUniformMatrix4fv(transformLocation, 1, GL_FALSE, &item.transform[0][0]);
+            glDrawElements(GL_TRIANGLES, vao->getIndexCount(), GL_UNSIGNED_INT, 0);
+
+            stats.drawCalls++;
+            stats.triangles += static_cast<size_t>(vao->getIndexCount()) / 3;
+            stats.stateChanges += 2;
+        }
+        glBindVertexArray(0);
+        CheckGLError("Immediate draw");
+    }
+
+    /**
+     * @brief Renders the camera path in one mode.
+     * @param mode The render mode.
+     * @param options The benchmark options.
+     * @param scene The scene, animated in place.
+     * @param program The scene program.
+     * @param shapes The cached shapes.
+     * @param jobs The job system.
+     * @return The measurements.
+     */
+    ModeResult RunMode(RenderMode mode, const Options& options, GeneratedScene& scene, ShaderProgram& program,
+                       ShapeFactoryManager& shapes, JobSystem& jobs)
+    {
+        SceneRenderer renderer(program, shapes, jobs);
+        if (mode == RenderMode::Serial)
+            renderer.SetItemsPerCommandBuffer(scene.objects.size()); ///< Everything in one buffer
+        int transformLocation = program.GetUniformLocation("uWorldTransform");
+        float aspect = static_cast<float>(options.width) / static_cast<float>(options.height);
+
+        ModeResult result;
+        result.mode = mode;
+        result.frameTimes = RollingStats(std::max<size_t>(options.frames, 1));
+
+        FramePacket packet;
+        SceneStats stats;
+        double cpuMs = 0.0;
+        for (size_t frame = 0; frame < options.warmup + options.frames; ++frame)
+        {
+            size_t pathFrame = frame < options.warmup ? frame : frame - options.warmup; ///< Warm up on the start of the path
+            auto start = std::chrono::steady_clock::now();
+
+            AnimateScene(scene, static_cast<double>(pathFrame) / ANIMATION_RATE);
+            BuildFramePacket(scene.objects, CameraPath(pathFrame, options.frames, options.scene.extent, aspect),
+                             1.0f, packet, jobs);
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            if (mode == RenderMode::Immediate)
+            {
+                DrawImmediate(packet, program, transformLocation, shapes, stats);
+            }
+            else
+            {
+                renderer.Render(packet);
+                stats = renderer.getLastFrameStats();
+            }
+            auto submitted = std::chrono::steady_clock::now();
+            glFinish(); ///< Count the GPU work, so the frame time does not depend on driver queueing
+            auto end = std::chrono::steady_clock::now();
+
+            if (frame < options.warmup)
+                continue;
+            result.frameTimes.AddSample(std::chrono::duration<double, std::milli>(end - start).count());
+            cpuMs += std::chrono::duration<double, std::milli>(submitted - start).count();
+            result.visible += static_cast<double>(stats.items);
+            result.drawCalls += static_cast<double>(stats.drawCalls);
+            result.triangles += static_cast<double>(stats.triangles);
+            result.stateChanges += static_cast<double>(stats.stateChanges);
+        }
+
+        double frames = static_cast<double>(std::max<size_t>(options.frames, 1));
+        result.cpuMs = cpuMs / frames;
+        result.visible /= frames;
+        result.drawCalls /= frames;
+        result.triangles /= frames;
+        result.stateChanges /= frames;
+        result.gpuBytes = GpuMemoryBytes();
+        result.processBytes = ProcessMemoryBytes();
+        return result;
+    }
+
+    /**
+     * @brief Builds the results in the schema written by the Benchmarks executable.
+     *
+     * real_time is the mean frame time and cpu_time the mean CPU part of a frame;
+     * the percentiles and per-frame work are extra counters. The scene settings are
+     * in the context so a comparison can check that both runs used the same workload.
+     *
+     * @param options The benchmark options.
+     * @param results One result per mode.
+     * @param glRenderer The GL_RENDERER string.
+     * @param executable Path of the executable.
+     * @return The report.
+     */
+    json BuildJsonReport(const Options& options, const std::vector<ModeResult>& results,
+                         const std::string& glRenderer, const std::string& executable)
+    {
+        static const char* SHAPE_NAMES[SHAPE_TYPE_COUNT] = {"circle", "square", "cube", "pyramid", "frustum"};
+        static const char* DISTRIBUTION_NAMES[] = {"uniform", "clustered", "grid"};
+
+        json shapes;
+        for (size_t s = 0; s < SHAPE_TYPE_COUNT; ++s)
+            shapes[SHAPE_NAMES[s]] = options.scene.shapeWeights[s];
+
+        json context;
+        std::time_t now = std::time(nullptr);
+        char date[32];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+        context["date"] = date;
+        char host[256] = "";
+#ifndef _WIN32
+        gethostname(host, sizeof(host) - 1);
+#endif
+        context["host_name"] = host;
+        context["executable"] = executable;
+        context["num_cpus"] = std::thread::hardware_concurrency();
+#ifdef NDEBUG
+        context["library_build_type"] = "release";
+#else
+        context["library_build_type"] = "debug";
+#endif
+        context["gl_renderer"] = glRenderer;
+        context["json_schema_version"] = 1;
+        context["scene"] = {
+            {"objects", options.scene.objectCount},
+            {"shapes", shapes},
+            {"textures", options.scene.textureCount},
+            {"distribution", DISTRIBUTION_NAMES[static_cast<int>(options.scene.distribution)]},
+            {"extent", options.scene.extent},
+            {"motion", options.scene.motionFraction},
+            {"seed", options.scene.seed},
+            {"frames", options.frames},
+            {"warmup", options.warmup},
+            {"width", options.width},
+            {"height", options.height}
+        };
+
+        json benchmarks = json::array();
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const ModeResult& result = results[i];
+            std::string name = std::string("BM_Scene/") + RenderModeName(result.mode);
+            benchmarks.push_back({
+                {"name", name},
+                {"family_index", i},
+                {"per_family_instance_index", 0},
+                {"run_name", name},
+                {"run_type", "iteration"},
+                {"repetitions", 1},
+                {"repetition_index", 0},
+                {"threads", 1},
+                {"iterations", result.frameTimes.getTotalCount()},
+                {"real_time", result.frameTimes.getMean()},
+                {"cpu_time", result.cpuMs},
+                {"time_unit", "ms"},
+                {"p50_ms", result.frameTimes.getPercentile(50.0)},
+                {"p95_ms", result.frameTimes.getPercentile(95.0)},
+                {"p99_ms", result.frameTimes.getPercentile(99.0)},
+                {"max_ms", result.frameTimes.getMax()},
+                {"visible", result.visible},
+                {"draw_calls", result.drawCalls},
+                {"triangles", result.triangles},
+                {"state_changes", result.stateChanges},
+                {"gpu_bytes", result.gpuBytes},
+                {"process_bytes", result.processBytes}
+            });
+        }
+        return json{{"context", context}, {"benchmarks", benchmarks}};
+    }
+
+    /**
+     * @brief Parses the command line.
+     * @param argc Number of arguments.
+     * @param argv The arguments.
+     * @return The options.
+     * @exception std::invalid_argument Thrown for an unknown option or a malformed value.
+     */
+    Options ParseOptions(int argc, char** argv)
+    {
+        Options options;
+        options.scene.objectCount = 10000;
+        for (int i = 1; i < argc; i += 2)
+        {
+            std::string option = argv[i];
+            if (i + 1 >= argc)
+                throw std::invalid_argument("Missing value for " + option);
+            std::string value = argv[i + 1];
+
+            if (option == "--objects")
+                options.scene.objectCount = std::stoul(value);
+            else if (option == "--shapes")
+                options.scene.shapeWeights = ParseShapeMix(value);
+            else if (option == "--textures")
+                options.scene.textureCount = std::stoul(value);
+            else if (option == "--distribution")
+                options.scene.distribution = ParseSpatialDistribution(value);
+            else if (option == "--extent")
+                options.scene.extent = std::stof(value);
+            else if (option == "--motion")
+                options.scene.motionFraction = std::stof(value);
+            else if (option == "--seed")
+                options.scene.seed = std::stoull(value);
+            else if (option == "--frames")
+                options.frames = std::stoul(value);
+            else if (option == "--warmup")
+                options.warmup = std::stoul(value);
+            else if (option == "--modes")
+                options.modes = ParseRenderModes(value);
+            else if (option == "--out")
+                options.outFile = value;
+            else if (option == "--size")
+            {
+                if (std::sscanf(value.c_str(), "%ux%u", &options.width, &options.height) != 2 ||
+                    options.width == 0 || options.height == 0)
+                    throw std::invalid_argument("Expected --size <width>x<height>");
+            }
+            else
+                throw std::invalid_argument("Unknown option: " + option);
+        }
+        if (options.frames == 0)
+            throw std::invalid_argument("--frames must be positive");
+        return options;
+    }
+}
+
+/**
+ * @brief Scene macrobenchmark entry point.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return 0 on success, -1 on bad options or if the scene cannot be rendered.
+ */
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        options = ParseOptions(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [--objects N] [--shapes cube=1,pyramid=1,...] [--textures N]"
+                  << " [--distribution uniform|clustered|grid] [--extent F] [--motion F] [--seed N]"
+                  << " [--frames N] [--warmup N] [--size WxH] [--modes immediate,serial,parallel] [--out file.json]"
+                  << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        GLWindow window;
+        window.createHeadless(options.width, options.height);
+        const GLubyte* rendererName = glGetString(GL_RENDERER);
+        std::string glRenderer = rendererName ? reinterpret_cast<const char*>(rendererName) : "";
+
+        JobSystem jobs;
+        ShapeFactoryManager shapes;
+        shapes.Preload(jobs);
+
+        ShaderProgram program;
+        program.Create();
+        program.AttachShader("../shaders/vertex.glsl", GL_VERTEX_SHADER);
+        program.AttachShader("../shaders/fragment.glsl", GL_FRAGMENT_SHADER);
+        program.Link();
+        program.AddUniform("uWorldTransform");
+
+        std::vector<std::string> textures = {
+            "../images/container.jpg",
+            "../images/container2.jpg",
+            "../images/container3.jpg",
+            "../images/container4.jpg"
+        };
+        if (options.scene.textureCount > textures.size())
+        {
+            std::cerr << "Only " << textures.size() << " textures are available; using all of them" << std::endl;
+            options.scene.textureCount = textures.size();
+        }
+        options.scene.textureCount = std::max<size_t>(options.scene.textureCount, 1);
+        textures.resize(options.scene.textureCount);
+        TextureManager::sAddTexturesFromFiles(textures, jobs);
+
+        GeneratedScene scene = GenerateScene(options.scene, textures);
+        glClearColor(0.0f, 0.4f, 0.7f, 1.0f);
+
+        std::cout << "scene: " << scene.objects.size() << " objects (" << scene.moving.size() << " moving), "
+                  << options.frames << " frames at " << options.width << "x" << options.height << " on " << glRenderer
+                  << std::endl;
+        std::cout << std::left << std::setw(10) << "mode" << std::right
+                  << std::setw(10) << "mean_ms" << std::setw(10) << "p50_ms" << std::setw(10) << "p95_ms"
+                  << std::setw(10) << "p99_ms" << std::setw(10) << "cpu_ms" << std::setw(10) << "draws"
+                  << std::setw(10) << "binds" << std::setw(12) << "gpu_MiB" << std::setw(12) << "rss_MiB" << std::endl;
+
+        std::vector<ModeResult> results;
+        for (RenderMode mode : options.modes)
+        {
+            results.push_back(RunMode(mode, options, scene, program, shapes, jobs));
+            const ModeResult& result = results.back();
+            std::cout << std::left << std::setw(10) << RenderModeName(mode) << std::right << std::fixed
+                      << std::setprecision(3)
+                      << std::setw(10) << result.frameTimes.getMean()
+                      << std::setw(10) << result.frameTimes.getPercentile(50.0)
+                      << std::setw(10) << result.frameTimes.getPercentile(95.0)
+                      << std::setw(10) << result.frameTimes.getPercentile(99.0)
+                      << std::setw(10) << result.cpuMs
+                      << std::setprecision(0)
+                      << std::setw(10) << result.drawCalls
+                      << std::setw(10) << result.stateChanges
+                      << std::setprecision(1)
+                      << std::setw(12) << static_cast<double>(result.gpuBytes) / (1024.0 * 1024.0)
+                      << std::setw(12) << static_cast<double>(result.processBytes) / (1024.0 * 1024.0) << std::endl;
+        }
+
+        shapes.Release(); ///< Delete every GL object while the context is alive
+        program.Release();
+        TextureManager::sRelease();
+        window.GetFrameBuffer().Release();
+        size_t leaks = GpuResourceTracker::sReportLeaks(std::cerr);
+        if (leaks > 0)
+            std::cerr << leaks << " OpenGL objects were not released" << std::endl;
+
+        if (!options.outFile.empty())
+        {
+            std::ofstream file(options.outFile);
+            file << BuildJsonReport(options, results, glRenderer, argv[0]).dump(2) << std::endl;
+            if (!file)
+            {
+                std::cerr << "Failed to write benchmark results: " << options.outFile << std::endl;
+                return -1;
+            }
+        }
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Scene benchmark failed: " << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,112 @@
+#define STB_IMAGE_RESIZE_IMPLEMENTATION
+
+#include "Benchmark.hpp"
+#include "BenchmarkScene.hpp"
+#include "TextureManager.hpp"
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <stb/stb_image.h>
+#include <stb/stb_image_resize2.h>
+
+/**
+ * @file TextureBenchmarks.cpp
+ * @brief Microbenchmarks of texture decoding, resizing and upload.
+ */
+
+namespace
+{
+    using namespace graf;
+    using namespace graf::bench;
+
+    /**
+     * @brief Reads a file into memory.
+     * @param fileName The file.
+     * @return The bytes, empty if the file cannot be read.
+     */
+    std::vector<unsigned char> ReadFile(const std::string& fileName)
+    {
+        std::ifstream file(fileName, std::ios::binary);
+        return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * @brief JPEG decoding from memory, as TextureManager does for each file; the argument selects the image.
+     */
+    void BM_DecodeTexture(State& state)
+    {
+        const std::string& fileName = BenchmarkTextures()[static_cast<size_t>(state.getRange(0))];
+        std::vector<unsigned char> encoded = ReadFile(fileName);
+        if (encoded.empty())
+        {
+            state.SkipWithError("cannot read " + fileName);
+            return;
+        }
+
+        stbi_set_flip_vertically_on_load_thread(true); ///< Same flags as TextureManager
+        int width = 0, height = 0, channels = 0;
+        for (auto _ : state)
+        {
+            unsigned char* pixels = stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()),
+                                                          &width, &height, &channels, 0);
+            DoNotOptimize(pixels);
+            stbi_image_free(pixels);
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.getIterations() * encoded.size()));
+        state.SetLabel(std::to_string(width) + "x" + std::to_string(height));
+    }
+    GRAF_BENCHMARK(BM_DecodeTexture)->Arg(0)->Arg(1)->Unit(TimeUnit::Microsecond);
+
+    /**
+     * @brief Linear downscaling of a decoded texture; the argument is the output width.
+     *
+     * glGenerateMipmap does this on the GPU; the case is the CPU reference for
+     * preparing smaller textures offline or on a worker.
+     */
+    void BM_ResizeTexture(State& state)
+    {
+        int width = 0, height = 0, channels = 0;
+        unsigned char* pixels = stbi_load(BenchmarkTextures()[0].c_str(), &width, &height, &channels, 0);
+        if (!pixels)
+        {
+            state.SkipWithError("cannot decode " + BenchmarkTextures()[0]);
+            return;
+        }
+
+        int outWidth = static_cast<int>(state.getRange(0));
+        int outHeight = std::max(1, static_cast<int>(static_cast<int64_t>(height) * outWidth / width));
+        std::vector<unsigned char> output(static_cast<size_t>(outWidth) * outHeight * channels);
+
+        for (auto _ : state)
+        {
+            stbir_resize_uint8_linear(pixels, width, height, 0, output.data(), outWidth, outHeight, 0,
+                                      static_cast<stbir_pixel_layout>(channels));
+            DoNotOptimize(output.data());
+        }
+
+        state.SetBytesProcessed(static_cast<int64_t>(state.getIterations()) * width * height * channels);
+        stbi_image_free(pixels);
+    }
+    GRAF_BENCHMARK(BM_ResizeTexture)->Arg(256)->Arg(64)->Unit(TimeUnit::Microsecond);
+
+    /**
+     * @brief Loading a texture from disk: decoding, upload and mipmap generation.
+     */
+    void BM_UploadTexture(State& state)
+    {
+        const std::string& fileName = BenchmarkTextures()[0];
+        for (auto _ : state)
+        {
+            TextureManager::sAddTextureFromFile(fileName);
+            glFinish(); ///< Include the GPU work
+
+            state.PauseTiming();
+            TextureManager::sRelease(); ///< Loaded textures are skipped, so start empty
+            state.ResumeTiming();
+        }
+    }
+    GRAF_BENCHMARK(BM_UploadTexture)->RequiresGL()->Unit(TimeUnit::Millisecond);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "RenderTask.hpp"
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * @file RenderCoordinator.hpp
+ * @brief Defines the RenderCoordinator class that distributes frames across worker processes.
+ */
+
+namespace graf
+{
+    /**
+     * @struct BatchResult
+     * @brief Summary of a batch run.
+     */
+    struct BatchResult
+    {
+        size_t rendered = 0;    ///< Frames written successfully.
+        size_t failed = 0;      ///< Frames a worker reported as failed.
+        double seconds = 0.0;   ///< Wall-clock duration of the run.
+    };
+
+    /**
+     * @class RenderCoordinator
+     * @brief Hands out render tasks dynamically to a pool of worker processes.
+     *
+     * Each worker is started with the given command and speaks a line protocol on
+     * its standard streams: one serialized RenderTask per line in, one JSON result
+     * per line out, in order. Every worker holds a small number of tasks so it never
+     * waits for the next one, and fast workers simply receive more tasks. Tasks of a
+     * worker that exits are given to the others. Since the protocol only needs a
+     * byte stream, remote machines can join by wrapping the command (e.g., with ssh)
+     * as long as they see the same scene and output paths.
+     */
+    class RenderCoordinator
+    {
+    public:
+        /**
+         * @brief Configures the coordinator.
+         * @param workerCommand Program and arguments that start one worker.
+         * @param workerCount Number of worker processes (at least 1).
+         * @param tasksPerWorker Tasks queued at each worker at a time (at least 1).
+         */
+        RenderCoordinator(std::vector<std::string> workerCommand, unsigned int workerCount, size_t tasksPerWorker = 2);
+
+        /**
+         * @brief Renders all tasks and waits for the workers to exit.
+         * @param tasks The frames to render.
+         * @return The summary of the run.
+         * @exception GrafException Thrown if workers cannot be started or all of them exit early.
+         */
+        BatchResult Run(const std::vector<RenderTask>& tasks);
+
+    private:
+        /**
+         * @struct WorkerConnection
+         * @brief A running worker process and its pipes.
+         */
+        struct WorkerConnection
+        {
+            int                 pid = -1;       ///< Process id.
+            int                 input = -1;     ///< Write end of the worker's stdin.
+            int                 output = -1;    ///< Read end of the worker's stdout.
+            std::string         buffer;         ///< Received bytes not yet forming a line.
+            std::deque<size_t>  inFlight;       ///< Tasks sent and not yet answered, in order.
+        };
+
+        /**
+         * @brief Starts a worker process connected through pipes.
+         * @param worker Receives the process id and pipe ends.
+         */
+        void Spawn(WorkerConnection& worker);
+
+        /**
+         * @brief Sends pending tasks until the worker holds tasksPerWorker of them.
+         * @param worker The worker to fill up.
+         * @param tasks All tasks of the batch.
+         * @param pending Ids of tasks not yet sent.
+         * @return False if the worker could not be written to.
+         */
+        bool FillWorker(WorkerConnection& worker, const std::vector<RenderTask>& tasks, std::deque<size_t>& pending);
+
+        /**
+         * @brief Closes the worker's pipes and waits for it to exit.
+         * @param worker The worker to shut down.
+         */
+        void Shutdown(WorkerConnection& worker);
+
+    private:
+        std::vector<std::string>    m_workerCommand;    ///< Command that starts a worker.
+        unsigned int                m_workerCount;      ///< Number of worker processes.
+        size_t                      m_tasksPerWorker;   ///< Queue depth per worker.
+    };
+}
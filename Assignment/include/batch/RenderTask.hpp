@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @file RenderTask.hpp
+ * @brief Defines the render tasks of the batch renderer and their serialization.
+ */
+
+namespace graf
+{
+    /**
+     * @struct RenderTask
+     * @brief A single frame to render offline.
+     *
+     * Tasks are self-contained so any worker, local or remote, can render one with
+     * nothing but access to the scene and texture files.
+     */
+    struct RenderTask
+    {
+        size_t      id = 0;                             ///< Index of the task in the batch.
+        std::string scene;                              ///< Path of the scene JSON file.
+        glm::vec3   cameraPosition{0.0f};               ///< Eye position.
+        glm::vec3   cameraTarget{0.0f, 0.0f, -1.0f};    ///< Point the camera looks at.
+        float       fov = 90.0f;                        ///< Vertical field of view in degrees.
+        int         width = 800;                        ///< Image width in pixels.
+        int         height = 800;                       ///< Image height in pixels.
+        std::string output;                             ///< Path of the PNG file to write.
+    };
+
+    /**
+     * @brief Loads a job list and expands it into frame tasks.
+     *
+     * The file holds `{"jobs": [...]}` where each job has `scene`, `output`, and
+     * optionally `width`, `height`, `camera` (`position`, `target`, `fov`) and
+     * `frames`. A job with more than one frame is a turntable: the camera orbits its
+     * target around the Y-axis and each frame's index is appended to the output name
+     * (e.g., `turn.png` becomes `turn_0007.png`).
+     *
+     * @param fileName Path of the job list JSON file.
+     * @return The frame tasks, numbered in order.
+     * @exception GrafException Thrown if the file cannot be read or a job is malformed.
+     */
+    std::vector<RenderTask> LoadRenderTasks(const std::string& fileName);
+
+    /**
+     * @brief Serializes a task as a single line of JSON for the worker protocol.
+     * @param task The task to serialize.
+     * @return The JSON text without a trailing newline.
+     */
+    std::string SerializeRenderTask(const RenderTask& task);
+
+    /**
+     * @brief Parses a task sent by the coordinator.
+     * @param line One line of JSON produced by SerializeRenderTask.
+     * @return The parsed task.
+     * @exception GrafException Thrown if the line is not a valid task.
+     */
+    RenderTask ParseRenderTask(const std::string& line);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "GLWindow.hpp"
+#include "JobSystem.hpp"
+#include "RenderTask.hpp"
+#include "Scene.hpp"
+#include "SceneRenderer.hpp"
+#include "ShaderProgram.hpp"
+#include "ShapeFactoryManager.hpp"
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file RenderWorker.hpp
+ * @brief Defines the RenderWorker class that renders batch tasks offscreen.
+ */
+
+namespace graf
+{
+    /**
+     * @class RenderWorker
+     * @brief Renders render tasks into PNG files using a headless OpenGL context.
+     *
+     * A worker owns its own context, shapes, shader and scene cache, so several
+     * workers can run as separate processes. Scenes and their textures are loaded
+     * on first use and kept for later tasks.
+     */
+    class RenderWorker
+    {
+    public:
+        /**
+         * @brief Creates the headless context and the rendering resources.
+         * @exception GrafException Thrown if the context, shaders or shapes cannot be created.
+         */
+        RenderWorker();
+
+        /**
+         * @brief Renders a task and writes its PNG file.
+         * @param task The frame to render.
+         * @return The time spent on the task in milliseconds.
+         * @exception GrafException Thrown if the scene, a texture or the output cannot be processed.
+         */
+        double RenderFrame(const RenderTask& task);
+
+        /**
+         * @brief Serves tasks from a coordinator until the input stream ends.
+         *
+         * Reads one serialized task per line and answers each with one JSON line:
+         * `{"id": N, "ok": true, "ms": T}` or `{"id": N, "ok": false, "error": "..."}`.
+         * The output stream is reserved for the protocol; diagnostics go to stderr.
+         *
+         * @param in Stream delivering tasks.
+         * @param out Stream receiving results.
+         */
+        void Serve(std::istream& in, std::ostream& out);
+
+    private:
+        /**
+         * @brief Gets a scene from the cache, loading it and its textures on first use.
+         * @param fileName Path of the scene JSON file.
+         * @return The scene objects.
+         */
+        const std::vector<ObjectData>& GetScene(const std::string& fileName);
+
+    private:
+        GLWindow                                     m_window;       ///< Headless context and offscreen framebuffer.
+        JobSystem                                    m_jobs;         ///< Small pool; parallelism comes from worker processes.
+        ShapeFactoryManager                          m_shapes;       ///< Cached shape meshes.
+        ShaderProgram                                m_program;      ///< Scene shader.
+        std::unique_ptr<SceneRenderer>               m_renderer;     ///< Draws frame packets.
+        std::map<std::string, std::vector<ObjectData>> m_scenes;     ///< Loaded scenes by file name.
+        FramePacket                                  m_packet;       ///< Reused between tasks.
+        std::vector<unsigned char>                   m_pixels;       ///< Reused readback storage.
+    };
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include "RollingStats.hpp"
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @file AllocationTracker.hpp
+ * @brief Defines the AllocationTracker, which counts heap allocations, and the per-frame FrameAllocationMonitor.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @struct AllocationStats
+     * @brief Heap operations counted up to one point, or the difference of two such counts.
+     */
+    struct AllocationStats
+    {
+        uint64_t allocations = 0;   ///< Calls of operator new.
+        uint64_t frees = 0;         ///< Calls of operator delete with a non-null pointer.
+        uint64_t bytes = 0;         ///< Bytes requested from operator new.
+    };
+
+    /**
+     * @brief Gets the operations counted between two points.
+     * @param end The later count.
+     * @param start The earlier count.
+     * @return The differences.
+     */
+    AllocationStats operator-(const AllocationStats& end, const AllocationStats& start);
+
+    /**
+     * @class AllocationTracker
+     * @brief Counts every heap allocation through the global operator new and delete.
+     *
+     * When built with GRAF_ENABLE_ALLOCATION_TRACKER the program's global operator
+     * new and delete are replaced by versions that forward to malloc and free and
+     * count into per-thread counters, so the hook never allocates or locks; the
+     * totals are summed over all threads when read. Optionally the call stack of
+     * every Nth allocation of each thread is sampled into a fixed buffer, which
+     * WriteSampleReport groups by call site. The build defines it for every
+     * configuration except Release; without it nothing is replaced and all counts
+     * stay zero.
+     */
+    class AllocationTracker
+    {
+    public:
+        /**
+         * @brief Checks whether allocations are counted in this build.
+         * @return True if GRAF_ENABLE_ALLOCATION_TRACKER was defined.
+         */
+        static bool IsEnabled();
+
+        /**
+         * @brief Gets the operations of all threads since the program started.
+         * @return The counts.
+         */
+        static AllocationStats GetTotals();
+
+        /**
+         * @brief Gets the operations of the calling thread since it started.
+         * @return The counts.
+         */
+        static AllocationStats GetThreadTotals();
+
+        /**
+         * @brief Sets how often call stacks are sampled.
+         * @param everyN Sample every Nth allocation of each thread; 1 samples all and 0 none.
+         */
+        static void SetSampleRate(uint32_t everyN);
+
+        /**
+         * @brief Gets how often call stacks are sampled.
+         * @return Every Nth allocation is sampled, 0 if sampling is off.
+         */
+        static uint32_t GetSampleRate();
+
+        /**
+         * @brief Gets the number of call stacks in the sample buffer.
+         * @return The count.
+         */
+        static size_t GetSampleCount();
+
+        /**
+         * @brief Gets the number of samples that did not fit into the buffer.
+         * @return The count.
+         */
+        static uint64_t GetDroppedSamples();
+
+        /**
+         * @brief Empties the sample buffer; sampling must be off.
+         */
+        static void ClearSamples();
+
+        /**
+         * @brief Writes the sampled call sites, most frequent first, with symbolized stacks where available.
+         * @param out The stream.
+         * @param maxSites Number of call sites written at most.
+         */
+        static void WriteSampleReport(ostream& out, size_t maxSites = 10);
+
+        /**
+         * @brief Registers the allocation totals with the MetricsRegistry; later calls do nothing.
+         */
+        static void RegisterMetrics();
+    };
+
+    /**
+     * @class FrameAllocationMonitor
+     * @brief Tracks the heap allocations of every frame and guards a zero-allocation steady state.
+     *
+     * EndFrame is called once per frame and attributes everything allocated by any
+     * thread since the previous call to the frame. With a steady-state check, the
+     * frames after a warmup must not allocate: the first one that does fails the
+     * check, and because sampling every allocation starts with the steady state,
+     * the samples are exactly the call sites of that frame.
+     */
+    class FrameAllocationMonitor
+    {
+    public:
+        /**
+         * @brief Constructs a monitor starting at the current totals.
+         * @param windowSize Number of recent frames kept for the statistics.
+         */
+        explicit FrameAllocationMonitor(size_t windowSize = 1024);
+
+        /**
+         * @brief Requires the frames after a warmup to be allocation-free.
+         * @param warmupFrames Frames allowed to allocate, e.g. for caches and first-use setup.
+         */
+        void SetSteadyStateCheck(uint64_t warmupFrames);
+
+        /**
+         * @brief Ends a frame: attributes the allocations since the last call to it.
+         */
+        void EndFrame();
+
+        /**
+         * @brief Gets the number of frames ended.
+         * @return The count.
+         */
+        uint64_t GetFrameCount() const;
+
+        /**
+         * @brief Gets the allocations of the last frame.
+         * @return The counts.
+         */
+        const AllocationStats& GetLastFrame() const;
+
+        /**
+         * @brief Gets the allocation count of recent frames.
+         * @return The statistics.
+         */
+        const RollingStats& GetAllocationsPerFrame() const;
+
+        /**
+         * @brief Gets the allocated bytes of recent frames.
+         * @return The statistics.
+         */
+        const RollingStats& GetBytesPerFrame() const;
+
+        /**
+         * @brief Gets the number of steady-state frames that allocated.
+         * @return The count, 0 without a steady-state check.
+         */
+        uint64_t GetAllocatingFrames() const;
+
+        /**
+         * @brief Checks whether a steady-state frame allocated.
+         * @return True if the check failed.
+         */
+        bool HasFailed() const;
+
+        /**
+         * @brief Writes the per-frame summary and, if the check failed, the call sites of the first failing frame.
+         * @param out The stream.
+         */
+        void WriteReport(ostream& out) const;
+
+    private:
+        AllocationStats m_previous;                 ///< Totals at the end of the previous frame.
+        AllocationStats m_lastFrame;                ///< Allocations of the last frame.
+        RollingStats    m_allocationsPerFrame;      ///< Allocation count per frame.
+        RollingStats    m_bytesPerFrame;            ///< Allocated bytes per frame.
+        uint64_t        m_frameCount = 0;           ///< Frames ended.
+        uint64_t        m_warmupFrames = 0;         ///< Frames before the steady state.
+        bool            m_checking = false;         ///< Whether the steady state is checked.
+        uint64_t        m_allocatingFrames = 0;     ///< Steady-state frames that allocated.
+        uint64_t        m_firstFailure = 0;         ///< Number of the first steady-state frame that allocated.
+        AllocationStats m_firstFailureStats;        ///< Allocations of that frame.
+    };
+}
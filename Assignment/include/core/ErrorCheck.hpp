@@ -18,10 +18,13 @@ namespace graf
      * and converts the error code into a human-readable message. If an error is detected,
      * it throws a GrafException with details about the failed operation.
      * 
+     * The operation is only turned into a string when an error is thrown, so the
+     * check does not allocate on the per-frame path.
+     * 
      * @param operation A string describing the OpenGL operation being checked (e.g., "Vertex Buffer Creation").
      * @exception GrafException Thrown if an OpenGL error is detected, containing the operation and error message.
      */
-    inline void CheckGLError(const std::string& operation) 
+    inline void CheckGLError(const char* operation) 
     {
         GLenum error = glGetError();
         if (error != GL_NO_ERROR) 
@@ -35,7 +38,7 @@ namespace graf
                 case GL_OUT_OF_MEMORY:      errorMsg = "Out of memory";     break; ///< Insufficient memory to complete the operation
                 default:                    errorMsg = "Unknown error";     break; ///< An unrecognized error code
             }
-            throw GrafException(operation + " failed: " + errorMsg);
+            throw GrafException(std::string(operation) + " failed: " + errorMsg);
         }
     }
 }
\ No newline at end of file
@@ -90,4 +90,20 @@ namespace graf
          */
         explicit GLWindowException(const std::string& message) : GrafException("Window Error: " + message) {}
     };
+
+    /**
+     * @class WorldException
+     * @brief Exception class for world generation errors.
+     * 
+     * Thrown when the data a procedural world is generated from cannot be loaded or used.
+     */
+    class WorldException : public GrafException 
+    {
+    public:
+        /**
+         * @brief Constructs a WorldException with a detailed message.
+         * @param message The specific error message (prefixed with "World Error: ").
+         */
+        explicit WorldException(const std::string& message) : GrafException("World Error: " + message) {}
+    };
 }
\ No newline at end of file
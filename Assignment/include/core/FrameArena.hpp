@@ -0,0 +1,294 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file FrameArena.hpp
+ * @brief Defines linear arenas for transient per-frame data and an STL allocator on top of them.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class LinearArena
+     * @brief A bump allocator over large blocks that frees everything at once.
+     *
+     * Allocation advances an offset in the current block and only takes a new
+     * block from the heap when the blocks kept so far are full. Individual
+     * allocations are never freed and no destructors run; Reset makes all memory
+     * reusable. If a frame needed several blocks, Reset replaces them by one
+     * block of their total size, so a steady workload settles on a single block
+     * and allocates nothing. Not thread-safe.
+     */
+    class LinearArena
+    {
+    public:
+        /**
+         * @brief Constructs an empty arena; no memory is taken until the first allocation.
+         * @param blockSize Minimum size of a block in bytes.
+         */
+        explicit LinearArena(size_t blockSize = 64 * 1024);
+
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        /**
+         * @brief Allocates memory that stays valid until the next Reset.
+         * @param size Size in bytes.
+         * @param alignment Alignment, a power of two.
+         * @return The memory.
+         */
+        void* Allocate(size_t size, size_t alignment = alignof(max_align_t));
+
+        /**
+         * @brief Allocates an array of default-initialized objects that stays valid until the next Reset.
+         * @tparam T Element type; its destructor is never run.
+         * @param count Number of elements.
+         * @return The first element.
+         */
+        template <class T>
+        T* AllocateArray(size_t count)
+        {
+            static_assert(is_trivially_destructible<T>::value, "Arena memory is reclaimed without running destructors");
+            T* elements = static_cast<T*>(Allocate(ArraySize<T>(count), alignof(T)));
+            for (size_t i = 0; i < count; ++i)
+                new (elements + i) T;
+            return elements;
+        }
+
+        /**
+         * @brief Makes all memory reusable and records the usage of the ending frame.
+         */
+        void Reset();
+
+        /**
+         * @brief Frees all blocks.
+         */
+        void Release();
+
+        /**
+         * @brief Gets the bytes allocated since the last Reset, including alignment padding.
+         * @return The byte count.
+         */
+        size_t GetUsed() const;
+
+        /**
+         * @brief Gets the most bytes allocated between two resets.
+         * @return The byte count.
+         */
+        size_t GetHighWater() const;
+
+        /**
+         * @brief Gets the size of all blocks held.
+         * @return The byte count.
+         */
+        size_t GetCapacity() const;
+
+        /**
+         * @brief Gets the number of blocks held.
+         * @return The count.
+         */
+        size_t GetBlockCount() const;
+
+        /**
+         * @brief Gets the size of an array of objects.
+         * @tparam T Element type.
+         * @param count Number of elements.
+         * @return The size in bytes.
+         * @exception std::bad_array_new_length Thrown if the size overflows.
+         */
+        template <class T>
+        static size_t ArraySize(size_t count)
+        {
+            if (count > SIZE_MAX / sizeof(T))
+                throw bad_array_new_length();
+            return count * sizeof(T);
+        }
+
+    private:
+        /**
+         * @struct Block
+         * @brief A contiguous piece of arena memory.
+         */
+        struct Block
+        {
+            unique_ptr<unsigned char[]> data;   ///< The memory.
+            size_t                      size;   ///< Its size in bytes.
+        };
+
+        vector<Block>   m_blocks;           ///< Blocks in allocation order.
+        size_t          m_blockSize;        ///< Minimum size of a new block.
+        size_t          m_current = 0;      ///< Block allocated from.
+        size_t          m_offset = 0;       ///< Bytes used in the current block.
+        size_t          m_used = 0;         ///< Bytes handed out since the last Reset.
+        size_t          m_highWater = 0;    ///< Most bytes handed out between two resets.
+    };
+
+    /**
+     * @class FrameArena
+     * @brief Transient memory of one frame, with a LinearArena per thread so workers allocate without locking.
+     *
+     * Allocate takes memory from the calling thread's sub-arena, which is created on
+     * the thread's first allocation; the memory may be used by any thread. Reset
+     * frees the memory of all threads at once and must only be called when no
+     * thread is allocating or using the frame's memory, e.g. at the start of the
+     * next frame of the stage that owns the arena.
+     */
+    class FrameArena
+    {
+    public:
+        static const size_t MAX_THREADS = 128; ///< Threads alive at once that can allocate.
+
+        /**
+         * @brief Constructs an empty arena; no memory is taken until the first allocation.
+         * @param blockSize Minimum size of a block of each sub-arena in bytes.
+         */
+        explicit FrameArena(size_t blockSize = 256 * 1024);
+
+        /**
+         * @brief Frees the sub-arenas.
+         */
+        ~FrameArena();
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        /**
+         * @brief Allocates memory from the calling thread's sub-arena, valid until the next Reset.
+         * @param size Size in bytes.
+         * @param alignment Alignment, a power of two.
+         * @return The memory.
+         */
+        void* Allocate(size_t size, size_t alignment = alignof(max_align_t));
+
+        /**
+         * @brief Allocates an array of default-initialized objects from the calling thread's sub-arena.
+         * @tparam T Element type; its destructor is never run.
+         * @param count Number of elements.
+         * @return The first element.
+         */
+        template <class T>
+        T* AllocateArray(size_t count)
+        {
+            return GetThreadArena().AllocateArray<T>(count);
+        }
+
+        /**
+         * @brief Gets the sub-arena of the calling thread, creating it on first use.
+         * @return The sub-arena.
+         * @exception GrafException Thrown if more than MAX_THREADS threads are alive.
+         */
+        LinearArena& GetThreadArena();
+
+        /**
+         * @brief Makes the memory of all threads reusable and records the usage of the ending frame.
+         */
+        void Reset();
+
+        /**
+         * @brief Gets the bytes allocated by all threads since the last Reset.
+         * @return The byte count.
+         */
+        size_t GetUsed() const;
+
+        /**
+         * @brief Gets the most bytes allocated by all threads between two resets.
+         * @return The byte count.
+         */
+        size_t GetHighWater() const;
+
+        /**
+         * @brief Gets the size of all blocks held by the sub-arenas.
+         * @return The byte count.
+         */
+        size_t GetCapacity() const;
+
+        /**
+         * @brief Gets the number of blocks held by the sub-arenas.
+         * @return The count.
+         */
+        size_t GetBlockCount() const;
+
+        /**
+         * @brief Gets the number of threads that have allocated from the arena.
+         * @return The count of sub-arenas.
+         */
+        size_t GetThreadArenaCount() const;
+
+    private:
+        size_t                  m_blockSize;                ///< Minimum block size of the sub-arenas.
+        atomic<LinearArena*>    m_arenas[MAX_THREADS] = {}; ///< Sub-arena per thread slot, owned.
+        size_t                  m_highWater = 0;            ///< Most bytes of all threads between two resets.
+    };
+
+    /**
+     * @class ArenaAllocator
+     * @brief STL allocator taking memory from an arena; deallocation does nothing.
+     *
+     * Containers using it must not outlive the arena's next Reset, and since
+     * growing never returns memory, they should reserve their final size.
+     *
+     * @tparam T Element type.
+     * @tparam Arena LinearArena or FrameArena.
+     */
+    template <class T, class Arena = FrameArena>
+    class ArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        /**
+         * @brief Constructs an allocator of an arena.
+         * @param arena The arena.
+         */
+        explicit ArenaAllocator(Arena& arena) noexcept : m_arena(&arena) {}
+
+        /**
+         * @brief Constructs an allocator of the same arena for another type.
+         * @param other The allocator.
+         */
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U, Arena>& other) noexcept : m_arena(other.GetArena()) {}
+
+        /**
+         * @brief Allocates storage for objects.
+         * @param count Number of objects.
+         * @return The storage.
+         */
+        T* allocate(size_t count) { return static_cast<T*>(m_arena->Allocate(LinearArena::ArraySize<T>(count), alignof(T))); }
+
+        /**
+         * @brief Does nothing; the memory is reclaimed by the arena's Reset.
+         */
+        void deallocate(T*, size_t) noexcept {}
+
+        /**
+         * @brief Gets the arena.
+         * @return The arena.
+         */
+        Arena* GetArena() const noexcept { return m_arena; }
+
+        template <class U>
+        bool operator==(const ArenaAllocator<U, Arena>& other) const noexcept { return m_arena == other.GetArena(); }
+
+        template <class U>
+        bool operator!=(const ArenaAllocator<U, Arena>& other) const noexcept { return m_arena != other.GetArena(); }
+
+    private:
+        Arena* m_arena; ///< The arena allocated from.
+    };
+
+    /**
+     * @brief A vector whose storage lives in an arena.
+     */
+    template <class T, class Arena = FrameArena>
+    using ArenaVector = vector<T, ArenaAllocator<T, Arena>>;
+}
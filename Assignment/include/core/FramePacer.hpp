@@ -0,0 +1,123 @@
+#pragma once
+
+#include "RollingStats.hpp"
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * @file FramePacer.hpp
+ * @brief Defines the FramePacer class for presentation-mode control and frame pacing.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @enum PresentMode
+     * @brief Controls how finished frames are paced.
+     */
+    enum class PresentMode
+    {
+        VSync,          ///< Swap interval 1: wait for every vertical blank.
+        AdaptiveVSync,  ///< Swap interval -1: sync when on time, tear instead of stalling when late.
+        Uncapped,       ///< Swap interval 0: render as fast as possible (benchmarking).
+        Limited         ///< Swap interval 0 plus a CPU-side limiter to a target frame rate.
+    };
+
+    /**
+     * @brief Parses a presentation mode name.
+     * @param name One of "vsync", "adaptive", "uncapped" or "limited".
+     * @return The matching mode.
+     * @exception std::invalid_argument Thrown if the name is unknown.
+     */
+    PresentMode ParsePresentMode(const string& name);
+
+    /**
+     * @class FramePacer
+     * @brief Paces frames and records frame-time statistics.
+     *
+     * Call EndFrame once per frame right after the buffer swap. In Limited mode it
+     * blocks until the next frame deadline using a hybrid wait: coarse sleeps while
+     * the remaining time exceeds the measured sleep inaccuracy, then a short spin.
+     * In every mode it records the time between frames and counts missed deadlines,
+     * i.e. frames that took more than one and a half target periods.
+     */
+    class FramePacer
+    {
+    public:
+        using Clock = chrono::steady_clock;
+
+        /**
+         * @brief Constructs a pacer in VSync mode targeting 60 frames per second.
+         */
+        FramePacer();
+
+        /**
+         * @brief Sets the presentation mode and resets the statistics.
+         * @param mode The presentation mode.
+         * @param targetFps Frame rate used for the limiter and the missed-deadline check.
+         *        For the vsync modes this should be the display refresh rate.
+         * @exception std::invalid_argument Thrown if targetFps is not positive.
+         */
+        void SetMode(PresentMode mode, double targetFps);
+
+        /**
+         * @brief Gets the presentation mode.
+         * @return The current mode.
+         */
+        PresentMode GetMode() const;
+
+        /**
+         * @brief Gets the target frame rate.
+         * @return Frames per second.
+         */
+        double GetTargetFps() const;
+
+        /**
+         * @brief Gets the swap interval to pass to the windowing system for the mode.
+         * @return 1 for VSync, -1 for AdaptiveVSync and 0 otherwise.
+         */
+        int GetSwapInterval() const;
+
+        /**
+         * @brief Finishes a frame: waits for its deadline if limited and records its duration.
+         */
+        void EndFrame();
+
+        /**
+         * @brief Gets the frame-time statistics in milliseconds.
+         * @return The statistics over the most recent frames.
+         */
+        const RollingStats& GetFrameTimes() const;
+
+        /**
+         * @brief Gets the number of frames that missed their deadline.
+         * @return The missed deadline count since the mode was set.
+         */
+        size_t GetMissedDeadlines() const;
+
+    private:
+        /**
+         * @brief Blocks until the given time point with sleep followed by spin.
+         * @param deadline The time point to wait for.
+         */
+        void WaitUntil(Clock::time_point deadline);
+
+    private:
+        PresentMode         m_mode = PresentMode::VSync;    ///< Current presentation mode.
+        double              m_targetFps = 60.0;             ///< Target frame rate.
+        Clock::duration     m_period;                       ///< Duration of one target frame.
+        Clock::time_point   m_lastFrameEnd;                 ///< End of the previous frame.
+        Clock::time_point   m_nextDeadline;                 ///< Deadline of the next frame in Limited mode.
+        bool                m_started = false;              ///< Whether a frame has ended since SetMode.
+        RollingStats        m_frameTimes;                   ///< Frame durations in milliseconds.
+        size_t              m_missedDeadlines = 0;          ///< Frames over one and a half periods.
+
+        double              m_sleepEstimate = 5.0e-3;       ///< Expected duration of a 1 ms sleep plus one deviation, in seconds.
+        double              m_sleepMean = 5.0e-3;           ///< Mean observed duration of a 1 ms sleep.
+        double              m_sleepM2 = 0.0;                ///< Sum of squared deviations (Welford).
+        size_t              m_sleepCount = 1;               ///< Number of observed sleeps.
+    };
+}
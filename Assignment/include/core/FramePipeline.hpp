@@ -0,0 +1,77 @@
+#pragma once
+
+#include "FramePacket.hpp"
+#include "RingDeque.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+/**
+ * @file FramePipeline.hpp
+ * @brief Defines the FramePipeline class for passing frame packets between threads.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class FramePipeline
+     * @brief A bounded producer/consumer queue of reusable frame packets.
+     * 
+     * The simulation thread writes into a free packet and publishes it, while the
+     * GL thread consumes published packets in order. The pool holds one packet per
+     * allowed queued frame plus the one currently held by the GL thread, so with a
+     * queue depth of 1 the packets are double-buffered and the simulation can run
+     * at most one frame ahead of rendering.
+     */
+    class FramePipeline
+    {
+    public:
+        /**
+         * @brief Constructs a pipeline with the given queue depth.
+         * @param queueDepth Maximum number of frames the simulation may run ahead (at least 1).
+         */
+        explicit FramePipeline(size_t queueDepth = 1);
+
+        /**
+         * @brief Acquires a free packet for the simulation to fill.
+         * 
+         * Blocks while every packet is either queued or in use by the GL thread.
+         * 
+         * @return Pointer to a writable packet, or nullptr if the pipeline was stopped.
+         */
+        FramePacket* BeginWrite();
+
+        /**
+         * @brief Publishes a packet previously obtained from BeginWrite.
+         * @param packet The filled packet to hand to the consumer.
+         */
+        void Publish(FramePacket* packet);
+
+        /**
+         * @brief Acquires the next published packet for rendering.
+         * 
+         * Recycles the packet returned by the previous call and blocks until a new
+         * packet is available.
+         * 
+         * @return Pointer to a read-only packet, or nullptr if the pipeline was stopped.
+         */
+        const FramePacket* AcquireNext();
+
+        /**
+         * @brief Stops the pipeline and wakes up all waiting threads.
+         */
+        void Stop();
+
+    private:
+        vector<FramePacket>     m_packets;           ///< Storage for all packets in the pool.
+        RingDeque<FramePacket*> m_free;              ///< Packets available for writing.
+        RingDeque<FramePacket*> m_ready;             ///< Published packets waiting to be rendered.
+        FramePacket*            m_current = nullptr; ///< Packet currently held by the consumer.
+        bool                    m_stopped = false;   ///< Whether the pipeline has been stopped.
+        mutex                   m_mutex;             ///< Guards the queues and the stop flag.
+        condition_variable      m_freeCondition;     ///< Signalled when a packet is recycled.
+        condition_variable      m_readyCondition;    ///< Signalled when a packet is published.
+    };
+}
@@ -11,6 +11,9 @@ namespace graf
 {
     using namespace std;
 
+    struct FramePacket;
+    struct InputEvent;
+
     /**
      * @brief Alias for a rendering callback function.
      * 
@@ -38,4 +41,45 @@ namespace graf
      * Used as a callback for handling window close events in the GLWindow class.
      */
     using CloseFunction     = function<void()>;
+
+    /**
+     * @brief Alias for a simulation callback function.
+     * 
+     * Represents a function that advances the application state and fills the
+     * given frame packet with everything needed to render the resulting frame.
+     * Runs on the simulation thread in pipelined mode.
+     * 
+     * @param packet The packet to fill for the next frame.
+     */
+    using SimulationFunction = function<void(FramePacket&)>;
+
+    /**
+     * @brief Alias for a fixed-timestep update callback function.
+     * 
+     * Represents a function that advances the application state by exactly one
+     * simulation tick. Runs on the simulation thread in pipelined mode.
+     * 
+     * @param dt The fixed tick duration in seconds.
+     */
+    using TickFunction = function<void(double)>;
+
+    /**
+     * @brief Alias for a frame packet rendering callback function.
+     * 
+     * Represents a function that issues the OpenGL calls for a published frame
+     * packet. Runs on the GL thread in pipelined mode.
+     * 
+     * @param packet The read-only packet to render.
+     */
+    using FrameRenderFunction = function<void(const FramePacket&)>;
+
+    /**
+     * @brief Alias for a generic input event callback function.
+     * 
+     * Receives every keyboard, mouse and resize event together with its receive
+     * timestamp. Runs on the simulation thread in pipelined mode.
+     * 
+     * @param event The input event.
+     */
+    using InputFunction = function<void(const InputEvent&)>;
 }
\ No newline at end of file
@@ -3,6 +3,16 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include "FunctionTypes.hpp"
+#include "FrameBuffer.hpp"
+#include "FramePacer.hpp"
+#include "FramePipeline.hpp"
+#include "InputEvents.hpp"
+#include "InputRecording.hpp"
+#include "RollingStats.hpp"
+#include "SpscRing.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
 
 /**
  * @file GLWindow.hpp
@@ -17,6 +27,12 @@ namespace graf
      * 
      * This class encapsulates the creation, rendering, and event handling of an OpenGL
      * window. It supports custom rendering and keyboard input callbacks through function objects.
+     * When a simulation function is set, the render loop runs pipelined: a simulation thread
+     * produces frame packets while the GL thread renders the previously published one.
+     * An optional tick function advances the state at a fixed rate independent of the
+     * frame rate; packets then carry the factor for interpolating between the last two ticks.
+     * In headless mode there is no visible window: rendering goes to an offscreen
+     * framebuffer, so the same render functions run on servers and in CI.
      */
     class GLWindow
     {
@@ -34,11 +50,49 @@ namespace graf
          */
         int create(unsigned int width, unsigned int height);
 
+        /**
+         * @brief Creates an OpenGL context without a visible window.
+         * 
+         * Initializes GLFW on its null platform and creates a surfaceless context,
+         * trying EGL first and OSMesa second, so it works without a display server or
+         * GPU (e.g., Mesa llvmpipe). An offscreen framebuffer of the given size is
+         * created and stays bound, so render functions run unchanged. The presentation
+         * mode defaults to uncapped.
+         * 
+         * @param width The width of the render target in pixels.
+         * @param height The height of the render target in pixels.
+         * @return 1 on success.
+         * @exception GLWindowException Thrown if no headless context can be created.
+         */
+        int createHeadless(unsigned int width, unsigned int height);
+
+        /**
+         * @brief Checks whether the window was created with createHeadless.
+         * @return True in headless mode.
+         */
+        bool IsHeadless() const;
+
+        /**
+         * @brief Gets the offscreen render target used in headless mode.
+         * @return The framebuffer; only valid in headless mode.
+         */
+        FrameBuffer& GetFrameBuffer();
+
+        /**
+         * @brief Stops the render loop after a number of frames.
+         * 
+         * Needed in headless mode, where the window cannot be closed by the user.
+         * 
+         * @param frameCount Number of frames to render; 0 renders until the window closes.
+         */
+        void SetFrameLimit(uint64_t frameCount);
+
         /**
          * @brief Runs the main rendering loop.
          * 
          * Enters a loop that continuously calls the render function, swaps buffers,
-         * and processes events until the window is closed.
+         * and processes events until the window is closed. If a simulation function
+         * is set, simulation runs on a separate thread and the loop renders frame packets.
          */
         void Render();
 
@@ -60,6 +114,124 @@ namespace graf
          */
         void SetCloseFunction(CloseFunction closeFunc);
 
+        /**
+         * @brief Sets the simulation callback and enables pipelined rendering.
+         * 
+         * The function runs on a dedicated simulation thread and fills one frame
+         * packet per call. Input events are delivered on the same thread, through a
+         * lock-free queue, right before the packet is simulated.
+         * 
+         * @param simulationFunc The function that advances the state and fills a packet.
+         * @param queueDepth Maximum number of frames the simulation may run ahead of rendering.
+         */
+        void SetSimulationFunction(SimulationFunction simulationFunc, size_t queueDepth = 1);
+
+        /**
+         * @brief Sets the fixed-timestep update callback.
+         * 
+         * Before each packet is filled, the simulation thread adds the elapsed real time
+         * to an accumulator and calls the tick function once per whole tick it contains.
+         * The remainder is stored in FramePacket::interpolation as a fraction of a tick.
+         * At most MAX_TICKS_PER_FRAME ticks run per packet; older backlog is dropped.
+         * Only used together with a simulation function.
+         * 
+         * @param tickFunc The function advancing the state by one tick.
+         * @param tickRate Number of ticks per second.
+         */
+        void SetTickFunction(TickFunction tickFunc, double tickRate = 60.0);
+
+        /**
+         * @brief Sets the callback that renders a published frame packet.
+         * @param frameRenderFunc The function to be called on the GL thread for each packet.
+         */
+        void SetFrameRenderFunction(FrameRenderFunction frameRenderFunc);
+
+        /**
+         * @brief Selects how frames are presented and paced.
+         * 
+         * Sets the swap interval for the mode (falling back from adaptive to regular
+         * vsync when the driver lacks swap-control-tear support) and configures the
+         * frame pacer. May be called before or after create.
+         * 
+         * @param mode The presentation mode.
+         * @param targetFps Target frame rate for Limited mode and missed-deadline checks;
+         *        0 uses the primary monitor's refresh rate.
+         */
+        void SetPresentMode(PresentMode mode, double targetFps = 0.0);
+
+        /**
+         * @brief Gets the frame pacer holding frame-time and missed-deadline statistics.
+         * @return The frame pacer.
+         */
+        const FramePacer& GetFramePacer() const;
+
+        /**
+         * @brief Gets the underlying GLFW window, e.g. for UI libraries.
+         * @return The window, or nullptr before create.
+         */
+        GLFWwindow* GetNativeWindow() const;
+
+        /**
+         * @brief Sets the callback receiving all keyboard, mouse and resize events.
+         * @param inputFunc The function to be called for each input event.
+         */
+        void SetInputFunction(InputFunction inputFunc);
+
+        /**
+         * @brief Starts recording every applied input event.
+         * 
+         * Events are stored with the simulation tick and frame they were applied at.
+         * Only used together with a simulation function.
+         * 
+         * @param seed Seed of the application's random number generator, stored for replays.
+         */
+        void StartInputRecording(uint64_t seed);
+
+        /**
+         * @brief Gets the input recorded since StartInputRecording.
+         * 
+         * Complete once Render has returned.
+         * 
+         * @return The recording.
+         */
+        const InputRecording& GetInputRecording() const;
+
+        /**
+         * @brief Replays a recorded input session instead of live input.
+         * 
+         * Every frame runs exactly one fixed tick at the recorded tick rate and the
+         * recorded events are applied at the ticks they were recorded at, so the
+         * simulation evolves identically to the recording regardless of frame rate.
+         * Live input is ignored, per-frame timings are logged and the loop stops after
+         * as many frames as the recording had ticks.
+         * 
+         * @param recording The session to replay.
+         */
+        void StartInputReplay(InputRecording recording);
+
+        /**
+         * @brief Gets the duration of every presented frame during a replay.
+         * @return Frame times in milliseconds, in presentation order.
+         */
+        const vector<double>& GetFrameTimeLog() const;
+
+        /**
+         * @brief Gets the input-to-present latency statistics in milliseconds.
+         * 
+         * One sample is recorded per input event, measured from the moment GLFW
+         * delivered the event to the buffer swap of the first frame that applied it.
+         * Only available in pipelined mode; read it from the GL thread.
+         * 
+         * @return The latency statistics.
+         */
+        const RollingStats& GetInputLatency() const;
+
+        /**
+         * @brief Gets the number of input events dropped because the queue was full.
+         * @return The dropped event count.
+         */
+        size_t GetDroppedInputEvents() const;
+
     private:
         /**
          * @brief Static callback function for GLFW keyboard events.
@@ -73,11 +245,124 @@ namespace graf
          * @param mods Bit field of modifier keys (e.g., Shift, Ctrl).
          */
         static void sKeyboardFunction(GLFWwindow* window, int key, int scancode, int action, int mods);
-    
+
+        /**
+         * @brief Static callback function for GLFW mouse button events.
+         * @param window The GLFW window that received the event.
+         * @param button The mouse button that was pressed or released.
+         * @param action The button action (GLFW_PRESS, GLFW_RELEASE).
+         * @param mods Bit field of modifier keys.
+         */
+        static void sMouseButtonFunction(GLFWwindow* window, int button, int action, int mods);
+
+        /**
+         * @brief Static callback function for GLFW cursor movement events.
+         * @param window The GLFW window that received the event.
+         * @param x The new cursor x position in screen coordinates.
+         * @param y The new cursor y position in screen coordinates.
+         */
+        static void sCursorPosFunction(GLFWwindow* window, double x, double y);
+
+        /**
+         * @brief Static callback function for GLFW framebuffer resize events.
+         * 
+         * Updates the viewport immediately, as it runs on the GL thread.
+         * 
+         * @param window The GLFW window that received the event.
+         * @param width The new framebuffer width in pixels.
+         * @param height The new framebuffer height in pixels.
+         */
+        static void sFramebufferSizeFunction(GLFWwindow* window, int width, int height);
+
+        /**
+         * @brief Timestamps an input event and routes it to the callbacks.
+         * 
+         * In pipelined mode the event is pushed to the input queue for the simulation
+         * thread; otherwise it is dispatched immediately.
+         * 
+         * @param event The event to route; its timestamp is filled in.
+         */
+        void QueueInput(InputEvent event);
+
+        /**
+         * @brief Invokes the keyboard and input callbacks for an event.
+         * @param event The event to dispatch.
+         */
+        void DispatchInput(const InputEvent& event);
+
+        /**
+         * @brief Runs the pipelined loop that renders packets from the simulation thread.
+         */
+        void RenderPipelined();
+
+        /**
+         * @brief Entry point of the simulation thread.
+         * 
+         * Delivers queued input events, calls the simulation function on a free
+         * packet and publishes it until the pipeline is stopped.
+         */
+        void SimulationLoop();
+
+        /**
+         * @brief Applies the frame pacer's swap interval to the window's context.
+         */
+        void ApplySwapInterval();
+
+        /**
+         * @brief Checks whether the render loop should stop.
+         * @return True if the window was closed or the frame limit was reached.
+         */
+        bool ShouldClose() const;
+
+        /**
+         * @brief Presents a finished frame and paces it.
+         * 
+         * Swaps buffers for visible windows; offscreen frames stay in the framebuffer.
+         */
+        void PresentFrame();
+
     private:
-        GLFWwindow*         m_window;           ///< Pointer to the GLFW window object.
+        static const size_t INPUT_QUEUE_CAPACITY = 1024; ///< Slots in the input event ring.
+        static const int    MAX_TICKS_PER_FRAME = 5;     ///< Catch-up limit that keeps slow frames from spiralling.
+
+    private:
+        GLFWwindow*         m_window = nullptr; ///< Pointer to the GLFW window object.
         RenderFunction      m_renderFunction;   ///< Callback function for rendering.
         KeyboardFunction    m_keyboardFunction; ///< Callback function for keyboard events.
         CloseFunction       m_closeFunction;    ///< Callback function for window close events.
+
+        SimulationFunction          m_simulationFunction;  ///< Callback filling frame packets on the simulation thread.
+        FrameRenderFunction         m_frameRenderFunction; ///< Callback rendering frame packets on the GL thread.
+        unique_ptr<FramePipeline>   m_pipeline;            ///< Packet queue between simulation and GL threads.
+        thread                      m_simulationThread;    ///< Thread running SimulationLoop.
+        InputFunction               m_inputFunction;       ///< Callback function for all input events.
+        SpscRing<InputEvent, INPUT_QUEUE_CAPACITY> m_inputQueue; ///< Events from the GL thread to the simulation thread.
+        atomic<size_t>              m_droppedInputEvents{0}; ///< Events lost to a full input queue.
+        RollingStats                m_inputLatency;        ///< Input-to-present latency in milliseconds.
+        TickFunction                m_tickFunction;        ///< Fixed-timestep update callback.
+        double                      m_tickSeconds = 1.0 / 60.0; ///< Duration of one simulation tick.
+        FramePacer                  m_framePacer;          ///< Presentation mode and frame-time statistics.
+        bool                        m_headless = false;    ///< Whether rendering goes to m_frameBuffer.
+        FrameBuffer                 m_frameBuffer;         ///< Offscreen render target in headless mode.
+        uint64_t                    m_frameLimit = 0;      ///< Frames to render before stopping, 0 for no limit.
+        uint64_t                    m_renderedFrames = 0;  ///< Frames presented so far.
+
+        /**
+         * @enum InputMode
+         * @brief Source of the input applied by the simulation thread.
+         */
+        enum class InputMode
+        {
+            Live,   ///< Events from the window.
+            Record, ///< Events from the window, also stored in m_inputRecording.
+            Replay  ///< Events from m_inputRecording; window input is ignored.
+        };
+
+        InputMode                   m_inputMode = InputMode::Live; ///< Current input source.
+        InputRecording              m_inputRecording;      ///< Session being recorded or replayed.
+        size_t                      m_replayCursor = 0;    ///< Next recorded event to apply.
+        int64_t                     m_recordStart = 0;     ///< Start time of the recording in steady_clock ns.
+        vector<double>              m_frameTimeLog;        ///< Per-frame times during a replay.
+        int64_t                     m_lastPresentTime = 0; ///< Time of the previous present in steady_clock ns.
     };
 }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @file InputEvents.hpp
+ * @brief Defines the timestamped input events delivered by GLWindow.
+ */
+
+namespace graf
+{
+    /**
+     * @enum InputEventType
+     * @brief Enumerates the kinds of input events.
+     */
+    enum class InputEventType : uint8_t
+    {
+        Key,         ///< A keyboard key was pressed, repeated or released.
+        MouseButton, ///< A mouse button was pressed or released.
+        CursorMove,  ///< The cursor moved within the window.
+        Resize       ///< The framebuffer was resized.
+    };
+
+    /**
+     * @struct InputEvent
+     * @brief A single input event with the time it was received.
+     * 
+     * Only the fields relevant to the event type are meaningful: key, scancode,
+     * action and mods for keys; button (in key), action, mods, x and y for mouse
+     * buttons; x and y for cursor moves; width and height for resizes.
+     */
+    struct InputEvent
+    {
+        InputEventType type = InputEventType::Key; ///< Kind of event.
+        int     key      = 0;   ///< Keyboard key or mouse button.
+        int     scancode = 0;   ///< System-specific scancode of the key.
+        int     action   = 0;   ///< GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT.
+        int     mods     = 0;   ///< Bit field of modifier keys.
+        double  x        = 0.0; ///< Cursor x position in screen coordinates.
+        double  y        = 0.0; ///< Cursor y position in screen coordinates.
+        int     width    = 0;   ///< New framebuffer width in pixels.
+        int     height   = 0;   ///< New framebuffer height in pixels.
+        int64_t timestamp = 0;  ///< Receive time in steady_clock nanoseconds.
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "InputEvents.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file InputRecording.hpp
+ * @brief Defines the InputRecording class for recording and replaying input sessions.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @struct RecordedInputEvent
+     * @brief An input event together with the point of the simulation it was applied at.
+     */
+    struct RecordedInputEvent
+    {
+        uint64_t    tick = 0;   ///< Number of simulation ticks completed before the event was applied.
+        uint64_t    frame = 0;  ///< Index of the frame packet the event was applied to.
+        InputEvent  event;      ///< The event; its timestamp is relative to the start of the recording.
+    };
+
+    /**
+     * @class InputRecording
+     * @brief A recorded input session that can be replayed deterministically.
+     *
+     * Besides the events it stores everything else a replay needs to reproduce the
+     * simulation: the tick rate, the total number of ticks and the seed of the
+     * application's random number generator. Files are a small binary header
+     * followed by fixed-size event records in host byte order (little-endian on
+     * all supported platforms).
+     */
+    class InputRecording
+    {
+    public:
+        /**
+         * @brief Writes the recording to a file.
+         * @param fileName Path of the file to write.
+         * @exception GrafException Thrown if the file cannot be written.
+         */
+        void Save(const string& fileName) const;
+
+        /**
+         * @brief Reads a recording from a file.
+         * @param fileName Path of the file to read.
+         * @return The recording.
+         * @exception GrafException Thrown if the file is missing, truncated or not a recording.
+         */
+        static InputRecording Load(const string& fileName);
+
+    public:
+        double                      tickRate = 60.0;    ///< Simulation ticks per second.
+        uint64_t                    seed = 0;           ///< Seed of the application's random number generator.
+        uint64_t                    tickCount = 0;      ///< Ticks simulated during the recording.
+        vector<RecordedInputEvent>  events;             ///< Events in the order they were applied.
+    };
+}
@@ -0,0 +1,361 @@
+#pragma once
+
+#include "RingDeque.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file JobSystem.hpp
+ * @brief Defines the JobSystem class, a work-stealing task scheduler.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @brief Alias for a unit of work executed by the job system.
+     */
+    using Job = function<void()>;
+
+    /**
+     * @class RangeFunctionRef
+     * @brief A non-owning reference to the body of a parallel-for loop.
+     *
+     * Called with a half-open index range [begin, end) to process. Unlike a
+     * std::function it never allocates; the referenced callable must outlive
+     * every call, which ParallelFor guarantees by waiting for all chunks.
+     */
+    class RangeFunctionRef
+    {
+    public:
+        /**
+         * @brief Refers to a callable taking (size_t begin, size_t end).
+         * @param function The callable; typically a lambda passed straight to ParallelFor.
+         */
+        template <typename Function, typename = enable_if_t<!is_same<decay_t<Function>, RangeFunctionRef>::value>>
+        RangeFunctionRef(Function&& function)
+            : m_callable(const_cast<void*>(static_cast<const void*>(std::addressof(function))))
+            , m_invoke(&Invoke<remove_reference_t<Function>>)
+        {
+        }
+
+        /**
+         * @brief Calls the referenced callable.
+         * @param begin First index of the range.
+         * @param end One past the last index of the range.
+         */
+        void operator()(size_t begin, size_t end) const { m_invoke(m_callable, begin, end); }
+
+    private:
+        /**
+         * @brief Calls a callable of a known type through its erased address.
+         * @param callable Address of the callable.
+         * @param begin First index of the range.
+         * @param end One past the last index of the range.
+         */
+        template <typename Function>
+        static void Invoke(void* callable, size_t begin, size_t end)
+        {
+            (*static_cast<Function*>(callable))(begin, end);
+        }
+
+        void* m_callable;                        ///< Address of the referenced callable.
+        void (*m_invoke)(void*, size_t, size_t); ///< Calls it with its real type.
+    };
+
+    /**
+     * @struct JobNode
+     * @brief Internal bookkeeping for a scheduled job.
+     *
+     * Tracks the number of unfinished dependencies and the jobs that continue
+     * after this one. Only the JobSystem touches its members.
+     */
+    struct JobNode
+    {
+        Job                         job;                      ///< The work to execute.
+        bool                        mainThread = false;       ///< Whether the job must run on the main thread.
+        atomic<int>                 pendingDependencies{1};   ///< Unfinished dependencies plus a scheduling guard.
+        atomic<bool>                finished{false};          ///< Set once the job has run.
+        mutex                       continuationMutex;        ///< Guards continuations and the finished transition.
+        vector<shared_ptr<JobNode>> continuations;            ///< Jobs waiting on this one.
+    };
+
+    /**
+     * @class JobHandle
+     * @brief A lightweight reference to a scheduled job.
+     *
+     * Handles can be waited on and passed as dependencies of later jobs.
+     */
+    class JobHandle
+    {
+    public:
+        JobHandle() = default;
+
+        /**
+         * @brief Checks whether the handle refers to a job.
+         * @return True if the handle was returned by the job system.
+         */
+        bool IsValid() const { return m_node != nullptr; }
+
+        /**
+         * @brief Checks whether the referenced job has finished.
+         * @return True if the job has run or the handle is empty.
+         */
+        bool IsDone() const { return !m_node || m_node->finished.load(memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+        explicit JobHandle(shared_ptr<JobNode> node) : m_node(std::move(node)) {}
+
+        shared_ptr<JobNode> m_node; ///< The referenced job.
+    };
+
+    /**
+     * @class JobSystem
+     * @brief A work-stealing task scheduler with a main-thread-affine queue.
+     *
+     * Each worker thread owns a deque: it pushes and pops its own jobs at the back
+     * and steals from the front of the other workers' deques when it runs dry.
+     * Jobs may depend on other jobs and only become runnable once all of their
+     * dependencies have finished. Jobs flagged for the main thread (typically GL
+     * work) are queued separately and executed by RunMainThreadJobs or while the
+     * main thread waits. The thread that constructs the job system is the main thread.
+     */
+    class JobSystem
+    {
+    public:
+        /**
+         * @brief Starts the worker threads.
+         * @param workerCount Number of worker threads; 0 uses one less than the hardware
+         *        thread count. At least one worker is always started.
+         */
+        explicit JobSystem(unsigned int workerCount = 0);
+
+        /**
+         * @brief Stops and joins all worker threads.
+         *
+         * Jobs still queued are discarded.
+         */
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        /**
+         * @brief Schedules a job on the worker threads.
+         * @param job The work to execute.
+         * @param dependencies Jobs that must finish before this one starts.
+         * @return A handle to the scheduled job.
+         */
+        JobHandle Schedule(Job job, const vector<JobHandle>& dependencies = {});
+
+        /**
+         * @brief Schedules a job that must run on the main thread.
+         * @param job The work to execute (e.g., OpenGL calls).
+         * @param dependencies Jobs that must finish before this one starts.
+         * @return A handle to the scheduled job.
+         */
+        JobHandle ScheduleOnMainThread(Job job, const vector<JobHandle>& dependencies = {});
+
+        /**
+         * @brief Schedules a continuation that runs after another job.
+         * @param parent The job to continue from.
+         * @param job The work to execute once the parent has finished.
+         * @return A handle to the continuation.
+         */
+        JobHandle Then(const JobHandle& parent, Job job);
+
+        /**
+         * @brief Blocks until a job has finished.
+         *
+         * The calling thread executes other runnable jobs while waiting. On the main
+         * thread this includes main-thread jobs, so waiting on GL work cannot deadlock.
+         *
+         * @param handle The job to wait for.
+         */
+        void Wait(const JobHandle& handle);
+
+        /**
+         * @brief Blocks until all of the given jobs have finished.
+         * @param handles The jobs to wait for.
+         */
+        void WaitAll(const vector<JobHandle>& handles);
+
+        /**
+         * @brief Processes an index range in parallel and waits for completion.
+         *
+         * Splits [begin, end) into chunks of at most grainSize indices and runs
+         * them across the workers and the calling thread. Always waits for every
+         * chunk, even if one throws. Once the chunk node pool has warmed up a call
+         * does not touch the heap.
+         *
+         * @param begin First index of the range.
+         * @param end One past the last index of the range.
+         * @param grainSize Maximum number of indices per chunk (at least 1).
+         * @param body Function called once per chunk with its sub-range.
+         * @exception std::exception The first exception thrown by a chunk, rethrown once all chunks have finished.
+         */
+        void ParallelFor(size_t begin, size_t end, size_t grainSize, RangeFunctionRef body);
+
+        /**
+         * @brief Runs all queued main-thread jobs.
+         *
+         * Must be called from the main thread, typically once per frame.
+         */
+        void RunMainThreadJobs();
+
+        /**
+         * @brief Gets the number of worker threads.
+         * @return The worker count (not including the main thread).
+         */
+        unsigned int GetWorkerCount() const;
+
+    private:
+        /**
+         * @struct WorkerQueue
+         * @brief A worker's job deque guarded by its own lock.
+         */
+        struct WorkerQueue
+        {
+            mutex                           queueMutex; ///< Guards jobs.
+            RingDeque<shared_ptr<JobNode>>  jobs;       ///< Runnable jobs owned by the worker.
+        };
+
+        /**
+         * @struct NodePool
+         * @brief Free list recycling the memory of parallel-for chunk nodes.
+         *
+         * Blocks are carved from slabs, so the pool grows in steps of many nodes
+         * and rarely allocates even when timing raises the number of nodes in
+         * flight. Chunk nodes never escape ParallelFor, so they are all released
+         * before the job system is destroyed, which frees the slabs.
+         */
+        struct NodePool
+        {
+            NodePool() = default;
+            NodePool(const NodePool&) = delete;
+            NodePool& operator=(const NodePool&) = delete;
+
+            /**
+             * @brief Frees all slabs.
+             */
+            ~NodePool();
+
+            /**
+             * @brief Takes a released block, carving a new slab if the list is empty.
+             * @param bytes Size of the block.
+             * @return The block.
+             */
+            void* Allocate(size_t bytes);
+
+            /**
+             * @brief Puts a block back on the free list.
+             * @param block The block.
+             * @param bytes Size of the block.
+             */
+            void Deallocate(void* block, size_t bytes);
+
+            /**
+             * @struct FreeBlock
+             * @brief A released block, linked through its own storage.
+             */
+            struct FreeBlock
+            {
+                FreeBlock* next; ///< The next released block.
+            };
+
+            static const size_t BLOCKS_PER_SLAB = 64; ///< Blocks carved from one allocation.
+
+            mutex           poolMutex;          ///< Guards everything below.
+            FreeBlock*      freeList = nullptr; ///< Released blocks of blockSize bytes.
+            size_t          blockSize = 0;      ///< Size of a node with its shared_ptr control block.
+            size_t          blockStride = 0;    ///< blockSize rounded up to the strictest alignment.
+            vector<void*>   slabs;              ///< Allocations the blocks are carved from.
+        };
+
+        /**
+         * @brief Creates a node and registers it with its dependencies.
+         * @param job The work to execute.
+         * @param dependencies Jobs that must finish first.
+         * @param mainThread Whether the job must run on the main thread.
+         * @return A handle to the scheduled job.
+         */
+        JobHandle ScheduleNode(Job job, const vector<JobHandle>& dependencies, bool mainThread);
+
+        /**
+         * @brief Enqueues a parallel-for chunk in a node from the chunk node pool.
+         * @param job The chunk's work; small enough to be stored inside the std::function.
+         */
+        void ScheduleChunk(Job job);
+
+        /**
+         * @class ChunkNodeAllocator
+         * @brief Allocator placing chunk nodes in the chunk node pool; defined in JobSystem.cpp.
+         */
+        template <typename T>
+        class ChunkNodeAllocator;
+
+        /**
+         * @brief Makes a job runnable by pushing it to the proper queue.
+         * @param node The job whose dependencies are all satisfied.
+         */
+        void Enqueue(shared_ptr<JobNode> node);
+
+        /**
+         * @brief Executes a job and releases its continuations.
+         * @param node The job to execute.
+         */
+        void Execute(const shared_ptr<JobNode>& node);
+
+        /**
+         * @brief Tries to take one runnable worker job.
+         *
+         * Pops from the back of the own deque first, then steals from the front of
+         * the other deques.
+         *
+         * @param workerIndex Index of the calling worker, or -1 for other threads.
+         * @return The job, or nullptr if no job was found.
+         */
+        shared_ptr<JobNode> TryPop(int workerIndex);
+
+        /**
+         * @brief Tries to run one queued main-thread job.
+         * @return True if a job was executed.
+         */
+        bool TryRunMainThreadJob();
+
+        /**
+         * @brief Runs one runnable job on behalf of a waiting thread, or yields if there is none.
+         *
+         * On the main thread main-thread jobs are preferred, so waiting on GL work cannot deadlock.
+         */
+        void HelpWhileWaiting();
+
+        /**
+         * @brief Main loop of a worker thread.
+         * @param workerIndex Index of the worker.
+         */
+        void WorkerLoop(int workerIndex);
+
+    private:
+        vector<unique_ptr<WorkerQueue>> m_queues;              ///< One deque per worker.
+        vector<thread>                  m_workers;             ///< Worker threads.
+        RingDeque<shared_ptr<JobNode>>  m_mainThreadJobs;      ///< Jobs affine to the main thread.
+        mutex                           m_mainThreadMutex;     ///< Guards m_mainThreadJobs.
+        thread::id                      m_mainThreadId;        ///< Thread that constructed the job system.
+        atomic<size_t>                  m_pendingJobs{0};      ///< Runnable worker jobs not yet taken.
+        atomic<size_t>                  m_nextQueue{0};        ///< Round-robin target for external submissions.
+        atomic<bool>                    m_stopping{false};     ///< Set when the workers should exit.
+        mutex                           m_sleepMutex;          ///< Lock used by idle workers.
+        condition_variable              m_sleepCondition;      ///< Wakes idle workers when jobs arrive.
+        NodePool                        m_chunkNodePool;       ///< Recycled parallel-for chunk nodes.
+    };
+}
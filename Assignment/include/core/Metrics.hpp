@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file Metrics.hpp
+ * @brief Defines the metric types and the MetricsRegistry with Prometheus text export.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class MetricCounter
+     * @brief A monotonically increasing count, updated with one relaxed atomic add.
+     */
+    class MetricCounter
+    {
+    public:
+        /**
+         * @brief Adds to the counter.
+         * @param amount The increment.
+         */
+        void Increment(uint64_t amount = 1);
+
+        /**
+         * @brief Gets the current count.
+         * @return The count.
+         */
+        uint64_t getValue() const;
+
+    private:
+        atomic<uint64_t> m_value{0}; ///< Current count.
+    };
+
+    /**
+     * @class MetricGauge
+     * @brief A value that can go up and down.
+     */
+    class MetricGauge
+    {
+    public:
+        /**
+         * @brief Replaces the value.
+         * @param value The new value.
+         */
+        void Set(double value);
+
+        /**
+         * @brief Adds to the value.
+         * @param amount The change, negative to decrease.
+         */
+        void Add(double amount);
+
+        /**
+         * @brief Gets the current value.
+         * @return The value.
+         */
+        double getValue() const;
+
+    private:
+        atomic<double> m_value{0.0}; ///< Current value.
+    };
+
+    /**
+     * @class MetricHistogram
+     * @brief Counts observations in fixed buckets and keeps their sum.
+     *
+     * Buckets are stored per bucket rather than cumulatively, so an observation
+     * updates a single bucket; the export adds them up.
+     */
+    class MetricHistogram
+    {
+    public:
+        /**
+         * @brief Constructs a histogram.
+         * @param bounds Inclusive upper bounds of the buckets in increasing order; +Inf is implied.
+         */
+        explicit MetricHistogram(const vector<double>& bounds);
+
+        /**
+         * @brief Records an observation.
+         * @param value The observed value.
+         */
+        void Observe(double value);
+
+        /**
+         * @brief Gets the upper bounds of the buckets, without +Inf.
+         * @return The bounds.
+         */
+        const vector<double>& getBounds() const;
+
+        /**
+         * @brief Gets the number of observations in one bucket.
+         * @param bucket Bucket index; getBounds().size() is the +Inf bucket.
+         * @return The observations that fell into the bucket alone.
+         */
+        uint64_t getBucketCount(size_t bucket) const;
+
+        /**
+         * @brief Gets the sum of all observations.
+         * @return The sum.
+         */
+        double getSum() const;
+
+    private:
+        vector<double>                  m_bounds;   ///< Bucket upper bounds.
+        unique_ptr<atomic<uint64_t>[]>  m_buckets;  ///< Observations per bucket, plus +Inf.
+        atomic<double>                  m_sum{0.0}; ///< Sum of all observations.
+    };
+
+    /**
+     * @class MetricsRegistry
+     * @brief Process-wide registry of named metrics, exported in the Prometheus text format.
+     *
+     * Metrics live until the process ends, so call sites look them up once and keep
+     * the reference, typically in a function-local static. Updates are lock-free;
+     * only registration and export take the registry lock. Values that are already
+     * counted elsewhere can be registered as functions that are read at export time.
+     *
+     * Labels are given preformatted, e.g. `result="hit"`; the same name with
+     * different labels forms one metric family.
+     */
+    class MetricsRegistry
+    {
+    public:
+        /**
+         * @brief Gets or creates a counter.
+         * @param name Metric name, conventionally ending in _total.
+         * @param help Description exported with the metric.
+         * @param labels Preformatted label pairs, or empty.
+         * @return The counter.
+         * @exception GrafException Thrown if the name is registered with another type.
+         */
+        static MetricCounter& GetCounter(const string& name, const string& help, const string& labels = "");
+
+        /**
+         * @brief Gets or creates a gauge.
+         * @param name Metric name.
+         * @param help Description exported with the metric.
+         * @param labels Preformatted label pairs, or empty.
+         * @return The gauge.
+         * @exception GrafException Thrown if the name is registered with another type.
+         */
+        static MetricGauge& GetGauge(const string& name, const string& help, const string& labels = "");
+
+        /**
+         * @brief Gets or creates a histogram; the bounds of an existing histogram are kept.
+         * @param name Metric name.
+         * @param help Description exported with the metric.
+         * @param bounds Bucket upper bounds in increasing order.
+         * @param labels Preformatted label pairs, or empty.
+         * @return The histogram.
+         * @exception GrafException Thrown if the name is registered with another type.
+         */
+        static MetricHistogram& GetHistogram(const string& name, const string& help,
+                                             const vector<double>& bounds, const string& labels = "");
+
+        /**
+         * @brief Registers a counter whose value is read from a function at export time.
+         * @param name Metric name.
+         * @param help Description exported with the metric.
+         * @param labels Preformatted label pairs, or empty.
+         * @param read Returns the current count; called from the exporting thread.
+         * @exception GrafException Thrown if the name is registered with another type.
+         */
+        static void RegisterCounterFunction(const string& name, const string& help, const string& labels,
+                                            function<double()> read);
+
+        /**
+         * @brief Registers a gauge whose value is read from a function at export time.
+         * @param name Metric name.
+         * @param help Description exported with the metric.
+         * @param labels Preformatted label pairs, or empty.
+         * @param read Returns the current value; called from the exporting thread.
+         * @exception GrafException Thrown if the name is registered with another type.
+         */
+        static void RegisterGaugeFunction(const string& name, const string& help, const string& labels,
+                                          function<double()> read);
+
+        /**
+         * @brief Writes all metrics in the Prometheus text exposition format.
+         * @param out The output stream.
+         */
+        static void WriteText(ostream& out);
+
+        /**
+         * @brief Formats all metrics in the Prometheus text exposition format.
+         * @return The exposition text.
+         */
+        static string FormatText();
+
+        /**
+         * @brief Gets the standard bucket bounds for durations in seconds.
+         * @return Bounds from 0.5 ms to 10 s.
+         */
+        static const vector<double>& GetDurationBuckets();
+    };
+}
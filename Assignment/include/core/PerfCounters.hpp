@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file PerfCounters.hpp
+ * @brief Defines the PerfCounters class for reading hardware performance counters.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @enum PerfCounter
+     * @brief Hardware events that can be counted.
+     */
+    enum class PerfCounter
+    {
+        Cycles,         ///< CPU cycles.
+        Instructions,   ///< Retired instructions.
+        L1DMisses,      ///< Level 1 data cache read misses.
+        LLCMisses,      ///< Last level cache misses.
+        BranchMisses,   ///< Mispredicted branches.
+        Count           ///< Number of events.
+    };
+
+    const size_t   PERF_COUNTER_COUNT = static_cast<size_t>(PerfCounter::Count);   ///< Number of countable events.
+    const uint32_t PERF_COUNTERS_ALL = (1u << PERF_COUNTER_COUNT) - 1;              ///< Mask selecting every event.
+
+    /**
+     * @brief Gets the mask bit of an event.
+     * @param counter The event.
+     * @return The bit.
+     */
+    inline uint32_t PerfCounterBit(PerfCounter counter)
+    {
+        return 1u << static_cast<uint32_t>(counter);
+    }
+
+    /**
+     * @struct PerfCounterSample
+     * @brief Counter values read at one point, or the difference of two reads.
+     */
+    struct PerfCounterSample
+    {
+        uint64_t values[PERF_COUNTER_COUNT] = {};   ///< Count per event, indexed by PerfCounter.
+        uint32_t mask = 0;                          ///< Events with a valid value.
+
+        /**
+         * @brief Checks whether an event was counted.
+         * @param counter The event.
+         * @return True if its value is valid.
+         */
+        bool Has(PerfCounter counter) const { return (mask & PerfCounterBit(counter)) != 0; }
+
+        /**
+         * @brief Gets the value of an event.
+         * @param counter The event.
+         * @return The count, 0 if not counted.
+         */
+        uint64_t Get(PerfCounter counter) const { return values[static_cast<size_t>(counter)]; }
+
+        /**
+         * @brief Gets the instructions per cycle.
+         * @return The ratio, 0 unless both events were counted.
+         */
+        double GetIpc() const
+        {
+            return Has(PerfCounter::Cycles) && Has(PerfCounter::Instructions) && Get(PerfCounter::Cycles) > 0
+                ? static_cast<double>(Get(PerfCounter::Instructions)) / static_cast<double>(Get(PerfCounter::Cycles))
+                : 0.0;
+        }
+    };
+
+    /**
+     * @brief Gets the events counted between two reads.
+     * @param end The later read.
+     * @param start The earlier read.
+     * @return The differences of the events valid in both reads.
+     */
+    PerfCounterSample operator-(const PerfCounterSample& end, const PerfCounterSample& start);
+
+    /**
+     * @class PerfCounters
+     * @brief A group of hardware counters of the calling thread, read with one system call.
+     *
+     * Uses Linux perf_event_open, counting user space only so the default
+     * perf_event_paranoid setting allows it. Events the processor or kernel does
+     * not support are left out; when none can be opened, for example in a container
+     * or a virtual machine without a PMU, Open returns false and GetError says why,
+     * so callers can carry on with timing alone. If the kernel multiplexes the
+     * group, the values are scaled to the full enabled time. On other platforms
+     * nothing can be opened.
+     */
+    class PerfCounters
+    {
+    public:
+        PerfCounters() = default;
+
+        /**
+         * @brief Closes the counters.
+         */
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        /**
+         * @brief Opens counters of the calling thread, stopped and at zero.
+         *
+         * Closes counters opened before. Events that cannot be opened, or that
+         * make the group too large to be scheduled, are dropped.
+         *
+         * @param counters Mask of the wanted events.
+         * @return True if at least one event is counted.
+         */
+        bool Open(uint32_t counters = PERF_COUNTERS_ALL);
+
+        /**
+         * @brief Closes the counters.
+         */
+        void Close();
+
+        /**
+         * @brief Checks whether any event is counted.
+         * @return True after a successful Open.
+         */
+        bool IsOpen() const;
+
+        /**
+         * @brief Gets the events that could be opened.
+         * @return The mask.
+         */
+        uint32_t GetOpenCounters() const;
+
+        /**
+         * @brief Gets why the wanted events could not all be opened.
+         * @return The reason, empty if all were opened.
+         */
+        const string& GetError() const;
+
+        /**
+         * @brief Sets all counters to zero.
+         */
+        void Reset();
+
+        /**
+         * @brief Starts counting.
+         */
+        void Start();
+
+        /**
+         * @brief Stops counting; the values are kept.
+         */
+        void Stop();
+
+        /**
+         * @brief Reads all counters at once.
+         * @param sample Receives the values.
+         * @return False if nothing is open or the group has not been scheduled yet.
+         */
+        bool Read(PerfCounterSample& sample) const;
+
+        /**
+         * @brief Gets the name of an event as used on command lines and in reports.
+         * @param counter The event.
+         * @return The name, e.g. "llc_misses".
+         */
+        static const char* GetCounterName(PerfCounter counter);
+
+        /**
+         * @brief Parses a comma-separated list of event names, or "all".
+         * @param list The list, e.g. "cycles,instructions".
+         * @return The mask of the events.
+         * @exception std::invalid_argument Thrown for an unknown name.
+         */
+        static uint32_t ParseCounterList(const string& list);
+
+        /**
+         * @brief Formats the names of the events in a mask.
+         * @param counters The mask.
+         * @return The comma-separated names.
+         */
+        static string FormatCounterList(uint32_t counters);
+
+    private:
+        /**
+         * @brief Opens a group of events, the first one leading.
+         * @param counters The events in order.
+         * @return The number opened; on failure of the leader 0 and m_error is set.
+         */
+        size_t OpenGroup(const vector<PerfCounter>& counters);
+
+        /**
+         * @brief Checks that the open group gets scheduled on the PMU.
+         * @return True if it counted while enabled.
+         */
+        bool ProbeGroup();
+
+    private:
+        vector<int>         m_fds;          ///< File descriptors, the group leader first.
+        vector<PerfCounter> m_counters;     ///< Event of each descriptor.
+        uint32_t            m_mask = 0;     ///< Open events.
+        string              m_error;        ///< Why wanted events are missing.
+    };
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "PerfCounters.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * @file Profiler.hpp
+ * @brief Defines the Profiler class and the scoped zone macros for CPU instrumentation.
+ *
+ * Zones are only recorded when GRAF_ENABLE_PROFILER is defined, which the build
+ * does for every configuration except Release. Otherwise the macros expand to
+ * nothing and instrumented code pays no cost.
+ */
+
+#define GRAF_PROFILE_CONCAT_INNER(a, b) a##b
+#define GRAF_PROFILE_CONCAT(a, b) GRAF_PROFILE_CONCAT_INNER(a, b)
+
+#ifdef GRAF_ENABLE_PROFILER
+/// Records the enclosing scope as a zone; name must be a string with static lifetime.
+#define GRAF_PROFILE_SCOPE(name) graf::ProfileZone GRAF_PROFILE_CONCAT(grafProfileZone, __LINE__)(name)
+/// Records the enclosing function as a zone.
+#define GRAF_PROFILE_FUNCTION() GRAF_PROFILE_SCOPE(__func__)
+/// Names the calling thread in exported traces.
+#define GRAF_PROFILE_THREAD(name) graf::Profiler::SetThreadName(name)
+#else
+#define GRAF_PROFILE_SCOPE(name) ((void)0)
+#define GRAF_PROFILE_FUNCTION() ((void)0)
+#define GRAF_PROFILE_THREAD(name) ((void)0)
+#endif
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class Profiler
+     * @brief Collects scoped CPU zones from all threads and exports them as a Chrome trace.
+     *
+     * Every thread writes its finished zones into its own lock-free ring, so recording
+     * a zone never takes a lock or allocates. Collect drains the rings into the trace
+     * and should be called regularly (GLWindow does so once per frame); zones that
+     * do not fit into a full ring are dropped and counted. Timestamps come from the
+     * time stamp counter on x86 and from steady_clock elsewhere.
+     */
+    class Profiler
+    {
+    public:
+        /**
+         * @brief Checks whether zones are recorded in this build.
+         * @return True if GRAF_ENABLE_PROFILER was defined.
+         */
+        static bool IsEnabled();
+
+        /**
+         * @brief Reads the profiler clock.
+         * @return The current time in clock ticks.
+         */
+        static uint64_t Now();
+
+        /**
+         * @brief Stores a finished zone in the calling thread's ring.
+         * @param name Zone name with static lifetime.
+         * @param start Start time in clock ticks.
+         * @param end End time in clock ticks.
+         */
+        static void RecordZone(const char* name, uint64_t start, uint64_t end);
+
+        /**
+         * @brief Stores a finished zone with the hardware events counted during it.
+         * @param name Zone name with static lifetime.
+         * @param start Start time in clock ticks.
+         * @param end End time in clock ticks.
+         * @param startCounters The calling thread's counters read at the start.
+         */
+        static void RecordZone(const char* name, uint64_t start, uint64_t end, const PerfCounterSample& startCounters);
+
+        /**
+         * @brief Counts hardware events in every zone recorded from now on.
+         *
+         * Each thread opens its own counters at its first counted zone; reading
+         * them costs a system call at both ends of a zone, so this is meant for
+         * targeted runs. Counting stays off if the calling thread cannot open any
+         * of the events.
+         *
+         * @param counters Mask of the events, 0 to stop counting.
+         * @param error Receives why counting is off or which events are missing.
+         * @return True if zones are counted.
+         */
+        static bool SetZoneCounters(uint32_t counters, string& error);
+
+        /**
+         * @brief Checks whether zones count hardware events.
+         * @return True after a successful SetZoneCounters.
+         */
+        static bool IsCountingZones();
+
+        /**
+         * @brief Reads the calling thread's zone counters, opening them on first use.
+         * @param sample Receives the values.
+         * @return False if the thread's counters cannot be read.
+         */
+        static bool ReadZoneCounters(PerfCounterSample& sample);
+
+        /**
+         * @brief Names the calling thread in exported traces.
+         * @param name The thread name.
+         */
+        static void SetThreadName(const string& name);
+
+        /**
+         * @brief Adds a timeline that is not tied to a thread, such as the GPU.
+         * @param name The name shown in the trace.
+         * @return Id of the track for RecordTrackZone.
+         */
+        static uint32_t RegisterTrack(const string& name);
+
+        /**
+         * @brief Adds a zone measured elsewhere to a track.
+         * 
+         * Unlike RecordZone this takes a lock, so it suits batches delivered once a frame.
+         * 
+         * @param track Id returned by RegisterTrack.
+         * @param name Zone name with static lifetime.
+         * @param start Start time in clock ticks.
+         * @param end End time in clock ticks.
+         */
+        static void RecordTrackZone(uint32_t track, const char* name, uint64_t start, uint64_t end);
+
+        /**
+         * @brief Gets the rate of the profiler clock, measured since its first use.
+         * @return Clock ticks per microsecond.
+         */
+        static double GetTicksPerMicrosecond();
+
+        /**
+         * @brief Chooses whether collected zones are kept for WriteChromeTrace.
+         *
+         * When they are not, each collect drops the zones the previous one delivered,
+         * so the trace stops growing; SumZoneTimes still sees every zone once per frame.
+         *
+         * @param keep True to keep every zone (the default).
+         */
+        static void SetKeepTrace(bool keep);
+
+        /**
+         * @brief Moves the zones of all threads from their rings into the trace.
+         */
+        static void Collect();
+
+        /**
+         * @brief Collects outstanding zones and writes the trace in Chrome trace event format.
+         *
+         * The file opens in chrome://tracing and in Perfetto.
+         *
+         * @param fileName Path of the JSON file to write.
+         * @exception GrafException Thrown if the file cannot be written.
+         */
+        static void WriteChromeTrace(const string& fileName);
+
+        /**
+         * @brief Discards all collected zones.
+         */
+        static void Clear();
+
+        /**
+         * @brief Sums the durations of collected zones by name.
+         * @param firstZone Index of the first collected zone to include.
+         * @param totals Receives the milliseconds per zone name (added to existing values).
+         * @return The index past the last collected zone, to pass as firstZone next time.
+         */
+        static size_t SumZoneTimes(size_t firstZone, map<string, double>& totals);
+
+        /**
+         * @brief Gets the number of zones collected into the trace.
+         * @return The zone count, including zones dropped because the trace is not kept.
+         */
+        static size_t GetZoneCount();
+
+        /**
+         * @brief Gets the number of zones lost because a ring or the trace was full.
+         * @return The dropped zone count.
+         */
+        static uint64_t GetDroppedZones();
+    };
+
+    /**
+     * @class ProfileZone
+     * @brief Records the lifetime of a scope as a profiler zone; use GRAF_PROFILE_SCOPE.
+     */
+    class ProfileZone
+    {
+    public:
+        /**
+         * @brief Starts the zone, reading the counters first if zones are counted.
+         * @param name Zone name with static lifetime.
+         */
+        explicit ProfileZone(const char* name)
+            : m_name(name), m_counted(Profiler::IsCountingZones() && Profiler::ReadZoneCounters(m_counters)),
+              m_start(Profiler::Now())
+        {
+        }
+
+        /**
+         * @brief Ends the zone and records it.
+         */
+        ~ProfileZone()
+        {
+            if (m_counted)
+                Profiler::RecordZone(m_name, m_start, Profiler::Now(), m_counters);
+            else
+                Profiler::RecordZone(m_name, m_start, Profiler::Now());
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        const char*         m_name;     ///< Zone name.
+        PerfCounterSample   m_counters; ///< Counters at the start, if counted.
+        bool                m_counted;  ///< Whether the start counters were read.
+        uint64_t            m_start;    ///< Start time in clock ticks.
+    };
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @file RingDeque.hpp
+ * @brief Defines the RingDeque class, a double-ended queue over a growable ring buffer.
+ */
+
+namespace graf
+{
+    /**
+     * @class RingDeque
+     * @brief A double-ended queue that reuses its storage instead of allocating per block.
+     *
+     * std::deque allocates a new block whenever its contents drift past a block
+     * boundary and frees the emptied one, so a queue that is pushed at one end and
+     * popped at the other allocates at a steady rate. This ring only grows, doubling
+     * when full, and never shrinks, so once it has reached its high-water mark no
+     * operation touches the heap. It is not synchronized.
+     *
+     * @tparam T The element type (moved in and out).
+     */
+    template <typename T>
+    class RingDeque
+    {
+    public:
+        /**
+         * @brief Constructs a ring with room for a number of elements.
+         * @param capacity Elements that fit before the first growth; rounded up to a power of two.
+         */
+        explicit RingDeque(size_t capacity = 0)
+        {
+            Reserve(capacity);
+        }
+
+        /**
+         * @brief Makes room for a number of elements, so they can be queued without allocating.
+         * @param capacity Elements that must fit; rounded up to a power of two.
+         */
+        void Reserve(size_t capacity)
+        {
+            if (capacity > m_slots.size())
+                Grow(capacity);
+        }
+
+        /**
+         * @brief Checks whether the ring is empty.
+         * @return True if no element is queued.
+         */
+        bool IsEmpty() const
+        {
+            return m_count == 0;
+        }
+
+        /**
+         * @brief Gets the number of queued elements.
+         * @return The element count.
+         */
+        size_t GetSize() const
+        {
+            return m_count;
+        }
+
+        /**
+         * @brief Appends an element at the back, growing the ring if it is full.
+         * @param value The element to append.
+         */
+        void PushBack(T value)
+        {
+            if (m_count == m_slots.size())
+                Grow(m_count + 1);
+
+            m_slots[(m_head + m_count) & (m_slots.size() - 1)] = std::move(value);
+            ++m_count;
+        }
+
+        /**
+         * @brief Removes the front element. The ring must not be empty.
+         * @return The element.
+         */
+        T PopFront()
+        {
+            T value = std::move(m_slots[m_head]);
+            m_head = (m_head + 1) & (m_slots.size() - 1);
+            --m_count;
+            return value;
+        }
+
+        /**
+         * @brief Removes the back element. The ring must not be empty.
+         * @return The element.
+         */
+        T PopBack()
+        {
+            --m_count;
+            return std::move(m_slots[(m_head + m_count) & (m_slots.size() - 1)]);
+        }
+
+    private:
+        /**
+         * @brief Moves the elements into storage of at least the given size, oldest first.
+         * @param minCapacity Elements the new storage must hold.
+         */
+        void Grow(size_t minCapacity)
+        {
+            size_t capacity = 16;
+            while (capacity < minCapacity)
+                capacity *= 2;
+
+            std::vector<T> slots(capacity);
+            for (size_t i = 0; i < m_count; ++i)
+                slots[i] = std::move(m_slots[(m_head + i) & (m_slots.size() - 1)]);
+
+            m_slots.swap(slots);
+            m_head = 0;
+        }
+
+        std::vector<T> m_slots;   ///< Element storage; its size is a power of two.
+        size_t         m_head = 0;  ///< Slot of the front element.
+        size_t         m_count = 0; ///< Number of queued elements.
+    };
+}
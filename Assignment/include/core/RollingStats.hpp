@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file RollingStats.hpp
+ * @brief Defines the RollingStats class for summarizing recent timing samples.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class RollingStats
+     * @brief Keeps the most recent samples of a measurement and summarizes them.
+     * 
+     * Statistics are computed over a fixed-size window of the latest samples, while
+     * the total sample count covers the whole run. Not thread-safe; each instance
+     * should be fed and read by a single thread.
+     */
+    class RollingStats
+    {
+    public:
+        /**
+         * @brief Constructs an empty statistics window.
+         * @param windowSize Maximum number of recent samples kept (at least 1).
+         */
+        explicit RollingStats(size_t windowSize = 1024);
+
+        /**
+         * @brief Adds a sample, evicting the oldest one when the window is full.
+         * @param value The sample value (e.g., milliseconds).
+         */
+        void AddSample(double value);
+
+        /**
+         * @brief Removes all samples and resets the total count.
+         */
+        void Clear();
+
+        /**
+         * @brief Gets the number of samples added since construction or Clear.
+         * @return The total sample count.
+         */
+        size_t getTotalCount() const;
+
+        /**
+         * @brief Gets the number of samples currently in the window.
+         * @return The window sample count.
+         */
+        size_t getCount() const;
+
+        /**
+         * @brief Gets the mean of the window.
+         * @return The mean, or 0 if empty.
+         */
+        double getMean() const;
+
+        /**
+         * @brief Gets the population variance of the window.
+         * @return The variance, or 0 if empty.
+         */
+        double getVariance() const;
+
+        /**
+         * @brief Gets the largest sample in the window.
+         * @return The maximum, or 0 if empty.
+         */
+        double getMax() const;
+
+        /**
+         * @brief Gets a percentile of the window using the nearest-rank method.
+         * @param percentile The percentile in [0, 100].
+         * @return The percentile value, or 0 if empty.
+         */
+        double getPercentile(double percentile) const;
+
+        /**
+         * @brief Gets the most recently added sample.
+         * @return The latest sample, or 0 if empty.
+         */
+        double getLatest() const;
+
+    private:
+        vector<double>          m_samples;      ///< Ring of the most recent samples.
+        size_t                  m_windowSize;   ///< Capacity of the ring.
+        size_t                  m_next = 0;     ///< Slot that receives the next sample.
+        size_t                  m_total = 0;    ///< Samples added in total.
+        mutable vector<double>  m_sorted;       ///< Scratch storage for percentile queries.
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @file SpscRing.hpp
+ * @brief Defines the SpscRing class, a lock-free single-producer single-consumer queue.
+ */
+
+namespace graf
+{
+    /**
+     * @class SpscRing
+     * @brief A fixed-capacity lock-free ring buffer for one producer and one consumer thread.
+     * 
+     * The producer only writes the tail index and the consumer only writes the head
+     * index, so neither side ever blocks. The indices live on separate cache lines to
+     * avoid false sharing between the two threads.
+     * 
+     * @tparam T The element type (copied in and out).
+     * @tparam Capacity The number of slots; must be a power of two.
+     */
+    template <typename T, size_t Capacity>
+    class SpscRing
+    {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscRing capacity must be a power of two");
+
+    public:
+        /**
+         * @brief Appends an element. Must only be called from the producer thread.
+         * @param value The element to append.
+         * @return False if the ring is full and the element was dropped.
+         */
+        bool TryPush(const T& value)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+                return false; ///< Full
+
+            m_slots[tail & (Capacity - 1)] = value;
+            m_tail.store(tail + 1, std::memory_order_release); ///< Publish the slot to the consumer
+            return true;
+        }
+
+        /**
+         * @brief Removes the oldest element. Must only be called from the consumer thread.
+         * @param value Receives the element.
+         * @return False if the ring is empty.
+         */
+        bool TryPop(T& value)
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (head == m_tail.load(std::memory_order_acquire))
+                return false; ///< Empty
+
+            value = m_slots[head & (Capacity - 1)];
+            m_head.store(head + 1, std::memory_order_release); ///< Hand the slot back to the producer
+            return true;
+        }
+
+        /**
+         * @brief Checks whether the ring is empty (approximate while the producer is active).
+         * @return True if no element is queued.
+         */
+        bool IsEmpty() const
+        {
+            return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+        }
+
+    private:
+        alignas(64) std::atomic<size_t> m_head{0}; ///< Next slot to read; written by the consumer.
+        alignas(64) std::atomic<size_t> m_tail{0}; ///< Next slot to write; written by the producer.
+        alignas(64) T m_slots[Capacity];           ///< Element storage.
+    };
+}
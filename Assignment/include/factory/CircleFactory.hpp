@@ -29,11 +29,11 @@ namespace graf
         explicit CircleFactory(int anglesInDegrees);
 
         /**
-         * @brief Creates a vertex array object representing a circle.
-         * @return A shared pointer to the VertexArrayObject containing the circle geometry.
-         * @exception BufferException Thrown if VAO creation fails due to invalid data.
+         * @brief Generates the vertex and index data of a circle.
+         * @param vertices The vertex list to fill (replaced).
+         * @param indices The index list to fill (replaced).
          */
-        std::shared_ptr<VertexArrayObject> createShape() override;
+        void generateMesh(VertexList& vertices, IndexList& indices) override;
 
     private:
         int m_angles; ///< The angle step (in degrees) used to approximate the circle.
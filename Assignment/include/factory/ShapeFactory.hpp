@@ -2,10 +2,10 @@
 
 #include <memory>
 #include <vector>
-#include "vertexarrayobject.hpp"
-#include "vertexbuffer.hpp"
-#include "indexbuffer.hpp"
-#include "vertextypes.hpp"
+#include "VertexArrayObject.hpp"
+#include "VertexBuffer.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexTypes.hpp"
 
 /**
  * @file ShapeFactory.hpp
@@ -27,32 +27,44 @@ namespace graf
         /**
          * @brief Creates a vertex array object for a specific 3D shape.
          * 
-         * Pure virtual function to be implemented by derived classes to generate
-         * the geometry of a specific shape.
+         * Generates the shape's mesh and uploads it. Must be called on the GL thread.
          * 
-         * @return A shared pointer to the created VertexArrayObject.
-         * @exception BufferException Thrown if VAO creation fails in derived implementations.
+         * @return The created VertexArrayObject, owning its buffers.
+         * @exception BufferException Thrown if VAO creation fails.
          */
-        virtual std::shared_ptr<VertexArrayObject> createShape() = 0;
+        VertexArrayObject createShape();
+
+        /**
+         * @brief Generates the vertex and index data of a specific 3D shape.
+         * 
+         * Pure virtual function to be implemented by derived classes. Performs no
+         * OpenGL calls, so it may run on worker threads.
+         * 
+         * @param vertices The vertex list to fill (replaced).
+         * @param indices The index list to fill (replaced).
+         */
+        virtual void generateMesh(VertexList& vertices, IndexList& indices) = 0;
 
         /**
          * @brief Virtual destructor for proper cleanup in derived classes.
          */
         virtual ~ShapeFactory() = default;
 
-    protected:
         /**
          * @brief Constructs a VAO from vertex and index data.
          * 
          * Utility function to create a VertexArrayObject from a list of vertices
-         * and indices, setting up position and texture attributes.
+         * and indices, setting up position and texture attributes. Must be called
+         * on the GL thread.
          * 
          * @param vertices List of vertex data defining the shape’s geometry.
          * @param indices List of indices defining the shape’s triangles.
-         * @return A shared pointer to the created VertexArrayObject.
+         * @return The created VertexArrayObject, owning its buffers.
          * @exception BufferException Thrown if vertex or index data is empty or invalid.
          */
-        std::shared_ptr<VertexArrayObject> createVAOFromData(const VertexList& vertices, const IndexList& indices);
+        VertexArrayObject createVAOFromData(const VertexList& vertices, const IndexList& indices);
+
+    protected:
 
         /**
          * @brief Sets texture coordinates for a single vertex.
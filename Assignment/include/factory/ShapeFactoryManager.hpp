@@ -6,6 +6,7 @@
 #include "PyramidFactory.hpp"
 #include "FrustumFactory.hpp"
 #include "Exceptions.hpp"
+#include "JobSystem.hpp"
 #include <map>
 
 /**
@@ -54,13 +55,42 @@ namespace graf
          * appropriate factory and caches it.
          * 
          * @param shapeType The type of shape to create (e.g., ShapeTypes::Cube).
-         * @return A shared pointer to the VertexArrayObject for the requested shape.
+         * @return The VertexArrayObject for the requested shape, owned by the cache.
          * @exception GrafException Thrown if an unknown shape type is requested.
          */
-        std::shared_ptr<graf::VertexArrayObject> createShape(graf::ShapeTypes shapeType);
+        graf::VertexArrayObject* createShape(graf::ShapeTypes shapeType);
+
+        /**
+         * @brief Creates and caches the VAOs of all supported shapes up front.
+         * 
+         * Meshes are generated in parallel on the job system's workers and uploaded
+         * by main-thread continuations. Must be called from the main (GL) thread.
+         * 
+         * @param jobs The job system used for mesh generation and upload.
+         * @exception BufferException Thrown if a mesh upload fails.
+         */
+        void Preload(JobSystem& jobs);
+
+        /**
+         * @brief Looks up an already created shape without creating it.
+         * 
+         * Performs no OpenGL calls and does not modify the cache, so it may be called
+         * from worker threads while the cache is not being modified.
+         * 
+         * @param shapeType The type of shape to look up.
+         * @return The cached VAO, or nullptr if the shape has not been created yet.
+         */
+        const graf::VertexArrayObject* getCachedShape(graf::ShapeTypes shapeType) const;
+
+        /**
+         * @brief Releases the OpenGL resources of all cached shapes and empties the cache.
+         * 
+         * Must be called from the main (GL) thread before the context is destroyed.
+         */
+        void Release();
 
     private:
         std::map<graf::ShapeTypes, std::unique_ptr<graf::ShapeFactory>> factories; ///< Map of shape types to their factories.
-        std::map<graf::ShapeTypes, std::shared_ptr<graf::VertexArrayObject>> shapeCache; ///< Cache of created VAOs by shape type.
+        std::map<graf::ShapeTypes, graf::VertexArrayObject> shapeCache; ///< Cache of created VAOs by shape type; entries never move.
     };
 }
\ No newline at end of file
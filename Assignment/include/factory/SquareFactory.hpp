@@ -20,10 +20,10 @@ namespace graf
     {
     public:
         /**
-         * @brief Creates a vertex array object representing a square.
-         * @return A shared pointer to the VertexArrayObject containing the square geometry.
-         * @exception BufferException Thrown if VAO creation fails due to invalid data.
+         * @brief Generates the vertex and index data of a square.
+         * @param vertices The vertex list to fill (replaced).
+         * @param indices The index list to fill (replaced).
          */
-        std::shared_ptr<VertexArrayObject> createShape() override;
+        void generateMesh(VertexList& vertices, IndexList& indices) override;
     };
 }
\ No newline at end of file
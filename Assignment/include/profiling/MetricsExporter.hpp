@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @file MetricsExporter.hpp
+ * @brief Defines the MetricsExporter class that publishes the MetricsRegistry for scraping.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class MetricsExporter
+     * @brief Publishes the metrics in the Prometheus text format from a background thread.
+     *
+     * In file mode the text is rewritten periodically through a temporary file and a
+     * rename, so a reader such as the node exporter's textfile collector never sees
+     * a partial file. In socket mode a Unix domain socket answers every connection
+     * with the current text; a client that sends an HTTP GET first receives an HTTP
+     * response, so `curl --unix-socket` works as a scraper.
+     */
+    class MetricsExporter
+    {
+    public:
+        /**
+         * @brief Constructs an exporter that is not running.
+         */
+        MetricsExporter() = default;
+
+        /**
+         * @brief Stops the exporter.
+         */
+        ~MetricsExporter();
+
+        MetricsExporter(const MetricsExporter&) = delete;
+        MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+        /**
+         * @brief Starts rewriting a file periodically.
+         * @param path Path of the file.
+         * @param intervalSeconds Time between two writes.
+         * @exception GrafException Thrown if the exporter is already running.
+         */
+        void StartFile(const string& path, double intervalSeconds);
+
+        /**
+         * @brief Starts serving the metrics on a Unix domain socket.
+         *
+         * A stale socket file at the path is replaced.
+         *
+         * @param path Path of the socket.
+         * @exception GrafException Thrown if already running or the socket cannot be created.
+         */
+        void StartSocket(const string& path);
+
+        /**
+         * @brief Stops the background thread; in file mode the file is written a last time.
+         */
+        void Stop();
+
+        /**
+         * @brief Checks whether the exporter is running.
+         * @return True between a Start and Stop.
+         */
+        bool IsRunning() const;
+
+        /**
+         * @brief Gets the number of files written or scrapes answered.
+         * @return The export count.
+         */
+        size_t getExportCount() const;
+
+    private:
+        /**
+         * @brief Writes the file until stopped.
+         */
+        void FileLoop();
+
+        /**
+         * @brief Answers connections until stopped.
+         */
+        void SocketLoop();
+
+        /**
+         * @brief Writes the metrics to the file through a temporary file.
+         */
+        void WriteFile();
+
+        /**
+         * @brief Sends the metrics to a connected client.
+         * @param client The client socket.
+         */
+        void Serve(int client);
+
+    private:
+        thread                      m_thread;               ///< Background export thread.
+        mutex                       m_mutex;                ///< Guards m_stop for the file loop's wait.
+        condition_variable          m_wake;                 ///< Wakes the file loop on Stop.
+        atomic<bool>                m_stop{false};          ///< Set to end the background thread.
+        bool                        m_socketMode = false;   ///< Whether a socket is served instead of a file.
+        string                      m_path;                 ///< File or socket path.
+        chrono::duration<double>    m_interval{5.0};        ///< Time between two file writes.
+        int                         m_listenSocket = -1;    ///< Listening socket in socket mode.
+        atomic<size_t>              m_exportCount{0};       ///< Files written or scrapes answered.
+    };
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "GLWindow.hpp"
+#include "GpuProfiler.hpp"
+#include "RollingStats.hpp"
+#include "SceneRenderer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @file PerfOverlay.hpp
+ * @brief Defines the PerfOverlay class, an in-app performance display built with Dear ImGui.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class PerfOverlay
+     * @brief Shows frame times, CPU and GPU zones, scene work, memory and cache statistics.
+     *
+     * The overlay is hidden initially. Dear ImGui and its GLFW and OpenGL backends are
+     * only initialized the first time it is shown, and while hidden Render returns at
+     * once, so an unused overlay costs nothing. Its own CPU time (and GPU time, if a
+     * GpuProfiler is attached) is measured and displayed as well.
+     *
+     * Toggle and SetVisible may be called from any thread; everything else must be
+     * called on the GL thread.
+     */
+    class PerfOverlay
+    {
+    public:
+        /**
+         * @brief Constructs a hidden overlay for a window.
+         * @param window The window whose frames are displayed; must outlive the overlay.
+         */
+        explicit PerfOverlay(GLWindow& window);
+
+        PerfOverlay(const PerfOverlay&) = delete;
+        PerfOverlay& operator=(const PerfOverlay&) = delete;
+
+        /**
+         * @brief Sets the source of the per-pass GPU times, also used to time the overlay.
+         * @param profiler The GPU profiler, or nullptr.
+         */
+        void SetGpuProfiler(GpuProfiler* profiler);
+
+        /**
+         * @brief Sets the source of the draw call, triangle and state change counts.
+         * @param renderer The scene renderer, or nullptr.
+         */
+        void SetSceneRenderer(const SceneRenderer* renderer);
+
+        /**
+         * @brief Shows the overlay if hidden and hides it if shown.
+         */
+        void Toggle();
+
+        /**
+         * @brief Shows or hides the overlay.
+         * @param visible Whether the overlay is drawn.
+         */
+        void SetVisible(bool visible);
+
+        /**
+         * @brief Checks whether the overlay is drawn.
+         * @return True if visible.
+         */
+        bool IsVisible() const;
+
+        /**
+         * @brief Draws the overlay on top of the current frame if it is visible.
+         *
+         * Call on the GL thread after the scene is drawn and before the frame is presented.
+         */
+        void Render();
+
+        /**
+         * @brief Shuts down Dear ImGui; call before the context is destroyed.
+         */
+        void Release();
+
+        /**
+         * @brief Gets the CPU time spent building and drawing the overlay.
+         * @return Milliseconds per drawn frame.
+         */
+        const RollingStats& getDrawTimes() const;
+
+    private:
+        /**
+         * @brief Creates the Dear ImGui context and initializes the backends.
+         */
+        void Initialize();
+
+        /**
+         * @brief Updates the history and submits the widgets of one frame.
+         */
+        void BuildWindow();
+
+    private:
+        static const size_t FRAME_HISTORY = 240; ///< Frames shown in the frame-time graph.
+
+        GLWindow&               m_window;                   ///< Window whose frames are shown.
+        GpuProfiler*            m_gpuProfiler = nullptr;    ///< Source of GPU pass times.
+        const SceneRenderer*    m_sceneRenderer = nullptr;  ///< Source of scene work counts.
+        atomic<bool>            m_visible{false};           ///< Whether the overlay is drawn.
+        bool                    m_wasVisible = false;       ///< Visibility during the previous Render.
+        bool                    m_initialized = false;      ///< Whether Dear ImGui is set up.
+
+        vector<float>           m_frameTimes;               ///< Ring of recent frame times in ms.
+        size_t                  m_frameTimeCursor = 0;      ///< Next slot in m_frameTimes.
+        uint64_t                m_lastFrameCount = 0;       ///< Frame-time samples seen so far.
+        size_t                  m_zoneCursor = 0;           ///< First profiler zone not summed yet.
+        map<string, double>     m_cpuZones;                 ///< CPU milliseconds per zone in the last frame.
+        uint64_t                m_lastBytesUploaded = 0;    ///< Upload counter at the previous frame.
+        uint64_t                m_frameBytesUploaded = 0;   ///< Bytes uploaded during the last frame.
+        RollingStats            m_drawTimes{FRAME_HISTORY}; ///< CPU cost of the overlay itself.
+    };
+}
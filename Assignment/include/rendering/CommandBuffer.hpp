@@ -0,0 +1,125 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * @file CommandBuffer.hpp
+ * @brief Defines the CommandBuffer class for recording draw commands off the GL thread.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @enum CommandType
+     * @brief Enumerates the commands that can be recorded into a CommandBuffer.
+     */
+    enum class CommandType : uint8_t
+    {
+        BindVertexArray, ///< Bind a VAO (payload: unsigned int handle).
+        BindTexture,     ///< Bind a 2D texture (payload: unsigned int handle).
+        SetMat4,         ///< Set a mat4 uniform (payload: int location, 16 floats).
+        DrawElements     ///< Draw indexed triangles (payload: int index count).
+    };
+
+    /**
+     * @class CommandBuffer
+     * @brief A linear buffer of compact binary draw commands.
+     * 
+     * Commands are recorded on any thread without touching OpenGL, then replayed
+     * on the GL thread. Each command is a one-byte type followed by a tightly packed
+     * payload, so replay is a single pass with minimal decoding. The storage is
+     * kept between frames, so recording stops allocating once the buffer has grown
+     * to its steady-state size.
+     */
+    class CommandBuffer
+    {
+    public:
+        /**
+         * @brief Clears all recorded commands while keeping the storage.
+         */
+        void Reset();
+
+        /**
+         * @brief Records binding a vertex array object.
+         * @param vao The OpenGL VAO handle.
+         */
+        void BindVertexArray(unsigned int vao);
+
+        /**
+         * @brief Records binding a 2D texture.
+         * @param texture The OpenGL texture handle.
+         */
+        void BindTexture(unsigned int texture);
+
+        /**
+         * @brief Records setting a 4x4 matrix uniform of the current program.
+         * @param location The uniform location.
+         * @param value The matrix value.
+         */
+        void SetMat4(int location, const glm::mat4& value);
+
+        /**
+         * @brief Records an indexed triangle draw using the bound VAO.
+         * @param indexCount The number of indices to draw.
+         */
+        void DrawElements(int indexCount);
+
+        /**
+         * @brief Executes all recorded commands in order.
+         * 
+         * Must be called on the GL thread.
+         */
+        void Replay() const;
+
+        /**
+         * @brief Gets the number of recorded commands.
+         * @return The command count.
+         */
+        size_t getCommandCount() const;
+
+        /**
+         * @brief Gets the size of the recorded command stream.
+         * @return The size in bytes.
+         */
+        size_t getSize() const;
+
+        /**
+         * @brief Gets the number of recorded draw calls.
+         * @return The draw count.
+         */
+        size_t getDrawCount() const;
+
+        /**
+         * @brief Gets the number of triangles the recorded draws submit.
+         * @return The triangle count.
+         */
+        size_t getTriangleCount() const;
+
+        /**
+         * @brief Gets the number of recorded VAO and texture binds.
+         * @return The state change count.
+         */
+        size_t getStateChangeCount() const;
+
+    private:
+        /**
+         * @brief Appends a command header and its payload.
+         * @param type The command type.
+         * @param payload Pointer to the payload bytes.
+         * @param size Size of the payload in bytes.
+         */
+        void Write(CommandType type, const void* payload, size_t size);
+
+    private:
+        vector<uint8_t> m_data;             ///< Encoded command stream.
+        size_t          m_commandCount = 0;     ///< Number of recorded commands.
+        size_t          m_drawCount = 0;        ///< Number of recorded draw calls.
+        size_t          m_triangleCount = 0;    ///< Triangles submitted by the draws.
+        size_t          m_stateChangeCount = 0; ///< Number of recorded binds.
+    };
+}
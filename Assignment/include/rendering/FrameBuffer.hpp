@@ -0,0 +1,84 @@
+#pragma once
+
+#include "GLHandle.hpp"
+#include <vector>
+
+/**
+ * @file FrameBuffer.hpp
+ * @brief Defines the FrameBuffer class for managing offscreen OpenGL render targets.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class FrameBuffer
+     * @brief A class for handling OpenGL framebuffer objects (FBOs).
+     *
+     * This class encapsulates an offscreen render target with an RGBA8 color
+     * attachment and a 24-bit depth / 8-bit stencil attachment of arbitrary size.
+     * While bound, all draw calls render into it instead of the window.
+     */
+    class FrameBuffer
+    {
+    public:
+        /**
+         * @brief Creates the framebuffer and its attachments.
+         * @param width Width of the render target in pixels.
+         * @param height Height of the render target in pixels.
+         * @exception BufferException Thrown if the size is invalid or the framebuffer is incomplete.
+         */
+        void Create(int width, int height);
+
+        /**
+         * @brief Binds the framebuffer for drawing and reading and sets the viewport to cover it.
+         */
+        void Bind();
+
+        /**
+         * @brief Binds the default framebuffer again.
+         */
+        void Unbind();
+
+        /**
+         * @brief Releases the framebuffer’s OpenGL resources.
+         */
+        void Release();
+
+        /**
+         * @brief Reads the color attachment back to client memory.
+         *
+         * Rows are returned top to bottom, four bytes (RGBA) per pixel.
+         *
+         * @param pixels Receives width * height * 4 bytes.
+         * @exception GrafException Thrown if the read fails.
+         */
+        void ReadPixels(vector<unsigned char>& pixels);
+
+        /**
+         * @brief Gets the OpenGL handle of the framebuffer.
+         * @return The framebuffer handle.
+         */
+        unsigned int getId() const;
+
+        /**
+         * @brief Gets the width of the render target.
+         * @return Width in pixels.
+         */
+        int getWidth() const;
+
+        /**
+         * @brief Gets the height of the render target.
+         * @return Height in pixels.
+         */
+        int getHeight() const;
+
+    private:
+        FramebufferHandle  m_fbo;       ///< Owned framebuffer object.
+        RenderbufferHandle m_color;     ///< Renderbuffer holding the color attachment.
+        RenderbufferHandle m_depth;     ///< Renderbuffer holding the depth/stencil attachment.
+        int          m_width = 0;       ///< Width in pixels.
+        int          m_height = 0;      ///< Height in pixels.
+    };
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "GLHandle.hpp"
+#include "JobSystem.hpp"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @file FrameCapture.hpp
+ * @brief Defines the FrameCapture class for asynchronous screenshots and frame recording.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @enum CaptureFormat
+     * @brief File format of captured frames.
+     */
+    enum class CaptureFormat
+    {
+        Png,    ///< PNG encoded with stb_image_write.
+        Raw     ///< Top-down RGBA bytes without a header.
+    };
+
+    /**
+     * @class FrameCapture
+     * @brief Captures rendered frames without stalling the GPU pipeline.
+     *
+     * At the end of a frame the current read framebuffer is copied into one of a
+     * ring of pixel buffer objects and a fence is inserted. Later frames poll the
+     * fences without waiting and map only the buffers whose copies have finished,
+     * so the CPU never blocks on the GPU. Mapped pixels are handed to the job system
+     * for flipping and encoding. When every buffer is busy or too many encodes are
+     * pending, the frame is skipped and counted instead of slowing down rendering.
+     *
+     * Capture requests may come from any thread; everything else must be called on
+     * the GL thread.
+     */
+    class FrameCapture
+    {
+    public:
+        /**
+         * @brief Constructs a capture facility.
+         * @param jobs The job system that encodes captured frames.
+         * @param bufferCount Number of pixel buffer objects in the ring (at least 2).
+         */
+        explicit FrameCapture(JobSystem& jobs, size_t bufferCount = 3);
+
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+        /**
+         * @brief Requests a screenshot of the next finished frame.
+         * @param fileName Path of the file to write.
+         * @param format File format.
+         */
+        void Capture(const string& fileName, CaptureFormat format = CaptureFormat::Png);
+
+        /**
+         * @brief Starts capturing every frame into a directory.
+         *
+         * Frames are written as frame_000000.png (or .rgba), numbered from zero;
+         * skipped frames leave gaps in the numbering.
+         *
+         * @param directory Output directory, created if missing.
+         * @param format File format.
+         */
+        void StartRecording(const string& directory, CaptureFormat format = CaptureFormat::Png);
+
+        /**
+         * @brief Stops capturing every frame.
+         */
+        void StopRecording();
+
+        /**
+         * @brief Checks whether every frame is being captured.
+         * @return True while recording.
+         */
+        bool IsRecording() const;
+
+        /**
+         * @brief Starts the readback of the finished frame and collects completed ones.
+         *
+         * Call on the GL thread after the frame is rendered and before buffers are swapped.
+         * Reads the area covered by the current viewport.
+         */
+        void EndFrame();
+
+        /**
+         * @brief Waits for all outstanding readbacks and encodes.
+         */
+        void Flush();
+
+        /**
+         * @brief Releases the pixel buffers and fences; call before the context is destroyed.
+         */
+        void Release();
+
+        /**
+         * @brief Gets the number of frames written or queued for writing.
+         * @return The captured frame count.
+         */
+        size_t getCapturedFrames() const;
+
+        /**
+         * @brief Gets the number of requested frames skipped to avoid stalling.
+         * @return The dropped frame count.
+         */
+        size_t getDroppedFrames() const;
+
+    private:
+        /**
+         * @struct ReadbackSlot
+         * @brief A pixel buffer object and the frame copied into it.
+         */
+        struct ReadbackSlot
+        {
+            BufferHandle    pbo;                ///< Owned pixel buffer.
+            size_t          capacity = 0;       ///< Allocated size of the buffer in bytes.
+            FenceHandle     fence;              ///< Signalled when the copy has finished.
+            int             width = 0;          ///< Width of the copied area.
+            int             height = 0;         ///< Height of the copied area.
+            string          fileName;           ///< Destination of the frame.
+            CaptureFormat   format = CaptureFormat::Png; ///< Encoding of the frame.
+        };
+
+        /**
+         * @brief Takes the next pending request for this frame.
+         * @param fileName Receives the destination file.
+         * @param format Receives the file format.
+         * @return False if nothing should be captured this frame.
+         */
+        bool NextRequest(string& fileName, CaptureFormat& format);
+
+        /**
+         * @brief Maps finished readbacks in submission order and schedules their encoding.
+         * @param wait Whether to block until every readback has finished.
+         */
+        void CollectFinished(bool wait);
+
+    private:
+        static const size_t MAX_PENDING_ENCODES = 8; ///< Encodes allowed to queue up before frames are skipped.
+
+        JobSystem&              m_jobs;                     ///< Runs the encodes.
+        vector<ReadbackSlot>    m_slots;                    ///< Ring of pixel buffers.
+        deque<size_t>           m_inFlight;                 ///< Busy slots, oldest first.
+        vector<JobHandle>       m_encodes;                  ///< Encodes that may still be running.
+        atomic<size_t>          m_pendingEncodes{0};        ///< Encodes not finished yet.
+
+        mutable mutex           m_requestMutex;             ///< Guards the request state below.
+        deque<pair<string, CaptureFormat>> m_screenshots;   ///< Requested single frames.
+        bool                    m_recording = false;        ///< Whether every frame is captured.
+        string                  m_recordDirectory;          ///< Output directory while recording.
+        CaptureFormat           m_recordFormat = CaptureFormat::Png; ///< Format while recording.
+        size_t                  m_recordedFrames = 0;       ///< Number used for the next recorded frame.
+
+        size_t                  m_capturedFrames = 0;       ///< Frames handed to the encoder.
+        size_t                  m_droppedFrames = 0;        ///< Frames skipped to avoid stalling.
+    };
+}
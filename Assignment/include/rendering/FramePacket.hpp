@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "ShapeFactoryManager.hpp"
+
+/**
+ * @file FramePacket.hpp
+ * @brief Defines the immutable per-frame data handed from simulation to rendering.
+ */
+
+namespace graf
+{
+    /**
+     * @struct DrawItem
+     * @brief Describes a single object to be drawn in a frame.
+     * 
+     * Contains everything the render thread needs to draw an object without
+     * touching simulation state: the shape to draw, its final transform and
+     * the OpenGL handle of its texture.
+     */
+    struct DrawItem
+    {
+        ShapeTypes   shape = ShapeTypes::Cube; ///< Shape whose cached VAO is drawn.
+        glm::mat4    transform{1.0f};          ///< Combined projection * world transform.
+        unsigned int texture = 0;              ///< OpenGL texture handle bound for the draw.
+    };
+
+    /**
+     * @struct FramePacket
+     * @brief Snapshot of everything required to render one frame.
+     * 
+     * Produced by the simulation thread and consumed by the GL thread. Once
+     * published, a packet is treated as read-only until it is recycled by
+     * the FramePipeline.
+     */
+    struct FramePacket
+    {
+        uint64_t              frameIndex = 0;       ///< Sequential index of the simulated frame.
+        uint64_t              tickIndex = 0;        ///< Number of fixed simulation ticks run so far (frames without a tick function).
+        float                 interpolation = 1.0f; ///< Blend factor between the previous and the latest tick state.
+        glm::mat4             viewProjection{1.0f}; ///< Projection (and view) matrix used for this frame.
+        std::vector<DrawItem> items;                ///< Objects to draw this frame.
+        std::vector<int64_t>  inputTimestamps;      ///< Receive times (steady_clock ns) of the input events applied to this frame.
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+/**
+ * @file Frustum.hpp
+ * @brief Defines the Frustum class for view frustum culling.
+ */
+
+namespace graf
+{
+    /**
+     * @class Frustum
+     * @brief The six clipping planes of a view-projection matrix.
+     * 
+     * Used to reject objects that lie completely outside the camera's view
+     * before they are submitted for drawing.
+     */
+    class Frustum
+    {
+    public:
+        /**
+         * @brief Extracts the frustum planes from a view-projection matrix.
+         * @param viewProjection The combined projection and view matrix.
+         */
+        explicit Frustum(const glm::mat4& viewProjection);
+
+        /**
+         * @brief Tests whether a bounding sphere is at least partially inside the frustum.
+         * @param center The sphere center in world space.
+         * @param radius The sphere radius.
+         * @return True if the sphere intersects or lies inside the frustum.
+         */
+        bool IntersectsSphere(const glm::vec3& center, float radius) const;
+
+        /**
+         * @brief Tests whether an axis-aligned box is at least partially inside the frustum.
+         * 
+         * Conservative: a box outside the frustum but not behind any single plane
+         * counts as intersecting.
+         * 
+         * @param boxMin The minimum corner in world space.
+         * @param boxMax The maximum corner in world space.
+         * @return True if the box intersects or lies inside the frustum.
+         */
+        bool IntersectsBox(const glm::vec3& boxMin, const glm::vec3& boxMax) const;
+
+    private:
+        glm::vec4 m_planes[6]; ///< Normalized planes (left, right, bottom, top, near, far); xyz is the inward normal.
+    };
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "GpuResourceTracker.hpp"
+#include <cstdint>
+#include <string>
+#include <utility>
+
+/**
+ * @file GLHandle.hpp
+ * @brief Defines move-only owning wrappers for OpenGL objects.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class GLHandle
+     * @brief Owns one OpenGL object and deletes it when destroyed or reset.
+     *
+     * The object is created and deleted through GpuResourceTracker, so it is
+     * accounted for like every other GL object. Handles can be moved but not
+     * copied, so each object has exactly one owner; code that only uses the object
+     * takes the raw id from getId or a reference to the owner. The destructor
+     * issues a GL call, so the owner must be destroyed or reset while the
+     * context is current.
+     *
+     * @tparam Type Category of the owned object.
+     */
+    template <GpuResourceType Type>
+    class GLHandle
+    {
+    public:
+        /**
+         * @brief Constructs an empty handle.
+         */
+        GLHandle() = default;
+
+        /**
+         * @brief Creates a new OpenGL object.
+         * @param owner Tag of the owner, e.g. the class or asset name.
+         * @param site Creation site, normally GRAF_GL_SITE.
+         * @param shaderType Shader stage for shader handles, ignored otherwise.
+         */
+        GLHandle(const string& owner, const char* site, unsigned int shaderType = 0)
+            : m_id(GpuResourceTracker::sCreate(Type, owner, site, shaderType))
+        {
+        }
+
+        /**
+         * @brief Deletes the owned object.
+         */
+        ~GLHandle()
+        {
+            Reset();
+        }
+
+        GLHandle(const GLHandle&) = delete;
+        GLHandle& operator=(const GLHandle&) = delete;
+
+        /**
+         * @brief Takes over the object of another handle, which becomes empty.
+         * @param other The handle to move from.
+         */
+        GLHandle(GLHandle&& other) noexcept
+            : m_id(std::exchange(other.m_id, 0u))
+        {
+        }
+
+        /**
+         * @brief Deletes the owned object and takes over the object of another handle.
+         * @param other The handle to move from.
+         * @return This handle.
+         */
+        GLHandle& operator=(GLHandle&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_id = std::exchange(other.m_id, 0u);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Deletes the owned object, leaving the handle empty.
+         */
+        void Reset()
+        {
+            GpuResourceTracker::sDelete(Type, m_id);
+        }
+
+        /**
+         * @brief Gets the OpenGL id without giving up ownership.
+         * @return The id, or 0 if empty.
+         */
+        unsigned int getId() const
+        {
+            return m_id;
+        }
+
+        /**
+         * @brief Checks whether the handle owns an object.
+         * @return True if not empty.
+         */
+        explicit operator bool() const
+        {
+            return m_id != 0;
+        }
+
+    private:
+        unsigned int m_id = 0; ///< OpenGL id, 0 if empty.
+    };
+
+    using BufferHandle       = GLHandle<GpuResourceType::Buffer>;       ///< Owns a buffer object.
+    using VertexArrayHandle  = GLHandle<GpuResourceType::VertexArray>;  ///< Owns a vertex array object.
+    using TextureHandle      = GLHandle<GpuResourceType::Texture>;      ///< Owns a texture.
+    using ShaderHandle       = GLHandle<GpuResourceType::Shader>;       ///< Owns a shader object.
+    using ProgramHandle      = GLHandle<GpuResourceType::Program>;      ///< Owns a shader program.
+    using FramebufferHandle  = GLHandle<GpuResourceType::Framebuffer>;  ///< Owns a framebuffer object.
+    using RenderbufferHandle = GLHandle<GpuResourceType::Renderbuffer>; ///< Owns a renderbuffer object.
+    using QueryHandle        = GLHandle<GpuResourceType::Query>;        ///< Owns a query object.
+
+    /**
+     * @enum FenceStatus
+     * @brief Result of waiting on a fence.
+     */
+    enum class FenceStatus
+    {
+        Signalled,  ///< The fenced commands have finished.
+        Pending,    ///< The timeout expired first.
+        Failed      ///< The wait failed, e.g. because the context was lost.
+    };
+
+    /**
+     * @class FenceHandle
+     * @brief Owns an OpenGL sync object and deletes it when destroyed or reset.
+     *
+     * Sync objects are pointers rather than names, so they have their own wrapper;
+     * they are short-lived and not counted by GpuResourceTracker.
+     */
+    class FenceHandle
+    {
+    public:
+        /**
+         * @brief Constructs an empty handle.
+         */
+        FenceHandle() = default;
+
+        /**
+         * @brief Deletes the owned fence.
+         */
+        ~FenceHandle();
+
+        FenceHandle(const FenceHandle&) = delete;
+        FenceHandle& operator=(const FenceHandle&) = delete;
+
+        /**
+         * @brief Takes over the fence of another handle, which becomes empty.
+         * @param other The handle to move from.
+         */
+        FenceHandle(FenceHandle&& other) noexcept;
+
+        /**
+         * @brief Deletes the owned fence and takes over the fence of another handle.
+         * @param other The handle to move from.
+         * @return This handle.
+         */
+        FenceHandle& operator=(FenceHandle&& other) noexcept;
+
+        /**
+         * @brief Replaces the owned fence by one signalled when all commands issued so far have finished.
+         */
+        void Insert();
+
+        /**
+         * @brief Waits for the fence to be signalled.
+         * @param timeoutNs Longest wait in nanoseconds; 0 polls without flushing, otherwise commands are flushed first.
+         * @return The state of the fence; an empty handle counts as signalled.
+         */
+        FenceStatus Wait(uint64_t timeoutNs = 0) const;
+
+        /**
+         * @brief Deletes the owned fence, leaving the handle empty.
+         */
+        void Reset();
+
+        /**
+         * @brief Checks whether the handle owns a fence.
+         * @return True if not empty.
+         */
+        explicit operator bool() const;
+
+    private:
+        void* m_sync = nullptr; ///< The GLsync, nullptr if empty.
+    };
+}
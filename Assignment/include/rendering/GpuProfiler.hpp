@@ -0,0 +1,197 @@
+#pragma once
+
+#include "GLHandle.hpp"
+#include "RollingStats.hpp"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @file GpuProfiler.hpp
+ * @brief Defines the GpuProfiler class for measuring GPU time per render pass.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class GpuProfiler
+     * @brief Measures the GPU time of render passes with timestamp queries.
+     *
+     * Every zone issues a GL_TIMESTAMP query at its start and end, taken from a pool
+     * that grows on demand, so zones may nest. The queries of a frame are read back
+     * only once the GPU has finished that frame, which is typically a few frames
+     * later; nothing ever waits for a result. When every frame slot is still in
+     * flight the oldest frame's results are dropped instead.
+     *
+     * Per frame the durations of all zones with the same name are summed into a
+     * per-pass RollingStats in milliseconds. When the CPU profiler is compiled in,
+     * the zones are also added to its trace on a "GPU" track, converted to the CPU
+     * clock with a GL_TIMESTAMP reading taken at the start of each frame.
+     *
+     * Must only be used on the GL thread.
+     */
+    class GpuProfiler
+    {
+    public:
+        /**
+         * @brief Constructs a disabled profiler.
+         * @param frameLatency Frames whose queries may be in flight at once (at least 2).
+         */
+        explicit GpuProfiler(size_t frameLatency = 4);
+
+        GpuProfiler(const GpuProfiler&) = delete;
+        GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+        /**
+         * @brief Enables or disables issuing queries; results in flight are still collected.
+         * @param enabled Whether zones are measured.
+         */
+        void SetEnabled(bool enabled);
+
+        /**
+         * @brief Checks whether zones are measured.
+         * @return True if enabled.
+         */
+        bool IsEnabled() const;
+
+        /**
+         * @brief Starts a zone; zones must be closed in reverse order.
+         * @param name Pass name with static lifetime.
+         */
+        void BeginZone(const char* name);
+
+        /**
+         * @brief Ends the innermost open zone.
+         */
+        void EndZone();
+
+        /**
+         * @brief Finishes the current frame and collects the results of completed frames.
+         *
+         * Call once per frame after its last zone. Zones still open are closed.
+         */
+        void EndFrame();
+
+        /**
+         * @brief Deletes all queries; call before the context is destroyed.
+         */
+        void Release();
+
+        /**
+         * @brief Gets the GPU time statistics of a pass in milliseconds per frame.
+         * @param name The pass name.
+         * @return The statistics, or nullptr if the pass was never measured.
+         */
+        const RollingStats* getPassStats(const string& name) const;
+
+        /**
+         * @brief Gets the names of all measured passes.
+         * @return The pass names in alphabetical order.
+         */
+        vector<string> getPassNames() const;
+
+        /**
+         * @brief Gets the number of frames whose results were read back.
+         * @return The measured frame count.
+         */
+        size_t getMeasuredFrames() const;
+
+        /**
+         * @brief Gets the number of frames dropped because their results arrived too late.
+         * @return The dropped frame count.
+         */
+        size_t getDroppedFrames() const;
+
+    private:
+        /**
+         * @struct Zone
+         * @brief A measured zone and the queries of its start and end.
+         */
+        struct Zone
+        {
+            const char*     name = nullptr;     ///< Pass name.
+            unsigned int    beginQuery = 0;     ///< Timestamp query at the start.
+            unsigned int    endQuery = 0;       ///< Timestamp query at the end, 0 while open.
+        };
+
+        /**
+         * @struct Frame
+         * @brief The zones of one frame and the clock reference for the CPU timeline.
+         */
+        struct Frame
+        {
+            vector<Zone>    zones;              ///< Zones in the order they started.
+            int64_t         gpuReference = 0;   ///< GL_TIMESTAMP at the first zone in ns.
+            uint64_t        cpuReference = 0;   ///< Profiler clock at the same moment.
+            unsigned int    lastQuery = 0;      ///< Query issued last; timestamps finish in order.
+        };
+
+        /**
+         * @brief Takes a query from the pool, creating more if needed.
+         * @return The query object.
+         */
+        unsigned int AcquireQuery();
+
+        /**
+         * @brief Checks without blocking whether all queries of a frame have finished.
+         * @param frame The frame.
+         * @return True if the results can be read.
+         */
+        bool IsFrameAvailable(const Frame& frame) const;
+
+        /**
+         * @brief Reads a finished frame into the statistics and the CPU trace.
+         * @param frame The frame.
+         */
+        void ReadFrame(const Frame& frame);
+
+        /**
+         * @brief Returns the queries of a frame to the pool and clears it.
+         * @param frame The frame.
+         */
+        void RecycleFrame(Frame& frame);
+
+    private:
+        bool                        m_enabled = false;      ///< Whether zones are measured.
+        vector<Frame>               m_frames;               ///< Ring of frame slots.
+        size_t                      m_current = 0;          ///< Slot of the frame being recorded.
+        deque<size_t>               m_pending;              ///< Slots waiting for results, oldest first.
+        vector<size_t>              m_openZones;            ///< Indices of open zones in the current frame.
+        vector<unsigned int>        m_freeQueries;          ///< Pool of unused queries.
+        vector<QueryHandle>         m_allQueries;           ///< Owns every query created.
+        map<string, RollingStats>   m_passStats;            ///< GPU time per pass and frame.
+        uint32_t                    m_track = 0;            ///< CPU profiler track, 0 until registered.
+        size_t                      m_measuredFrames = 0;   ///< Frames read back.
+        size_t                      m_droppedFrames = 0;    ///< Frames discarded unread.
+    };
+
+    /**
+     * @class GpuZone
+     * @brief Measures the GPU time of a scope; does nothing if the profiler is disabled.
+     */
+    class GpuZone
+    {
+    public:
+        /**
+         * @brief Starts the zone.
+         * @param profiler The profiler.
+         * @param name Pass name with static lifetime.
+         */
+        GpuZone(GpuProfiler& profiler, const char* name) : m_profiler(profiler) { m_profiler.BeginZone(name); }
+
+        /**
+         * @brief Ends the zone.
+         */
+        ~GpuZone() { m_profiler.EndZone(); }
+
+        GpuZone(const GpuZone&) = delete;
+        GpuZone& operator=(const GpuZone&) = delete;
+
+    private:
+        GpuProfiler& m_profiler; ///< The profiler that owns the zone.
+    };
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file GpuResourceTracker.hpp
+ * @brief Defines the GpuResourceTracker class that creates, deletes and accounts for OpenGL objects.
+ */
+
+#define GRAF_GL_STRINGIFY_INNER(x) #x
+#define GRAF_GL_STRINGIFY(x) GRAF_GL_STRINGIFY_INNER(x)
+/// Source location of the calling line, recorded as the creation site of an OpenGL object.
+#define GRAF_GL_SITE __FILE__ ":" GRAF_GL_STRINGIFY(__LINE__)
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @enum GpuResourceType
+     * @brief Categories of tracked OpenGL objects.
+     */
+    enum class GpuResourceType
+    {
+        Buffer,         ///< Vertex, index and pixel buffers.
+        VertexArray,    ///< Vertex array objects.
+        Texture,        ///< Textures.
+        Shader,         ///< Shader objects.
+        Program,        ///< Shader programs.
+        Framebuffer,    ///< Framebuffer objects.
+        Renderbuffer,   ///< Renderbuffer objects.
+        Query,          ///< Query objects.
+        Count           ///< Number of categories.
+    };
+
+    /**
+     * @struct GpuResourceInfo
+     * @brief A live OpenGL object as recorded by the tracker.
+     */
+    struct GpuResourceInfo
+    {
+        GpuResourceType type = GpuResourceType::Buffer; ///< Category.
+        unsigned int    id = 0;                         ///< OpenGL handle.
+        int64_t         bytes = 0;                      ///< GPU memory attributed to the object.
+        string          owner;                          ///< Tag of the owning subsystem or asset.
+        const char*     site = "";                      ///< Source location that created it.
+    };
+
+    /**
+     * @class GpuResourceTracker
+     * @brief Creates and deletes OpenGL objects and keeps a record of every live one.
+     *
+     * All engine code creates and deletes GL objects through this class, so at any
+     * time it knows the live count and bytes per category, and at shutdown the
+     * objects still alive are reported as leaks with their owner and creation site.
+     * Byte budgets can be set per category and for the total; exceeding one prints
+     * a warning once until usage drops below it again.
+     *
+     * Creation and deletion take a lock, which is fine since they are never on a
+     * per-draw path. Objects must be created and deleted on the GL thread.
+     */
+    class GpuResourceTracker
+    {
+    public:
+        /**
+         * @brief Creates an OpenGL object and records it.
+         * @param type Category of the object.
+         * @param owner Tag of the owner, e.g. the class or asset name.
+         * @param site Creation site, normally GRAF_GL_SITE.
+         * @param shaderType Shader stage for GpuResourceType::Shader, ignored otherwise.
+         * @return The new handle, or 0 if creation failed.
+         */
+        static unsigned int sCreate(GpuResourceType type, const string& owner, const char* site, unsigned int shaderType = 0);
+
+        /**
+         * @brief Deletes a recorded OpenGL object and resets the handle.
+         * @param type Category of the object.
+         * @param id The handle; set to 0. Nothing happens if it is already 0.
+         */
+        static void sDelete(GpuResourceType type, unsigned int& id);
+
+        /**
+         * @brief Sets the GPU memory attributed to an object, e.g. after uploading its storage.
+         * @param type Category of the object.
+         * @param id The handle.
+         * @param bytes The size in bytes.
+         */
+        static void sSetSize(GpuResourceType type, unsigned int id, int64_t bytes);
+
+        /**
+         * @brief Sets the byte budget of a category.
+         * @param type The category.
+         * @param bytes The budget, or 0 for none.
+         */
+        static void sSetBudget(GpuResourceType type, int64_t bytes);
+
+        /**
+         * @brief Sets the byte budget of all categories together.
+         * @param bytes The budget, or 0 for none.
+         */
+        static void sSetTotalBudget(int64_t bytes);
+
+        /**
+         * @brief Gets the number of live objects of a category.
+         * @param type The category.
+         * @return The live count.
+         */
+        static size_t sGetLiveCount(GpuResourceType type);
+
+        /**
+         * @brief Gets the GPU memory of the live objects of a category.
+         * @param type The category.
+         * @return The size in bytes.
+         */
+        static int64_t sGetLiveBytes(GpuResourceType type);
+
+        /**
+         * @brief Gets all live objects.
+         * @return The objects, ordered by category and handle.
+         */
+        static vector<GpuResourceInfo> sGetLiveResources();
+
+        /**
+         * @brief Gets the display name of a category.
+         * @param type The category.
+         * @return The name, e.g. "buffer".
+         */
+        static const char* sGetTypeName(GpuResourceType type);
+
+        /**
+         * @brief Writes the live counts and bytes per category.
+         * @param out The output stream.
+         */
+        static void sWriteSummary(ostream& out);
+
+        /**
+         * @brief Writes every live object as a leak; call after all owners have released.
+         * @param out The output stream.
+         * @return The number of leaked objects.
+         */
+        static size_t sReportLeaks(ostream& out);
+
+        /**
+         * @brief Publishes the live counts and bytes in the MetricsRegistry.
+         *
+         * Calling it more than once has no further effect.
+         */
+        static void sRegisterMetrics();
+    };
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * @file ImageWriter.hpp
+ * @brief Provides functions for writing rendered images to disk.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Writes RGBA pixels to a PNG file using stb_image_write.
+     * 
+     * Missing parent directories of the output path are created.
+     * 
+     * @param fileName Path of the PNG file to write.
+     * @param width Image width in pixels.
+     * @param height Image height in pixels.
+     * @param pixels Top-to-bottom RGBA rows, width * height * 4 bytes.
+     * @exception TextureException Thrown if the size does not match or the file cannot be written.
+     */
+    void WritePng(const std::string& fileName, int width, int height, const std::vector<unsigned char>& pixels);
+
+    /**
+     * @brief Writes pixels to a file as raw bytes without a header.
+     * 
+     * Missing parent directories of the output path are created.
+     * 
+     * @param fileName Path of the file to write.
+     * @param pixels The bytes to write.
+     * @exception TextureException Thrown if the file cannot be written.
+     */
+    void WriteRaw(const std::string& fileName, const std::vector<unsigned char>& pixels);
+}
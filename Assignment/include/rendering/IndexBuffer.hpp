@@ -1,5 +1,7 @@
 #pragma once
 
+#include "GLHandle.hpp"
+
 /**
  * @file IndexBuffer.hpp
  * @brief Defines the IndexBuffer class for managing OpenGL index buffers.
@@ -13,10 +15,27 @@ namespace graf
      * 
      * This class encapsulates the creation, binding, and management of an index buffer,
      * which stores indices defining the order of vertices to form triangles in 3D rendering.
+     * It owns its buffer object, so it can be moved but not copied.
      */
     class IndexBuffer
     {
     public:
+        IndexBuffer() = default;
+
+        /**
+         * @brief Releases the buffer if it is still owned.
+         */
+        ~IndexBuffer();
+
+        IndexBuffer(IndexBuffer&&) = default;
+
+        /**
+         * @brief Releases the owned buffer and takes over the buffer of another instance.
+         * @param other The buffer to move from.
+         * @return This buffer.
+         */
+        IndexBuffer& operator=(IndexBuffer&& other) noexcept;
+
         /**
          * @brief Creates an OpenGL index buffer with the specified data.
          * 
@@ -55,8 +74,14 @@ namespace graf
          */
         int getIndexCount() const;
 
+        /**
+         * @brief Gets the OpenGL id, e.g. to bind the buffer into other vertex arrays.
+         * @return The id, or 0 if no buffer was created.
+         */
+        unsigned int getId() const;
+
     private:
-        unsigned int m_id;        ///< OpenGL handle for the index buffer object.
-        int m_IndexCount;         ///< Number of indices in the buffer.
+        BufferHandle m_buffer;    ///< Owned index buffer object.
+        int m_IndexCount = 0;     ///< Number of indices in the buffer.
     };
 }
\ No newline at end of file
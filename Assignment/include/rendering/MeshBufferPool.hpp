@@ -0,0 +1,193 @@
+#pragma once
+
+#include "GLHandle.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * @file MeshBufferPool.hpp
+ * @brief Defines the MeshBufferPool class, which sub-allocates many small meshes from a few large vertex buffers.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @struct MeshAttribute
+     * @brief One vertex attribute of the meshes of a pool.
+     */
+    struct MeshAttribute
+    {
+        unsigned int location;      ///< Attribute location in the shader.
+        int          components;    ///< Number of components (1 to 4).
+        unsigned int type;          ///< Component type, e.g. GL_FLOAT or GL_UNSIGNED_INT.
+        bool         integer;       ///< Whether the shader reads it as an integer attribute.
+        size_t       offset;        ///< Byte offset within the vertex.
+    };
+
+    /**
+     * @struct MeshAllocation
+     * @brief A range of a pool page holding the vertices of one mesh.
+     */
+    struct MeshAllocation
+    {
+        static const uint32_t INVALID_PAGE = UINT32_MAX; ///< Page of an empty allocation.
+
+        uint32_t page = INVALID_PAGE;   ///< Page index.
+        uint32_t offset = 0;            ///< Byte offset in the page.
+        uint32_t size = 0;              ///< Size in bytes, rounded up to the pool alignment.
+
+        /**
+         * @brief Checks whether the allocation holds a range.
+         * @return False for an empty allocation.
+         */
+        bool IsValid() const { return page != INVALID_PAGE; }
+    };
+
+    /**
+     * @class MeshBufferPool
+     * @brief Keeps streamed meshes of one vertex format in large shared vertex buffers.
+     *
+     * Each page is one vertex buffer with its own vertex array, so meshes that are
+     * created and destroyed all the time, like terrain chunks, neither create GL
+     * objects nor reallocate buffer storage; an upload only writes the mesh's range.
+     * Meshes of a page are drawn with a base vertex from the same vertex array, so
+     * drawing them sorted by page binds each vertex array once. Free ranges of a
+     * page are kept sorted and merged with their neighbours when freed. Pages that
+     * become empty are deleted, except for one kept for the next allocations.
+     */
+    class MeshBufferPool
+    {
+    public:
+        /**
+         * @brief Constructs an empty pool; pages are created on the first allocations.
+         * @param layout The vertex attributes.
+         * @param vertexStride Size of a vertex in bytes.
+         * @param alignment Granularity of allocations in bytes, a multiple of the vertex stride.
+         * @param pageSize Size of a page in bytes; larger meshes get a page of their own.
+         */
+        MeshBufferPool(const vector<MeshAttribute>& layout, size_t vertexStride, size_t alignment, size_t pageSize = 16 * 1024 * 1024);
+
+        /**
+         * @brief Deletes the pages.
+         */
+        ~MeshBufferPool();
+
+        MeshBufferPool(const MeshBufferPool&) = delete;
+        MeshBufferPool& operator=(const MeshBufferPool&) = delete;
+
+        /**
+         * @brief Sets the index buffer bound to the vertex arrays of all pages, e.g. a shared quad index buffer.
+         * @param indexBuffer The buffer id, 0 for none.
+         */
+        void SetIndexBuffer(unsigned int indexBuffer);
+
+        /**
+         * @brief Reserves a range for a mesh.
+         * @param bytes Size of the mesh in bytes.
+         * @return The range.
+         * @exception BufferException Thrown if a page cannot be created.
+         */
+        MeshAllocation Allocate(size_t bytes);
+
+        /**
+         * @brief Returns a range to its page and clears the allocation.
+         * @param allocation The range; an empty allocation is ignored.
+         */
+        void Free(MeshAllocation& allocation);
+
+        /**
+         * @brief Writes vertices into a range.
+         * @param allocation The range.
+         * @param data The vertices.
+         * @param bytes Their size, at most the size of the range.
+         */
+        void Upload(const MeshAllocation& allocation, const void* data, size_t bytes);
+
+        /**
+         * @brief Gets the vertex array of a page.
+         * @param page The page index of an allocation.
+         * @return The vertex array id.
+         */
+        unsigned int getVertexArray(uint32_t page) const;
+
+        /**
+         * @brief Gets the index of the first vertex of a range in its page.
+         * @param allocation The range.
+         * @return The base vertex for glDrawElementsBaseVertex.
+         */
+        int getBaseVertex(const MeshAllocation& allocation) const;
+
+        /**
+         * @brief Deletes all pages; allocations still held become invalid.
+         */
+        void Release();
+
+        /**
+         * @brief Gets the number of pages.
+         * @return The count.
+         */
+        size_t getPageCount() const;
+
+        /**
+         * @brief Gets the size of all pages.
+         * @return The byte count.
+         */
+        size_t getCapacity() const;
+
+        /**
+         * @brief Gets the size of all allocated ranges.
+         * @return The byte count.
+         */
+        size_t getUsed() const;
+
+        /**
+         * @brief Gets the number of allocated ranges.
+         * @return The count.
+         */
+        size_t getAllocationCount() const;
+
+    private:
+        /**
+         * @struct Page
+         * @brief One vertex buffer and the free ranges in it.
+         */
+        struct Page
+        {
+            BufferHandle                buffer;         ///< The vertex buffer.
+            VertexArrayHandle           vertexArray;    ///< Vertex array reading the buffer.
+            size_t                      size = 0;       ///< Size of the buffer in bytes.
+            size_t                      used = 0;       ///< Bytes allocated from it.
+            map<uint32_t, uint32_t>     freeRanges;     ///< Free ranges by offset, never adjacent.
+        };
+
+        /**
+         * @brief Creates a page and its vertex array.
+         * @param size Size in bytes.
+         * @return The page index.
+         */
+        uint32_t CreatePage(size_t size);
+
+        /**
+         * @brief Takes a range from the free ranges of a page.
+         * @param page The page.
+         * @param size Size in bytes, a multiple of the alignment.
+         * @param offset Receives the offset of the range.
+         * @return False if no free range is large enough.
+         */
+        static bool TakeRange(Page& page, uint32_t size, uint32_t& offset);
+
+    private:
+        vector<MeshAttribute>       m_layout;               ///< Vertex attributes.
+        size_t                      m_vertexStride;         ///< Size of a vertex.
+        size_t                      m_alignment;            ///< Allocation granularity.
+        size_t                      m_pageSize;             ///< Size of regular pages.
+        unsigned int                m_indexBuffer = 0;      ///< Index buffer bound to every vertex array.
+        vector<unique_ptr<Page>>    m_pages;                ///< Pages by index, nullptr for deleted ones.
+        size_t                      m_allocationCount = 0;  ///< Ranges allocated.
+    };
+}
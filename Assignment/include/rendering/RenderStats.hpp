@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file RenderStats.hpp
+ * @brief Defines the RenderStats class with process-wide rendering counters.
+ */
+
+namespace graf
+{
+    /**
+     * @enum StatsCache
+     * @brief Caches whose lookups are counted.
+     */
+    enum class StatsCache
+    {
+        Shape,          ///< ShapeFactoryManager VAO cache.
+        Texture,        ///< TextureManager name lookups.
+        ShaderSource,   ///< ShaderProgram source file cache.
+        Count           ///< Number of caches.
+    };
+
+    /**
+     * @class RenderStats
+     * @brief Counts uploads, GPU memory and cache lookups across the whole process.
+     *
+     * All counters are relaxed atomics, so they can be updated from any thread at
+     * the cost of one uncontended atomic add.
+     */
+    class RenderStats
+    {
+    public:
+        /**
+         * @brief Records data uploaded to the GPU.
+         * @param bytes Number of bytes uploaded.
+         */
+        static void sAddUpload(size_t bytes);
+
+        /**
+         * @brief Adjusts the memory held by vertex and index buffers.
+         * @param bytes Bytes allocated (positive) or freed (negative).
+         */
+        static void sAddMeshMemory(int64_t bytes);
+
+        /**
+         * @brief Adjusts the memory held by textures.
+         * @param bytes Bytes allocated (positive) or freed (negative).
+         */
+        static void sAddTextureMemory(int64_t bytes);
+
+        /**
+         * @brief Records a cache lookup.
+         * @param cache The cache that was queried.
+         * @param hit Whether the entry was found.
+         */
+        static void sRecordCacheLookup(StatsCache cache, bool hit);
+
+        /**
+         * @brief Gets the total number of bytes uploaded to the GPU.
+         * @return The byte count.
+         */
+        static uint64_t sGetBytesUploaded();
+
+        /**
+         * @brief Gets the memory currently held by vertex and index buffers.
+         * @return The size in bytes.
+         */
+        static int64_t sGetMeshMemory();
+
+        /**
+         * @brief Gets the memory currently held by textures, including mipmaps.
+         * @return The size in bytes.
+         */
+        static int64_t sGetTextureMemory();
+
+        /**
+         * @brief Gets the number of hits of a cache.
+         * @param cache The cache.
+         * @return The hit count.
+         */
+        static uint64_t sGetCacheHits(StatsCache cache);
+
+        /**
+         * @brief Gets the number of misses of a cache.
+         * @param cache The cache.
+         * @return The miss count.
+         */
+        static uint64_t sGetCacheMisses(StatsCache cache);
+
+        /**
+         * @brief Publishes the counters in the MetricsRegistry, read at export time.
+         *
+         * Calling it more than once has no further effect.
+         */
+        static void sRegisterMetrics();
+    };
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "CommandBuffer.hpp"
+#include "FrameArena.hpp"
+#include "FramePacket.hpp"
+#include "GpuProfiler.hpp"
+#include "JobSystem.hpp"
+#include "ShaderProgram.hpp"
+#include "ShapeFactoryManager.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file SceneRenderer.hpp
+ * @brief Defines the SceneRenderer class for drawing frame packets.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @struct SceneStats
+     * @brief Work submitted by SceneRenderer for one frame.
+     */
+    struct SceneStats
+    {
+        size_t items = 0;           ///< Items in the frame packet.
+        size_t commandBuffers = 0;  ///< Command buffers recorded.
+        size_t drawCalls = 0;       ///< Draw calls issued.
+        size_t triangles = 0;       ///< Triangles submitted.
+        size_t stateChanges = 0;    ///< VAO and texture binds issued.
+    };
+
+    /**
+     * @class SceneRenderer
+     * @brief Draws the items of a frame packet through parallel-recorded command buffers.
+     * 
+     * Each frame the items are sorted by shape and texture into a render queue, the
+     * queue is split into chunks that worker threads record into their own command
+     * buffers, and the GL thread replays the buffers in order. Recording skips binds
+     * that would not change the state within a chunk. The queue lives in a frame
+     * arena that is reset by the next Render call; the command buffers keep their
+     * storage between frames.
+     */
+    class SceneRenderer
+    {
+    public:
+        /**
+         * @brief Constructs a renderer for the given program and shapes.
+         * 
+         * The program must be linked and have its "uWorldTransform" uniform added, and
+         * every shape drawn must already be cached (see ShapeFactoryManager::Preload).
+         * 
+         * @param program The shader program used for all draws.
+         * @param shapes The manager providing the cached shape VAOs.
+         * @param jobs The job system used for recording.
+         */
+        SceneRenderer(ShaderProgram& program, ShapeFactoryManager& shapes, JobSystem& jobs);
+
+        /**
+         * @brief Draws all items of a frame packet.
+         * 
+         * Must be called on the GL thread.
+         * 
+         * @param packet The packet to draw.
+         */
+        void Render(const FramePacket& packet);
+
+        /**
+         * @brief Sets how many items each command buffer records.
+         * @param itemsPerBuffer Items per recording job (at least 1).
+         */
+        void SetItemsPerCommandBuffer(size_t itemsPerBuffer);
+
+        /**
+         * @brief Measures the GPU time of every replayed command buffer as a "DrawGroup" zone.
+         * @param profiler The profiler to use, or nullptr to stop measuring.
+         */
+        void SetGpuProfiler(GpuProfiler* profiler);
+
+        /**
+         * @brief Gets the work submitted by the most recent Render call.
+         * @return The statistics.
+         */
+        const SceneStats& getLastFrameStats() const;
+
+        /**
+         * @brief Gets the arena holding the transient data of the last frame.
+         * @return The arena.
+         */
+        const FrameArena& getFrameArena() const;
+
+        /**
+         * @struct QueueEntry
+         * @brief An item reference in the render queue, ordered by its sort key.
+         */
+        struct QueueEntry
+        {
+            uint64_t key;   ///< Shape in the high 32 bits, texture handle in the low 32 bits.
+            uint32_t index; ///< Index of the item in the frame packet.
+        };
+
+        /**
+         * @brief Fills the render queue of a packet, sorted by shape and then texture.
+         * 
+         * Performs no OpenGL calls.
+         * 
+         * @param packet The packet to sort.
+         * @param queue The queue to fill, with room for every item of the packet.
+         */
+        static void BuildQueue(const FramePacket& packet, QueueEntry* queue);
+
+    private:
+        /**
+         * @brief Records a range of the render queue into a command buffer.
+         * @param packet The packet that owns the items.
+         * @param queue The sorted render queue.
+         * @param begin First queue entry.
+         * @param end One past the last queue entry.
+         * @param buffer The buffer to record into (reset first).
+         */
+        void Record(const FramePacket& packet, const QueueEntry* queue, size_t begin, size_t end, CommandBuffer& buffer) const;
+
+    private:
+        ShaderProgram&          m_program;                ///< Program used for all draws.
+        ShapeFactoryManager&    m_shapes;                 ///< Source of the cached shape VAOs.
+        JobSystem&              m_jobs;                   ///< Job system used for recording.
+        int                     m_transformLocation;      ///< Location of the uWorldTransform uniform.
+        size_t                  m_itemsPerBuffer = 256;   ///< Items recorded per command buffer.
+        FrameArena              m_frameArena;             ///< Transient data of the current frame, such as the render queue.
+        vector<CommandBuffer>   m_commandBuffers;         ///< One buffer per recording chunk, reused between frames.
+        GpuProfiler*            m_gpuProfiler = nullptr;  ///< Measures the draw groups if set.
+        SceneStats              m_lastFrameStats;         ///< Work submitted by the last frame.
+    };
+}
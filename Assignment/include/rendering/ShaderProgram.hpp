@@ -1,7 +1,9 @@
 #pragma once
 
+#include "GLHandle.hpp"
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 
 /**
@@ -42,6 +44,24 @@ namespace graf
          */
         void AttachShader(const string& fileName, unsigned int shadertype);
 
+        /**
+         * @brief Attaches a shader compiled from source code in memory.
+         * 
+         * Used for shaders that come with a library instead of a file.
+         * 
+         * @param source The GLSL source code.
+         * @param shaderType The type of shader (e.g., GL_VERTEX_SHADER, GL_FRAGMENT_SHADER).
+         * @param name Name of the shader in error messages and the resource tracker.
+         */
+        void AttachShaderSource(const string& source, unsigned int shaderType, const string& name);
+
+        /**
+         * @brief Assigns a vertex attribute to a location; takes effect at the next Link.
+         * @param location The attribute location.
+         * @param attributeName The name of the attribute in the vertex shader.
+         */
+        void BindAttributeLocation(unsigned int location, const string& attributeName);
+
         /**
          * @brief Adds a uniform variable to the program.
          * 
@@ -54,11 +74,19 @@ namespace graf
         /**
          * @brief Links the attached shaders into a complete program.
          * 
-         * Finalizes the shader program by linking all attached shaders.
+         * Finalizes the shader program by linking all attached shaders, then deletes
+         * the shader objects, which the linked program no longer needs.
          * @exception ShaderException Thrown if linking fails (not directly here, but in practice).
          */
         void Link();
 
+        /**
+         * @brief Releases the program's OpenGL resources.
+         * 
+         * Deletes the program and any shaders attached but not linked yet.
+         */
+        void Release();
+
         /**
          * @brief Activates the shader program for rendering.
          * 
@@ -93,6 +121,16 @@ namespace graf
          * @param value The glm::mat4 value to set.
          */
         void SetMat4(const string& varName, const glm::mat4& value);
+
+        /**
+         * @brief Gets the location of a uniform added with AddUniform.
+         * 
+         * Lets hot paths resolve the name once and set the uniform by location.
+         * 
+         * @param varName The name of the uniform variable.
+         * @return The uniform location, or -1 if the uniform was not added.
+         */
+        int GetUniformLocation(const string& varName) const;
         
     private:
         /**
@@ -106,7 +144,8 @@ namespace graf
         string getShaderFromFile(const string& fileName);
 
     private:
-        unsigned int m_id;                        ///< OpenGL handle for the shader program.
+        ProgramHandle m_program;                  ///< Owned OpenGL shader program.
+        vector<ShaderHandle> m_shaders;           ///< Shaders attached since the last link.
         unordered_map<string, unsigned int> m_uniforms; ///< Map of uniform names to their locations.
         static unordered_map<string, string> shaderCache; ///< Cache of loaded shader source code.
     };
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "GLHandle.hpp"
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 /**
  * @file TextureManager.hpp
@@ -12,6 +14,8 @@
 namespace graf
 {
     using namespace std;
+
+    class JobSystem;
     
     /**
      * @class TextureManager
@@ -34,6 +38,18 @@ namespace graf
          */
         static void sAddTextureFromFile(const string& fileName);
 
+        /**
+         * @brief Loads several textures, decoding the image files in parallel.
+         * 
+         * Images are decoded on the job system's workers and uploaded to OpenGL by
+         * main-thread jobs. Must be called from the main (GL) thread.
+         * 
+         * @param fileNames The paths to the image files.
+         * @param jobs The job system used for decoding and upload.
+         * @exception TextureException Thrown if a file doesn’t exist or fails to load.
+         */
+        static void sAddTexturesFromFiles(const vector<string>& fileNames, JobSystem& jobs);
+
         /**
          * @brief Activates a texture for rendering.
          * 
@@ -44,6 +60,29 @@ namespace graf
          */
         static void sActivateTexture(const string& textureName);
 
+        /**
+         * @brief Looks up the OpenGL handle of a loaded texture.
+         * 
+         * Performs no OpenGL calls, so it may be used from the simulation thread
+         * once all textures have been loaded.
+         * 
+         * @param textureName The name (file path) of the texture.
+         * @return The OpenGL texture handle.
+         * @exception TextureException Thrown if the texture is not found in the manager.
+         */
+        static unsigned int sGetTextureHandle(const string& textureName);
+
+        /**
+         * @brief Binds a texture by its OpenGL handle.
+         * @param textureId The OpenGL texture handle obtained from sGetTextureHandle.
+         */
+        static void sBindTexture(unsigned int textureId);
+
+        /**
+         * @brief Deletes all loaded textures; call before the OpenGL context is destroyed.
+         */
+        static void sRelease();
+
         /**
          * @brief Destructor for cleaning up texture resources.
          * 
@@ -52,6 +91,33 @@ namespace graf
         ~TextureManager();
 
     private:
+        /**
+         * @struct DecodedImage
+         * @brief Pixel data of an image decoded by stb_image.
+         */
+        struct DecodedImage
+        {
+            unsigned char* data = nullptr; ///< Pixel data owned by stb_image.
+            int width = 0;                 ///< Width in pixels.
+            int height = 0;                ///< Height in pixels.
+            int channels = 0;              ///< Number of color channels.
+        };
+
+        /**
+         * @brief Decodes an image file into memory without touching OpenGL.
+         * @param fileName The path to the image file.
+         * @return The decoded image; the caller owns its pixel data.
+         * @exception TextureException Thrown if decoding fails.
+         */
+        static DecodedImage DecodeImage(const string& fileName);
+
+        /**
+         * @brief Uploads a decoded image as an OpenGL texture and registers it.
+         * @param fileName The name under which the texture is registered.
+         * @param image The decoded image; its pixel data is freed.
+         */
+        static void UploadImage(const string& fileName, DecodedImage& image);
+
         /**
          * @brief Private constructor for singleton pattern.
          * 
@@ -71,6 +137,6 @@ namespace graf
 
     private:
         static shared_ptr<TextureManager> ms_instance;    ///< Singleton instance of the manager.
-        unordered_map<string, unsigned int> m_textureMap; ///< Map of texture names to OpenGL texture IDs.
+        unordered_map<string, TextureHandle> m_textureMap; ///< Map of texture names to owned OpenGL textures.
     };
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <memory>
+#include "GLHandle.hpp"
+#include "IndexBuffer.hpp"
+#include "VertexBuffer.hpp"
 #include <vector>
 
 /**
@@ -33,16 +35,14 @@ namespace graf
      */
     using AttributeList = vector<VertexAttributeType>;
 
-    class VertexBuffer;
-    class IndexBuffer;
-
     /**
      * @class VertexArrayObject
      * @brief A class for handling OpenGL vertex array objects (VAOs).
      * 
      * This class encapsulates the creation, configuration, and rendering of a VAO,
      * which combines vertex buffers, index buffers, and attribute layouts for efficient
-     * 3D rendering.
+     * 3D rendering. It owns the VAO and both buffers, so it can be moved but not
+     * copied; renderers refer to it by pointer or reference.
      */
     class VertexArrayObject
     {
@@ -56,18 +56,18 @@ namespace graf
         void Create();
 
         /**
-         * @brief Sets the vertex buffer for the VAO.
-         * @param p_vb Shared pointer to the VertexBuffer containing vertex data.
-         * @exception BufferException Thrown if the vertex buffer is null or binding fails.
+         * @brief Takes ownership of the vertex buffer for the VAO.
+         * @param vb The VertexBuffer containing vertex data.
+         * @exception BufferException Thrown if binding fails.
          */
-        void SetVertexBuffer(shared_ptr<VertexBuffer> p_vb);
+        void SetVertexBuffer(VertexBuffer&& vb);
 
         /**
-         * @brief Sets the index buffer for the VAO.
-         * @param p_ib Shared pointer to the IndexBuffer containing index data.
-         * @exception BufferException Thrown if the index buffer is null or binding fails.
+         * @brief Takes ownership of the index buffer for the VAO.
+         * @param ib The IndexBuffer containing index data.
+         * @exception BufferException Thrown if binding fails.
          */
-        void SetIndexBuffer(shared_ptr<IndexBuffer> p_ib);
+        void SetIndexBuffer(IndexBuffer&& ib);
 
         /**
          * @brief Adds a vertex attribute to the VAO’s layout.
@@ -100,7 +100,7 @@ namespace graf
         /**
          * @brief Releases the VAO’s OpenGL resources.
          * 
-         * Deletes the VAO and releases the vertex buffer resources.
+         * Deletes the VAO and releases the vertex and index buffer resources.
          */
         void Release();
 
@@ -112,6 +112,18 @@ namespace graf
          */
         void Draw();
 
+        /**
+         * @brief Gets the OpenGL handle of the VAO.
+         * @return The VAO handle.
+         */
+        unsigned int getId() const;
+
+        /**
+         * @brief Gets the number of indices drawn by Draw.
+         * @return The index count, or 0 if no index buffer is set.
+         */
+        int getIndexCount() const;
+
     private:
         /**
          * @brief Gets the size in bytes of a vertex attribute type.
@@ -121,10 +133,10 @@ namespace graf
         int getTypeSize(VertexAttributeType type);
 
     private:
-        unsigned int    m_id;           ///< OpenGL handle for the VAO.
-        shared_ptr<VertexBuffer> mp_vb; ///< Pointer to the associated vertex buffer.
-        shared_ptr<IndexBuffer> mp_ib;  ///< Pointer to the associated index buffer.
-        unsigned int    m_stride;       ///< Total size in bytes of one vertex’s attributes.
+        VertexArrayHandle m_vao;        ///< Owned OpenGL VAO.
+        VertexBuffer    m_vb;           ///< Owned vertex buffer.
+        IndexBuffer     m_ib;           ///< Owned index buffer.
+        unsigned int    m_stride = 0;   ///< Total size in bytes of one vertex’s attributes.
         AttributeList   m_attributes;   ///< List of attribute types in the vertex layout.
     };
 }
\ No newline at end of file
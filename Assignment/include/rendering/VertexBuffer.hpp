@@ -1,5 +1,7 @@
 #pragma once
 
+#include "GLHandle.hpp"
+
 /**
  * @file VertexBuffer.hpp
  * @brief Defines the VertexBuffer class for managing OpenGL vertex buffers.
@@ -13,10 +15,27 @@ namespace graf
      * 
      * This class encapsulates the creation, binding, and management of a vertex buffer,
      * which stores vertex data (e.g., positions, texture coordinates) for 3D rendering.
+     * It owns its buffer object, so it can be moved but not copied.
      */
     class VertexBuffer
     {
     public:
+        VertexBuffer() = default;
+
+        /**
+         * @brief Releases the buffer if it is still owned.
+         */
+        ~VertexBuffer();
+
+        VertexBuffer(VertexBuffer&&) = default;
+
+        /**
+         * @brief Releases the owned buffer and takes over the buffer of another instance.
+         * @param other The buffer to move from.
+         * @return This buffer.
+         */
+        VertexBuffer& operator=(VertexBuffer&& other) noexcept;
+
         /**
          * @brief Creates an OpenGL vertex buffer with the specified data.
          * 
@@ -50,6 +69,7 @@ namespace graf
         void Release();
 
     private:
-        unsigned int m_id; ///< OpenGL handle for the vertex buffer object.
+        BufferHandle m_buffer; ///< Owned vertex buffer object.
+        int m_size = 0;        ///< Size of the buffer in bytes.
     };
 }
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ShapeFactoryManager.hpp"
+#include "FramePacket.hpp"
+#include "JobSystem.hpp"
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @file Scene.hpp
+ * @brief Defines the scene object data and functions to persist and render it.
+ */
+
+namespace graf
+{
+    /**
+     * @struct ObjectData
+     * @brief Stores properties of a renderable 3D object.
+     */
+    struct ObjectData 
+    {
+        glm::vec3 position;            ///< 3D position of the object in world space.
+        float angle = 0.0f;            ///< Rotation angle around the Y-axis in degrees.
+        std::string texture;           ///< File path of the texture applied to the object.
+        ShapeTypes shape = ShapeTypes::Cube; ///< Type of shape (e.g., Cube, Pyramid).
+    };
+
+    /**
+     * @brief Saves the state of objects to a JSON file.
+     * 
+     * @param objects Vector of ObjectData containing the objects to save.
+     * @param filename The path to the JSON file where data will be saved.
+     */
+    void saveObjectsToJson(const std::vector<ObjectData>& objects, const std::string& filename);
+
+    /**
+     * @brief Loads the state of objects from a JSON file.
+     * 
+     * The document is parsed on the calling thread and its entries are converted
+     * to ObjectData in parallel.
+     * 
+     * @param filename The path to the JSON file to read from.
+     * @param jobs The job system used to convert the entries.
+     * @return Vector of ObjectData loaded from the file, or empty if loading fails.
+     */
+    std::vector<ObjectData> loadObjectsFromJson(const std::string& filename, JobSystem& jobs);
+
+    /**
+     * @brief Builds the world transform of an object.
+     * 
+     * @param position The object’s position in 3D space.
+     * @param angle The rotation angle around the Y-axis in degrees.
+     * @param scale The uniform scale factor for the object.
+     * @return The combined world transform.
+     */
+    glm::mat4 BuildWorldMatrix(const glm::vec3& position, float angle, float scale);
+
+    /**
+     * @brief Fills a frame packet with the visible objects of a scene.
+     * 
+     * Frustum culling, matrix composition and texture handle lookup run in parallel
+     * on the job system; the visible items keep the order of the objects.
+     * 
+     * @param objects The scene objects.
+     * @param viewProjection The combined projection and view matrix.
+     * @param scale The uniform scale factor applied to all objects.
+     * @param packet The packet to fill; its previous items are replaced.
+     * @param jobs The job system used for the per-object work.
+     */
+    void BuildFramePacket(const std::vector<ObjectData>& objects, const glm::mat4& viewProjection,
+                          float scale, FramePacket& packet, JobSystem& jobs);
+
+    /**
+     * @brief Fills a frame packet with objects interpolated between two simulation ticks.
+     * 
+     * Position and angle are blended between the previous and the current state;
+     * shape and texture are taken from the current state. Objects without a previous
+     * state are drawn at their current state.
+     * 
+     * @param previous The scene objects as of the tick before the latest one.
+     * @param objects The scene objects as of the latest tick.
+     * @param alpha Blend factor in [0, 1]; 0 is the previous state, 1 the current one.
+     * @param viewProjection The combined projection and view matrix.
+     * @param scale The uniform scale factor applied to all objects.
+     * @param packet The packet to fill; its previous items are replaced.
+     * @param jobs The job system used for the per-object work.
+     */
+    void BuildFramePacket(const std::vector<ObjectData>& previous, const std::vector<ObjectData>& objects,
+                          float alpha, const glm::mat4& viewProjection, float scale,
+                          FramePacket& packet, JobSystem& jobs);
+}
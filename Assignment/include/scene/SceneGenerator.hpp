@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Scene.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file SceneGenerator.hpp
+ * @brief Defines a seeded generator of large synthetic scenes for stress tests and benchmarks.
+ */
+
+namespace graf
+{
+    const size_t SHAPE_TYPE_COUNT = 5; ///< Number of ShapeTypes values.
+
+    /**
+     * @enum SpatialDistribution
+     * @brief How generated objects are placed in the scene volume.
+     */
+    enum class SpatialDistribution
+    {
+        Uniform,    ///< Uniformly random in the whole volume.
+        Clustered,  ///< Normally distributed around a few random cluster centres.
+        Grid        ///< A regular grid on the ground plane, like the demo scene at scale.
+    };
+
+    /**
+     * @struct SceneGeneratorSettings
+     * @brief Parameters of a generated scene.
+     */
+    struct SceneGeneratorSettings
+    {
+        size_t  objectCount = 1000;                                         ///< Number of objects.
+        std::array<float, SHAPE_TYPE_COUNT> shapeWeights{1, 1, 1, 1, 1};    ///< Relative frequency of each shape, indexed by ShapeTypes.
+        size_t  textureCount = 4;                                           ///< Distinct textures used (at most the number of files given).
+        SpatialDistribution distribution = SpatialDistribution::Uniform;    ///< Placement of the objects.
+        float   extent = 50.0f;                                             ///< Half width of the scene volume around the origin.
+        size_t  clusterCount = 8;                                           ///< Cluster centres of SpatialDistribution::Clustered.
+        float   motionFraction = 0.1f;                                      ///< Fraction of objects animated by AnimateScene, in [0, 1].
+        uint64_t seed = 42;                                                 ///< Seed of the generator.
+    };
+
+    /**
+     * @struct GeneratedScene
+     * @brief A generated object list and the state needed to animate it.
+     */
+    struct GeneratedScene
+    {
+        std::vector<ObjectData> objects;    ///< The scene objects.
+        std::vector<size_t>     moving;     ///< Indices of the animated objects.
+        std::vector<glm::vec3>  anchors;    ///< Rest position of each animated object.
+        std::vector<float>      phases;     ///< Animation phase of each animated object in radians.
+    };
+
+    /**
+     * @brief Generates a scene; the same settings and textures always give the same scene.
+     *
+     * Shapes are drawn by weight, textures uniformly from the first textureCount
+     * files, and the volume is [-extent, extent] horizontally and a quarter of that
+     * vertically. The standard distributions are used, so the scene is only
+     * identical between builds with the same standard library.
+     *
+     * @param settings The scene parameters.
+     * @param textures Texture files to assign, which must be loaded before drawing.
+     * @return The scene.
+     * @exception std::invalid_argument Thrown for an empty texture list, a negative shape weight or all-zero shape weights.
+     */
+    GeneratedScene GenerateScene(const SceneGeneratorSettings& settings, const std::vector<std::string>& textures);
+
+    /**
+     * @brief Moves the animated objects of a scene to their state at a point in time.
+     *
+     * Each animated object circles its anchor and spins; the state depends only on
+     * the time, so frames can be rendered in any order.
+     *
+     * @param scene The scene to update.
+     * @param time Seconds since the start of the animation.
+     */
+    void AnimateScene(GeneratedScene& scene, double time);
+
+    /**
+     * @brief Parses a spatial distribution from its command-line name.
+     * @param name One of "uniform", "clustered" or "grid".
+     * @return The distribution.
+     * @exception std::invalid_argument Thrown for an unknown name.
+     */
+    SpatialDistribution ParseSpatialDistribution(const std::string& name);
+
+    /**
+     * @brief Parses shape weights such as "cube=4,pyramid=1"; unnamed shapes get weight 0.
+     * @param mix Comma-separated name=weight pairs of circle, square, cube, pyramid and frustum.
+     * @return The weights, indexed by ShapeTypes.
+     * @exception std::invalid_argument Thrown for an unknown shape or a malformed pair.
+     */
+    std::array<float, SHAPE_TYPE_COUNT> ParseShapeMix(const std::string& mix);
+}
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @file SlotMap.hpp
+ * @brief Defines the SlotMap container, which addresses densely stored values through generational handles.
+ */
+
+namespace graf
+{
+    /**
+     * @struct SlotHandle
+     * @brief A stable reference to a value of a SlotMap.
+     *
+     * The index names a slot of the map and the generation the value that
+     * occupied it when the handle was made; erasing the value changes the slot's
+     * generation, so every handle to it becomes detectably stale.
+     */
+    struct SlotHandle
+    {
+        static const uint32_t INVALID_INDEX = UINT32_MAX; ///< Index of a handle that refers to nothing.
+
+        uint32_t index = INVALID_INDEX;     ///< Slot of the value.
+        uint32_t generation = 0;            ///< Generation of the slot when the value was inserted.
+
+        /**
+         * @brief Checks whether the handle was returned by a map, which does not mean its value still exists.
+         * @return False for a default-constructed handle.
+         */
+        bool IsValid() const { return index != INVALID_INDEX; }
+
+        bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+        bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+    };
+
+    /**
+     * @class SlotMap
+     * @brief An unordered container with O(1) insertion, erasure and lookup through generational handles.
+     *
+     * Values are packed into one vector, so iterating over them is a linear walk
+     * that existing functions taking a std::vector can use via GetValues. A slot
+     * table maps handles to positions in that vector. Erasing moves the last value
+     * into the gap instead of shifting, so erasure is O(1) and the order of the
+     * values changes; positions are therefore not stable, only handles are. A
+     * slot whose generation counter is exhausted is retired instead of reused, so
+     * a stale handle can never match a later value. Copies of a map accept the
+     * same handles, and performing the same operations on both keeps their
+     * values at the same positions.
+     *
+     * @tparam T Value type.
+     */
+    template <class T>
+    class SlotMap
+    {
+    public:
+        using iterator = typename std::vector<T>::iterator;
+        using const_iterator = typename std::vector<T>::const_iterator;
+
+        /**
+         * @brief Inserts a copy of a value.
+         * @param value The value.
+         * @return The handle of the new value.
+         */
+        SlotHandle Insert(const T& value) { return Emplace(value); }
+
+        /**
+         * @brief Inserts a value by moving it.
+         * @param value The value.
+         * @return The handle of the new value.
+         */
+        SlotHandle Insert(T&& value) { return Emplace(std::move(value)); }
+
+        /**
+         * @brief Inserts a value constructed in place, after the existing ones.
+         * @param args Constructor arguments.
+         * @return The handle of the new value.
+         * @exception std::length_error Thrown if the slot table would exceed 32-bit indices.
+         */
+        template <class... Args>
+        SlotHandle Emplace(Args&&... args)
+        {
+            uint32_t slotIndex = AcquireSlot();
+            size_t denseIndex = m_values.size();
+            try
+            {
+                m_values.emplace_back(std::forward<Args>(args)...);
+                m_denseToSlot.push_back(slotIndex);
+            }
+            catch (...)
+            {
+                if (m_values.size() > denseIndex)
+                    m_values.pop_back();
+                FreeSlot(slotIndex);
+                throw;
+            }
+            m_slots[slotIndex].denseIndex = static_cast<uint32_t>(denseIndex);
+            return SlotHandle{slotIndex, m_slots[slotIndex].generation};
+        }
+
+        /**
+         * @brief Inserts a range of values, reserving room for all of them first when the range size is known.
+         * @param first The first value.
+         * @param last One past the last value.
+         * @param handles Receives the handles of the new values in order, if given.
+         */
+        template <class InputIt>
+        void Insert(InputIt first, InputIt last, std::vector<SlotHandle>* handles = nullptr)
+        {
+            using Category = typename std::iterator_traits<InputIt>::iterator_category;
+            if constexpr (std::is_base_of<std::forward_iterator_tag, Category>::value)
+            {
+                size_t count = static_cast<size_t>(std::distance(first, last));
+                Reserve(m_values.size() + count);
+                if (handles)
+                    handles->reserve(handles->size() + count);
+            }
+            for (; first != last; ++first)
+            {
+                SlotHandle handle = Emplace(*first);
+                if (handles)
+                    handles->push_back(handle);
+            }
+        }
+
+        /**
+         * @brief Erases a value; the last value moves into its position.
+         * @param handle The handle of the value.
+         * @return False if the handle is stale or invalid.
+         */
+        bool Erase(SlotHandle handle)
+        {
+            if (!Contains(handle))
+                return false;
+            EraseAt(m_slots[handle.index].denseIndex);
+            return true;
+        }
+
+        /**
+         * @brief Erases the values of several handles, each in O(1).
+         * @param handles The handles; stale and repeated ones are skipped.
+         * @return The number of values erased.
+         */
+        size_t Erase(const std::vector<SlotHandle>& handles)
+        {
+            size_t erased = 0;
+            for (const SlotHandle& handle : handles)
+                erased += Erase(handle) ? 1 : 0;
+            return erased;
+        }
+
+        /**
+         * @brief Erases every value matching a predicate in one pass.
+         * @param predicate Called with each value; true erases it.
+         * @return The number of values erased.
+         */
+        template <class Predicate>
+        size_t EraseIf(Predicate predicate)
+        {
+            size_t erased = 0;
+            for (size_t i = 0; i < m_values.size();)
+            {
+                if (predicate(m_values[i]))
+                {
+                    EraseAt(i); ///< The last value moved to i and is tested next
+                    erased++;
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+            return erased;
+        }
+
+        /**
+         * @brief Erases all values; every handle becomes stale.
+         */
+        void Clear()
+        {
+            for (uint32_t slotIndex : m_denseToSlot)
+                RetireOrFreeSlot(slotIndex);
+            m_values.clear();
+            m_denseToSlot.clear();
+        }
+
+        /**
+         * @brief Reserves room for a number of values.
+         * @param capacity The number of values.
+         */
+        void Reserve(size_t capacity)
+        {
+            m_values.reserve(capacity);
+            m_denseToSlot.reserve(capacity);
+            m_slots.reserve(capacity);
+        }
+
+        /**
+         * @brief Checks whether a handle refers to a value of the map.
+         * @param handle The handle.
+         * @return False if it is stale or invalid.
+         */
+        bool Contains(SlotHandle handle) const
+        {
+            return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+        }
+
+        /**
+         * @brief Gets the value of a handle.
+         * @param handle The handle.
+         * @return The value, or nullptr if the handle is stale or invalid.
+         */
+        T* Get(SlotHandle handle) { return Contains(handle) ? &m_values[m_slots[handle.index].denseIndex] : nullptr; }
+
+        /**
+         * @brief Gets the value of a handle.
+         * @param handle The handle.
+         * @return The value, or nullptr if the handle is stale or invalid.
+         */
+        const T* Get(SlotHandle handle) const { return Contains(handle) ? &m_values[m_slots[handle.index].denseIndex] : nullptr; }
+
+        /**
+         * @brief Gets the value of a handle that must be live.
+         * @param handle The handle.
+         * @return The value.
+         * @exception std::out_of_range Thrown if the handle is stale or invalid.
+         */
+        T& At(SlotHandle handle)
+        {
+            if (!Contains(handle))
+                throw std::out_of_range("Stale or invalid slot map handle");
+            return m_values[m_slots[handle.index].denseIndex];
+        }
+
+        /**
+         * @brief Gets the handle of the value at a position of the dense storage.
+         * @param denseIndex The position, less than size().
+         * @return The handle.
+         */
+        SlotHandle GetHandle(size_t denseIndex) const
+        {
+            uint32_t slotIndex = m_denseToSlot[denseIndex];
+            return SlotHandle{slotIndex, m_slots[slotIndex].generation};
+        }
+
+        /**
+         * @brief Gets the densely packed values, whose order changes when values are erased.
+         * @return The values.
+         */
+        const std::vector<T>& GetValues() const { return m_values; }
+
+        /**
+         * @brief Gets the number of values.
+         * @return The count.
+         */
+        size_t size() const { return m_values.size(); }
+
+        /**
+         * @brief Checks whether the map holds no values.
+         * @return True if empty.
+         */
+        bool empty() const { return m_values.empty(); }
+
+        iterator begin() { return m_values.begin(); }
+        iterator end() { return m_values.end(); }
+        const_iterator begin() const { return m_values.begin(); }
+        const_iterator end() const { return m_values.end(); }
+
+    private:
+        /**
+         * @struct Slot
+         * @brief Maps a handle index to a position in the dense storage.
+         */
+        struct Slot
+        {
+            uint32_t denseIndex;    ///< Position of the value; for a free slot the next free slot.
+            uint32_t generation;    ///< Incremented when the value is erased.
+        };
+
+        static const uint32_t RETIRED_GENERATION = UINT32_MAX; ///< Generation of slots that are never reused.
+
+        /**
+         * @brief Takes a slot from the free list or appends one.
+         * @return The slot index.
+         */
+        uint32_t AcquireSlot()
+        {
+            if (m_freeHead != SlotHandle::INVALID_INDEX)
+            {
+                uint32_t slotIndex = m_freeHead;
+                m_freeHead = m_slots[slotIndex].denseIndex;
+                return slotIndex;
+            }
+            if (m_slots.size() >= SlotHandle::INVALID_INDEX)
+                throw std::length_error("SlotMap slot table is full");
+            m_slots.push_back(Slot{SlotHandle::INVALID_INDEX, 0});
+            return static_cast<uint32_t>(m_slots.size() - 1);
+        }
+
+        /**
+         * @brief Puts a slot on the free list.
+         * @param slotIndex The slot.
+         */
+        void FreeSlot(uint32_t slotIndex)
+        {
+            m_slots[slotIndex].denseIndex = m_freeHead;
+            m_freeHead = slotIndex;
+        }
+
+        /**
+         * @brief Invalidates the handles of a slot and frees it unless its generations are exhausted.
+         * @param slotIndex The slot.
+         */
+        void RetireOrFreeSlot(uint32_t slotIndex)
+        {
+            if (++m_slots[slotIndex].generation != RETIRED_GENERATION)
+                FreeSlot(slotIndex);
+        }
+
+        /**
+         * @brief Erases the value at a position by moving the last value into it.
+         * @param denseIndex The position.
+         */
+        void EraseAt(size_t denseIndex)
+        {
+            uint32_t slotIndex = m_denseToSlot[denseIndex];
+            size_t last = m_values.size() - 1;
+            if (denseIndex != last)
+            {
+                m_values[denseIndex] = std::move(m_values[last]);
+                m_denseToSlot[denseIndex] = m_denseToSlot[last];
+                m_slots[m_denseToSlot[denseIndex]].denseIndex = static_cast<uint32_t>(denseIndex);
+            }
+            m_values.pop_back();
+            m_denseToSlot.pop_back();
+            RetireOrFreeSlot(slotIndex);
+        }
+
+    private:
+        std::vector<T>          m_values;                               ///< Densely packed values.
+        std::vector<uint32_t>   m_denseToSlot;                          ///< Slot of each value.
+        std::vector<Slot>       m_slots;                                ///< Slot table indexed by handle index.
+        uint32_t                m_freeHead = SlotHandle::INVALID_INDEX; ///< First free slot.
+    };
+}
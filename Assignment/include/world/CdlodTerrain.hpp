@@ -0,0 +1,308 @@
+#pragma once
+
+#include "HeightField.hpp"
+#include "IndexBuffer.hpp"
+#include "JobSystem.hpp"
+#include "GLHandle.hpp"
+#include "ShaderProgram.hpp"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @file CdlodTerrain.hpp
+ * @brief Defines the CdlodTerrain class, a heightfield terrain of unbounded size drawn with continuous distance-dependent level of detail.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    class Frustum;
+
+    /**
+     * @struct CdlodTerrainSettings
+     * @brief Parameters of a CDLOD terrain, in world units.
+     */
+    struct CdlodTerrainSettings
+    {
+        HeightFieldSettings terrain;                    ///< The generated terrain.
+        float       viewDistance = 3000.0f;             ///< Distance up to which terrain is drawn.
+        float       leafSize = 64.0f;                   ///< Width of the finest nodes.
+        int         gridSize = 32;                      ///< Quads along each side of the node mesh; a power of two.
+        float       lodRatio = 2.5f;                    ///< A node is drawn while the camera is within this many node widths of it.
+        float       morphStart = 0.7f;                  ///< Fraction of a level's range, past the next finer one, where morphing begins.
+        size_t      maxTiles = 1024;                    ///< Height tiles resident at once.
+        size_t      maxJobs = 0;                        ///< Tiles generated at once; 0 uses twice the worker count.
+        size_t      uploadBudget = 64;                  ///< Tiles uploaded per frame at most.
+        uint64_t    unloadDelay = 120;                  ///< Frames a tile stays resident after it was last needed.
+        glm::vec3   fogColor = glm::vec3(0.62f, 0.74f, 0.88f); ///< Color distant terrain fades into, normally the clear color.
+    };
+
+    /**
+     * @struct CdlodTerrainStats
+     * @brief State of the streaming and the work of the last rendered frame.
+     */
+    struct CdlodTerrainStats
+    {
+        int32_t     levels = 0;             ///< Levels of the quadtree.
+        size_t      residentTiles = 0;      ///< Tiles with heights on the GPU.
+        size_t      pendingTiles = 0;       ///< Tiles waiting for or in generation.
+        size_t      generationJobs = 0;     ///< Tiles being generated.
+        size_t      selectedNodes = 0;      ///< Nodes drawn, whole or in part.
+        size_t      culledNodes = 0;        ///< Nodes rejected by the frustum.
+        size_t      drawCalls = 0;          ///< Draw calls of the last frame.
+        uint64_t    triangles = 0;          ///< Triangles drawn in the last frame.
+        uint64_t    uploadedTiles = 0;      ///< Tiles uploaded in the last update.
+        uint64_t    generatedTiles = 0;     ///< Tiles generated since the start.
+        size_t      tileCapacity = 0;       ///< Layers of the height texture.
+    };
+
+    /**
+     * @class CdlodTerrain
+     * @brief Draws a HeightField of any size with Continuous Distance-Dependent Level of Detail.
+     *
+     * The terrain is covered by a quadtree whose level L nodes are leafSize * 2^L
+     * units wide. Every node is drawn with the same gridSize^2 grid mesh scaled to
+     * its width, so a level holds half the detail of the next finer one. Each
+     * update selects, starting from the coarsest nodes within the view distance,
+     * the nodes whose level suits their distance to the camera: a node is split
+     * into its children where they are within the next finer level's range, and
+     * the quadrants outside it are drawn with the node's own mesh. The number of
+     * nodes per level depends only on lodRatio, so the triangle count grows with
+     * the logarithm of the view distance and not at all with the terrain's size.
+     *
+     * Heights come from the vertex shader: each node has a tile of
+     * (gridSize + 3)^2 samples, one per grid vertex plus a border for normals,
+     * generated from the HeightField on the job system and uploaded into a layer
+     * of a texture array. Towards the end of a level's range the vertex shader
+     * slides every odd vertex onto its even neighbour, so at the range's end the
+     * mesh equals the next coarser level's and neighbouring levels meet without
+     * cracks or popping. While a node's tile is not resident, its parent is drawn
+     * in its place.
+     *
+     * The program must read a vec2 grid position at location 0 and declare the
+     * uniforms uViewProjection, uCamera, uNode, uMorph, uGridSize, uHeights and
+     * uFog (see shaders/terrain_vertex.glsl). Update and Render must be called on
+     * the GL thread.
+     */
+    class CdlodTerrain
+    {
+    public:
+        static const int32_t MAX_LEVELS = 16;   ///< Levels of the quadtree at most.
+
+        /**
+         * @brief Creates the grid mesh and the height texture; no tile is generated before the first Update.
+         * @param jobs The job system that generates the tiles.
+         * @param program The program drawing the terrain.
+         * @param settings The terrain parameters.
+         * @exception WorldException Thrown if the grid size is not a power of two of at least 2 and at most 128.
+         */
+        CdlodTerrain(JobSystem& jobs, ShaderProgram& program, const CdlodTerrainSettings& settings = CdlodTerrainSettings());
+
+        /**
+         * @brief Waits for the generation jobs and releases the GL objects.
+         */
+        ~CdlodTerrain();
+
+        CdlodTerrain(const CdlodTerrain&) = delete;
+        CdlodTerrain& operator=(const CdlodTerrain&) = delete;
+
+        /**
+         * @brief Streams the terrain for a view: uploads finished tiles, selects nodes and schedules generation.
+         * @param viewProjection The combined projection and view matrix.
+         * @param camera The camera position.
+         */
+        void Update(const glm::mat4& viewProjection, const glm::vec3& camera);
+
+        /**
+         * @brief Draws the nodes selected by the last Update.
+         * @param viewProjection The combined projection and view matrix.
+         * @param camera The camera position.
+         */
+        void Render(const glm::mat4& viewProjection, const glm::vec3& camera);
+
+        /**
+         * @brief Gets the terrain's height function.
+         * @return The height field.
+         */
+        const HeightField& GetTerrain() const;
+
+        /**
+         * @brief Gets the streaming state and the work of the last frame.
+         * @return The statistics.
+         */
+        const CdlodTerrainStats& GetStats() const;
+
+        /**
+         * @brief Waits for the generation jobs and deletes all GL objects; must be called while the context is current.
+         */
+        void Release();
+
+    private:
+        /**
+         * @struct NodeKey
+         * @brief Position of a node in the quadtree.
+         */
+        struct NodeKey
+        {
+            int32_t x;      ///< Node index along x at its level.
+            int32_t y;      ///< Node index along y at its level.
+            int32_t level;  ///< Level; 0 is the finest.
+        };
+
+        /**
+         * @enum TileState
+         * @brief Progress of a tile from requested to resident.
+         */
+        enum class TileState
+        {
+            Queued,     ///< Waiting for a generation job.
+            Generating, ///< A job is generating it.
+            Ready       ///< Uploaded to its layer.
+        };
+
+        /**
+         * @struct Tile
+         * @brief The heights of one node.
+         */
+        struct Tile
+        {
+            NodeKey     key{0, 0, 0};               ///< The node.
+            uint64_t    id = 0;                     ///< Unique per creation, so results for an unloaded tile are recognized.
+            TileState   state = TileState::Queued;  ///< Progress.
+            float       priority = 0.0f;            ///< Distance to the camera; lower is generated first.
+            uint64_t    lastUsedFrame = 0;          ///< Last update that needed it.
+            uint32_t    layer = 0;                  ///< Layer of the height texture, once ready.
+            float       minHeight = 0.0f;           ///< Lowest height of the node, once ready.
+            float       maxHeight = 0.0f;           ///< Highest height of the node, once ready.
+        };
+
+        /**
+         * @struct TileResult
+         * @brief The heights of one tile produced by a job.
+         */
+        struct TileResult
+        {
+            uint64_t        key = 0;        ///< Packed node position.
+            uint64_t        tileId = 0;     ///< Id of the tile when the job started.
+            vector<float>   heights;        ///< Samples, row by row.
+            float           minHeight = 0.0f; ///< Lowest height of the grid vertices.
+            float           maxHeight = 0.0f; ///< Highest height of the grid vertices.
+        };
+
+        /**
+         * @struct DrawItem
+         * @brief A node selected for drawing.
+         */
+        struct DrawItem
+        {
+            NodeKey     key;        ///< The node.
+            uint32_t    layer;      ///< Layer of its heights.
+            uint32_t    quadrants;  ///< Bit i set draws quadrant i; x is bit 0 and y bit 1 of i.
+        };
+
+        /**
+         * @brief Packs a node position into a hash map key.
+         * @param key The node.
+         * @return The key.
+         */
+        static uint64_t PackKey(const NodeKey& key);
+
+        /**
+         * @brief Gets the width of the nodes of a level.
+         * @param level The level.
+         * @return The width in world units.
+         */
+        float NodeWidth(int32_t level) const;
+
+        /**
+         * @brief Gets the bounding box of a node, tight once its tile is resident.
+         * @param key The node.
+         * @param boxMin Receives the minimum corner.
+         * @param boxMax Receives the maximum corner.
+         */
+        void NodeBounds(const NodeKey& key, glm::vec3& boxMin, glm::vec3& boxMax) const;
+
+        /**
+         * @brief Checks whether a node's bounding box comes within a distance of the camera.
+         * @param key The node.
+         * @param camera The camera position.
+         * @param distance The distance.
+         * @return True if any point of the box is within the distance.
+         */
+        bool IsInRange(const NodeKey& key, const glm::vec3& camera, float distance) const;
+
+        /**
+         * @brief Selects the nodes covering a quadtree node and requests the missing tiles.
+         * @param key The node.
+         * @param camera The camera position.
+         * @param frustum The view frustum.
+         * @return True if the node is covered by drawable nodes or culled.
+         */
+        bool SelectNode(const NodeKey& key, const glm::vec3& camera, const Frustum& frustum);
+
+        /**
+         * @brief Gets a tile, requesting it if it is not resident yet, and marks it used.
+         * @param key The node.
+         * @param camera The camera position.
+         * @return The tile.
+         */
+        Tile& RequestTile(const NodeKey& key, const glm::vec3& camera);
+
+        /**
+         * @brief Starts generation jobs for queued tiles up to the job limit, coarsest and nearest first.
+         */
+        void ScheduleGeneration();
+
+        /**
+         * @brief Uploads finished tiles within the budget.
+         */
+        void ApplyResults();
+
+        /**
+         * @brief Unloads the least recently used tile that was not needed in the last frame.
+         * @return False if every resident tile is in use.
+         */
+        bool EvictTile();
+
+        /**
+         * @brief Unloads tiles that were not needed for a while and frees their layers.
+         */
+        void UnloadTiles();
+
+        /**
+         * @brief Drops the handles of finished jobs.
+         */
+        void PruneJobs();
+
+    private:
+        JobSystem&                          m_jobs;             ///< Runs the generation jobs.
+        ShaderProgram&                      m_program;          ///< Draws the terrain.
+        CdlodTerrainSettings                m_settings;         ///< The parameters.
+        HeightField                         m_terrain;          ///< The generated terrain.
+        int32_t                             m_topLevel = 0;     ///< Level of the quadtree roots.
+        vector<float>                       m_ranges;           ///< Distance up to which each level is drawn.
+        vector<glm::vec2>                   m_morphRanges;      ///< Distances where each level's morphing starts and ends.
+        int                                 m_tileSamples = 0;  ///< Samples along each side of a tile.
+        VertexArrayHandle                   m_gridArray;        ///< Vertex array of the grid mesh.
+        BufferHandle                        m_gridVertices;     ///< Grid vertex positions.
+        IndexBuffer                         m_gridIndices;      ///< Grid triangles, ordered by quadrant.
+        TextureHandle                       m_heightTexture;    ///< Texture array with one tile per layer.
+        vector<uint32_t>                    m_freeLayers;       ///< Layers holding no tile.
+        unordered_map<uint64_t, Tile>       m_tiles;            ///< Resident and requested tiles.
+        vector<DrawItem>                    m_selected;         ///< Nodes drawn, from the last Update.
+        vector<TileResult>                  m_results;          ///< Finished jobs not applied yet, guarded by m_resultMutex.
+        mutex                               m_resultMutex;      ///< Guards m_results.
+        vector<TileResult>                  m_pendingResults;   ///< Taken from m_results, waiting for upload budget.
+        vector<JobHandle>                   m_tileJobs;         ///< Running jobs.
+        vector<Tile*>                       m_queue;            ///< Scratch list of tiles to schedule.
+        uint64_t                            m_frame = 0;        ///< Updates so far.
+        uint64_t                            m_nextTileId = 1;   ///< Id of the next created tile.
+        size_t                              m_jobsInFlight = 0; ///< Scheduled jobs whose results are not applied yet.
+        uint64_t                            m_generatedTiles = 0; ///< Tiles generated since the start.
+        CdlodTerrainStats                   m_stats;            ///< Statistics of the last frame.
+    };
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @file HeightField.hpp
+ * @brief Defines a procedural height field of fractal Perlin noise for outdoor worlds.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @struct HeightFieldSettings
+     * @brief Parameters of a procedural height field, in world units.
+     */
+    struct HeightFieldSettings
+    {
+        uint32_t seed = 1;              ///< Selects the variation of the noise.
+        float    baseHeight = 48.0f;    ///< Height of the plains.
+        float    hillHeight = 40.0f;    ///< Amplitude of the rolling hills.
+        float    mountainHeight = 140.0f; ///< Height the ridged mountains add where they occur.
+        float    featureSize = 400.0f;  ///< Horizontal size of the largest hills.
+        int      octaves = 6;           ///< Noise octaves; each adds detail at half the size.
+        float    lacunarity = 2.0f;     ///< Frequency ratio of successive octaves.
+        float    gain = 0.5f;           ///< Amplitude ratio of successive octaves.
+    };
+
+    /**
+     * @class HeightField
+     * @brief Terrain height as a pure function of the horizontal position.
+     *
+     * Sums fractal Brownian motion for hills and ridged noise, masked by a very low
+     * frequency noise, for mountain ranges, using stb_perlin. The function has no
+     * state besides its settings, so any number of threads can sample it at once
+     * and tiles generated in any order agree at their borders.
+     */
+    class HeightField
+    {
+    public:
+        /**
+         * @brief Constructs a height field.
+         * @param settings The parameters.
+         */
+        explicit HeightField(const HeightFieldSettings& settings = HeightFieldSettings());
+
+        /**
+         * @brief Gets the height at a position.
+         * @param x First horizontal coordinate.
+         * @param y Second horizontal coordinate.
+         * @return The height, at least 0.
+         */
+        float GetHeight(float x, float y) const;
+
+        /**
+         * @brief Gets the highest height the field can return.
+         * @return The bound.
+         */
+        float GetMaxHeight() const;
+
+        /**
+         * @brief Gets the parameters.
+         * @return The settings.
+         */
+        const HeightFieldSettings& GetSettings() const;
+
+    private:
+        HeightFieldSettings m_settings;     ///< The parameters.
+        float               m_seedOffset;   ///< Noise z coordinate selecting the seed's slice of the noise.
+        float               m_frequency;    ///< Inverse of the feature size.
+    };
+}
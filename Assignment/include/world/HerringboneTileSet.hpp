@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file HerringboneTileSet.hpp
+ * @brief Defines the HerringboneTileSet class, which generates tile maps from stb herringbone Wang tile templates.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @class HerringboneTileSet
+     * @brief A set of herringbone Wang tiles that fills any rectangle of an unbounded map on demand.
+     *
+     * Templates are the images of stb_herringbone_wang_tile: rectangles of 2n x n
+     * and n x 2n cells whose corners or edges carry colors, laid out in a
+     * herringbone pattern so that tiles whose colors match join seamlessly. One
+     * template pixel becomes one map cell, stored as an index into the palette of
+     * the template's colors.
+     *
+     * stb's own generator fills one image of at most 100 x 100 tiles in scan order
+     * with rand() and global state, so it can neither run on several threads nor
+     * produce part of a larger map. Here the color of every corner or edge is
+     * instead a hash of its lattice position and the seed, and each tile is chosen
+     * among the variants matching its six colors by a hash of its position. Every
+     * cell is thus a pure function of its coordinates: rectangles can be generated
+     * in any order, on any thread, and always agree along their borders. The
+     * repetition reduction of stb's generator is not applied.
+     */
+    class HerringboneTileSet
+    {
+    public:
+        static const uint8_t VOID_CELL = 255;   ///< Cell index outside the map.
+
+        /**
+         * @brief Loads a template image.
+         * @param templateFile Path of a template PNG made with stb_herringbone_wang_tile.
+         * @exception WorldException Thrown if the image cannot be loaded or is not a template.
+         */
+        explicit HerringboneTileSet(const string& templateFile);
+
+        /**
+         * @brief Generates the cells of a rectangle of the map; thread-safe.
+         * @param seed Selects the map.
+         * @param x First column of the rectangle.
+         * @param y First row of the rectangle.
+         * @param width Columns of the rectangle.
+         * @param height Rows of the rectangle.
+         * @param cells Receives the palette indices, row by row.
+         * @param stride Distance between rows of cells.
+         */
+        void Generate(uint32_t seed, int32_t x, int32_t y, int width, int height, uint8_t* cells, size_t stride) const;
+
+        /**
+         * @brief Gets the colors the cell values index.
+         * @return Red, green and blue of each palette entry.
+         */
+        const vector<array<uint8_t, 3>>& GetPalette() const;
+
+        /**
+         * @brief Gets the length of the short side of the tiles.
+         * @return The length in cells.
+         */
+        int GetShortSide() const;
+
+        /**
+         * @brief Gets the number of tile variants.
+         * @return The count of horizontal and vertical tiles.
+         */
+        size_t GetTileCount() const;
+
+    private:
+        /**
+         * @struct Tile
+         * @brief One tile variant: its six corner or edge colors and its cells.
+         */
+        struct Tile
+        {
+            int8_t          colors[6];  ///< Colors in stb's constraint order a to f.
+            vector<uint8_t> cells;      ///< Palette indices, row by row.
+        };
+
+        /**
+         * @brief Packs six colors into a lookup key.
+         * @param colors The colors, each below 8.
+         * @return The key.
+         */
+        static uint32_t PackColors(const int8_t colors[6]);
+
+        /**
+         * @brief Gets the color of a lattice corner.
+         * @param seed The map seed.
+         * @param x Corner column in short-side units.
+         * @param y Corner row in short-side units.
+         * @return The color.
+         */
+        int8_t CornerColor(uint32_t seed, int32_t x, int32_t y) const;
+
+        /**
+         * @brief Gets the color of a lattice edge.
+         * @param seed The map seed.
+         * @param horizontal Whether the edge runs along x.
+         * @param x Column of the edge's first corner in short-side units.
+         * @param y Row of the edge's first corner in short-side units.
+         * @return The color.
+         */
+        int8_t EdgeColor(uint32_t seed, bool horizontal, int32_t x, int32_t y) const;
+
+        /**
+         * @brief Chooses the variant placed at a tile position.
+         * @param tiles The horizontal or vertical tiles.
+         * @param lookup Indices of those tiles by packed colors.
+         * @param colors The colors the tile must match.
+         * @param hash Hash of the tile position.
+         * @return The tile; the best partial match if no tile matches all colors.
+         */
+        static const Tile& ChooseTile(const vector<Tile>& tiles, const unordered_map<uint32_t, vector<uint32_t>>& lookup,
+                                      const int8_t colors[6], uint32_t hash);
+
+        /**
+         * @brief Copies the clipped part of a tile into a rectangle of cells.
+         * @param tile The tile.
+         * @param tileWidth Columns of the tile.
+         * @param tileHeight Rows of the tile.
+         * @param tileX First map column of the tile.
+         * @param tileY First map row of the tile.
+         * @param x First column of the rectangle.
+         * @param y First row of the rectangle.
+         * @param width Columns of the rectangle.
+         * @param height Rows of the rectangle.
+         * @param cells The rectangle's cells.
+         * @param stride Distance between rows of cells.
+         */
+        static void Blit(const Tile& tile, int tileWidth, int tileHeight, int32_t tileX, int32_t tileY,
+                         int32_t x, int32_t y, int width, int height, uint8_t* cells, size_t stride);
+
+    private:
+        bool                                        m_cornerColors = true;  ///< Whether tiles match by corner rather than edge colors.
+        int                                         m_shortSide = 0;        ///< Short side of the tiles in cells.
+        int                                         m_colorCount[6] = {};   ///< Colors of each corner or edge type.
+        vector<Tile>                                m_horizontalTiles;      ///< 2n x n tiles.
+        vector<Tile>                                m_verticalTiles;        ///< n x 2n tiles.
+        unordered_map<uint32_t, vector<uint32_t>>   m_horizontalLookup;     ///< Horizontal tiles by packed colors.
+        unordered_map<uint32_t, vector<uint32_t>>   m_verticalLookup;       ///< Vertical tiles by packed colors.
+        vector<array<uint8_t, 3>>                   m_palette;              ///< Distinct colors of the template.
+    };
+}
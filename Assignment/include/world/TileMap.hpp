@@ -0,0 +1,255 @@
+#pragma once
+
+#include "HerringboneTileSet.hpp"
+#include "IndexBuffer.hpp"
+#include "JobSystem.hpp"
+#include "MeshBufferPool.hpp"
+#include "ShaderProgram.hpp"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @file TileMap.hpp
+ * @brief Defines the TileMap class, a huge herringbone Wang tile map generated and meshed in chunks around the view.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @struct TileMapSettings
+     * @brief Parameters of a tile map; one cell is one world unit.
+     */
+    struct TileMapSettings
+    {
+        string      templateFile;                   ///< Herringbone tile template PNG.
+        uint32_t    seed = 1;                       ///< Selects the map.
+        int32_t     width = 100000;                 ///< Columns of the map.
+        int32_t     height = 100000;                ///< Rows of the map.
+        float       viewDistance = 2000.0f;         ///< Distance from the camera beyond which nothing is loaded.
+        int32_t     prefetchChunks = 1;             ///< Chunks beyond the visible ones generated ahead of time.
+        int32_t     stripChunks = 8;                ///< Adjacent chunks of a row generated by one job.
+        size_t      maxJobs = 0;                    ///< Strips generated at once; 0 uses twice the worker count.
+        size_t      uploadBudget = 2 * 1024 * 1024; ///< Mesh bytes uploaded per frame at most.
+        uint64_t    unloadDelay = 60;               ///< Frames a chunk stays resident after it was last needed.
+    };
+
+    /**
+     * @struct TileMapStats
+     * @brief State of the streaming and the work of the last rendered frame.
+     */
+    struct TileMapStats
+    {
+        size_t      residentChunks = 0;     ///< Chunks with a mesh.
+        size_t      pendingChunks = 0;      ///< Chunks waiting for or in generation.
+        size_t      generationJobs = 0;     ///< Strip jobs running or waiting for upload.
+        size_t      visibleChunks = 0;      ///< Chunks in the view.
+        size_t      drawnChunks = 0;        ///< Chunks drawn in the last frame.
+        size_t      drawCalls = 0;          ///< Draw calls of the last frame.
+        size_t      vertexArrayBinds = 0;   ///< Vertex array binds of the last frame.
+        uint64_t    quads = 0;              ///< Quads drawn in the last frame.
+        uint64_t    uploadedBytes = 0;      ///< Mesh bytes uploaded in the last update.
+        uint64_t    generatedChunks = 0;    ///< Chunks generated since the start.
+        size_t      poolCapacity = 0;       ///< Bytes of the mesh pool.
+        size_t      poolUsed = 0;           ///< Bytes of the mesh pool holding meshes.
+    };
+
+    /**
+     * @class TileMap
+     * @brief Streams a herringbone Wang tile map of up to billions of cells around the camera.
+     *
+     * The map lies in the z = 0 plane and is divided into CHUNK_SIZE^2 chunks.
+     * Every update finds the chunks whose area intersects the view frustum, plus
+     * a small margin, and generates the missing ones on the job system: missing
+     * chunks that are adjacent in a row are generated together as one strip,
+     * which evaluates the herringbone tiles straddling their borders once. Each
+     * chunk is turned into a static mesh of the largest rectangles of equal
+     * cells, usually a few hundred quads for 4096 cells, and uploaded on the GL
+     * thread within a byte budget into a MeshBufferPool. Chunks out of view are
+     * unloaded after a delay, so the memory use depends on the view, not on the
+     * map size; nothing of the map is stored but the tile set.
+     *
+     * The program must read a uvec2 cell position at location 0 and a uvec4 color
+     * at location 1, and have the uniforms uViewProjection and uChunkOrigin.
+     * Update and Render must be called on the GL thread.
+     */
+    class TileMap
+    {
+    public:
+        static const int CHUNK_SIZE = 64;                   ///< Cells along each side of a chunk.
+        static const size_t BYTES_PER_VERTEX = 8;           ///< Two 16-bit coordinates and an RGBA color.
+        static const size_t BYTES_PER_QUAD = 4 * BYTES_PER_VERTEX; ///< Size of a quad in the vertex format.
+        static const uint32_t MAX_QUADS_PER_CHUNK = CHUNK_SIZE * CHUNK_SIZE; ///< Quads of a checkerboard, the worst case.
+
+        /**
+         * @brief Loads the tile set and creates the mesh pool; no chunk is generated before the first Update.
+         * @param jobs The job system that generates the chunks.
+         * @param program The program drawing the chunks.
+         * @param settings The map parameters.
+         * @exception WorldException Thrown if the tile template cannot be loaded.
+         */
+        TileMap(JobSystem& jobs, ShaderProgram& program, const TileMapSettings& settings);
+
+        /**
+         * @brief Waits for the generation jobs and releases the GL objects.
+         */
+        ~TileMap();
+
+        TileMap(const TileMap&) = delete;
+        TileMap& operator=(const TileMap&) = delete;
+
+        /**
+         * @brief Streams the map for a view: uploads finished chunks, selects visible ones and schedules generation.
+         * @param viewProjection The combined projection and view matrix.
+         * @param camera The camera position.
+         */
+        void Update(const glm::mat4& viewProjection, const glm::vec3& camera);
+
+        /**
+         * @brief Draws the visible chunks selected by the last Update.
+         * @param viewProjection The combined projection and view matrix.
+         */
+        void Render(const glm::mat4& viewProjection);
+
+        /**
+         * @brief Gets the tile set the map is generated from.
+         * @return The tile set.
+         */
+        const HerringboneTileSet& GetTileSet() const;
+
+        /**
+         * @brief Gets the streaming state and the work of the last frame.
+         * @return The statistics.
+         */
+        const TileMapStats& GetStats() const;
+
+        /**
+         * @brief Checks whether every chunk in view is generated and uploaded.
+         * @return True if nothing is pending.
+         */
+        bool IsSettled() const;
+
+        /**
+         * @brief Waits for the generation jobs and deletes all GL objects; must be called while the context is current.
+         */
+        void Release();
+
+    private:
+        /**
+         * @struct Chunk
+         * @brief A resident or requested chunk.
+         */
+        struct Chunk
+        {
+            int32_t         x = 0;              ///< Chunk column.
+            int32_t         y = 0;              ///< Chunk row.
+            uint64_t        id = 0;             ///< Unique per creation, so results for an unloaded chunk are recognized.
+            bool            scheduled = false;  ///< Whether a job is generating it.
+            bool            ready = false;      ///< Whether its mesh is uploaded.
+            float           priority = 0.0f;    ///< Distance to the camera; lower is generated first.
+            uint64_t        lastUsedFrame = 0;  ///< Last update that needed it.
+            MeshAllocation  allocation;         ///< Range of the mesh in the pool.
+            uint32_t        quadCount = 0;      ///< Quads of the mesh.
+        };
+
+        /**
+         * @struct ChunkMesh
+         * @brief The mesh of one chunk produced by a job.
+         */
+        struct ChunkMesh
+        {
+            uint64_t        key = 0;        ///< Packed chunk position.
+            uint64_t        chunkId = 0;    ///< Id of the chunk when the job started.
+            vector<uint8_t> vertices;       ///< Four vertices per quad.
+        };
+
+        /**
+         * @struct DrawItem
+         * @brief A visible chunk of the frame.
+         */
+        struct DrawItem
+        {
+            uint32_t        page;       ///< Pool page.
+            int             baseVertex; ///< First vertex in the page.
+            const Chunk*    chunk;      ///< The chunk.
+        };
+
+        /**
+         * @brief Packs a chunk position into a hash map key.
+         * @param x Chunk column.
+         * @param y Chunk row.
+         * @return The key.
+         */
+        static uint64_t PackKey(int32_t x, int32_t y);
+
+        /**
+         * @brief Finds the area of the map plane inside the view frustum.
+         * @param viewProjection The combined projection and view matrix.
+         * @param areaMin Receives the minimum corner.
+         * @param areaMax Receives the maximum corner.
+         * @return False if the frustum does not reach the plane.
+         */
+        static bool FindVisibleArea(const glm::mat4& viewProjection, glm::vec2& areaMin, glm::vec2& areaMax);
+
+        /**
+         * @brief Starts strip jobs for requested chunks up to the job limit, nearest first.
+         */
+        void ScheduleGeneration();
+
+        /**
+         * @brief Starts a job that generates and meshes adjacent chunks of a row.
+         * @param strip The chunks, ordered by column without gaps.
+         */
+        void ScheduleStrip(const vector<Chunk*>& strip);
+
+        /**
+         * @brief Builds the mesh of one chunk from its cells.
+         * @param cells The cells of the strip.
+         * @param stride Distance between rows of cells.
+         * @param palette Colors of the cell values.
+         * @param mesh Receives the vertices.
+         */
+        static void MeshChunk(const uint8_t* cells, size_t stride, const vector<array<uint8_t, 3>>& palette, ChunkMesh& mesh);
+
+        /**
+         * @brief Uploads finished meshes within the byte budget.
+         */
+        void ApplyResults();
+
+        /**
+         * @brief Unloads chunks that were not needed for a while.
+         */
+        void UnloadChunks();
+
+        /**
+         * @brief Drops the handles of finished jobs.
+         */
+        void PruneJobs();
+
+    private:
+        JobSystem&                      m_jobs;             ///< Runs the generation jobs.
+        ShaderProgram&                  m_program;          ///< Draws the chunks.
+        TileMapSettings                 m_settings;         ///< The parameters.
+        HerringboneTileSet              m_tileSet;          ///< The tiles.
+        IndexBuffer                     m_quadIndices;      ///< Two triangles per quad, shared by all chunks.
+        MeshBufferPool                  m_pool;             ///< Vertex storage of all chunks.
+        unordered_map<uint64_t, Chunk>  m_chunks;           ///< Resident and requested chunks.
+        vector<uint64_t>                m_visible;          ///< Chunks in view, from the last Update.
+        vector<ChunkMesh>               m_results;          ///< Finished meshes not applied yet, guarded by m_resultMutex.
+        mutex                           m_resultMutex;      ///< Guards m_results.
+        vector<ChunkMesh>               m_pendingResults;   ///< Taken from m_results, waiting for upload budget.
+        vector<JobHandle>               m_stripJobs;        ///< Running jobs.
+        vector<Chunk*>                  m_queue;            ///< Scratch list of chunks to schedule.
+        vector<DrawItem>                m_drawItems;        ///< Scratch list of visible chunks.
+        size_t                          m_chunksInFlight = 0; ///< Scheduled chunks whose meshes are not applied yet.
+        uint64_t                        m_frame = 0;        ///< Updates so far.
+        uint64_t                        m_nextChunkId = 1;  ///< Id of the next created chunk.
+        uint64_t                        m_generatedChunks = 0; ///< Chunks generated since the start.
+        TileMapStats                    m_stats;            ///< Statistics of the last frame.
+    };
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "HeightField.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @file VoxelMesher.hpp
+ * @brief Defines the VoxelMesher class, which turns procedural voxel chunks into stb_voxel_render meshes.
+ */
+
+struct stbvox_mesh_maker;
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @enum VoxelBlock
+     * @brief Block types of the voxel world; Air is empty space.
+     */
+    enum class VoxelBlock : uint8_t
+    {
+        Air = 0,
+        Stone,
+        Dirt,
+        Grass,
+        Sand,
+        Snow,
+        Brick,  ///< Placed by edits only.
+        Count   ///< Number of block types.
+    };
+
+    /**
+     * @struct VoxelEdit
+     * @brief A block set by an edit, overriding the generated terrain.
+     */
+    struct VoxelEdit
+    {
+        int32_t x, y, z;    ///< Voxel position in world voxels; z is up.
+        VoxelBlock block;   ///< The block placed, Air to dig.
+    };
+
+    /**
+     * @struct VoxelChunkMesh
+     * @brief The mesh of one chunk in stb_voxel_render's vertex format.
+     */
+    struct VoxelChunkMesh
+    {
+        int32_t         chunkZ = 0;     ///< Vertical chunk index within the column.
+        uint32_t        quadCount = 0;  ///< Number of quads, four vertices each.
+        vector<uint8_t> vertices;       ///< Vertices: a packed position and AO word, then the face color and normal.
+        float           transform[3][3] = {}; ///< Value of the shader's per-mesh transform uniform.
+    };
+
+    /**
+     * @class VoxelMesher
+     * @brief Generates the voxels of chunks from a height field and meshes them with stb_voxel_render.
+     *
+     * A chunk is CHUNK_SIZE voxels along each axis. Chunks of level L have voxels
+     * 2^L world units wide, so one mesh of the same size covers 2^L times the
+     * area, which is how distant terrain is drawn with few quads. The stb mesher
+     * reads one voxel beyond the chunk on every side, so the voxels are generated
+     * into a padded block that also lets it cull hidden faces and compute ambient
+     * occlusion across chunk borders. A mesher holds large buffers and is not
+     * thread-safe; each worker thread uses its own.
+     *
+     * Uses stb_voxel_render mode 20: untextured, with a 24-bit color per face and
+     * 32 bytes per quad, all in vertex attributes.
+     */
+    class VoxelMesher
+    {
+    public:
+        static const int CHUNK_SIZE = 32;                       ///< Voxels along each axis of a chunk.
+        static const int PADDED_SIZE = CHUNK_SIZE + 2;          ///< Voxels along each axis of the padded input.
+        static const size_t BYTES_PER_QUAD = 32;                ///< Size of a quad in the vertex format.
+        static const size_t BYTES_PER_VERTEX = 8;               ///< Size of a vertex in the vertex format.
+        static const uint32_t MAX_QUADS_PER_CHUNK = 3 * CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE; ///< Quads of a 3D checkerboard, the worst case.
+
+        /**
+         * @brief Constructs a mesher.
+         */
+        VoxelMesher();
+
+        /**
+         * @brief Frees the mesher's buffers.
+         */
+        ~VoxelMesher();
+
+        VoxelMesher(const VoxelMesher&) = delete;
+        VoxelMesher& operator=(const VoxelMesher&) = delete;
+
+        /**
+         * @brief Samples the terrain heights of a column of chunks; all chunks of the column share them.
+         * @param terrain The height field.
+         * @param level Detail level; voxels are 2^level world units wide.
+         * @param columnX Column index along x at that level.
+         * @param columnY Column index along y at that level.
+         */
+        void BeginColumn(const HeightField& terrain, int level, int32_t columnX, int32_t columnY);
+
+        /**
+         * @brief Generates and meshes one chunk of the current column.
+         *
+         * Chunks entirely above or below the terrain surface are skipped without
+         * running the mesher, unless an edit touches them.
+         *
+         * @param chunkZ Vertical chunk index.
+         * @param edits Edits overriding the generated blocks; only level 0 applies them.
+         * @param mesh Receives the mesh.
+         */
+        void MeshChunk(int32_t chunkZ, const vector<VoxelEdit>& edits, VoxelChunkMesh& mesh);
+
+        /**
+         * @brief Gets the generated block of a voxel; everything below height 0 is stone.
+         * @param surfaceHeight Terrain height at the voxel's centre.
+         * @param centre Height of the voxel's centre.
+         * @param voxelSize Width of the voxel.
+         * @return The block.
+         */
+        static VoxelBlock GetGeneratedBlock(float surfaceHeight, float centre, float voxelSize);
+
+        /**
+         * @brief Gets the vertex shader matching the vertex format.
+         * @return The GLSL source.
+         */
+        static string GetVertexShader();
+
+        /**
+         * @brief Gets the fragment shader matching the vertex format, with distance fog.
+         * @return The GLSL source.
+         */
+        static string GetFragmentShader();
+
+        /**
+         * @brief Gets the face normals indexed by the shaders' normal_table uniform.
+         * @param normals Receives 32 normals.
+         */
+        static void GetNormalTable(float normals[32][3]);
+
+        /**
+         * @brief Gets the color of a block type.
+         * @param block The block type.
+         * @param rgb Receives the red, green and blue components.
+         */
+        static void GetBlockColor(VoxelBlock block, uint8_t rgb[3]);
+
+    private:
+        unique_ptr<stbvox_mesh_maker>   m_maker;        ///< stb mesher state.
+        vector<uint8_t>                 m_blocks;       ///< Padded block types, z fastest.
+        vector<uint8_t>                 m_lighting;     ///< Padded light values for ambient occlusion.
+        vector<uint8_t>                 m_colors;       ///< Padded colors, three bytes per voxel.
+        vector<uint8_t>                 m_output;       ///< stb output buffer, copied out when full.
+        vector<float>                   m_heights;      ///< Terrain height of each padded column.
+        int                             m_level = 0;    ///< Level of the current column.
+        int32_t                         m_columnX = 0;  ///< Current column along x.
+        int32_t                         m_columnY = 0;  ///< Current column along y.
+        float                           m_minHeight = 0.0f; ///< Lowest height of the current column.
+        float                           m_maxHeight = 0.0f; ///< Highest height of the current column.
+    };
+}
@@ -0,0 +1,368 @@
+#pragma once
+
+#include "HeightField.hpp"
+#include "VoxelMesher.hpp"
+#include "IndexBuffer.hpp"
+#include "JobSystem.hpp"
+#include "MeshBufferPool.hpp"
+#include "ShaderProgram.hpp"
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @file VoxelWorld.hpp
+ * @brief Defines the VoxelWorld class, a streamed, editable voxel terrain drawn with stb_voxel_render.
+ */
+
+namespace graf
+{
+    using namespace std;
+
+    /**
+     * @struct VoxelWorldSettings
+     * @brief Parameters of a voxel world, in world units of one level 0 voxel.
+     */
+    struct VoxelWorldSettings
+    {
+        HeightFieldSettings terrain;                    ///< The generated terrain.
+        float       viewDistance = 3000.0f;             ///< Distance up to which terrain is drawn.
+        float       detail = 2.5f;                      ///< A column is split into finer ones when the camera is closer than this many column widths.
+        int32_t     worldHeight = 256;                  ///< Height of the world; edits above it are not drawn.
+        size_t      maxMeshJobs = 0;                    ///< Columns meshed at once; 0 uses twice the worker count.
+        size_t      uploadBudget = 4 * 1024 * 1024;     ///< Mesh bytes uploaded per frame at most.
+        uint64_t    unloadDelay = 120;                  ///< Frames a column stays resident after it was last needed.
+        glm::vec3   fogColor = glm::vec3(0.62f, 0.74f, 0.88f); ///< Color distant terrain fades into, normally the clear color.
+    };
+
+    /**
+     * @struct VoxelWorldStats
+     * @brief State of the streaming and the work of the last rendered frame.
+     */
+    struct VoxelWorldStats
+    {
+        size_t      residentColumns = 0;    ///< Columns with a mesh.
+        size_t      pendingColumns = 0;     ///< Columns waiting for or in meshing.
+        size_t      meshJobs = 0;           ///< Meshing jobs running.
+        size_t      selectedColumns = 0;    ///< Columns covering the view.
+        size_t      drawnChunks = 0;        ///< Chunks drawn in the last frame.
+        size_t      culledChunks = 0;       ///< Chunks rejected by the frustum in the last frame.
+        size_t      drawCalls = 0;          ///< Draw calls of the last frame.
+        size_t      vertexArrayBinds = 0;   ///< Vertex array binds of the last frame.
+        uint64_t    quads = 0;              ///< Quads drawn in the last frame.
+        uint64_t    uploadedBytes = 0;      ///< Mesh bytes uploaded in the last update.
+        uint64_t    meshedColumns = 0;      ///< Columns meshed since the start.
+        uint64_t    remeshedChunks = 0;     ///< Chunks meshed again after edits since the start.
+        size_t      poolCapacity = 0;       ///< Bytes of the mesh pool.
+        size_t      poolUsed = 0;           ///< Bytes of the mesh pool holding meshes.
+    };
+
+    /**
+     * @class VoxelWorld
+     * @brief A procedural voxel terrain that streams, meshes and draws chunks around the camera.
+     *
+     * The world is divided into columns of CHUNK_SIZE^3 chunks stacked along z, the
+     * up axis. A column of level L is 2^L times as wide as a level 0 one and made
+     * of voxels 2^L units wide, and covers four columns of level L - 1, which makes
+     * the columns a quadtree. Every update selects the columns covering the view:
+     * starting from coarse columns within the view distance, a column is replaced
+     * by its four children while the camera is closer than a few column widths, so
+     * the number of columns and quads stays roughly constant however far the view
+     * reaches. While a column is not meshed yet, its resident parent or children
+     * are drawn in its place, so streaming never opens holes.
+     *
+     * Missing columns are meshed by jobs on the job system, nearest and coarsest
+     * first, each worker with its own VoxelMesher. The meshes are uploaded on the
+     * GL thread within a byte budget per frame into a MeshBufferPool, and columns
+     * no longer selected are unloaded after a delay. Rendering uses stb's shaders,
+     * culls every chunk against the frustum, and issues one draw per visible chunk
+     * sorted by pool page.
+     *
+     * Edits are kept as a sparse overlay of level 0 voxels. An edit remeshes only
+     * the level 0 chunks whose padded input contains the voxel, in the background;
+     * the old mesh stays visible until the new one is uploaded. Coarser levels
+     * show the generated terrain without the edits.
+     *
+     * Update, Render and the edit functions must be called on the GL thread.
+     */
+    class VoxelWorld
+    {
+    public:
+        /**
+         * @brief Creates the shaders and the mesh pool; no terrain is generated before the first Update.
+         * @param jobs The job system that meshes the chunks.
+         * @param settings The world parameters.
+         * @exception GrafException Thrown if a GL object cannot be created.
+         */
+        VoxelWorld(JobSystem& jobs, const VoxelWorldSettings& settings = VoxelWorldSettings());
+
+        /**
+         * @brief Waits for the meshing jobs and releases the GL objects.
+         */
+        ~VoxelWorld();
+
+        VoxelWorld(const VoxelWorld&) = delete;
+        VoxelWorld& operator=(const VoxelWorld&) = delete;
+
+        /**
+         * @brief Streams the world for a camera position: uploads finished meshes, selects columns and schedules meshing.
+         * @param camera The camera position.
+         */
+        void Update(const glm::vec3& camera);
+
+        /**
+         * @brief Draws the columns selected by the last Update.
+         * @param viewProjection The combined projection and view matrix.
+         * @param camera The camera position.
+         */
+        void Render(const glm::mat4& viewProjection, const glm::vec3& camera);
+
+        /**
+         * @brief Sets the block of a level 0 voxel and remeshes the affected chunks.
+         * @param voxel The voxel.
+         * @param block The new block.
+         * @return False if the voxel already had that block.
+         */
+        bool SetBlock(const glm::ivec3& voxel, VoxelBlock block);
+
+        /**
+         * @brief Sets the blocks of all voxels whose centres are inside a sphere.
+         * @param center Centre of the sphere.
+         * @param radius Radius of the sphere.
+         * @param block The new block, Air to dig a hole.
+         * @return The number of voxels changed.
+         */
+        size_t SetSphere(const glm::vec3& center, float radius, VoxelBlock block);
+
+        /**
+         * @brief Gets the block of a level 0 voxel, edited or generated.
+         * @param voxel The voxel.
+         * @return The block.
+         */
+        VoxelBlock GetBlock(const glm::ivec3& voxel) const;
+
+        /**
+         * @brief Gets the generated terrain.
+         * @return The height field.
+         */
+        const HeightField& GetTerrain() const;
+
+        /**
+         * @brief Gets the streaming state and the work of the last frame.
+         * @return The statistics.
+         */
+        const VoxelWorldStats& GetStats() const;
+
+        /**
+         * @brief Checks whether every selected column is meshed and uploaded.
+         * @return True if nothing is pending.
+         */
+        bool IsSettled() const;
+
+        /**
+         * @brief Waits for the meshing jobs and deletes all GL objects; must be called while the context is current.
+         */
+        void Release();
+
+    private:
+        /**
+         * @struct ColumnKey
+         * @brief Position of a column in the quadtree.
+         */
+        struct ColumnKey
+        {
+            int32_t x;      ///< Column index along x at its level.
+            int32_t y;      ///< Column index along y at its level.
+            int32_t level;  ///< Level; voxels are 2^level units wide.
+        };
+
+        /**
+         * @enum ColumnState
+         * @brief Progress of a column from requested to drawable.
+         */
+        enum class ColumnState
+        {
+            Queued,     ///< Waiting for a meshing job.
+            Meshing,    ///< A job is meshing it.
+            Ready       ///< Meshed and uploaded.
+        };
+
+        /**
+         * @struct ChunkDraw
+         * @brief The uploaded mesh of one chunk.
+         */
+        struct ChunkDraw
+        {
+            int32_t         chunkZ = 0;         ///< Vertical chunk index.
+            MeshAllocation  allocation;         ///< Range of the mesh in the pool.
+            uint32_t        quadCount = 0;      ///< Quads of the mesh.
+            float           transform[3][3];    ///< Shader transform uniform.
+            glm::vec3       boundsMin;          ///< Minimum corner of the chunk.
+            glm::vec3       boundsMax;          ///< Maximum corner of the chunk.
+        };
+
+        /**
+         * @struct Column
+         * @brief A resident or requested column.
+         */
+        struct Column
+        {
+            ColumnKey           key;                    ///< Position.
+            uint64_t            id = 0;                 ///< Unique per creation, so results for an unloaded column are recognized.
+            ColumnState         state = ColumnState::Queued; ///< Progress.
+            bool                ready = false;          ///< Whether it has been meshed once, so it can be drawn.
+            float               priority = 0.0f;        ///< Distance over width; lower is meshed first.
+            uint64_t            lastUsedFrame = 0;      ///< Last update that selected or drew it.
+            vector<ChunkDraw>   chunks;                 ///< Non-empty chunks.
+            vector<int32_t>     dirtyChunks;            ///< Chunks to mesh again after edits.
+        };
+
+        /**
+         * @struct MeshResult
+         * @brief Meshes produced by a job, applied on the GL thread.
+         */
+        struct MeshResult
+        {
+            uint64_t                key = 0;        ///< Packed column key.
+            uint64_t                columnId = 0;   ///< Id of the column when the job started.
+            bool                    partial = false; ///< Whether only the listed chunks were meshed.
+            vector<VoxelChunkMesh>  chunks;         ///< The meshes, including empty ones of partial results.
+        };
+
+        /**
+         * @struct DrawItem
+         * @brief A visible chunk of the frame.
+         */
+        struct DrawItem
+        {
+            uint32_t            page;       ///< Pool page.
+            int                 baseVertex; ///< First vertex in the page.
+            uint32_t            quadCount;  ///< Quads to draw.
+            const ChunkDraw*    chunk;      ///< The chunk, for its transform.
+        };
+
+        /**
+         * @brief Packs a column key into a hash map key.
+         * @param key The column key.
+         * @return The packed key.
+         */
+        static uint64_t PackKey(const ColumnKey& key);
+
+        /**
+         * @brief Gets the width of the columns of a level.
+         * @param level The level.
+         * @return The width in world units.
+         */
+        static float ColumnWidth(int32_t level);
+
+        /**
+         * @brief Gets the distance from the camera to a column's bounds.
+         * @param key The column.
+         * @param camera The camera position.
+         * @return The distance, 0 inside.
+         */
+        float ColumnDistance(const ColumnKey& key, const glm::vec3& camera) const;
+
+        /**
+         * @brief Gets the number of chunks stacked in a column of a level.
+         * @param level The level.
+         * @return The count.
+         */
+        int32_t ChunksPerColumn(int32_t level) const;
+
+        /**
+         * @brief Selects the columns covering a quadtree node and requests the missing ones.
+         * @param key The node.
+         * @param camera The camera position.
+         * @return True if the node is covered by drawable columns.
+         */
+        bool SelectColumns(const ColumnKey& key, const glm::vec3& camera);
+
+        /**
+         * @brief Gets a column if it is resident or requested.
+         * @param key The column.
+         * @return The column, or nullptr.
+         */
+        Column* FindColumn(const ColumnKey& key);
+
+        /**
+         * @brief Gets a column, requesting it if it is not resident yet, and marks it used.
+         * @param key The column.
+         * @param camera The camera position.
+         * @return The column.
+         */
+        Column& RequestColumn(const ColumnKey& key, const glm::vec3& camera);
+
+        /**
+         * @brief Starts meshing jobs for queued and edited columns up to the job limit.
+         */
+        void ScheduleMeshing();
+
+        /**
+         * @brief Starts a job that meshes a column or some of its chunks.
+         * @param column The column.
+         * @param chunks The chunks to mesh; empty for all.
+         */
+        void ScheduleColumn(Column& column, vector<int32_t> chunks);
+
+        /**
+         * @brief Uploads finished meshes within the byte budget.
+         */
+        void ApplyResults();
+
+        /**
+         * @brief Unloads columns that were not used for a while.
+         */
+        void UnloadColumns();
+
+        /**
+         * @brief Frees the pool ranges of a column's chunks.
+         * @param column The column.
+         */
+        void FreeColumn(Column& column);
+
+        /**
+         * @brief Marks the level 0 chunks whose padded input contains a voxel for remeshing.
+         * @param voxel The edited voxel.
+         */
+        void InvalidateVoxel(const glm::ivec3& voxel);
+
+        /**
+         * @brief Collects the edits of a level 0 column and its eight neighbours.
+         * @param key The column.
+         * @return The edits.
+         */
+        vector<VoxelEdit> GatherEdits(const ColumnKey& key) const;
+
+        /**
+         * @brief Drops the handles of finished jobs.
+         */
+        void PruneJobs();
+
+    private:
+        JobSystem&                              m_jobs;             ///< Runs the meshing jobs.
+        VoxelWorldSettings                      m_settings;         ///< The parameters.
+        HeightField                             m_terrain;          ///< The generated terrain.
+        int32_t                                 m_topLevel;         ///< Level of the quadtree roots.
+        ShaderProgram                           m_program;          ///< stb's shaders.
+        IndexBuffer                             m_quadIndices;      ///< Two triangles per quad, shared by all chunks.
+        MeshBufferPool                          m_pool;             ///< Vertex storage of all chunks.
+        unordered_map<uint64_t, Column>         m_columns;          ///< Resident and requested columns.
+        unordered_map<uint64_t, unordered_map<uint64_t, VoxelEdit>> m_edits; ///< Edits by level 0 column, then by voxel.
+        vector<uint64_t>                        m_selected;         ///< Columns drawn, from the last Update.
+        vector<MeshResult>                      m_results;          ///< Finished jobs not applied yet, guarded by m_resultMutex.
+        mutex                                   m_resultMutex;      ///< Guards m_results.
+        vector<MeshResult>                      m_pendingResults;   ///< Taken from m_results, waiting for upload budget.
+        vector<JobHandle>                       m_meshJobs;         ///< Running jobs.
+        vector<Column*>                         m_queue;            ///< Scratch list of columns to schedule.
+        vector<DrawItem>                        m_drawItems;        ///< Scratch list of visible chunks.
+        uint64_t                                m_frame = 0;        ///< Updates so far.
+        uint64_t                                m_nextColumnId = 1; ///< Id of the next created column.
+        size_t                                  m_jobsInFlight = 0; ///< Scheduled jobs whose results are not applied yet.
+        uint64_t                                m_meshedColumns = 0; ///< Columns meshed since the start.
+        uint64_t                                m_remeshedChunks = 0; ///< Chunks remeshed after edits.
+        VoxelWorldStats                         m_stats;            ///< Statistics of the last frame.
+    };
+}
@@ -0,0 +1,23 @@
+#version 330 core
+in vec3 worldPosition;
+in vec3 normal;
+out vec4 fragColor;
+
+uniform vec3 uCamera;
+uniform vec4 uFog;                  // Color and inverse square fog distance
+
+void main()
+{
+   vec3 n = normalize(normal);
+   vec3 grass = mix(vec3(0.30, 0.45, 0.20), vec3(0.45, 0.50, 0.28), clamp(worldPosition.z / 120.0, 0.0, 1.0));
+   vec3 rock = vec3(0.45, 0.42, 0.40);
+   vec3 albedo = mix(grass, rock, smoothstep(0.75, 0.6, n.z));
+   albedo = mix(albedo, vec3(0.92, 0.93, 0.95), smoothstep(170.0, 200.0, worldPosition.z + 20.0 * n.z));
+
+   vec3 light = normalize(vec3(0.3, -0.5, 0.8));
+   vec3 color = albedo * (vec3(0.55, 0.52, 0.45) * 1.6 * max(dot(n, light), 0.0) + vec3(0.42, 0.46, 0.52) * 0.6);
+
+   vec3 toCamera = worldPosition - uCamera;
+   float fog = 1.0 - exp(-dot(toCamera, toCamera) * uFog.w * 3.0);
+   fragColor = vec4(mix(color, uFog.rgb, fog), 1.0);
+}
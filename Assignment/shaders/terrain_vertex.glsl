@@ -0,0 +1,33 @@
+#version 330 core
+layout (location = 0) in vec2 inGrid;
+
+uniform mat4 uViewProjection;
+uniform vec3 uCamera;
+uniform vec4 uNode;                 // Origin x and y, width, height texture layer
+uniform vec2 uMorph;                // Distances where morphing starts and ends
+uniform float uGridSize;
+uniform sampler2DArray uHeights;
+out vec3 worldPosition;
+out vec3 normal;
+
+float SampleHeight(vec2 grid)
+{
+   vec2 texCoord = (grid + 1.5) / (uGridSize + 3.0);    // Tiles have a border of one sample
+   return texture(uHeights, vec3(texCoord, uNode.w)).r;
+}
+
+void main()
+{
+   float spacing = uNode.z / uGridSize;
+   vec3 position = vec3(uNode.xy + inGrid * spacing, SampleHeight(inGrid));
+
+   // Slide odd vertices onto their even neighbours as the next coarser level nears
+   float morph = clamp((distance(position, uCamera) - uMorph.x) / (uMorph.y - uMorph.x), 0.0, 1.0);
+   vec2 grid = inGrid - fract(inGrid * 0.5) * 2.0 * morph;
+
+   worldPosition = vec3(uNode.xy + grid * spacing, SampleHeight(grid));
+   float slopeX = SampleHeight(grid + vec2(1.0, 0.0)) - SampleHeight(grid - vec2(1.0, 0.0));
+   float slopeY = SampleHeight(grid + vec2(0.0, 1.0)) - SampleHeight(grid - vec2(0.0, 1.0));
+   normal = normalize(vec3(-slopeX, -slopeY, 2.0 * spacing));
+   gl_Position = uViewProjection * vec4(worldPosition, 1.0);
+}
@@ -0,0 +1,13 @@
+#version 330 core
+layout (location = 0) in uvec2 inCell;
+layout (location = 1) in uvec4 inColor;
+
+uniform mat4 uViewProjection;
+uniform vec2 uChunkOrigin;
+out vec3 color;
+
+void main()
+{
+   gl_Position = uViewProjection*vec4(uChunkOrigin + vec2(inCell), 0.0, 1.0);
+   color = vec3(inColor.rgb) / 255.0;
+}
@@ -0,0 +1,115 @@
+#define GLFW_INCLUDE_NONE
+
+#include "RenderCoordinator.hpp"
+#include "RenderTask.hpp"
+#include "RenderWorker.hpp"
+#include "Exceptions.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+/**
+ * @file BatchRenderer.cpp
+ * @brief Command-line tool that renders stills and turntables from scene files offline.
+ *
+ * Usage:
+ *   BatchRenderer <jobs.json> [--workers N]   Coordinate N headless worker processes
+ *                                             (default: one per hardware thread,
+ *                                             0: render in this process).
+ *   BatchRenderer --worker                    Serve render tasks on stdin/stdout.
+ */
+
+/**
+ * @brief Batch renderer entry point.
+ * 
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit status: 0 if every frame was rendered, -1 otherwise.
+ */
+int main(int argc, char** argv)
+{
+    try
+    {
+        if (argc >= 2 && std::string(argv[1]) == "--worker")
+        {
+            graf::RenderWorker worker;
+            worker.Serve(std::cin, std::cout);
+            return 0;
+        }
+
+        if (argc < 2)
+        {
+            std::cerr << "Usage: " << argv[0] << " <jobs.json> [--workers N]" << std::endl;
+            return -1;
+        }
+
+        unsigned int workerCount = std::thread::hardware_concurrency();
+        try
+        {
+            for (int i = 2; i < argc; i += 2)
+            {
+                std::string option = argv[i];
+                if (i + 1 >= argc)
+                    throw std::invalid_argument("Missing value for " + option);
+                if (option == "--workers")
+                    workerCount = static_cast<unsigned int>(std::stoul(argv[i + 1]));
+                else
+                    throw std::invalid_argument("Unknown option " + option);
+            }
+        }
+        catch (const std::logic_error& e) ///< Unknown options, missing values and malformed numbers
+        {
+            std::cerr << e.what() << std::endl;
+            std::cerr << "Usage: " << argv[0] << " <jobs.json> [--workers N]" << std::endl;
+            return -1;
+        }
+
+        std::vector<graf::RenderTask> tasks = graf::LoadRenderTasks(argv[1]);
+
+        graf::BatchResult result;
+        if (workerCount == 0)
+        {
+            auto start = std::chrono::steady_clock::now();
+            graf::RenderWorker worker;
+            for (const auto& task : tasks)
+            {
+                try
+                {
+                    double ms = worker.RenderFrame(task);
+                    result.rendered++;
+                    std::cout << "[" << (task.id + 1) << "/" << tasks.size() << "] " << task.output
+                              << " (" << ms << " ms)" << std::endl;
+                }
+                catch (const std::exception& e) ///< Also file and JSON errors, as the workers do
+                {
+                    result.failed++;
+                    std::cerr << "Failed to render " << task.output << ": " << e.what() << std::endl;
+                }
+            }
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        else
+        {
+            graf::RenderCoordinator coordinator({argv[0], "--worker"}, workerCount);
+            result = coordinator.Run(tasks);
+        }
+
+        std::cout << "Rendered " << result.rendered << " frames (" << result.failed << " failed) in "
+                  << result.seconds << " s, " << (result.seconds > 0 ? result.rendered / result.seconds : 0.0)
+                  << " frames/s" << std::endl;
+        return result.failed == 0 ? 0 : -1;
+    }
+    catch (const graf::GrafException& e)
+    {
+        std::cerr << "Batch error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Unexpected error: " << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,387 @@
+#define GLFW_INCLUDE_NONE
+
+#include "GLWindow.hpp"
+#include "JobSystem.hpp"
+#include "FrameCapture.hpp"
+#include "VoxelWorld.hpp"
+#include "TileMap.hpp"
+#include "CdlodTerrain.hpp"
+#include "ShaderProgram.hpp"
+#include "RollingStats.hpp"
+#include "GpuResourceTracker.hpp"
+#include "Exceptions.hpp"
+#include "Profiler.hpp"
+#include <GLFW/glfw3.h>
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <glm/gtc/matrix_transform.hpp>
+
+/**
+ * @file WorldViewer.cpp
+ * @brief Flies a camera over a streamed outdoor world and reports the frame times and streaming statistics.
+ *
+ * Usage:
+ *   WorldViewer [--world voxel|tiles|terrain] [--headless WxH] [--frames N] [--view-distance F]
+ *               [--speed F] [--edits N] [--template file.png] [--seed N]
+ *               [--screenshot file.png] [--trace file.json]
+ *
+ * `--world voxel` streams the voxel terrain; `--world terrain` draws the same
+ * height field as a smooth CDLOD terrain; `--world tiles` streams a
+ * 100000 x 100000 herringbone Wang tile map made from `--template`, seen from
+ * above. The camera follows a fixed path, so runs are repeatable; in a
+ * window the left and right arrow keys steer and the up and down arrow keys
+ * change the speed. `--edits N` digs a crater ahead of the camera every N frames
+ * (0 disables it) to exercise remeshing of the voxel world. `--screenshot` saves the last frame.
+ * Headless runs need `--frames`.
+ */
+
+namespace
+{
+    /**
+     * @struct Options
+     * @brief Command-line options of the viewer.
+     */
+    struct Options
+    {
+        std::string world = "voxel";        ///< World subsystem to view.
+        bool        headless = false;       ///< Render offscreen.
+        unsigned    width = 1280;           ///< Framebuffer width.
+        unsigned    height = 720;           ///< Framebuffer height.
+        uint64_t    frames = 0;             ///< Frames to render; 0 renders until the window closes.
+        float       viewDistance = 3000.0f; ///< Distance up to which the world is drawn.
+        float       speed = 120.0f;         ///< Camera speed in units per second.
+        uint64_t    editInterval = 90;      ///< Frames between edits; 0 disables them.
+        std::string templateFile = "../Thirdparty/stb/data/herringbone/template_rooms_and_corridors.png"; ///< Tile template of the tile map.
+        uint32_t    seed = 1;               ///< Seed of the tile map.
+        std::string screenshotFile;         ///< Image of the last frame.
+        std::string traceFile;              ///< Chrome trace written on exit.
+    };
+
+    /**
+     * @brief Parses the command line.
+     * @param argc Number of arguments.
+     * @param argv The arguments.
+     * @return The options.
+     * @exception std::invalid_argument Thrown for an unknown option or a malformed value.
+     */
+    Options ParseOptions(int argc, char** argv)
+    {
+        Options options;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string option = argv[i];
+            if (i + 1 >= argc)
+                throw std::invalid_argument("Missing value for " + option);
+            std::string value = argv[++i];
+            if (option == "--world")
+                options.world = value;
+            else if (option == "--headless")
+            {
+                options.headless = true;
+                if (std::sscanf(value.c_str(), "%ux%u", &options.width, &options.height) != 2)
+                    throw std::invalid_argument("Expected --headless <width>x<height>");
+            }
+            else if (option == "--frames")
+                options.frames = std::stoull(value);
+            else if (option == "--view-distance")
+                options.viewDistance = std::stof(value);
+            else if (option == "--speed")
+                options.speed = std::stof(value);
+            else if (option == "--edits")
+                options.editInterval = std::stoull(value);
+            else if (option == "--template")
+                options.templateFile = value;
+            else if (option == "--seed")
+                options.seed = static_cast<uint32_t>(std::stoul(value));
+            else if (option == "--screenshot")
+                options.screenshotFile = value;
+            else if (option == "--trace")
+                options.traceFile = value;
+            else
+                throw std::invalid_argument("Unknown option " + option);
+        }
+        if (options.world != "voxel" && options.world != "tiles" && options.world != "terrain")
+            throw std::invalid_argument("Unknown world " + options.world);
+        if (options.headless && options.frames == 0)
+            throw std::invalid_argument("Headless runs need --frames");
+        return options;
+    }
+
+    /**
+     * @struct FlightCamera
+     * @brief A camera gliding over the terrain, or over the plane z = 0, at a fixed height above the ground; z is up.
+     */
+    struct FlightCamera
+    {
+        glm::vec3 position = glm::vec3(0.0f);  ///< Current position.
+        float     heading = 0.3f;               ///< Direction of flight in radians around z.
+        float     turnRate = 0.0f;              ///< Heading change in radians per second, from the arrow keys.
+        float     speed = 120.0f;               ///< Units per second.
+        float     clearance = 45.0f;            ///< Height above the terrain.
+        float     pitch = -0.18f;               ///< Vertical part of the view direction per unit ahead.
+
+        /**
+         * @brief Gets the direction of flight.
+         * @return The horizontal unit vector.
+         */
+        glm::vec3 Forward() const
+        {
+            return glm::vec3(std::cos(heading), std::sin(heading), 0.0f);
+        }
+
+        /**
+         * @brief Moves the camera by one step, following the terrain height smoothly.
+         * @param terrain The terrain to follow, or null for the plane z = 0.
+         * @param seconds Length of the step.
+         */
+        void Advance(const graf::HeightField* terrain, float seconds)
+        {
+            heading += (turnRate + 0.05f * std::sin(position.x * 0.0007f)) * seconds; ///< Slow meander
+            position += Forward() * speed * seconds;
+            glm::vec3 ahead = position + Forward() * 80.0f;
+            float ground = terrain ? std::max(terrain->GetHeight(position.x, position.y), terrain->GetHeight(ahead.x, ahead.y)) : 0.0f;
+            float target = ground + clearance;
+            float blend = std::min(seconds * 2.0f, 1.0f);
+            position.z = position.z == 0.0f ? target : position.z + (target - position.z) * blend;
+        }
+
+        /**
+         * @brief Gets the view matrix, looking ahead and down by the pitch.
+         * @return The matrix.
+         */
+        glm::mat4 View() const
+        {
+            glm::vec3 look = Forward() + glm::vec3(0.0f, 0.0f, pitch);
+            return glm::lookAt(position, position + look, glm::vec3(0.0f, 0.0f, 1.0f));
+        }
+    };
+}
+
+/**
+ * @brief World viewer entry point.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Array of command-line arguments.
+ * @return Exit status: 0 on success, -1 on failure.
+ */
+int main(int argc, char** argv)
+{
+    Options options;
+    try
+    {
+        options = ParseOptions(argc, argv);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [--world voxel|tiles|terrain] [--headless WxH] [--frames N] [--view-distance F]"
+                  << " [--speed F] [--edits N] [--template file.png] [--seed N] [--screenshot file.png]"
+                  << " [--trace file.json]" << std::endl;
+        return -1;
+    }
+
+    try
+    {
+        graf::Profiler::SetKeepTrace(!options.traceFile.empty()); ///< Keep zones only when they are written out
+        graf::GLWindow glwindow;
+        if (options.headless)
+        {
+            glwindow.createHeadless(options.width, options.height);
+            glwindow.SetPresentMode(graf::PresentMode::Uncapped);
+        }
+        else
+        {
+            glwindow.create(options.width, options.height);
+        }
+        glwindow.SetFrameLimit(options.frames);
+
+        graf::JobSystem jobs;
+        FlightCamera camera;
+        camera.speed = options.speed;
+        std::unique_ptr<graf::VoxelWorld> world;
+        std::unique_ptr<graf::TileMap> tileMap;
+        std::unique_ptr<graf::CdlodTerrain> terrain;
+        graf::ShaderProgram tileProgram;
+        graf::ShaderProgram terrainProgram;
+        if (options.world == "tiles")
+        {
+            tileProgram.Create();
+            tileProgram.AttachShader("../shaders/tilemap_vertex.glsl", GL_VERTEX_SHADER);
+            tileProgram.AttachShader("../shaders/tilemap_fragment.glsl", GL_FRAGMENT_SHADER);
+            tileProgram.Link();
+            tileProgram.AddUniform("uViewProjection");
+            tileProgram.AddUniform("uChunkOrigin");
+
+            graf::TileMapSettings settings;
+            settings.templateFile = options.templateFile;
+            settings.seed = options.seed;
+            settings.viewDistance = options.viewDistance;
+            tileMap = std::make_unique<graf::TileMap>(jobs, tileProgram, settings);
+            camera.position = glm::vec3(settings.width * 0.5f, settings.height * 0.5f, 0.0f);
+            camera.clearance = 120.0f;
+            camera.pitch = -1.2f;
+            glClearColor(0.05f, 0.05f, 0.08f, 1.0f);
+        }
+        else if (options.world == "terrain")
+        {
+            terrainProgram.Create();
+            terrainProgram.AttachShader("../shaders/terrain_vertex.glsl", GL_VERTEX_SHADER);
+            terrainProgram.AttachShader("../shaders/terrain_fragment.glsl", GL_FRAGMENT_SHADER);
+            terrainProgram.Link();
+
+            graf::CdlodTerrainSettings settings;
+            settings.viewDistance = options.viewDistance;
+            terrain = std::make_unique<graf::CdlodTerrain>(jobs, terrainProgram, settings);
+            glm::vec3 sky = settings.fogColor;
+            glClearColor(sky.r, sky.g, sky.b, 1.0f);
+        }
+        else
+        {
+            graf::VoxelWorldSettings settings;
+            settings.viewDistance = options.viewDistance;
+            world = std::make_unique<graf::VoxelWorld>(jobs, settings);
+            glm::vec3 sky = settings.fogColor;
+            glClearColor(sky.r, sky.g, sky.b, 1.0f);
+        }
+        graf::FrameCapture capture(jobs);
+
+        const float step = 1.0f / 60.0f; ///< Fixed step, so every run flies the same path
+        uint64_t frame = 0;
+        size_t editedVoxels = 0;
+        graf::RollingStats frameTimes(std::max<size_t>(options.frames, 1024));
+        graf::RollingStats cpuTimes(std::max<size_t>(options.frames, 1024));
+        auto lastFrame = std::chrono::steady_clock::now();
+
+        glwindow.SetKeyboardFunction([&](int key, int, int action) {
+            bool down = action != GLFW_RELEASE;
+            if (key == GLFW_KEY_LEFT)
+                camera.turnRate = down ? 0.8f : 0.0f;
+            else if (key == GLFW_KEY_RIGHT)
+                camera.turnRate = down ? -0.8f : 0.0f;
+            else if (key == GLFW_KEY_UP && down)
+                camera.speed *= 1.25f;
+            else if (key == GLFW_KEY_DOWN && down)
+                camera.speed /= 1.25f;
+        });
+
+        glwindow.SetRenderFunction([&]() {
+            auto start = std::chrono::steady_clock::now();
+            const graf::HeightField* ground = world ? &world->GetTerrain() : terrain ? &terrain->GetTerrain() : nullptr;
+            camera.Advance(ground, step);
+
+            if (world && options.editInterval > 0 && frame > 0 && frame % options.editInterval == 0)
+            {
+                glm::vec3 target = camera.position + camera.Forward() * 60.0f;
+                target.z = world->GetTerrain().GetHeight(target.x, target.y);
+                editedVoxels += world->SetSphere(target, 7.0f, graf::VoxelBlock::Air);
+                editedVoxels += world->SetSphere(target + glm::vec3(0.0f, 0.0f, 9.0f), 2.5f, graf::VoxelBlock::Brick);
+            }
+            if (world)
+                world->Update(camera.position);
+
+            int width = static_cast<int>(options.width), height = static_cast<int>(options.height);
+            if (!options.headless)
+                glfwGetFramebufferSize(glwindow.GetNativeWindow(), &width, &height);
+            float aspect = height > 0 ? static_cast<float>(width) / static_cast<float>(height) : 1.0f;
+            glm::mat4 projection = glm::perspective(glm::radians(70.0f), aspect, 0.5f, options.viewDistance * 1.1f);
+
+            glm::mat4 viewProjection = projection * camera.View();
+
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            if (world)
+                world->Render(viewProjection, camera.position);
+            else if (terrain)
+            {
+                terrain->Update(viewProjection, camera.position);
+                terrain->Render(viewProjection, camera.position);
+            }
+            else
+            {
+                tileMap->Update(viewProjection, camera.position);
+                tileMap->Render(viewProjection);
+            }
+            if (!options.screenshotFile.empty() && frame + 1 == options.frames)
+                capture.Capture(options.screenshotFile);
+            capture.EndFrame();
+
+            auto end = std::chrono::steady_clock::now();
+            cpuTimes.AddSample(std::chrono::duration<double, std::milli>(end - start).count());
+            if (frame > 0)
+                frameTimes.AddSample(std::chrono::duration<double, std::milli>(start - lastFrame).count());
+            lastFrame = start;
+            ++frame;
+        });
+
+        glwindow.SetCloseFunction([&]() {
+            std::cout << "Frames: " << frame << ", frame time mean " << frameTimes.getMean() << " ms, p95 "
+                      << frameTimes.getPercentile(95.0) << " ms, p99 " << frameTimes.getPercentile(99.0)
+                      << " ms; CPU mean " << cpuTimes.getMean() << " ms, p99 " << cpuTimes.getPercentile(99.0)
+                      << " ms" << std::endl;
+            if (terrain)
+            {
+                const graf::CdlodTerrainStats& stats = terrain->GetStats();
+                std::cout << "CDLOD terrain: " << stats.levels << " levels; " << stats.selectedNodes << " nodes drawn, "
+                          << stats.culledNodes << " culled, " << stats.triangles << " triangles in " << stats.drawCalls
+                          << " draws; " << stats.residentTiles << " tiles resident, " << stats.pendingTiles << " pending, "
+                          << stats.generatedTiles << " generated of " << stats.tileCapacity << " layers" << std::endl;
+            }
+            else if (tileMap)
+            {
+                const graf::TileMapStats& stats = tileMap->GetStats();
+                std::cout << "Tile map: " << tileMap->GetTileSet().GetTileCount() << " tiles; " << stats.visibleChunks
+                          << " chunks visible, " << stats.residentChunks << " resident, " << stats.pendingChunks
+                          << " pending; " << stats.quads << " quads in " << stats.drawCalls << " draws and "
+                          << stats.vertexArrayBinds << " binds; " << stats.generatedChunks << " chunks generated; pool "
+                          << stats.poolUsed / (1024 * 1024) << " / " << stats.poolCapacity / (1024 * 1024) << " MiB"
+                          << std::endl;
+            }
+            else
+            {
+                const graf::VoxelWorldStats& stats = world->GetStats();
+                std::cout << "Voxel world: " << stats.selectedColumns << " columns selected, " << stats.residentColumns
+                          << " resident, " << stats.pendingColumns << " pending; " << stats.drawnChunks << " chunks drawn, "
+                          << stats.culledChunks << " culled, " << stats.quads << " quads in " << stats.drawCalls
+                          << " draws; " << stats.meshedColumns << " columns meshed, " << stats.remeshedChunks
+                          << " chunks remeshed after " << editedVoxels << " edited voxels; pool "
+                          << stats.poolUsed / (1024 * 1024) << " / " << stats.poolCapacity / (1024 * 1024) << " MiB"
+                          << std::endl;
+            }
+
+            if (!options.traceFile.empty() && graf::Profiler::IsEnabled())
+                graf::Profiler::WriteChromeTrace(options.traceFile);
+
+            capture.Flush();
+            capture.Release();
+            world.reset(); ///< Delete every GL object while the context is alive
+            tileMap.reset();
+            terrain.reset();
+            tileProgram.Release();
+            terrainProgram.Release();
+            glwindow.GetFrameBuffer().Release();
+        });
+        glwindow.Render();
+
+        size_t leaks = graf::GpuResourceTracker::sReportLeaks(std::cerr);
+        if (leaks > 0)
+            std::cerr << leaks << " OpenGL objects were not released" << std::endl;
+        return 0;
+    }
+    catch (const graf::GrafException& e)
+    {
+        std::cerr << "World viewer error: " << e.what() << std::endl;
+        return -1;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Unexpected error: " << e.what() << std::endl;
+        return -1;
+    }
+}
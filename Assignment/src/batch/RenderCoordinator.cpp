@@ -0,0 +1,269 @@
+#include "RenderCoordinator.hpp"
+#include "Exceptions.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <nlohmann/json.hpp>
+
+#ifndef _WIN32
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+/**
+ * @file RenderCoordinator.cpp
+ * @brief Implementation of the RenderCoordinator class that distributes frames across worker processes.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Configures the coordinator.
+     * @param workerCommand Program and arguments that start one worker.
+     * @param workerCount Number of worker processes (at least 1).
+     * @param tasksPerWorker Tasks queued at each worker at a time (at least 1).
+     */
+    RenderCoordinator::RenderCoordinator(std::vector<std::string> workerCommand, unsigned int workerCount, size_t tasksPerWorker)
+        : m_workerCommand(std::move(workerCommand)),
+          m_workerCount(std::max(workerCount, 1u)),
+          m_tasksPerWorker(std::max<size_t>(tasksPerWorker, 1))
+    {
+    }
+
+#ifdef _WIN32
+    BatchResult RenderCoordinator::Run(const std::vector<RenderTask>&)
+    {
+        throw GrafException("Worker processes are only supported on POSIX systems; use --workers 0");
+    }
+
+    void RenderCoordinator::Spawn(WorkerConnection&) {}
+    bool RenderCoordinator::FillWorker(WorkerConnection&, const std::vector<RenderTask>&, std::deque<size_t>&) { return false; }
+    void RenderCoordinator::Shutdown(WorkerConnection&) {}
+#else
+    /**
+     * @brief Renders all tasks and waits for the workers to exit.
+     *
+     * Waits on all worker outputs with poll. Every answer completes the oldest task
+     * of that worker and is immediately replaced by the next pending task. A worker
+     * whose output closes is dropped and its unanswered tasks go back to the front
+     * of the pending queue.
+     *
+     * @param tasks The frames to render.
+     * @return The summary of the run.
+     * @exception GrafException Thrown if workers cannot be started or all of them exit early.
+     */
+    BatchResult RenderCoordinator::Run(const std::vector<RenderTask>& tasks)
+    {
+        std::signal(SIGPIPE, SIG_IGN); ///< A dead worker must surface as a write error, not kill us
+
+        auto start = std::chrono::steady_clock::now();
+        BatchResult result;
+        if (tasks.empty())
+            return result;
+
+        std::deque<size_t> pending;
+        for (size_t i = 0; i < tasks.size(); ++i)
+            pending.push_back(i);
+
+        std::vector<WorkerConnection> workers(std::min<size_t>(m_workerCount, tasks.size()));
+        for (auto& worker : workers)
+            Spawn(worker);
+
+        std::vector<WorkerConnection*> alive;
+        for (auto& worker : workers)
+            alive.push_back(&worker);
+
+        auto dropWorker = [&](WorkerConnection* worker) {
+            std::cerr << "Render worker " << worker->pid << " exited with "
+                      << worker->inFlight.size() << " unfinished tasks" << std::endl;
+            pending.insert(pending.begin(), worker->inFlight.begin(), worker->inFlight.end()); ///< Hand them to others
+            worker->inFlight.clear();
+            Shutdown(*worker);
+            alive.erase(std::find(alive.begin(), alive.end(), worker));
+        };
+
+        size_t remaining = tasks.size();
+        std::vector<pollfd> pollSet;
+        char chunk[4096];
+
+        while (remaining > 0)
+        {
+            for (size_t i = 0; i < alive.size(); )
+            {
+                WorkerConnection* worker = alive[i];
+                if (FillWorker(*worker, tasks, pending))
+                    ++i;
+                else
+                    dropWorker(worker);
+            }
+
+            if (alive.empty())
+                throw GrafException("All render workers exited with " + std::to_string(remaining) + " frames left");
+
+            pollSet.clear();
+            for (WorkerConnection* worker : alive)
+                pollSet.push_back({worker->output, POLLIN, 0});
+
+            if (poll(pollSet.data(), pollSet.size(), -1) < 0)
+                continue; ///< Interrupted by a signal
+
+            std::vector<WorkerConnection*> ready;
+            for (size_t i = 0; i < pollSet.size(); ++i)
+            {
+                if (pollSet[i].revents != 0)
+                    ready.push_back(alive[i]);
+            }
+
+            for (WorkerConnection* worker : ready)
+            {
+                ssize_t count = read(worker->output, chunk, sizeof(chunk));
+                if (count <= 0)
+                {
+                    dropWorker(worker);
+                    continue;
+                }
+                worker->buffer.append(chunk, count);
+
+                size_t lineEnd;
+                while ((lineEnd = worker->buffer.find('\n')) != std::string::npos)
+                {
+                    std::string line = worker->buffer.substr(0, lineEnd);
+                    worker->buffer.erase(0, lineEnd + 1);
+                    if (worker->inFlight.empty())
+                        continue; ///< Stray output, nothing to match it to
+
+                    size_t id = worker->inFlight.front(); ///< Workers answer in order
+                    worker->inFlight.pop_front();
+                    remaining--;
+
+                    json answer = json::parse(line, nullptr, false);
+                    if (!answer.is_discarded() && answer.value("ok", false))
+                    {
+                        result.rendered++;
+                        std::cout << "[" << (tasks.size() - remaining) << "/" << tasks.size() << "] "
+                                  << tasks[id].output << " (" << answer.value("ms", 0.0) << " ms)" << std::endl;
+                    }
+                    else
+                    {
+                        result.failed++;
+                        std::cerr << "Failed to render " << tasks[id].output << ": "
+                                  << (answer.is_discarded() ? line : answer.value("error", std::string("unknown error")))
+                                  << std::endl;
+                    }
+                }
+            }
+        }
+
+        for (WorkerConnection* worker : alive)
+            Shutdown(*worker);
+
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    /**
+     * @brief Starts a worker process connected through pipes.
+     *
+     * The parent's pipe ends are close-on-exec so later workers do not inherit them,
+     * which would keep a dead worker's pipes open.
+     *
+     * @param worker Receives the process id and pipe ends.
+     * @exception GrafException Thrown if the pipes or the process cannot be created.
+     */
+    void RenderCoordinator::Spawn(WorkerConnection& worker)
+    {
+        int toWorker[2], fromWorker[2];
+        if (pipe(toWorker) != 0)
+            throw GrafException("Failed to create worker pipe");
+        if (pipe(fromWorker) != 0)
+        {
+            close(toWorker[0]);
+            close(toWorker[1]);
+            throw GrafException("Failed to create worker pipe");
+        }
+
+        std::vector<char*> argv;
+        for (auto& arg : m_workerCommand)
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        argv.push_back(nullptr);
+
+        pid_t pid = fork();
+        if (pid < 0)
+            throw GrafException("Failed to start render worker");
+
+        if (pid == 0)
+        {
+            dup2(toWorker[0], STDIN_FILENO);
+            dup2(fromWorker[1], STDOUT_FILENO);
+            close(toWorker[0]);
+            close(toWorker[1]);
+            close(fromWorker[0]);
+            close(fromWorker[1]);
+            execvp(argv[0], argv.data());
+            _exit(127); ///< exec failed; the coordinator sees EOF
+        }
+
+        close(toWorker[0]);
+        close(fromWorker[1]);
+        fcntl(toWorker[1], F_SETFD, FD_CLOEXEC);
+        fcntl(fromWorker[0], F_SETFD, FD_CLOEXEC);
+
+        worker.pid = pid;
+        worker.input = toWorker[1];
+        worker.output = fromWorker[0];
+    }
+
+    /**
+     * @brief Sends pending tasks until the worker holds tasksPerWorker of them.
+     * @param worker The worker to fill up.
+     * @param tasks All tasks of the batch.
+     * @param pending Ids of tasks not yet sent.
+     * @return False if the worker could not be written to.
+     */
+    bool RenderCoordinator::FillWorker(WorkerConnection& worker, const std::vector<RenderTask>& tasks, std::deque<size_t>& pending)
+    {
+        while (worker.inFlight.size() < m_tasksPerWorker && !pending.empty())
+        {
+            size_t id = pending.front();
+            std::string line = SerializeRenderTask(tasks[id]) + "\n";
+
+            size_t written = 0;
+            while (written < line.size())
+            {
+                ssize_t count = write(worker.input, line.data() + written, line.size() - written);
+                if (count <= 0)
+                    return false;
+                written += count;
+            }
+
+            pending.pop_front();
+            worker.inFlight.push_back(id);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Closes the worker's pipes and waits for it to exit.
+     *
+     * Closing the worker's input ends its task loop.
+     *
+     * @param worker The worker to shut down.
+     */
+    void RenderCoordinator::Shutdown(WorkerConnection& worker)
+    {
+        if (worker.input >= 0)
+            close(worker.input);
+        if (worker.output >= 0)
+            close(worker.output);
+        if (worker.pid > 0)
+            waitpid(worker.pid, nullptr, 0);
+
+        worker.input = worker.output = worker.pid = -1;
+    }
+#endif
+}
@@ -0,0 +1,160 @@
+#include "RenderTask.hpp"
+#include "Exceptions.hpp"
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <glm/gtc/matrix_transform.hpp>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+/**
+ * @file RenderTask.cpp
+ * @brief Implementation of the render task loading and serialization.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        /**
+         * @brief Reads a 3D vector stored as a JSON array.
+         * @param value The JSON array with three numbers.
+         * @return The vector.
+         */
+        glm::vec3 ReadVec3(const json& value)
+        {
+            return glm::vec3(value.at(0).get<float>(), value.at(1).get<float>(), value.at(2).get<float>());
+        }
+
+        /**
+         * @brief Appends a frame number to a file name, before its extension.
+         * @param fileName The output path of the job.
+         * @param frame The frame number.
+         * @return The output path of the frame.
+         */
+        std::string FrameFileName(const std::string& fileName, int frame)
+        {
+            char suffix[16];
+            std::snprintf(suffix, sizeof(suffix), "_%04d", frame);
+
+            std::filesystem::path path(fileName);
+            std::string extension = path.extension().string();
+            path.replace_extension();
+            return path.string() + suffix + extension;
+        }
+    }
+
+    /**
+     * @brief Loads a job list and expands it into frame tasks.
+     * @param fileName Path of the job list JSON file.
+     * @return The frame tasks, numbered in order.
+     * @exception GrafException Thrown if the file cannot be read or a job is malformed.
+     */
+    std::vector<RenderTask> LoadRenderTasks(const std::string& fileName)
+    {
+        std::ifstream file(fileName);
+        if (!file.is_open())
+            throw GrafException("Failed to open job list: " + fileName);
+
+        std::vector<RenderTask> tasks;
+        try
+        {
+            json j;
+            file >> j;
+
+            for (const auto& job : j.at("jobs"))
+            {
+                RenderTask task;
+                task.scene = job.at("scene").get<std::string>();
+                task.output = job.at("output").get<std::string>();
+                task.width = job.value("width", task.width);
+                task.height = job.value("height", task.height);
+
+                if (job.contains("camera"))
+                {
+                    const json& camera = job["camera"];
+                    if (camera.contains("position")) task.cameraPosition = ReadVec3(camera["position"]);
+                    if (camera.contains("target"))   task.cameraTarget = ReadVec3(camera["target"]);
+                    task.fov = camera.value("fov", task.fov);
+                }
+
+                int frames = job.value("frames", 1);
+                if (frames < 1)
+                    throw GrafException("Job frame count must be positive: " + task.output);
+
+                glm::vec3 offset = task.cameraPosition - task.cameraTarget;
+                for (int frame = 0; frame < frames; ++frame)
+                {
+                    RenderTask frameTask = task;
+                    frameTask.id = tasks.size();
+
+                    if (frames > 1)
+                    {
+                        float angle = 360.0f * frame / frames; ///< Orbit the target once over the turntable
+                        glm::mat4 rotation = glm::rotate(glm::mat4(1), glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f));
+                        frameTask.cameraPosition = task.cameraTarget + glm::vec3(rotation * glm::vec4(offset, 0.0f));
+                        frameTask.output = FrameFileName(task.output, frame);
+                    }
+
+                    tasks.push_back(frameTask);
+                }
+            }
+        }
+        catch (const json::exception& e)
+        {
+            throw GrafException("Invalid job list " + fileName + ": " + e.what());
+        }
+
+        return tasks;
+    }
+
+    /**
+     * @brief Serializes a task as a single line of JSON for the worker protocol.
+     * @param task The task to serialize.
+     * @return The JSON text without a trailing newline.
+     */
+    std::string SerializeRenderTask(const RenderTask& task)
+    {
+        json j;
+        j["id"] = task.id;
+        j["scene"] = task.scene;
+        j["position"] = {task.cameraPosition.x, task.cameraPosition.y, task.cameraPosition.z};
+        j["target"] = {task.cameraTarget.x, task.cameraTarget.y, task.cameraTarget.z};
+        j["fov"] = task.fov;
+        j["width"] = task.width;
+        j["height"] = task.height;
+        j["output"] = task.output;
+        return j.dump(); ///< Compact output never contains a newline
+    }
+
+    /**
+     * @brief Parses a task sent by the coordinator.
+     * @param line One line of JSON produced by SerializeRenderTask.
+     * @return The parsed task.
+     * @exception GrafException Thrown if the line is not a valid task.
+     */
+    RenderTask ParseRenderTask(const std::string& line)
+    {
+        try
+        {
+            json j = json::parse(line);
+
+            RenderTask task;
+            task.id = j.at("id").get<size_t>();
+            task.scene = j.at("scene").get<std::string>();
+            task.cameraPosition = ReadVec3(j.at("position"));
+            task.cameraTarget = ReadVec3(j.at("target"));
+            task.fov = j.at("fov").get<float>();
+            task.width = j.at("width").get<int>();
+            task.height = j.at("height").get<int>();
+            task.output = j.at("output").get<std::string>();
+            return task;
+        }
+        catch (const json::exception& e)
+        {
+            throw GrafException(std::string("Invalid render task: ") + e.what());
+        }
+    }
+}
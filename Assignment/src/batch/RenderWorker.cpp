@@ -0,0 +1,140 @@
+#include "RenderWorker.hpp"
+#include "ErrorCheck.hpp"
+#include "Exceptions.hpp"
+#include "ImageWriter.hpp"
+#include "TextureManager.hpp"
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <glm/gtc/matrix_transform.hpp>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+/**
+ * @file RenderWorker.cpp
+ * @brief Implementation of the RenderWorker class that renders batch tasks offscreen.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Creates the headless context and the rendering resources.
+     *
+     * Uses a single job worker, since batch throughput comes from running one
+     * worker process per core.
+     *
+     * @exception GrafException Thrown if the context, shaders or shapes cannot be created.
+     */
+    RenderWorker::RenderWorker()
+        : m_jobs(1)
+    {
+        m_window.createHeadless(1, 1); ///< Resized per task
+
+        m_shapes.Preload(m_jobs);
+
+        m_program.Create();
+        m_program.AttachShader("../shaders/vertex.glsl", GL_VERTEX_SHADER);
+        m_program.AttachShader("../shaders/fragment.glsl", GL_FRAGMENT_SHADER);
+        m_program.Link();
+        m_program.AddUniform("uWorldTransform");
+
+        m_renderer = std::make_unique<SceneRenderer>(m_program, m_shapes, m_jobs);
+    }
+
+    /**
+     * @brief Gets a scene from the cache, loading it and its textures on first use.
+     * @param fileName Path of the scene JSON file.
+     * @return The scene objects.
+     * @exception GrafException Thrown if the scene is missing or empty.
+     */
+    const std::vector<ObjectData>& RenderWorker::GetScene(const std::string& fileName)
+    {
+        auto it = m_scenes.find(fileName);
+        if (it != m_scenes.end())
+            return it->second;
+
+        std::vector<ObjectData> objects = loadObjectsFromJson(fileName, m_jobs);
+        if (objects.empty())
+            throw GrafException("Scene is empty or unreadable: " + fileName);
+
+        std::set<std::string> textures;
+        for (const auto& obj : objects)
+            textures.insert(obj.texture);
+        TextureManager::sAddTexturesFromFiles(std::vector<std::string>(textures.begin(), textures.end()), m_jobs);
+
+        return m_scenes.emplace(fileName, std::move(objects)).first->second;
+    }
+
+    /**
+     * @brief Renders a task and writes its PNG file.
+     *
+     * Resizes the offscreen framebuffer when the resolution changes, draws the scene
+     * from the task's camera, reads the pixels back and encodes them.
+     *
+     * @param task The frame to render.
+     * @return The time spent on the task in milliseconds.
+     * @exception GrafException Thrown if the scene, a texture or the output cannot be processed.
+     */
+    double RenderWorker::RenderFrame(const RenderTask& task)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        const std::vector<ObjectData>& objects = GetScene(task.scene);
+
+        FrameBuffer& frameBuffer = m_window.GetFrameBuffer();
+        if (frameBuffer.getWidth() != task.width || frameBuffer.getHeight() != task.height)
+        {
+            frameBuffer.Release();
+            frameBuffer.Create(task.width, task.height);
+        }
+        frameBuffer.Bind();
+
+        float aspect = static_cast<float>(task.width) / task.height;
+        glm::mat4 matProj = glm::perspective(glm::radians(task.fov), aspect, 1.0f, 100.0f);
+        glm::mat4 matView = glm::lookAt(task.cameraPosition, task.cameraTarget, glm::vec3(0.0f, 1.0f, 0.0f));
+        BuildFramePacket(objects, matProj * matView, 1.0f, m_packet, m_jobs);
+
+        glClearColor(0.0f, 0.4f, 0.7f, 1.0f); ///< Same background as the interactive view
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        CheckGLError("Clear buffers");
+        m_renderer->Render(m_packet);
+
+        frameBuffer.ReadPixels(m_pixels);
+        WritePng(task.output, task.width, task.height, m_pixels);
+
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief Serves tasks from a coordinator until the input stream ends.
+     * @param in Stream delivering tasks.
+     * @param out Stream receiving results.
+     */
+    void RenderWorker::Serve(std::istream& in, std::ostream& out)
+    {
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.empty())
+                continue;
+
+            json result;
+            try
+            {
+                RenderTask task = ParseRenderTask(line);
+                result["id"] = task.id;
+                result["ms"] = RenderFrame(task);
+                result["ok"] = true;
+            }
+            catch (const std::exception& e)
+            {
+                result["ok"] = false;
+                result["error"] = e.what();
+                std::cerr << "Render task failed: " << e.what() << std::endl;
+            }
+
+            out << result.dump() << std::endl; ///< Flush so the coordinator can hand out the next task
+        }
+    }
+}
@@ -0,0 +1,716 @@
+#include "AllocationTracker.hpp"
+#include "Metrics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <intrin.h>
+#define GRAF_RETURN_ADDRESS() _ReturnAddress()
+#define GRAF_HAS_BACKTRACE
+#elif defined(__GLIBC__) || defined(__APPLE__)
+#include <cxxabi.h>
+#include <execinfo.h>
+#define GRAF_RETURN_ADDRESS() __builtin_return_address(0)
+#define GRAF_HAS_BACKTRACE
+#else
+#define GRAF_RETURN_ADDRESS() nullptr
+#endif
+
+/**
+ * @file AllocationTracker.cpp
+ * @brief Implementation of the allocation counting operator new and delete, the call-site sampler and the FrameAllocationMonitor.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        /**
+         * @struct ThreadCounters
+         * @brief Heap operations of one thread; only read by other threads.
+         */
+        struct ThreadCounters
+        {
+            std::atomic<uint64_t> allocations{0};   ///< Calls of operator new.
+            std::atomic<uint64_t> frees{0};         ///< Calls of operator delete.
+            std::atomic<uint64_t> bytes{0};         ///< Bytes requested.
+        };
+
+        const size_t MAX_TRACKED_THREADS = 256;     ///< Threads with their own counters; later ones share the last slot.
+        const size_t MAX_SAMPLE_FRAMES = 16;        ///< Stack depth kept per sample.
+        const size_t SAMPLE_CAPACITY = 4096;        ///< Samples kept until ClearSamples.
+        const size_t REPORT_FRAMES = 8;             ///< Stack depth written per call site.
+
+        /**
+         * @struct AllocationSample
+         * @brief Call stack of one sampled allocation, starting at the caller of operator new.
+         */
+        struct AllocationSample
+        {
+            void*             frames[MAX_SAMPLE_FRAMES];    ///< Return addresses, innermost first.
+            size_t            depth;                        ///< Valid frames.
+            size_t            size;                         ///< Requested bytes.
+            std::atomic<bool> ready{false};                 ///< Set once the sample is complete.
+        };
+
+        // Everything the hook touches is constant-initialized, so it works before main and never allocates
+        ThreadCounters          g_threadCounters[MAX_TRACKED_THREADS];
+        std::atomic<size_t>     g_threadCount{0};               ///< Slots handed out, may exceed MAX_TRACKED_THREADS.
+        std::atomic<uint32_t>   g_sampleRate{0};                ///< Every Nth allocation of a thread is sampled.
+        AllocationSample        g_samples[SAMPLE_CAPACITY];
+        std::atomic<size_t>     g_sampleReservations{0};        ///< Samples started, may exceed SAMPLE_CAPACITY.
+
+        thread_local ThreadCounters* t_counters = nullptr;      ///< Slot of the calling thread.
+        thread_local uint32_t        t_sampleCountdown = 0;     ///< Allocations until the next sample.
+        thread_local bool            t_sampling = false;        ///< Set while sampling, whose own allocations are not sampled.
+
+        /**
+         * @brief Gets the counters of the calling thread, handing out a slot on first use.
+         * @return The counters.
+         */
+        ThreadCounters& GetThreadCounters()
+        {
+            if (t_counters == nullptr)
+            {
+                size_t slot = g_threadCount.fetch_add(1, std::memory_order_relaxed);
+                t_counters = &g_threadCounters[std::min(slot, MAX_TRACKED_THREADS - 1)];
+            }
+            return *t_counters;
+        }
+
+        /**
+         * @brief Stores the call stack of an allocation into the sample buffer.
+         * @param size Requested bytes.
+         * @param caller Return address into the caller of operator new, where the stored stack starts.
+         */
+        void SampleCallStack(size_t size, void* caller)
+        {
+#ifdef GRAF_HAS_BACKTRACE
+            size_t index = g_sampleReservations.fetch_add(1, std::memory_order_relaxed);
+            if (index >= SAMPLE_CAPACITY)
+                return; ///< Counted as dropped
+
+            t_sampling = true;
+            void* frames[MAX_SAMPLE_FRAMES + 4];
+#ifdef _WIN32
+            size_t depth = CaptureStackBackTrace(0, static_cast<DWORD>(MAX_SAMPLE_FRAMES + 4), frames, nullptr);
+#else
+            size_t depth = static_cast<size_t>(backtrace(frames, static_cast<int>(MAX_SAMPLE_FRAMES + 4)));
+#endif
+            size_t first = 0;
+            while (first < depth && frames[first] != caller)
+                ++first;
+            if (first == depth)
+                first = 0; ///< Caller not found, e.g. after a tail call: keep the whole stack
+
+            AllocationSample& sample = g_samples[index];
+            sample.depth = std::min(depth - first, MAX_SAMPLE_FRAMES);
+            std::copy(frames + first, frames + first + sample.depth, sample.frames);
+            sample.size = size;
+            sample.ready.store(true, std::memory_order_release);
+            t_sampling = false;
+#else
+            (void)size;
+            (void)caller;
+#endif
+        }
+
+        /**
+         * @brief Counts an allocation and samples its call stack when due.
+         * @param size Requested bytes.
+         * @param caller Return address into the caller of operator new.
+         */
+        void CountAllocation(size_t size, void* caller)
+        {
+            ThreadCounters& counters = GetThreadCounters();
+            counters.allocations.fetch_add(1, std::memory_order_relaxed);
+            counters.bytes.fetch_add(size, std::memory_order_relaxed);
+
+            uint32_t rate = g_sampleRate.load(std::memory_order_relaxed);
+            if (rate == 0 || t_sampling)
+                return;
+            if (t_sampleCountdown == 0 || t_sampleCountdown > rate)
+                t_sampleCountdown = rate;
+            if (--t_sampleCountdown == 0)
+                SampleCallStack(size, caller);
+        }
+
+        /**
+         * @brief Counts a deallocation.
+         * @param pointer The freed pointer; null is not counted.
+         */
+        void CountFree(void* pointer)
+        {
+            if (pointer != nullptr)
+                GetThreadCounters().frees.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Allocates like the standard operator new, calling the new handler until malloc succeeds.
+         * @param size Requested bytes.
+         * @param alignment Alignment, 0 for the default.
+         * @param caller Return address into the caller of operator new.
+         * @return The memory, or null if there is no new handler.
+         */
+        void* Allocate(size_t size, size_t alignment, void* caller)
+        {
+            if (size == 0)
+                size = 1;
+            while (true)
+            {
+                void* pointer = nullptr;
+                if (alignment == 0)
+                    pointer = std::malloc(size);
+#ifdef _WIN32
+                else
+                    pointer = _aligned_malloc(size, alignment);
+#else
+                else if (posix_memalign(&pointer, std::max(alignment, sizeof(void*)), size) != 0)
+                    pointer = nullptr;
+#endif
+                if (pointer != nullptr)
+                {
+                    CountAllocation(size, caller);
+                    return pointer;
+                }
+
+                std::new_handler handler = std::get_new_handler();
+                if (handler == nullptr)
+                    return nullptr;
+                handler();
+            }
+        }
+
+        /**
+         * @brief Frees memory from Allocate.
+         * @param pointer The memory, may be null.
+         * @param aligned Whether it was allocated with an alignment.
+         */
+        void Free(void* pointer, bool aligned)
+        {
+            CountFree(pointer);
+#ifdef _WIN32
+            if (aligned)
+            {
+                _aligned_free(pointer);
+                return;
+            }
+#else
+            (void)aligned;
+#endif
+            std::free(pointer);
+        }
+
+        /**
+         * @brief Allocates for a throwing operator new.
+         * @param size Requested bytes.
+         * @param alignment Alignment, 0 for the default.
+         * @param caller Return address into the caller of operator new.
+         * @return The memory.
+         * @exception std::bad_alloc Thrown if the memory is exhausted.
+         */
+        void* AllocateOrThrow(size_t size, size_t alignment, void* caller)
+        {
+            void* pointer = Allocate(size, alignment, caller);
+            if (pointer == nullptr)
+                throw std::bad_alloc();
+            return pointer;
+        }
+
+        /**
+         * @brief Allocates for a nothrow operator new.
+         * @param size Requested bytes.
+         * @param alignment Alignment, 0 for the default.
+         * @param caller Return address into the caller of operator new.
+         * @return The memory, or null if it is exhausted.
+         */
+        void* AllocateNoThrow(size_t size, size_t alignment, void* caller) noexcept
+        {
+            try
+            {
+                return Allocate(size, alignment, caller);
+            }
+            catch (...)
+            {
+                return nullptr; ///< Thrown by the new handler
+            }
+        }
+
+        /**
+         * @brief Gets the demangled function of a frame symbolized by backtrace_symbols.
+         * @param symbol Such as "binary(_ZN4graf5SceneC1Ev+0x1f) [0x4011ab]".
+         * @return Such as "graf::Scene::Scene() [binary+0x1f]", or the symbol unchanged if it has no name.
+         */
+        string DescribeFrame(const char* symbol)
+        {
+            string text = symbol;
+#if defined(GRAF_HAS_BACKTRACE) && !defined(_WIN32)
+            size_t open = text.find('(');
+            size_t plus = text.find('+', open);
+            if (open == string::npos || plus == string::npos || plus == open + 1)
+                return text;
+
+            string mangled = text.substr(open + 1, plus - open - 1);
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+            string name = status == 0 && demangled != nullptr ? demangled : mangled;
+            std::free(demangled);
+            size_t close = text.find(')', plus);
+            return name + " [" + text.substr(0, open) + text.substr(plus, close == string::npos ? string::npos : close - plus) + "]";
+#else
+            return text;
+#endif
+        }
+    }
+
+    /**
+     * @brief Gets the operations counted between two points.
+     * @param end The later count.
+     * @param start The earlier count.
+     * @return The differences.
+     */
+    AllocationStats operator-(const AllocationStats& end, const AllocationStats& start)
+    {
+        AllocationStats delta;
+        delta.allocations = end.allocations - start.allocations;
+        delta.frees = end.frees - start.frees;
+        delta.bytes = end.bytes - start.bytes;
+        return delta;
+    }
+
+    /**
+     * @brief Checks whether allocations are counted in this build.
+     * @return True if GRAF_ENABLE_ALLOCATION_TRACKER was defined.
+     */
+    bool AllocationTracker::IsEnabled()
+    {
+#ifdef GRAF_ENABLE_ALLOCATION_TRACKER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Gets the operations of all threads since the program started.
+     * @return The counts.
+     */
+    AllocationStats AllocationTracker::GetTotals()
+    {
+        AllocationStats totals;
+        size_t threads = std::min(g_threadCount.load(std::memory_order_relaxed), MAX_TRACKED_THREADS);
+        for (size_t i = 0; i < threads; ++i)
+        {
+            totals.allocations += g_threadCounters[i].allocations.load(std::memory_order_relaxed);
+            totals.frees += g_threadCounters[i].frees.load(std::memory_order_relaxed);
+            totals.bytes += g_threadCounters[i].bytes.load(std::memory_order_relaxed);
+        }
+        return totals;
+    }
+
+    /**
+     * @brief Gets the operations of the calling thread since it started.
+     * @return The counts.
+     */
+    AllocationStats AllocationTracker::GetThreadTotals()
+    {
+        AllocationStats totals;
+        if (t_counters != nullptr)
+        {
+            totals.allocations = t_counters->allocations.load(std::memory_order_relaxed);
+            totals.frees = t_counters->frees.load(std::memory_order_relaxed);
+            totals.bytes = t_counters->bytes.load(std::memory_order_relaxed);
+        }
+        return totals;
+    }
+
+    /**
+     * @brief Sets how often call stacks are sampled.
+     *
+     * The stack walker is called once beforehand, since its first call may load
+     * libraries and allocate.
+     *
+     * @param everyN Sample every Nth allocation of each thread; 1 samples all and 0 none.
+     */
+    void AllocationTracker::SetSampleRate(uint32_t everyN)
+    {
+#if defined(GRAF_HAS_BACKTRACE) && !defined(_WIN32)
+        if (everyN != 0)
+        {
+            t_sampling = true;
+            void* frame = nullptr;
+            backtrace(&frame, 1);
+            t_sampling = false;
+        }
+#endif
+        g_sampleRate.store(everyN, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets how often call stacks are sampled.
+     * @return Every Nth allocation is sampled, 0 if sampling is off.
+     */
+    uint32_t AllocationTracker::GetSampleRate()
+    {
+        return g_sampleRate.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the number of call stacks in the sample buffer.
+     * @return The count.
+     */
+    size_t AllocationTracker::GetSampleCount()
+    {
+        return std::min(g_sampleReservations.load(std::memory_order_relaxed), SAMPLE_CAPACITY);
+    }
+
+    /**
+     * @brief Gets the number of samples that did not fit into the buffer.
+     * @return The count.
+     */
+    uint64_t AllocationTracker::GetDroppedSamples()
+    {
+        size_t reservations = g_sampleReservations.load(std::memory_order_relaxed);
+        return reservations > SAMPLE_CAPACITY ? reservations - SAMPLE_CAPACITY : 0;
+    }
+
+    /**
+     * @brief Empties the sample buffer; sampling must be off.
+     */
+    void AllocationTracker::ClearSamples()
+    {
+        size_t count = GetSampleCount();
+        for (size_t i = 0; i < count; ++i)
+            g_samples[i].ready.store(false, std::memory_order_relaxed);
+        g_sampleReservations.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Writes the sampled call sites, most frequent first, with symbolized stacks where available.
+     *
+     * Samples with the same stack form one call site. Names are symbolized with
+     * backtrace_symbols, which only knows exported symbols, so executables are linked
+     * with their symbols exported; other frames are written as module and offset.
+     *
+     * @param out The stream.
+     * @param maxSites Number of call sites written at most.
+     */
+    void AllocationTracker::WriteSampleReport(ostream& out, size_t maxSites)
+    {
+        struct CallSite
+        {
+            uint64_t samples = 0;   ///< Samples with this stack.
+            uint64_t bytes = 0;     ///< Bytes they requested.
+        };
+
+        std::map<std::vector<void*>, CallSite> sites;
+        size_t count = GetSampleCount();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const AllocationSample& sample = g_samples[i];
+            if (!sample.ready.load(std::memory_order_acquire))
+                continue; ///< Still being written
+            CallSite& site = sites[std::vector<void*>(sample.frames, sample.frames + sample.depth)];
+            site.samples++;
+            site.bytes += sample.size;
+        }
+
+        std::vector<std::pair<std::vector<void*>, CallSite>> sorted(sites.begin(), sites.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second.samples > b.second.samples; });
+
+        out << "Sampled " << count << " allocations (every " << std::max<uint32_t>(GetSampleRate(), 1) << ", "
+            << GetDroppedSamples() << " dropped) at " << sites.size() << " call sites" << std::endl;
+        for (size_t i = 0; i < sorted.size() && i < maxSites; ++i)
+        {
+            const std::vector<void*>& frames = sorted[i].first;
+            out << "  " << sorted[i].second.samples << " allocations, " << sorted[i].second.bytes << " bytes:" << std::endl;
+            size_t depth = std::min(frames.size(), REPORT_FRAMES);
+#if defined(GRAF_HAS_BACKTRACE) && !defined(_WIN32)
+            char** symbols = backtrace_symbols(frames.data(), static_cast<int>(depth));
+            for (size_t f = 0; f < depth; ++f)
+                out << "    " << (symbols != nullptr ? DescribeFrame(symbols[f]) : DescribeFrame("?")) << std::endl;
+            std::free(symbols);
+#else
+            for (size_t f = 0; f < depth; ++f)
+                out << "    " << frames[f] << std::endl;
+#endif
+        }
+    }
+
+    /**
+     * @brief Registers the allocation totals with the MetricsRegistry; later calls do nothing.
+     */
+    void AllocationTracker::RegisterMetrics()
+    {
+        static std::once_flag registered;
+        std::call_once(registered, []() {
+            MetricsRegistry::RegisterCounterFunction("graf_heap_allocations_total", "Calls of operator new.", "",
+                                                     []() { return static_cast<double>(GetTotals().allocations); });
+            MetricsRegistry::RegisterCounterFunction("graf_heap_frees_total", "Calls of operator delete.", "",
+                                                     []() { return static_cast<double>(GetTotals().frees); });
+            MetricsRegistry::RegisterCounterFunction("graf_heap_allocated_bytes_total", "Bytes requested from operator new.", "",
+                                                     []() { return static_cast<double>(GetTotals().bytes); });
+        });
+    }
+
+    /**
+     * @brief Constructs a monitor starting at the current totals.
+     * @param windowSize Number of recent frames kept for the statistics.
+     */
+    FrameAllocationMonitor::FrameAllocationMonitor(size_t windowSize)
+        : m_previous(AllocationTracker::GetTotals()),
+          m_allocationsPerFrame(windowSize),
+          m_bytesPerFrame(windowSize)
+    {
+    }
+
+    /**
+     * @brief Requires the frames after a warmup to be allocation-free.
+     *
+     * Sampling every allocation starts with the first steady-state frame and stops
+     * after the first one that allocates.
+     *
+     * @param warmupFrames Frames allowed to allocate, e.g. for caches and first-use setup.
+     */
+    void FrameAllocationMonitor::SetSteadyStateCheck(uint64_t warmupFrames)
+    {
+        m_checking = true;
+        m_warmupFrames = warmupFrames;
+        if (m_frameCount >= m_warmupFrames)
+        {
+            AllocationTracker::SetSampleRate(0);
+            AllocationTracker::ClearSamples();
+            AllocationTracker::SetSampleRate(1);
+        }
+    }
+
+    /**
+     * @brief Ends a frame: attributes the allocations since the last call to it.
+     */
+    void FrameAllocationMonitor::EndFrame()
+    {
+        AllocationStats totals = AllocationTracker::GetTotals();
+        m_lastFrame = totals - m_previous;
+        m_previous = totals;
+        m_frameCount++;
+        m_allocationsPerFrame.AddSample(static_cast<double>(m_lastFrame.allocations));
+        m_bytesPerFrame.AddSample(static_cast<double>(m_lastFrame.bytes));
+
+        if (!m_checking)
+            return;
+        if (m_frameCount == m_warmupFrames)
+        {
+            AllocationTracker::SetSampleRate(0);
+            AllocationTracker::ClearSamples();
+            AllocationTracker::SetSampleRate(1); ///< Sample the whole steady state
+        }
+        else if (m_frameCount > m_warmupFrames && m_lastFrame.allocations > 0)
+        {
+            if (m_allocatingFrames++ == 0)
+            {
+                m_firstFailure = m_frameCount;
+                m_firstFailureStats = m_lastFrame;
+                AllocationTracker::SetSampleRate(0); ///< Keep only the sites of this frame
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the number of frames ended.
+     * @return The count.
+     */
+    uint64_t FrameAllocationMonitor::GetFrameCount() const
+    {
+        return m_frameCount;
+    }
+
+    /**
+     * @brief Gets the allocations of the last frame.
+     * @return The counts.
+     */
+    const AllocationStats& FrameAllocationMonitor::GetLastFrame() const
+    {
+        return m_lastFrame;
+    }
+
+    /**
+     * @brief Gets the allocation count of recent frames.
+     * @return The statistics.
+     */
+    const RollingStats& FrameAllocationMonitor::GetAllocationsPerFrame() const
+    {
+        return m_allocationsPerFrame;
+    }
+
+    /**
+     * @brief Gets the allocated bytes of recent frames.
+     * @return The statistics.
+     */
+    const RollingStats& FrameAllocationMonitor::GetBytesPerFrame() const
+    {
+        return m_bytesPerFrame;
+    }
+
+    /**
+     * @brief Gets the number of steady-state frames that allocated.
+     * @return The count, 0 without a steady-state check.
+     */
+    uint64_t FrameAllocationMonitor::GetAllocatingFrames() const
+    {
+        return m_allocatingFrames;
+    }
+
+    /**
+     * @brief Checks whether a steady-state frame allocated.
+     * @return True if the check failed.
+     */
+    bool FrameAllocationMonitor::HasFailed() const
+    {
+        return m_allocatingFrames > 0;
+    }
+
+    /**
+     * @brief Writes the per-frame summary and, if the check failed, the call sites of the first failing frame.
+     * @param out The stream.
+     */
+    void FrameAllocationMonitor::WriteReport(ostream& out) const
+    {
+        if (!AllocationTracker::IsEnabled())
+        {
+            out << "Heap allocations are not tracked in this build" << std::endl;
+            return;
+        }
+
+        out << "Heap allocations: mean " << m_allocationsPerFrame.getMean() << " per frame, p95 "
+            << m_allocationsPerFrame.getPercentile(95.0) << ", max " << m_allocationsPerFrame.getMax() << ", mean "
+            << m_bytesPerFrame.getMean() << " bytes per frame over " << m_frameCount << " frames" << std::endl;
+        if (!m_checking)
+            return;
+
+        uint64_t steadyFrames = m_frameCount > m_warmupFrames ? m_frameCount - m_warmupFrames : 0;
+        if (!HasFailed())
+        {
+            out << "Steady state: no allocations in " << steadyFrames << " frames after " << m_warmupFrames
+                << " warmup frames" << std::endl;
+            return;
+        }
+        out << "Steady state: " << m_allocatingFrames << " of " << steadyFrames << " frames after " << m_warmupFrames
+            << " warmup frames allocated; frame " << m_firstFailure << " made " << m_firstFailureStats.allocations
+            << " allocations (" << m_firstFailureStats.bytes << " bytes)" << std::endl;
+        AllocationTracker::WriteSampleReport(out);
+    }
+}
+
+#ifdef GRAF_ENABLE_ALLOCATION_TRACKER
+
+// Replacements of the global allocation functions, counting into graf::AllocationTracker
+
+void* operator new(std::size_t size)
+{
+    return graf::AllocateOrThrow(size, 0, GRAF_RETURN_ADDRESS());
+}
+
+void* operator new[](std::size_t size)
+{
+    return graf::AllocateOrThrow(size, 0, GRAF_RETURN_ADDRESS());
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return graf::AllocateNoThrow(size, 0, GRAF_RETURN_ADDRESS());
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return graf::AllocateNoThrow(size, 0, GRAF_RETURN_ADDRESS());
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return graf::AllocateOrThrow(size, static_cast<std::size_t>(alignment), GRAF_RETURN_ADDRESS());
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return graf::AllocateOrThrow(size, static_cast<std::size_t>(alignment), GRAF_RETURN_ADDRESS());
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return graf::AllocateNoThrow(size, static_cast<std::size_t>(alignment), GRAF_RETURN_ADDRESS());
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return graf::AllocateNoThrow(size, static_cast<std::size_t>(alignment), GRAF_RETURN_ADDRESS());
+}
+
+void operator delete(void* pointer) noexcept
+{
+    graf::Free(pointer, false);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    graf::Free(pointer, false);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    graf::Free(pointer, false);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    graf::Free(pointer, false);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    graf::Free(pointer, false);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    graf::Free(pointer, false);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    graf::Free(pointer, true);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+    graf::Free(pointer, true);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    graf::Free(pointer, true);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    graf::Free(pointer, true);
+}
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    graf::Free(pointer, true);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    graf::Free(pointer, true);
+}
+
+#endif
@@ -0,0 +1,334 @@
+#include "FrameArena.hpp"
+#include "Exceptions.hpp"
+#include <algorithm>
+#include <mutex>
+#include <string>
+
+/**
+ * @file FrameArena.cpp
+ * @brief Implementation of the LinearArena and FrameArena classes.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        /**
+         * @struct ThreadSlot
+         * @brief Index of a live thread into the sub-arenas of every FrameArena.
+         *
+         * Indices of exited threads are reused, so a new thread continues with the
+         * sub-arenas of an exited one instead of growing the tables.
+         */
+        struct ThreadSlot
+        {
+            size_t index; ///< Index of the thread.
+
+            ThreadSlot()
+            {
+                std::lock_guard<std::mutex> lock(GetMutex());
+                std::vector<size_t>& free = GetFreeSlots();
+                if (free.empty())
+                {
+                    index = GetNextSlot()++;
+                }
+                else
+                {
+                    index = free.back();
+                    free.pop_back();
+                }
+            }
+
+            ~ThreadSlot()
+            {
+                std::lock_guard<std::mutex> lock(GetMutex());
+                GetFreeSlots().push_back(index);
+            }
+
+            static std::mutex& GetMutex()
+            {
+                static std::mutex mutex;
+                return mutex;
+            }
+
+            static std::vector<size_t>& GetFreeSlots()
+            {
+                static std::vector<size_t> free;
+                return free;
+            }
+
+            static size_t& GetNextSlot()
+            {
+                static size_t next = 0;
+                return next;
+            }
+        };
+
+        thread_local ThreadSlot t_slot; ///< Slot of the calling thread.
+
+        /**
+         * @brief Rounds an address up to an alignment.
+         * @param address The address.
+         * @param alignment A power of two.
+         * @return The aligned address.
+         */
+        uintptr_t AlignUp(uintptr_t address, size_t alignment)
+        {
+            return (address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        }
+    }
+
+    /**
+     * @brief Constructs an empty arena; no memory is taken until the first allocation.
+     * @param blockSize Minimum size of a block in bytes.
+     */
+    LinearArena::LinearArena(size_t blockSize)
+        : m_blockSize(std::max<size_t>(blockSize, 64))
+    {
+    }
+
+    /**
+     * @brief Allocates memory that stays valid until the next Reset.
+     *
+     * Moves on to the next kept block that fits when the current one is full, and
+     * takes a new block from the heap when none does.
+     *
+     * @param size Size in bytes.
+     * @param alignment Alignment, a power of two.
+     * @return The memory.
+     */
+    void* LinearArena::Allocate(size_t size, size_t alignment)
+    {
+        alignment = std::max<size_t>(alignment, 1);
+        for (; m_current < m_blocks.size(); ++m_current, m_offset = 0)
+        {
+            Block& block = m_blocks[m_current];
+            uintptr_t start = reinterpret_cast<uintptr_t>(block.data.get());
+            uintptr_t aligned = AlignUp(start + m_offset, alignment);
+            if (aligned - start <= block.size && size <= block.size - (aligned - start))
+            {
+                size_t end = static_cast<size_t>(aligned - start) + size;
+                m_used += end - m_offset;
+                m_offset = end;
+                return reinterpret_cast<void*>(aligned);
+            }
+        }
+
+        Block block;
+        block.size = std::max(m_blockSize, size + alignment - 1); ///< Room for the worst-case padding
+        block.data.reset(new unsigned char[block.size]);
+        m_blocks.push_back(std::move(block));
+        m_current = m_blocks.size() - 1;
+        m_offset = 0;
+        return Allocate(size, alignment);
+    }
+
+    /**
+     * @brief Makes all memory reusable and records the usage of the ending frame.
+     *
+     * Several blocks are merged into one of their total size, so the next frame
+     * fits into a single block.
+     */
+    void LinearArena::Reset()
+    {
+        m_highWater = std::max(m_highWater, m_used);
+        if (m_blocks.size() > 1)
+        {
+            size_t capacity = GetCapacity();
+            m_blocks.clear();
+            Block block;
+            block.size = capacity;
+            block.data.reset(new unsigned char[capacity]);
+            m_blocks.push_back(std::move(block));
+        }
+        m_current = 0;
+        m_offset = 0;
+        m_used = 0;
+    }
+
+    /**
+     * @brief Frees all blocks.
+     */
+    void LinearArena::Release()
+    {
+        m_highWater = std::max(m_highWater, m_used);
+        m_blocks.clear();
+        m_blocks.shrink_to_fit();
+        m_current = 0;
+        m_offset = 0;
+        m_used = 0;
+    }
+
+    /**
+     * @brief Gets the bytes allocated since the last Reset, including alignment padding.
+     * @return The byte count.
+     */
+    size_t LinearArena::GetUsed() const
+    {
+        return m_used;
+    }
+
+    /**
+     * @brief Gets the most bytes allocated between two resets.
+     * @return The byte count.
+     */
+    size_t LinearArena::GetHighWater() const
+    {
+        return std::max(m_highWater, m_used);
+    }
+
+    /**
+     * @brief Gets the size of all blocks held.
+     * @return The byte count.
+     */
+    size_t LinearArena::GetCapacity() const
+    {
+        size_t capacity = 0;
+        for (const Block& block : m_blocks)
+            capacity += block.size;
+        return capacity;
+    }
+
+    /**
+     * @brief Gets the number of blocks held.
+     * @return The count.
+     */
+    size_t LinearArena::GetBlockCount() const
+    {
+        return m_blocks.size();
+    }
+
+    /**
+     * @brief Constructs an empty arena; no memory is taken until the first allocation.
+     * @param blockSize Minimum size of a block of each sub-arena in bytes.
+     */
+    FrameArena::FrameArena(size_t blockSize)
+        : m_blockSize(blockSize)
+    {
+    }
+
+    /**
+     * @brief Frees the sub-arenas.
+     */
+    FrameArena::~FrameArena()
+    {
+        for (atomic<LinearArena*>& arena : m_arenas)
+            delete arena.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Allocates memory from the calling thread's sub-arena, valid until the next Reset.
+     * @param size Size in bytes.
+     * @param alignment Alignment, a power of two.
+     * @return The memory.
+     */
+    void* FrameArena::Allocate(size_t size, size_t alignment)
+    {
+        return GetThreadArena().Allocate(size, alignment);
+    }
+
+    /**
+     * @brief Gets the sub-arena of the calling thread, creating it on first use.
+     *
+     * Only the calling thread creates its slot's sub-arena, so no lock is needed;
+     * the release store publishes it to Reset and the statistics.
+     *
+     * @return The sub-arena.
+     */
+    LinearArena& FrameArena::GetThreadArena()
+    {
+        size_t index = t_slot.index;
+        if (index >= MAX_THREADS)
+            throw GrafException("FrameArena supports at most " + std::to_string(MAX_THREADS) + " threads at once");
+
+        LinearArena* arena = m_arenas[index].load(std::memory_order_acquire);
+        if (arena == nullptr)
+        {
+            arena = new LinearArena(m_blockSize);
+            m_arenas[index].store(arena, std::memory_order_release);
+        }
+        return *arena;
+    }
+
+    /**
+     * @brief Makes the memory of all threads reusable and records the usage of the ending frame.
+     */
+    void FrameArena::Reset()
+    {
+        m_highWater = std::max(m_highWater, GetUsed());
+        for (atomic<LinearArena*>& slot : m_arenas)
+        {
+            if (LinearArena* arena = slot.load(std::memory_order_acquire))
+                arena->Reset();
+        }
+    }
+
+    /**
+     * @brief Gets the bytes allocated by all threads since the last Reset.
+     * @return The byte count.
+     */
+    size_t FrameArena::GetUsed() const
+    {
+        size_t used = 0;
+        for (const atomic<LinearArena*>& slot : m_arenas)
+        {
+            if (const LinearArena* arena = slot.load(std::memory_order_acquire))
+                used += arena->GetUsed();
+        }
+        return used;
+    }
+
+    /**
+     * @brief Gets the most bytes allocated by all threads between two resets.
+     * @return The byte count.
+     */
+    size_t FrameArena::GetHighWater() const
+    {
+        return std::max(m_highWater, GetUsed());
+    }
+
+    /**
+     * @brief Gets the size of all blocks held by the sub-arenas.
+     * @return The byte count.
+     */
+    size_t FrameArena::GetCapacity() const
+    {
+        size_t capacity = 0;
+        for (const atomic<LinearArena*>& slot : m_arenas)
+        {
+            if (const LinearArena* arena = slot.load(std::memory_order_acquire))
+                capacity += arena->GetCapacity();
+        }
+        return capacity;
+    }
+
+    /**
+     * @brief Gets the number of blocks held by the sub-arenas.
+     * @return The count.
+     */
+    size_t FrameArena::GetBlockCount() const
+    {
+        size_t blocks = 0;
+        for (const atomic<LinearArena*>& slot : m_arenas)
+        {
+            if (const LinearArena* arena = slot.load(std::memory_order_acquire))
+                blocks += arena->GetBlockCount();
+        }
+        return blocks;
+    }
+
+    /**
+     * @brief Gets the number of threads that have allocated from the arena.
+     * @return The count of sub-arenas.
+     */
+    size_t FrameArena::GetThreadArenaCount() const
+    {
+        size_t count = 0;
+        for (const atomic<LinearArena*>& slot : m_arenas)
+        {
+            if (slot.load(std::memory_order_acquire) != nullptr)
+                count++;
+        }
+        return count;
+    }
+}
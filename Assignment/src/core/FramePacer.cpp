@@ -0,0 +1,187 @@
+#include "FramePacer.hpp"
+#include "Metrics.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * @file FramePacer.cpp
+ * @brief Implementation of the FramePacer class for presentation-mode control and frame pacing.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Parses a presentation mode name.
+     * @param name One of "vsync", "adaptive", "uncapped" or "limited".
+     * @return The matching mode.
+     * @exception std::invalid_argument Thrown if the name is unknown.
+     */
+    PresentMode ParsePresentMode(const string& name)
+    {
+        if (name == "vsync")    return PresentMode::VSync;
+        if (name == "adaptive") return PresentMode::AdaptiveVSync;
+        if (name == "uncapped") return PresentMode::Uncapped;
+        if (name == "limited")  return PresentMode::Limited;
+        throw std::invalid_argument("Unknown present mode: " + name);
+    }
+
+    /**
+     * @brief Constructs a pacer in VSync mode targeting 60 frames per second.
+     */
+    FramePacer::FramePacer()
+    {
+        SetMode(PresentMode::VSync, 60.0);
+    }
+
+    /**
+     * @brief Sets the presentation mode and resets the statistics.
+     * @param mode The presentation mode.
+     * @param targetFps Frame rate used for the limiter and the missed-deadline check.
+     */
+    void FramePacer::SetMode(PresentMode mode, double targetFps)
+    {
+        if (targetFps <= 0.0)
+            throw std::invalid_argument("Target frame rate must be positive");
+
+        m_mode = mode;
+        m_targetFps = targetFps;
+        m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetFps));
+        m_started = false;
+        m_frameTimes.Clear();
+        m_missedDeadlines = 0;
+    }
+
+    /**
+     * @brief Gets the presentation mode.
+     * @return The current mode.
+     */
+    PresentMode FramePacer::GetMode() const
+    {
+        return m_mode;
+    }
+
+    /**
+     * @brief Gets the target frame rate.
+     * @return Frames per second.
+     */
+    double FramePacer::GetTargetFps() const
+    {
+        return m_targetFps;
+    }
+
+    /**
+     * @brief Gets the swap interval to pass to the windowing system for the mode.
+     * @return 1 for VSync, -1 for AdaptiveVSync and 0 otherwise.
+     */
+    int FramePacer::GetSwapInterval() const
+    {
+        switch (m_mode)
+        {
+        case PresentMode::VSync:         return 1;
+        case PresentMode::AdaptiveVSync: return -1;
+        default:                         return 0;
+        }
+    }
+
+    /**
+     * @brief Finishes a frame: waits for its deadline if limited and records its duration.
+     *
+     * The limiter schedules deadlines on a fixed grid so short frames make up for
+     * timer jitter; after falling more than a period behind it restarts the grid
+     * instead of rushing to catch up.
+     */
+    void FramePacer::EndFrame()
+    {
+        Clock::time_point now = Clock::now();
+
+        if (m_mode == PresentMode::Limited && m_started)
+        {
+            if (now < m_nextDeadline)
+            {
+                WaitUntil(m_nextDeadline);
+                now = Clock::now();
+            }
+
+            m_nextDeadline += m_period;
+            if (m_nextDeadline < now)
+                m_nextDeadline = now + m_period; ///< Too far behind, restart the schedule
+        }
+        else
+        {
+            m_nextDeadline = now + m_period;
+        }
+
+        if (m_started)
+        {
+            static MetricHistogram& frameTimeMetric = MetricsRegistry::GetHistogram(
+                "graf_frame_time_seconds", "Time between two presented frames.", MetricsRegistry::GetDurationBuckets());
+            static MetricCounter& missedMetric = MetricsRegistry::GetCounter(
+                "graf_missed_deadlines_total", "Frames that took at least one extra refresh period.");
+
+            Clock::duration frameTime = now - m_lastFrameEnd;
+            m_frameTimes.AddSample(std::chrono::duration<double, std::milli>(frameTime).count());
+            frameTimeMetric.Observe(std::chrono::duration<double>(frameTime).count());
+
+            if (m_mode != PresentMode::Uncapped && frameTime > m_period + m_period / 2)
+            {
+                m_missedDeadlines++; ///< Took at least one extra period
+                missedMetric.Increment();
+            }
+        }
+
+        m_lastFrameEnd = now;
+        m_started = true;
+    }
+
+    /**
+     * @brief Gets the frame-time statistics in milliseconds.
+     * @return The statistics over the most recent frames.
+     */
+    const RollingStats& FramePacer::GetFrameTimes() const
+    {
+        return m_frameTimes;
+    }
+
+    /**
+     * @brief Gets the number of frames that missed their deadline.
+     * @return The missed deadline count since the mode was set.
+     */
+    size_t FramePacer::GetMissedDeadlines() const
+    {
+        return m_missedDeadlines;
+    }
+
+    /**
+     * @brief Blocks until the given time point with sleep followed by spin.
+     *
+     * Sleeps in 1 ms steps while the remaining time exceeds the expected duration of
+     * such a sleep (mean plus one standard deviation, learned online), then spins
+     * for the rest. This keeps the CPU idle for most of the wait while still waking
+     * up precisely on platforms with coarse timers.
+     *
+     * @param deadline The time point to wait for.
+     */
+    void FramePacer::WaitUntil(Clock::time_point deadline)
+    {
+        while (true)
+        {
+            Clock::time_point start = Clock::now();
+            double remaining = std::chrono::duration<double>(deadline - start).count();
+            if (remaining <= m_sleepEstimate)
+                break;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            double observed = std::chrono::duration<double>(Clock::now() - start).count();
+            m_sleepCount++;
+            double delta = observed - m_sleepMean;
+            m_sleepMean += delta / m_sleepCount;
+            m_sleepM2 += delta * (observed - m_sleepMean);
+            m_sleepEstimate = m_sleepMean + std::sqrt(m_sleepM2 / (m_sleepCount - 1));
+        }
+
+        while (Clock::now() < deadline)
+            std::this_thread::yield(); ///< Spin for the final stretch
+    }
+}
@@ -0,0 +1,97 @@
+#include "FramePipeline.hpp"
+#include <algorithm>
+
+/**
+ * @file FramePipeline.cpp
+ * @brief Implementation of the FramePipeline class for passing frame packets between threads.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Constructs a pipeline with the given queue depth.
+     * 
+     * Allocates one packet per queued frame plus one for the GL thread and marks
+     * all of them as free. Both queues get room for every packet up front, so
+     * passing packets around never allocates.
+     * 
+     * @param queueDepth Maximum number of frames the simulation may run ahead (at least 1).
+     */
+    FramePipeline::FramePipeline(size_t queueDepth)
+        : m_packets(std::max<size_t>(queueDepth, 1) + 1), m_free(m_packets.size()), m_ready(m_packets.size())
+    {
+        for (auto& packet : m_packets)
+            m_free.PushBack(&packet); ///< Every packet starts out writable
+    }
+
+    /**
+     * @brief Acquires a free packet for the simulation to fill.
+     * 
+     * Waits until the GL thread recycles a packet when the queue is full.
+     * 
+     * @return Pointer to a writable packet, or nullptr if the pipeline was stopped.
+     */
+    FramePacket* FramePipeline::BeginWrite()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_freeCondition.wait(lock, [this] { return m_stopped || !m_free.IsEmpty(); });
+
+        if (m_stopped)
+            return nullptr; ///< Pipeline shut down while waiting
+
+        return m_free.PopFront();
+    }
+
+    /**
+     * @brief Publishes a packet previously obtained from BeginWrite.
+     * @param packet The filled packet to hand to the consumer.
+     */
+    void FramePipeline::Publish(FramePacket* packet)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_ready.PushBack(packet); ///< Queue for rendering in submission order
+        }
+        m_readyCondition.notify_one();
+    }
+
+    /**
+     * @brief Acquires the next published packet for rendering.
+     * 
+     * Returns the packet held since the previous call to the free list, then waits
+     * for the oldest published packet.
+     * 
+     * @return Pointer to a read-only packet, or nullptr if the pipeline was stopped.
+     */
+    const FramePacket* FramePipeline::AcquireNext()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_current)
+        {
+            m_free.PushBack(m_current); ///< Recycle the previously rendered packet
+            m_current = nullptr;
+            m_freeCondition.notify_one();
+        }
+
+        m_readyCondition.wait(lock, [this] { return m_stopped || !m_ready.IsEmpty(); });
+
+        if (m_stopped)
+            return nullptr; ///< Pipeline shut down while waiting
+
+        m_current = m_ready.PopFront();
+        return m_current;
+    }
+
+    /**
+     * @brief Stops the pipeline and wakes up all waiting threads.
+     */
+    void FramePipeline::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopped = true;
+        }
+        m_freeCondition.notify_all();
+        m_readyCondition.notify_all();
+    }
+}
@@ -1,4 +1,8 @@
 #include "GLWindow.hpp"
+#include "Exceptions.hpp"
+#include "Profiler.hpp"
+#include <chrono>
+#include <cmath>
 #include <iostream>
 
 /**
@@ -8,11 +12,24 @@
 
 namespace graf
 {
+    namespace
+    {
+        /**
+         * @brief Gets the current steady_clock time in nanoseconds.
+         * @return The timestamp used for input events and latency measurement.
+         */
+        int64_t NowNanoseconds()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    }
+
     /**
      * @brief Static callback function for GLFW keyboard events.
      * 
      * Retrieves the GLWindow instance from the window’s user pointer and forwards
-     * the keyboard event to the instance’s registered keyboard callback.
+     * the keyboard event to the instance’s input queue.
      * 
      * @param window The GLFW window that received the event.
      * @param key The keyboard key that was pressed or released.
@@ -23,7 +40,250 @@ namespace graf
     void GLWindow::sKeyboardFunction(GLFWwindow* window, int key, int scancode, int action, int mods)
     {
         GLWindow* pWindow = (GLWindow*)glfwGetWindowUserPointer(window);
-        pWindow->m_keyboardFunction(key, scancode, action); ///< Forward event to instance callback
+
+        InputEvent event;
+        event.type = InputEventType::Key;
+        event.key = key;
+        event.scancode = scancode;
+        event.action = action;
+        event.mods = mods;
+        pWindow->QueueInput(event); ///< Forward event to instance callbacks
+    }
+
+    /**
+     * @brief Static callback function for GLFW mouse button events.
+     * 
+     * Records the cursor position at the time of the click along with the button.
+     * 
+     * @param window The GLFW window that received the event.
+     * @param button The mouse button that was pressed or released.
+     * @param action The button action (GLFW_PRESS, GLFW_RELEASE).
+     * @param mods Bit field of modifier keys.
+     */
+    void GLWindow::sMouseButtonFunction(GLFWwindow* window, int button, int action, int mods)
+    {
+        GLWindow* pWindow = (GLWindow*)glfwGetWindowUserPointer(window);
+
+        InputEvent event;
+        event.type = InputEventType::MouseButton;
+        event.key = button;
+        event.action = action;
+        event.mods = mods;
+        glfwGetCursorPos(window, &event.x, &event.y);
+        pWindow->QueueInput(event);
+    }
+
+    /**
+     * @brief Static callback function for GLFW cursor movement events.
+     * @param window The GLFW window that received the event.
+     * @param x The new cursor x position in screen coordinates.
+     * @param y The new cursor y position in screen coordinates.
+     */
+    void GLWindow::sCursorPosFunction(GLFWwindow* window, double x, double y)
+    {
+        GLWindow* pWindow = (GLWindow*)glfwGetWindowUserPointer(window);
+
+        InputEvent event;
+        event.type = InputEventType::CursorMove;
+        event.x = x;
+        event.y = y;
+        pWindow->QueueInput(event);
+    }
+
+    /**
+     * @brief Static callback function for GLFW framebuffer resize events.
+     * 
+     * Updates the OpenGL viewport right away and forwards the event.
+     * 
+     * @param window The GLFW window that received the event.
+     * @param width The new framebuffer width in pixels.
+     * @param height The new framebuffer height in pixels.
+     */
+    void GLWindow::sFramebufferSizeFunction(GLFWwindow* window, int width, int height)
+    {
+        GLWindow* pWindow = (GLWindow*)glfwGetWindowUserPointer(window);
+        glViewport(0, 0, width, height); ///< Keep rendering to the whole framebuffer
+
+        InputEvent event;
+        event.type = InputEventType::Resize;
+        event.width = width;
+        event.height = height;
+        pWindow->QueueInput(event);
+    }
+
+    /**
+     * @brief Timestamps an input event and routes it to the callbacks.
+     * 
+     * In pipelined mode the event is pushed to the lock-free input queue and picked up
+     * by the simulation thread; if the queue is full the event is dropped and counted.
+     * Otherwise the callbacks are invoked immediately. Window input is ignored while
+     * a recording is replayed.
+     * 
+     * @param event The event to route; its timestamp is filled in.
+     */
+    void GLWindow::QueueInput(InputEvent event)
+    {
+        if (m_inputMode == InputMode::Replay)
+            return; ///< The recording is the only input source
+
+        event.timestamp = NowNanoseconds();
+
+        if (!m_simulationFunction)
+        {
+            DispatchInput(event);
+            return;
+        }
+
+        if (!m_inputQueue.TryPush(event))
+            m_droppedInputEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Invokes the keyboard and input callbacks for an event.
+     * @param event The event to dispatch.
+     */
+    void GLWindow::DispatchInput(const InputEvent& event)
+    {
+        if (event.type == InputEventType::Key && m_keyboardFunction)
+            m_keyboardFunction(event.key, event.scancode, event.action); ///< Forward event to instance callback
+
+        if (m_inputFunction)
+            m_inputFunction(event);
+    }
+
+    /**
+     * @brief Selects how frames are presented and paced.
+     * @param mode The presentation mode.
+     * @param targetFps Target frame rate; 0 uses the primary monitor's refresh rate.
+     */
+    void GLWindow::SetPresentMode(PresentMode mode, double targetFps)
+    {
+        if (targetFps <= 0.0)
+        {
+            targetFps = 60.0; ///< Fallback when no monitor information is available
+            if (m_window)
+            {
+                GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+                const GLFWvidmode* videoMode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+                if (videoMode && videoMode->refreshRate > 0)
+                    targetFps = videoMode->refreshRate;
+            }
+        }
+
+        m_framePacer.SetMode(mode, targetFps);
+        if (m_window && !m_headless)
+            ApplySwapInterval();
+    }
+
+    /**
+     * @brief Gets the frame pacer holding frame-time and missed-deadline statistics.
+     * @return The frame pacer.
+     */
+    const FramePacer& GLWindow::GetFramePacer() const
+    {
+        return m_framePacer;
+    }
+
+    /**
+     * @brief Gets the underlying GLFW window, e.g. for UI libraries.
+     * @return The window, or nullptr before create.
+     */
+    GLFWwindow* GLWindow::GetNativeWindow() const
+    {
+        return m_window;
+    }
+
+    /**
+     * @brief Applies the frame pacer's swap interval to the window's context.
+     * 
+     * Adaptive vsync needs the swap-control-tear extension; without it regular
+     * vsync is used.
+     */
+    void GLWindow::ApplySwapInterval()
+    {
+        int interval = m_framePacer.GetSwapInterval();
+        if (interval < 0 && !glfwExtensionSupported("WGL_EXT_swap_control_tear")
+                         && !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+        {
+            std::cerr << "Adaptive vsync is not supported, using vsync" << std::endl;
+            interval = 1;
+        }
+
+        glfwSwapInterval(interval);
+    }
+
+    /**
+     * @brief Sets the callback receiving all keyboard, mouse and resize events.
+     * @param inputFunc The function to be called for each input event.
+     */
+    void GLWindow::SetInputFunction(InputFunction inputFunc)
+    {
+        m_inputFunction = inputFunc;
+    }
+
+    /**
+     * @brief Starts recording every applied input event.
+     * @param seed Seed of the application's random number generator, stored for replays.
+     */
+    void GLWindow::StartInputRecording(uint64_t seed)
+    {
+        m_inputMode = InputMode::Record;
+        m_inputRecording = InputRecording();
+        m_inputRecording.seed = seed;
+        m_recordStart = NowNanoseconds();
+    }
+
+    /**
+     * @brief Gets the input recorded since StartInputRecording.
+     * @return The recording.
+     */
+    const InputRecording& GLWindow::GetInputRecording() const
+    {
+        return m_inputRecording;
+    }
+
+    /**
+     * @brief Replays a recorded input session instead of live input.
+     * @param recording The session to replay.
+     */
+    void GLWindow::StartInputReplay(InputRecording recording)
+    {
+        if (recording.tickRate <= 0.0)
+            throw GLWindowException("Input recording has an invalid tick rate");
+
+        m_inputMode = InputMode::Replay;
+        m_inputRecording = std::move(recording);
+        m_replayCursor = 0;
+        m_frameLimit = m_inputRecording.tickCount; ///< One tick per replayed frame
+        m_frameTimeLog.clear();
+        m_frameTimeLog.reserve(m_inputRecording.tickCount);
+    }
+
+    /**
+     * @brief Gets the duration of every presented frame during a replay.
+     * @return Frame times in milliseconds, in presentation order.
+     */
+    const vector<double>& GLWindow::GetFrameTimeLog() const
+    {
+        return m_frameTimeLog;
+    }
+
+    /**
+     * @brief Gets the input-to-present latency statistics in milliseconds.
+     * @return The latency statistics.
+     */
+    const RollingStats& GLWindow::GetInputLatency() const
+    {
+        return m_inputLatency;
+    }
+
+    /**
+     * @brief Gets the number of input events dropped because the queue was full.
+     * @return The dropped event count.
+     */
+    size_t GLWindow::GetDroppedInputEvents() const
+    {
+        return m_droppedInputEvents.load(std::memory_order_relaxed);
     }
 
     /**
@@ -83,12 +343,140 @@ namespace graf
         }  
 
         glEnable(GL_DEPTH_TEST); ///< Enable depth testing for 3D rendering
+        ApplySwapInterval(); ///< Pacing is explicit instead of the driver default
         glfwSetWindowUserPointer(m_window, this); ///< Store instance pointer for callbacks
         glfwSetKeyCallback(m_window, sKeyboardFunction); ///< Set keyboard callback
+        glfwSetMouseButtonCallback(m_window, sMouseButtonFunction); ///< Set mouse button callback
+        glfwSetCursorPosCallback(m_window, sCursorPosFunction); ///< Set cursor movement callback
+        glfwSetFramebufferSizeCallback(m_window, sFramebufferSizeFunction); ///< Set resize callback
 
         return 1;
     }
 
+    /**
+     * @brief Creates an OpenGL context without a visible window.
+     * 
+     * Uses GLFW's null platform, which needs no display server, and asks for an EGL
+     * context first (surfaceless, hardware or Mesa llvmpipe) and an OSMesa context
+     * second. The window itself is only a context holder; everything is drawn into
+     * an offscreen framebuffer of the requested size.
+     * 
+     * @param width The width of the render target in pixels.
+     * @param height The height of the render target in pixels.
+     * @return 1 on success.
+     * @exception GLWindowException Thrown if no headless context can be created.
+     */
+    int GLWindow::createHeadless(unsigned int width, unsigned int height)
+    {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL); ///< No display server required
+        if (!glfwInit())
+            throw GLWindowException("Failed to initialize GLFW for headless rendering");
+
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3); ///< Request OpenGL 3.3
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+        const int contextApis[] = { GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API };
+        for (int contextApi : contextApis)
+        {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextApi);
+            m_window = glfwCreateWindow(width, height, "Headless", NULL, NULL);
+            if (m_window)
+                break;
+        }
+
+        if (!m_window)
+        {
+            glfwTerminate();
+            throw GLWindowException("No headless OpenGL context available (EGL or OSMesa)");
+        }
+
+        glfwMakeContextCurrent(m_window);
+
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+        {
+            glfwDestroyWindow(m_window);
+            glfwTerminate();
+            throw GLWindowException("Failed to initialize GLAD");
+        }
+
+        glEnable(GL_DEPTH_TEST); ///< Enable depth testing for 3D rendering
+        glfwSetWindowUserPointer(m_window, this); ///< Store instance pointer for callbacks
+
+        m_headless = true;
+        m_frameBuffer.Create(width, height);
+        m_frameBuffer.Bind(); ///< All rendering goes offscreen from here on
+        m_framePacer.SetMode(PresentMode::Uncapped, 60.0);
+
+        return 1;
+    }
+
+    /**
+     * @brief Checks whether the window was created with createHeadless.
+     * @return True in headless mode.
+     */
+    bool GLWindow::IsHeadless() const
+    {
+        return m_headless;
+    }
+
+    /**
+     * @brief Gets the offscreen render target used in headless mode.
+     * @return The framebuffer; only valid in headless mode.
+     */
+    FrameBuffer& GLWindow::GetFrameBuffer()
+    {
+        return m_frameBuffer;
+    }
+
+    /**
+     * @brief Stops the render loop after a number of frames.
+     * @param frameCount Number of frames to render; 0 renders until the window closes.
+     */
+    void GLWindow::SetFrameLimit(uint64_t frameCount)
+    {
+        m_frameLimit = frameCount;
+    }
+
+    /**
+     * @brief Checks whether the render loop should stop.
+     * @return True if the window was closed or the frame limit was reached.
+     */
+    bool GLWindow::ShouldClose() const
+    {
+        if (m_frameLimit != 0 && m_renderedFrames >= m_frameLimit)
+            return true;
+
+        return glfwWindowShouldClose(m_window);
+    }
+
+    /**
+     * @brief Presents a finished frame and paces it.
+     */
+    void GLWindow::PresentFrame()
+    {
+        if (!m_headless)
+        {
+            GRAF_PROFILE_SCOPE("SwapBuffers");
+            glfwSwapBuffers(m_window); ///< Swap front and back buffers
+        }
+
+        m_renderedFrames++;
+        {
+            GRAF_PROFILE_SCOPE("FramePacer::EndFrame");
+            m_framePacer.EndFrame(); ///< Limit the frame rate and record the frame time
+        }
+#ifdef GRAF_ENABLE_PROFILER
+        Profiler::Collect(); ///< Drain the zone rings once per frame
+#endif
+
+        int64_t now = NowNanoseconds();
+        if (m_inputMode == InputMode::Replay)
+            m_frameTimeLog.push_back((now - m_lastPresentTime) / 1.0e6);
+        m_lastPresentTime = now;
+    }
+
     /**
      * @brief Sets the custom rendering callback function.
      * 
@@ -101,26 +489,235 @@ namespace graf
         m_renderFunction = renderFunc;
     }
 
+    /**
+     * @brief Sets the simulation callback and enables pipelined rendering.
+     * 
+     * @param simulationFunc The function that advances the state and fills a packet.
+     * @param queueDepth Maximum number of frames the simulation may run ahead of rendering.
+     */
+    void GLWindow::SetSimulationFunction(SimulationFunction simulationFunc, size_t queueDepth)
+    {
+        m_simulationFunction = simulationFunc;
+        m_pipeline = std::make_unique<FramePipeline>(queueDepth);
+    }
+
+    /**
+     * @brief Sets the fixed-timestep update callback.
+     * @param tickFunc The function advancing the state by one tick.
+     * @param tickRate Number of ticks per second.
+     */
+    void GLWindow::SetTickFunction(TickFunction tickFunc, double tickRate)
+    {
+        if (tickRate <= 0.0)
+            throw GLWindowException("Tick rate must be positive");
+
+        m_tickFunction = tickFunc;
+        m_tickSeconds = 1.0 / tickRate;
+    }
+
+    /**
+     * @brief Sets the callback that renders a published frame packet.
+     * @param frameRenderFunc The function to be called on the GL thread for each packet.
+     */
+    void GLWindow::SetFrameRenderFunction(FrameRenderFunction frameRenderFunc)
+    {
+        m_frameRenderFunction = frameRenderFunc;
+    }
+
+    /**
+     * @brief Entry point of the simulation thread.
+     * 
+     * Each iteration drains the input events queued by the GL thread, lets the
+     * simulation function fill a free packet and publishes it. The receive time of
+     * every applied event travels with the packet so the GL thread can measure
+     * input-to-present latency. With a tick function, the elapsed real time is
+     * consumed in fixed ticks and the leftover fraction becomes the packet's
+     * interpolation factor, so simulation speed no longer depends on the frame rate.
+     * During a replay every packet runs exactly one tick at the recorded rate and
+     * the recorded events are applied before the tick they were recorded at.
+     * The loop blocks in BeginWrite whenever the simulation is a full queue ahead
+     * of rendering.
+     */
+    void GLWindow::SimulationLoop()
+    {
+        uint64_t frameIndex = 0;
+        uint64_t tickIndex = 0;
+        double accumulator = 0.0;
+        int64_t lastTime = NowNanoseconds();
+        GRAF_PROFILE_THREAD("Simulation");
+
+        if (m_inputMode == InputMode::Record)
+            m_inputRecording.tickRate = 1.0 / m_tickSeconds;
+        else if (m_inputMode == InputMode::Replay)
+            m_tickSeconds = 1.0 / m_inputRecording.tickRate; ///< Overrides SetTickFunction
+
+        while (FramePacket* packet = m_pipeline->BeginWrite())
+        {
+            GRAF_PROFILE_SCOPE("SimulateFrame");
+            packet->inputTimestamps.clear();
+
+            try
+            {
+                if (m_inputMode == InputMode::Replay)
+                {
+                    const auto& events = m_inputRecording.events;
+                    while (m_replayCursor < events.size() && events[m_replayCursor].tick <= tickIndex)
+                    {
+                        InputEvent event = events[m_replayCursor++].event;
+                        event.timestamp = NowNanoseconds();
+                        packet->inputTimestamps.push_back(event.timestamp);
+                        DispatchInput(event); ///< Apply at the recorded tick
+                    }
+
+                    if (m_tickFunction)
+                        m_tickFunction(m_tickSeconds); ///< Exactly one step per frame, independent of timing
+                    ++tickIndex;
+                    packet->interpolation = 1.0f;
+                }
+                else
+                {
+                    InputEvent event;
+                    while (m_inputQueue.TryPop(event))
+                    {
+                        if (m_inputMode == InputMode::Record)
+                        {
+                            RecordedInputEvent recorded{tickIndex, frameIndex, event};
+                            recorded.event.timestamp -= m_recordStart;
+                            m_inputRecording.events.push_back(recorded);
+                        }
+
+                        packet->inputTimestamps.push_back(event.timestamp);
+                        DispatchInput(event); ///< Apply input before simulating
+                    }
+
+                    if (m_tickFunction)
+                    {
+                        int64_t now = NowNanoseconds();
+                        accumulator += (now - lastTime) / 1.0e9;
+                        lastTime = now;
+
+                        int ticks = 0;
+                        while (accumulator >= m_tickSeconds && ticks < MAX_TICKS_PER_FRAME)
+                        {
+                            GRAF_PROFILE_SCOPE("Tick");
+                            m_tickFunction(m_tickSeconds); ///< Advance state by one fixed step
+                            accumulator -= m_tickSeconds;
+                            ++tickIndex;
+                            ++ticks;
+                        }
+
+                        if (accumulator >= m_tickSeconds)
+                            accumulator = std::fmod(accumulator, m_tickSeconds); ///< Drop backlog after a stall
+
+                        packet->interpolation = static_cast<float>(accumulator / m_tickSeconds);
+                    }
+                    else
+                    {
+                        packet->interpolation = 1.0f;
+                        ++tickIndex; ///< Without a tick function every frame is one step
+                    }
+                }
+
+                if (m_inputMode == InputMode::Record)
+                    m_inputRecording.tickCount = tickIndex;
+
+                packet->frameIndex = frameIndex++;
+                packet->tickIndex = tickIndex;
+
+                GRAF_PROFILE_SCOPE("SimulationFunction");
+                m_simulationFunction(*packet); ///< Fill the packet from the current state
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "Simulation error: " << e.what() << std::endl;
+            }
+
+            m_pipeline->Publish(packet);
+        }
+    }
+
+    /**
+     * @brief Runs the pipelined loop that renders packets from the simulation thread.
+     * 
+     * Starts the simulation thread, then renders each published packet, swaps buffers
+     * and processes events until the window is closed. The simulation thread is stopped
+     * and joined before returning, so the close function never races with it.
+     */
+    void GLWindow::RenderPipelined()
+    {
+        m_simulationThread = std::thread(&GLWindow::SimulationLoop, this);
+
+        while (!ShouldClose())
+        {
+            GRAF_PROFILE_SCOPE("Frame");
+            const FramePacket* packet;
+            {
+                GRAF_PROFILE_SCOPE("AcquireFramePacket");
+                packet = m_pipeline->AcquireNext(); ///< Wait for the next simulated frame
+            }
+            if (!packet)
+                break;
+
+            if (m_frameRenderFunction)
+            {
+                GRAF_PROFILE_SCOPE("FrameRenderFunction");
+                m_frameRenderFunction(*packet); ///< Issue GL calls for the packet
+            }
+
+            PresentFrame();
+
+            int64_t presentTime = NowNanoseconds();
+            for (int64_t timestamp : packet->inputTimestamps)
+                m_inputLatency.AddSample((presentTime - timestamp) / 1.0e6); ///< Input-to-present latency in ms
+
+            GRAF_PROFILE_SCOPE("PollEvents");
+            glfwPollEvents(); ///< Process pending events (e.g., keyboard, window close)
+        }
+
+        m_pipeline->Stop(); ///< Release the simulation thread if it is waiting for a packet
+        m_simulationThread.join();
+    }
+
     /**
      * @brief Runs the main rendering loop and handles window closure.
      * 
      * Continuously calls the registered render function, swaps buffers, and processes
-     * events until the window is closed by the user. Upon closure, calls the registered
-     * close function if set.
+     * events until the window is closed by the user. If a simulation function is set,
+     * the pipelined loop is used instead. Upon closure, calls the registered close
+     * function if set.
      */
     void GLWindow::Render()
     {
-        while (!glfwWindowShouldClose(m_window))
+        GRAF_PROFILE_THREAD("Main");
+        m_lastPresentTime = NowNanoseconds();
+
+        if (m_simulationFunction)
         {
-            m_renderFunction(); ///< Call custom render function
-            
-            glfwSwapBuffers(m_window); ///< Swap front and back buffers
-            glfwPollEvents(); ///< Process pending events (e.g., keyboard, window close)
+            RenderPipelined();
+        }
+        else
+        {
+            while (!ShouldClose())
+            {
+                GRAF_PROFILE_SCOPE("Frame");
+                {
+                    GRAF_PROFILE_SCOPE("RenderFunction");
+                    m_renderFunction(); ///< Call custom render function
+                }
+
+                PresentFrame();
+
+                GRAF_PROFILE_SCOPE("PollEvents");
+                glfwPollEvents(); ///< Process pending events (e.g., keyboard, window close)
+            }
         }
 
         if (m_closeFunction) 
             m_closeFunction(); ///< Call the registered close function if it exists
 
+        if (m_headless)
+            m_frameBuffer.Release(); ///< Delete while the context is still alive
+
         glfwDestroyWindow(m_window); ///< Destroy the GLFW window
         glfwTerminate(); ///< Terminate GLFW
     }
@@ -0,0 +1,158 @@
+#include "InputRecording.hpp"
+#include "Exceptions.hpp"
+#include <cstring>
+#include <fstream>
+
+/**
+ * @file InputRecording.cpp
+ * @brief Implementation of the InputRecording class for recording and replaying input sessions.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const char      RECORDING_MAGIC[4] = {'G', 'I', 'N', 'P'};  ///< File signature.
+        const uint32_t  RECORDING_VERSION  = 1;                     ///< Format version.
+        const uint64_t  EVENT_RECORD_SIZE  = 44;                    ///< Bytes per stored event.
+
+        /**
+         * @brief Appends the bytes of a trivially copyable value to a buffer.
+         * @param buffer The buffer to append to.
+         * @param value The value to append.
+         */
+        template<typename T>
+        void Put(vector<char>& buffer, const T& value)
+        {
+            const char* bytes = reinterpret_cast<const char*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+
+        /**
+         * @brief Reads a trivially copyable value from a stream.
+         * @param file The stream to read from.
+         * @param value Receives the value.
+         * @exception GrafException Thrown if the stream ends early.
+         */
+        template<typename T>
+        void Get(std::ifstream& file, T& value)
+        {
+            if (!file.read(reinterpret_cast<char*>(&value), sizeof(T)))
+                throw GrafException("Input recording is truncated");
+        }
+    }
+
+    /**
+     * @brief Writes the recording to a file.
+     *
+     * Each event takes 44 bytes: tick and frame as 32-bit values, the relative
+     * timestamp, the type, action and mods, key and scancode, the cursor position
+     * and the framebuffer size.
+     *
+     * @param fileName Path of the file to write.
+     * @exception GrafException Thrown if the file cannot be written.
+     */
+    void InputRecording::Save(const string& fileName) const
+    {
+        vector<char> buffer;
+        buffer.insert(buffer.end(), RECORDING_MAGIC, RECORDING_MAGIC + sizeof(RECORDING_MAGIC));
+        Put(buffer, RECORDING_VERSION);
+        Put(buffer, tickRate);
+        Put(buffer, seed);
+        Put(buffer, tickCount);
+        Put(buffer, static_cast<uint64_t>(events.size()));
+
+        for (const auto& recorded : events)
+        {
+            const InputEvent& event = recorded.event;
+            Put(buffer, static_cast<uint32_t>(recorded.tick));
+            Put(buffer, static_cast<uint32_t>(recorded.frame));
+            Put(buffer, event.timestamp);
+            Put(buffer, static_cast<uint8_t>(event.type));
+            Put(buffer, static_cast<uint8_t>(event.action));
+            Put(buffer, static_cast<uint16_t>(event.mods));
+            Put(buffer, static_cast<int32_t>(event.key));
+            Put(buffer, static_cast<int32_t>(event.scancode));
+            Put(buffer, static_cast<float>(event.x));
+            Put(buffer, static_cast<float>(event.y));
+            Put(buffer, static_cast<int32_t>(event.width));
+            Put(buffer, static_cast<int32_t>(event.height));
+        }
+
+        std::ofstream file(fileName, std::ios::binary);
+        file.write(buffer.data(), buffer.size());
+        if (!file)
+            throw GrafException("Failed to write input recording: " + fileName);
+    }
+
+    /**
+     * @brief Reads a recording from a file.
+     * @param fileName Path of the file to read.
+     * @return The recording.
+     * @exception GrafException Thrown if the file is missing, truncated or not a recording.
+     */
+    InputRecording InputRecording::Load(const string& fileName)
+    {
+        std::ifstream file(fileName, std::ios::binary);
+        if (!file.is_open())
+            throw GrafException("Failed to open input recording: " + fileName);
+
+        char magic[sizeof(RECORDING_MAGIC)];
+        uint32_t version = 0;
+        Get(file, magic);
+        Get(file, version);
+        if (std::memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0 || version != RECORDING_VERSION)
+            throw GrafException("Not a supported input recording: " + fileName);
+
+        InputRecording recording;
+        uint64_t eventCount = 0;
+        Get(file, recording.tickRate);
+        Get(file, recording.seed);
+        Get(file, recording.tickCount);
+        Get(file, eventCount);
+
+        std::streampos dataStart = file.tellg();
+        file.seekg(0, std::ios::end);
+        uint64_t dataSize = static_cast<uint64_t>(file.tellg() - dataStart);
+        file.seekg(dataStart);
+        if (eventCount > dataSize / EVENT_RECORD_SIZE)
+            throw GrafException("Input recording is truncated");
+
+        recording.events.resize(eventCount);
+        for (auto& recorded : recording.events)
+        {
+            uint32_t tick, frame;
+            uint8_t type, action;
+            uint16_t mods;
+            int32_t key, scancode, width, height;
+            float x, y;
+
+            Get(file, tick);
+            Get(file, frame);
+            Get(file, recorded.event.timestamp);
+            Get(file, type);
+            Get(file, action);
+            Get(file, mods);
+            Get(file, key);
+            Get(file, scancode);
+            Get(file, x);
+            Get(file, y);
+            Get(file, width);
+            Get(file, height);
+
+            recorded.tick = tick;
+            recorded.frame = frame;
+            recorded.event.type = static_cast<InputEventType>(type);
+            recorded.event.action = action;
+            recorded.event.mods = mods;
+            recorded.event.key = key;
+            recorded.event.scancode = scancode;
+            recorded.event.x = x;
+            recorded.event.y = y;
+            recorded.event.width = width;
+            recorded.event.height = height;
+        }
+
+        return recording;
+    }
+}
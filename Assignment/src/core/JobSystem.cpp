@@ -0,0 +1,560 @@
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iostream>
+#include <new>
+
+/**
+ * @file JobSystem.cpp
+ * @brief Implementation of the JobSystem work-stealing task scheduler.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        thread_local int         t_workerIndex = -1;      ///< Index of the current worker thread, -1 elsewhere.
+        thread_local JobSystem*  t_owner       = nullptr; ///< Job system owning the current worker thread.
+
+        const size_t INITIAL_QUEUE_CAPACITY = 256; ///< Jobs a queue holds before it first grows.
+    }
+
+    /**
+     * @class JobSystem::ChunkNodeAllocator
+     * @brief Hands out blocks of a job system's chunk node pool to std::allocate_shared.
+     *
+     * allocate_shared rebinds it to its combined node and control block type, so
+     * every request has the same size and the pool's blocks are reused as they are.
+     */
+    template <typename T>
+    class JobSystem::ChunkNodeAllocator
+    {
+    public:
+        using value_type = T;
+
+        /**
+         * @brief Constructs an allocator.
+         * @param pool The pool to allocate from.
+         */
+        explicit ChunkNodeAllocator(NodePool& pool) : m_pool(&pool) {}
+
+        /**
+         * @brief Converts from an allocator of another type sharing the pool.
+         * @param other The allocator to copy the pool from.
+         */
+        template <typename U>
+        ChunkNodeAllocator(const ChunkNodeAllocator<U>& other) : m_pool(other.m_pool) {}
+
+        /**
+         * @brief Allocates storage for objects.
+         * @param count Number of objects.
+         * @return The storage.
+         */
+        T* allocate(size_t count)
+        {
+            return static_cast<T*>(m_pool->Allocate(count * sizeof(T)));
+        }
+
+        /**
+         * @brief Returns storage to the pool.
+         * @param pointer The storage.
+         * @param count Number of objects it was allocated for.
+         */
+        void deallocate(T* pointer, size_t count)
+        {
+            m_pool->Deallocate(pointer, count * sizeof(T));
+        }
+
+        /**
+         * @brief Compares two allocators.
+         * @param other The allocator to compare with.
+         * @return True if both use the same pool.
+         */
+        template <typename U>
+        bool operator==(const ChunkNodeAllocator<U>& other) const { return m_pool == other.m_pool; }
+
+        /**
+         * @brief Compares two allocators.
+         * @param other The allocator to compare with.
+         * @return True if they use different pools.
+         */
+        template <typename U>
+        bool operator!=(const ChunkNodeAllocator<U>& other) const { return m_pool != other.m_pool; }
+
+    private:
+        template <typename U>
+        friend class ChunkNodeAllocator;
+
+        NodePool* m_pool; ///< The pool of the owning job system.
+    };
+
+    /**
+     * @brief Frees all slabs.
+     */
+    JobSystem::NodePool::~NodePool()
+    {
+        for (void* slab : slabs)
+            ::operator delete(slab);
+    }
+
+    /**
+     * @brief Takes a released block, carving a new slab if the list is empty.
+     *
+     * The first request fixes the size of every pooled block; requests of another
+     * size go to the heap.
+     *
+     * @param bytes Size of the block.
+     * @return The block.
+     */
+    void* JobSystem::NodePool::Allocate(size_t bytes)
+    {
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if (blockSize == 0)
+            {
+                const size_t alignment = alignof(std::max_align_t);
+                blockSize = bytes;
+                blockStride = (std::max(bytes, sizeof(FreeBlock)) + alignment - 1) / alignment * alignment;
+            }
+
+            if (bytes == blockSize)
+            {
+                if (!freeList)
+                {
+                    char* slab = static_cast<char*>(::operator new(blockStride * BLOCKS_PER_SLAB));
+                    slabs.push_back(slab);
+                    for (size_t i = BLOCKS_PER_SLAB; i-- > 0;)
+                    {
+                        FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + i * blockStride);
+                        block->next = freeList;
+                        freeList = block;
+                    }
+                }
+
+                FreeBlock* block = freeList;
+                freeList = block->next;
+                return block;
+            }
+        }
+        return ::operator new(bytes);
+    }
+
+    /**
+     * @brief Puts a block back on the free list.
+     *
+     * Blocks of an unexpected size are freed right away.
+     *
+     * @param block The block.
+     * @param bytes Size of the block.
+     */
+    void JobSystem::NodePool::Deallocate(void* block, size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (bytes != blockSize)
+        {
+            ::operator delete(block);
+            return;
+        }
+        FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+        freeBlock->next = freeList;
+        freeList = freeBlock;
+    }
+
+    /**
+     * @brief Starts the worker threads.
+     *
+     * Creates one deque per worker, with room for enough jobs that the queues
+     * rarely grow, and records the calling thread as the main thread.
+     *
+     * @param workerCount Number of worker threads; 0 uses one less than the hardware thread count.
+     */
+    JobSystem::JobSystem(unsigned int workerCount)
+        : m_mainThreadId(std::this_thread::get_id())
+    {
+        if (workerCount == 0)
+        {
+            unsigned int hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1; ///< Leave a core for the main thread
+        }
+
+        for (unsigned int i = 0; i < workerCount; ++i)
+        {
+            m_queues.push_back(std::make_unique<WorkerQueue>());
+            m_queues.back()->jobs.Reserve(INITIAL_QUEUE_CAPACITY);
+        }
+        m_mainThreadJobs.Reserve(INITIAL_QUEUE_CAPACITY);
+
+        for (unsigned int i = 0; i < workerCount; ++i)
+            m_workers.emplace_back(&JobSystem::WorkerLoop, this, static_cast<int>(i));
+    }
+
+    /**
+     * @brief Stops and joins all worker threads.
+     */
+    JobSystem::~JobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_stopping = true;
+        }
+        m_sleepCondition.notify_all();
+
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+
+    /**
+     * @brief Schedules a job on the worker threads.
+     * @param job The work to execute.
+     * @param dependencies Jobs that must finish before this one starts.
+     * @return A handle to the scheduled job.
+     */
+    JobHandle JobSystem::Schedule(Job job, const vector<JobHandle>& dependencies)
+    {
+        return ScheduleNode(std::move(job), dependencies, false);
+    }
+
+    /**
+     * @brief Schedules a job that must run on the main thread.
+     * @param job The work to execute (e.g., OpenGL calls).
+     * @param dependencies Jobs that must finish before this one starts.
+     * @return A handle to the scheduled job.
+     */
+    JobHandle JobSystem::ScheduleOnMainThread(Job job, const vector<JobHandle>& dependencies)
+    {
+        return ScheduleNode(std::move(job), dependencies, true);
+    }
+
+    /**
+     * @brief Schedules a continuation that runs after another job.
+     * @param parent The job to continue from.
+     * @param job The work to execute once the parent has finished.
+     * @return A handle to the continuation.
+     */
+    JobHandle JobSystem::Then(const JobHandle& parent, Job job)
+    {
+        return ScheduleNode(std::move(job), {parent}, false);
+    }
+
+    /**
+     * @brief Creates a node and registers it with its dependencies.
+     *
+     * The pending counter starts at the number of dependencies plus one guard, so the
+     * node cannot be enqueued by a finishing dependency before registration completes.
+     *
+     * @param job The work to execute.
+     * @param dependencies Jobs that must finish first.
+     * @param mainThread Whether the job must run on the main thread.
+     * @return A handle to the scheduled job.
+     */
+    JobHandle JobSystem::ScheduleNode(Job job, const vector<JobHandle>& dependencies, bool mainThread)
+    {
+        auto node = std::make_shared<JobNode>();
+        node->job = std::move(job);
+        node->mainThread = mainThread;
+        node->pendingDependencies.store(static_cast<int>(dependencies.size()) + 1);
+
+        for (const auto& dependency : dependencies)
+        {
+            if (!dependency.m_node)
+            {
+                node->pendingDependencies.fetch_sub(1); ///< Empty handles are already satisfied
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(dependency.m_node->continuationMutex);
+            if (dependency.m_node->finished.load(std::memory_order_acquire))
+                node->pendingDependencies.fetch_sub(1); ///< Dependency already done
+            else
+                dependency.m_node->continuations.push_back(node); ///< Released when the dependency finishes
+        }
+
+        if (node->pendingDependencies.fetch_sub(1) == 1)
+            Enqueue(node); ///< Drop the guard; runnable if nothing is pending
+
+        return JobHandle(node);
+    }
+
+    /**
+     * @brief Enqueues a parallel-for chunk in a node from the chunk node pool.
+     *
+     * Chunks have no dependencies and nobody holds a handle to them, so the node
+     * is runnable right away.
+     *
+     * @param job The chunk's work; small enough to be stored inside the std::function.
+     */
+    void JobSystem::ScheduleChunk(Job job)
+    {
+        auto node = std::allocate_shared<JobNode>(ChunkNodeAllocator<JobNode>(m_chunkNodePool));
+        node->job = std::move(job);
+        node->pendingDependencies.store(0);
+        Enqueue(std::move(node));
+    }
+
+    /**
+     * @brief Makes a job runnable by pushing it to the proper queue.
+     *
+     * Main-thread jobs go to the main-thread queue. Worker jobs go to the back of the
+     * current worker's deque, or round-robin to a worker when submitted from elsewhere.
+     *
+     * @param node The job whose dependencies are all satisfied.
+     */
+    void JobSystem::Enqueue(shared_ptr<JobNode> node)
+    {
+        if (node->mainThread)
+        {
+            std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+            m_mainThreadJobs.PushBack(std::move(node));
+            return;
+        }
+
+        size_t queueIndex = (t_owner == this) ? static_cast<size_t>(t_workerIndex)
+                                              : m_nextQueue.fetch_add(1) % m_queues.size();
+
+        m_pendingJobs.fetch_add(1); ///< Count before publishing so a thief never drives it below zero
+        {
+            std::lock_guard<std::mutex> lock(m_queues[queueIndex]->queueMutex);
+            m_queues[queueIndex]->jobs.PushBack(std::move(node));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex); ///< Pairs with the wait predicate to avoid lost wake-ups
+        }
+        m_sleepCondition.notify_one();
+    }
+
+    /**
+     * @brief Executes a job and releases its continuations.
+     *
+     * Exceptions thrown by the job are logged, and the job still counts as finished
+     * so dependants are never stranded.
+     *
+     * @param node The job to execute.
+     */
+    void JobSystem::Execute(const shared_ptr<JobNode>& node)
+    {
+        GRAF_PROFILE_SCOPE("JobSystem::Execute");
+        try
+        {
+            node->job();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Job error: " << e.what() << std::endl;
+        }
+        node->job = nullptr; ///< Release captured state early
+
+        vector<shared_ptr<JobNode>> continuations;
+        {
+            std::lock_guard<std::mutex> lock(node->continuationMutex);
+            node->finished.store(true, std::memory_order_release);
+            continuations.swap(node->continuations);
+        }
+
+        for (auto& continuation : continuations)
+        {
+            if (continuation->pendingDependencies.fetch_sub(1) == 1)
+                Enqueue(std::move(continuation)); ///< Last dependency finished
+        }
+    }
+
+    /**
+     * @brief Tries to take one runnable worker job.
+     * @param workerIndex Index of the calling worker, or -1 for other threads.
+     * @return The job, or nullptr if no job was found.
+     */
+    shared_ptr<JobNode> JobSystem::TryPop(int workerIndex)
+    {
+        if (workerIndex >= 0)
+        {
+            WorkerQueue& own = *m_queues[workerIndex];
+            std::lock_guard<std::mutex> lock(own.queueMutex);
+            if (!own.jobs.IsEmpty())
+            {
+                auto node = own.jobs.PopBack(); ///< LIFO on the own deque for cache locality
+                m_pendingJobs.fetch_sub(1);
+                return node;
+            }
+        }
+
+        size_t queueCount = m_queues.size();
+        size_t start = workerIndex >= 0 ? static_cast<size_t>(workerIndex) + 1 : 0;
+        for (size_t i = 0; i < queueCount; ++i)
+        {
+            WorkerQueue& victim = *m_queues[(start + i) % queueCount];
+            std::lock_guard<std::mutex> lock(victim.queueMutex);
+            if (!victim.jobs.IsEmpty())
+            {
+                auto node = victim.jobs.PopFront(); ///< Steal the oldest job
+                m_pendingJobs.fetch_sub(1);
+                return node;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Tries to run one queued main-thread job.
+     * @return True if a job was executed.
+     */
+    bool JobSystem::TryRunMainThreadJob()
+    {
+        shared_ptr<JobNode> node;
+        {
+            std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+            if (m_mainThreadJobs.IsEmpty())
+                return false;
+
+            node = m_mainThreadJobs.PopFront();
+        }
+
+        Execute(node);
+        return true;
+    }
+
+    /**
+     * @brief Runs all queued main-thread jobs.
+     */
+    void JobSystem::RunMainThreadJobs()
+    {
+        while (TryRunMainThreadJob())
+            ;
+    }
+
+    /**
+     * @brief Runs one runnable job on behalf of a waiting thread, or yields if there is none.
+     */
+    void JobSystem::HelpWhileWaiting()
+    {
+        bool onMainThread = std::this_thread::get_id() == m_mainThreadId;
+        int workerIndex = (t_owner == this) ? t_workerIndex : -1;
+
+        if (onMainThread && TryRunMainThreadJob())
+            return;
+
+        if (auto node = TryPop(workerIndex))
+            Execute(node);
+        else
+            std::this_thread::yield(); ///< Nothing to help with; the awaited work is running elsewhere
+    }
+
+    /**
+     * @brief Blocks until a job has finished, helping with other work meanwhile.
+     * @param handle The job to wait for.
+     */
+    void JobSystem::Wait(const JobHandle& handle)
+    {
+        while (!handle.IsDone())
+            HelpWhileWaiting();
+    }
+
+    /**
+     * @brief Blocks until all of the given jobs have finished.
+     * @param handles The jobs to wait for.
+     */
+    void JobSystem::WaitAll(const vector<JobHandle>& handles)
+    {
+        for (const auto& handle : handles)
+            Wait(handle);
+    }
+
+    /**
+     * @brief Processes an index range in parallel and waits for completion.
+     *
+     * The first chunk runs on the calling thread, the rest are scheduled as jobs
+     * in pooled nodes. Each chunk job only captures the chunk runner and its start
+     * index, which std::function stores without allocating, and the chunks count
+     * down a shared counter instead of being tracked by handles. Each chunk catches
+     * its own exceptions, so every chunk finishes before the body and its captures
+     * go out of scope; the first exception is rethrown once all chunks are done.
+     *
+     * @param begin First index of the range.
+     * @param end One past the last index of the range.
+     * @param grainSize Maximum number of indices per chunk (at least 1).
+     * @param body Function called once per chunk with its sub-range.
+     * @exception std::exception The first exception thrown by a chunk.
+     */
+    void JobSystem::ParallelFor(size_t begin, size_t end, size_t grainSize, RangeFunctionRef body)
+    {
+        if (begin >= end)
+            return;
+
+        grainSize = std::max<size_t>(grainSize, 1);
+        if (end - begin <= grainSize)
+        {
+            body(begin, end); ///< Not worth splitting
+            return;
+        }
+
+        exception_ptr firstError;
+        std::mutex errorMutex;
+        std::atomic<size_t> remainingChunks{(end - begin - 1) / grainSize}; ///< Scheduled chunks not finished yet
+        auto runChunk = [&](size_t chunkBegin) {
+            try
+            {
+                body(chunkBegin, std::min(chunkBegin + grainSize, end));
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError)
+                    firstError = std::current_exception();
+            }
+        };
+
+        auto runScheduledChunk = [&](size_t chunkBegin) {
+            runChunk(chunkBegin);
+            remainingChunks.fetch_sub(1, std::memory_order_release); ///< Last access to this call's state
+        };
+
+        for (size_t chunkBegin = begin + grainSize; chunkBegin < end; chunkBegin += grainSize)
+            ScheduleChunk([&runScheduledChunk, chunkBegin]() { runScheduledChunk(chunkBegin); });
+
+        runChunk(begin); ///< Calling thread takes the first chunk
+        while (remainingChunks.load(std::memory_order_acquire) != 0)
+            HelpWhileWaiting();
+        if (firstError)
+            std::rethrow_exception(firstError);
+    }
+
+    /**
+     * @brief Gets the number of worker threads.
+     * @return The worker count (not including the main thread).
+     */
+    unsigned int JobSystem::GetWorkerCount() const
+    {
+        return static_cast<unsigned int>(m_workers.size());
+    }
+
+    /**
+     * @brief Main loop of a worker thread.
+     *
+     * Runs jobs from the own deque, steals when it is empty and sleeps when no job
+     * is pending anywhere.
+     *
+     * @param workerIndex Index of the worker.
+     */
+    void JobSystem::WorkerLoop(int workerIndex)
+    {
+        t_workerIndex = workerIndex;
+        t_owner = this;
+        GRAF_PROFILE_THREAD("Worker " + std::to_string(workerIndex));
+
+        while (true)
+        {
+            if (auto node = TryPop(workerIndex))
+            {
+                Execute(node);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepCondition.wait(lock, [this] { return m_stopping.load() || m_pendingJobs.load() > 0; });
+            if (m_stopping)
+                break;
+        }
+    }
+}
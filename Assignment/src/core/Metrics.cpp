@@ -0,0 +1,414 @@
+#include "Metrics.hpp"
+#include "Exceptions.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+/**
+ * @file Metrics.cpp
+ * @brief Implementation of the metric types and the MetricsRegistry.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        /**
+         * @enum MetricType
+         * @brief Type of a metric family.
+         */
+        enum class MetricType
+        {
+            Counter,
+            Gauge,
+            Histogram
+        };
+
+        /**
+         * @struct MetricEntry
+         * @brief One labelled metric of a family; exactly one member is set.
+         */
+        struct MetricEntry
+        {
+            unique_ptr<MetricCounter>   counter;    ///< Counter updated by the engine.
+            unique_ptr<MetricGauge>     gauge;      ///< Gauge updated by the engine.
+            unique_ptr<MetricHistogram> histogram;  ///< Histogram updated by the engine.
+            function<double()>          read;       ///< Value read at export time.
+        };
+
+        /**
+         * @struct MetricFamily
+         * @brief All metrics sharing a name.
+         */
+        struct MetricFamily
+        {
+            MetricType                  type = MetricType::Counter; ///< Type of every entry.
+            string                      help;                       ///< Exported description.
+            map<string, MetricEntry>    entries;                    ///< Entries by label text.
+        };
+
+        /**
+         * @struct RegistryState
+         * @brief Process-wide registry state.
+         */
+        struct RegistryState
+        {
+            mutex                       stateMutex; ///< Guards the families, not the metric values.
+            map<string, MetricFamily>   families;   ///< Families by name, exported in name order.
+        };
+
+        /**
+         * @brief Gets the process-wide registry state, created on first use.
+         * @return The state.
+         */
+        RegistryState& State()
+        {
+            static RegistryState state;
+            return state;
+        }
+
+        /**
+         * @brief Adds to an atomic double; C++17 has no fetch_add for floating point.
+         * @param value The atomic.
+         * @param amount The increment.
+         */
+        void AtomicAdd(atomic<double>& value, double amount)
+        {
+            double current = value.load(std::memory_order_relaxed);
+            while (!value.compare_exchange_weak(current, current + amount, std::memory_order_relaxed)) {}
+        }
+
+        /**
+         * @brief Gets the entry for a name and labels, creating the family and entry if needed.
+         *
+         * The caller holds the state mutex.
+         *
+         * @param name Metric name.
+         * @param help Description for a new family.
+         * @param labels Label text.
+         * @param type Expected type of the family.
+         * @return The entry, possibly empty if just created.
+         * @exception GrafException Thrown if the family has another type.
+         */
+        MetricEntry& GetEntryLocked(const string& name, const string& help, const string& labels, MetricType type)
+        {
+            RegistryState& state = State();
+            auto it = state.families.find(name);
+            if (it == state.families.end())
+            {
+                it = state.families.emplace(name, MetricFamily()).first;
+                it->second.type = type;
+                it->second.help = help;
+            }
+            else if (it->second.type != type)
+            {
+                throw GrafException("Metric registered with another type: " + name);
+            }
+            return it->second.entries[labels];
+        }
+
+        /**
+         * @brief Formats a sample value the way Prometheus parses it.
+         * @param value The value.
+         * @return The text.
+         */
+        string FormatValue(double value)
+        {
+            if (std::isnan(value))
+                return "NaN";
+            if (std::isinf(value))
+                return value > 0 ? "+Inf" : "-Inf";
+
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.10g", value);
+            return text;
+        }
+
+        /**
+         * @brief Writes one sample line.
+         * @param out The output stream.
+         * @param name Sample name.
+         * @param labels Label text of the metric.
+         * @param extraLabel Additional label text such as the bucket bound, or empty.
+         * @param value Formatted value.
+         */
+        void WriteSample(ostream& out, const string& name, const string& labels, const string& extraLabel,
+                         const string& value)
+        {
+            out << name;
+            if (!labels.empty() || !extraLabel.empty())
+            {
+                out << '{' << labels;
+                if (!labels.empty() && !extraLabel.empty())
+                    out << ',';
+                out << extraLabel << '}';
+            }
+            out << ' ' << value << '\n';
+        }
+
+        /**
+         * @brief Writes the bucket, sum and count samples of a histogram.
+         * @param out The output stream.
+         * @param name Metric name.
+         * @param labels Label text of the metric.
+         * @param histogram The histogram.
+         */
+        void WriteHistogram(ostream& out, const string& name, const string& labels, const MetricHistogram& histogram)
+        {
+            const vector<double>& bounds = histogram.getBounds();
+            uint64_t cumulative = 0;
+            for (size_t b = 0; b <= bounds.size(); ++b)
+            {
+                cumulative += histogram.getBucketCount(b); ///< Count is derived from the buckets so both agree
+                string bound = b < bounds.size() ? FormatValue(bounds[b]) : "+Inf";
+                WriteSample(out, name + "_bucket", labels, "le=\"" + bound + "\"", std::to_string(cumulative));
+            }
+            WriteSample(out, name + "_sum", labels, "", FormatValue(histogram.getSum()));
+            WriteSample(out, name + "_count", labels, "", std::to_string(cumulative));
+        }
+    }
+
+    /**
+     * @brief Adds to the counter.
+     * @param amount The increment.
+     */
+    void MetricCounter::Increment(uint64_t amount)
+    {
+        m_value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the current count.
+     * @return The count.
+     */
+    uint64_t MetricCounter::getValue() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Replaces the value.
+     * @param value The new value.
+     */
+    void MetricGauge::Set(double value)
+    {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adds to the value.
+     * @param amount The change, negative to decrease.
+     */
+    void MetricGauge::Add(double amount)
+    {
+        AtomicAdd(m_value, amount);
+    }
+
+    /**
+     * @brief Gets the current value.
+     * @return The value.
+     */
+    double MetricGauge::getValue() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Constructs a histogram.
+     * @param bounds Inclusive upper bounds of the buckets in increasing order; +Inf is implied.
+     */
+    MetricHistogram::MetricHistogram(const vector<double>& bounds)
+        : m_bounds(bounds),
+          m_buckets(new atomic<uint64_t>[bounds.size() + 1])
+    {
+        for (size_t b = 0; b <= m_bounds.size(); ++b)
+            m_buckets[b].store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records an observation.
+     * @param value The observed value.
+     */
+    void MetricHistogram::Observe(double value)
+    {
+        size_t bucket = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin(); ///< First bound >= value
+        m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        AtomicAdd(m_sum, value);
+    }
+
+    /**
+     * @brief Gets the upper bounds of the buckets, without +Inf.
+     * @return The bounds.
+     */
+    const vector<double>& MetricHistogram::getBounds() const
+    {
+        return m_bounds;
+    }
+
+    /**
+     * @brief Gets the number of observations in one bucket.
+     * @param bucket Bucket index; getBounds().size() is the +Inf bucket.
+     * @return The observations that fell into the bucket alone.
+     */
+    uint64_t MetricHistogram::getBucketCount(size_t bucket) const
+    {
+        return m_buckets[bucket].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the sum of all observations.
+     * @return The sum.
+     */
+    double MetricHistogram::getSum() const
+    {
+        return m_sum.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets or creates a counter.
+     * @param name Metric name, conventionally ending in _total.
+     * @param help Description exported with the metric.
+     * @param labels Preformatted label pairs, or empty.
+     * @return The counter.
+     * @exception GrafException Thrown if the name is registered with another type.
+     */
+    MetricCounter& MetricsRegistry::GetCounter(const string& name, const string& help, const string& labels)
+    {
+        std::lock_guard<std::mutex> lock(State().stateMutex);
+        MetricEntry& entry = GetEntryLocked(name, help, labels, MetricType::Counter);
+        if (entry.read)
+            throw GrafException("Metric is registered as a function: " + name);
+        if (!entry.counter)
+            entry.counter = std::make_unique<MetricCounter>();
+        return *entry.counter;
+    }
+
+    /**
+     * @brief Gets or creates a gauge.
+     * @param name Metric name.
+     * @param help Description exported with the metric.
+     * @param labels Preformatted label pairs, or empty.
+     * @return The gauge.
+     * @exception GrafException Thrown if the name is registered with another type.
+     */
+    MetricGauge& MetricsRegistry::GetGauge(const string& name, const string& help, const string& labels)
+    {
+        std::lock_guard<std::mutex> lock(State().stateMutex);
+        MetricEntry& entry = GetEntryLocked(name, help, labels, MetricType::Gauge);
+        if (entry.read)
+            throw GrafException("Metric is registered as a function: " + name);
+        if (!entry.gauge)
+            entry.gauge = std::make_unique<MetricGauge>();
+        return *entry.gauge;
+    }
+
+    /**
+     * @brief Gets or creates a histogram; the bounds of an existing histogram are kept.
+     * @param name Metric name.
+     * @param help Description exported with the metric.
+     * @param bounds Bucket upper bounds in increasing order.
+     * @param labels Preformatted label pairs, or empty.
+     * @return The histogram.
+     * @exception GrafException Thrown if the name is registered with another type.
+     */
+    MetricHistogram& MetricsRegistry::GetHistogram(const string& name, const string& help,
+                                                   const vector<double>& bounds, const string& labels)
+    {
+        std::lock_guard<std::mutex> lock(State().stateMutex);
+        MetricEntry& entry = GetEntryLocked(name, help, labels, MetricType::Histogram);
+        if (!entry.histogram)
+            entry.histogram = std::make_unique<MetricHistogram>(bounds);
+        return *entry.histogram;
+    }
+
+    /**
+     * @brief Registers a counter whose value is read from a function at export time.
+     * @param name Metric name.
+     * @param help Description exported with the metric.
+     * @param labels Preformatted label pairs, or empty.
+     * @param read Returns the current count; called from the exporting thread.
+     * @exception GrafException Thrown if the name is registered with another type.
+     */
+    void MetricsRegistry::RegisterCounterFunction(const string& name, const string& help, const string& labels,
+                                                  function<double()> read)
+    {
+        std::lock_guard<std::mutex> lock(State().stateMutex);
+        MetricEntry& entry = GetEntryLocked(name, help, labels, MetricType::Counter);
+        if (entry.counter)
+            throw GrafException("Metric is registered as a counter: " + name);
+        entry.read = std::move(read);
+    }
+
+    /**
+     * @brief Registers a gauge whose value is read from a function at export time.
+     * @param name Metric name.
+     * @param help Description exported with the metric.
+     * @param labels Preformatted label pairs, or empty.
+     * @param read Returns the current value; called from the exporting thread.
+     * @exception GrafException Thrown if the name is registered with another type.
+     */
+    void MetricsRegistry::RegisterGaugeFunction(const string& name, const string& help, const string& labels,
+                                                function<double()> read)
+    {
+        std::lock_guard<std::mutex> lock(State().stateMutex);
+        MetricEntry& entry = GetEntryLocked(name, help, labels, MetricType::Gauge);
+        if (entry.gauge)
+            throw GrafException("Metric is registered as a gauge: " + name);
+        entry.read = std::move(read);
+    }
+
+    /**
+     * @brief Writes all metrics in the Prometheus text exposition format.
+     * @param out The output stream.
+     */
+    void MetricsRegistry::WriteText(ostream& out)
+    {
+        RegistryState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        for (const auto& [name, family] : state.families)
+        {
+            const char* type = family.type == MetricType::Counter ? "counter"
+                             : family.type == MetricType::Gauge   ? "gauge" : "histogram";
+            out << "# HELP " << name << ' ' << family.help << '\n';
+            out << "# TYPE " << name << ' ' << type << '\n';
+
+            for (const auto& [labels, entry] : family.entries)
+            {
+                if (entry.counter)
+                    WriteSample(out, name, labels, "", std::to_string(entry.counter->getValue()));
+                else if (entry.gauge)
+                    WriteSample(out, name, labels, "", FormatValue(entry.gauge->getValue()));
+                else if (entry.histogram)
+                    WriteHistogram(out, name, labels, *entry.histogram);
+                else if (entry.read)
+                    WriteSample(out, name, labels, "", FormatValue(entry.read()));
+            }
+        }
+    }
+
+    /**
+     * @brief Formats all metrics in the Prometheus text exposition format.
+     * @return The exposition text.
+     */
+    string MetricsRegistry::FormatText()
+    {
+        std::ostringstream out;
+        WriteText(out);
+        return out.str();
+    }
+
+    /**
+     * @brief Gets the standard bucket bounds for durations in seconds.
+     * @return Bounds from 0.5 ms to 10 s.
+     */
+    const vector<double>& MetricsRegistry::GetDurationBuckets()
+    {
+        static const vector<double> bounds = {
+            0.0005, 0.001, 0.0025, 0.005, 0.0083, 0.0167, 0.025, 0.0333, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 10.0
+        }; ///< Fine around the 60 and 120 Hz frame budgets
+        return bounds;
+    }
+}
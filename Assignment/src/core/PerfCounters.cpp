@@ -0,0 +1,397 @@
+#include "PerfCounters.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <fstream>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file PerfCounters.cpp
+ * @brief Implementation of the PerfCounters class on top of Linux perf_event_open.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const char* COUNTER_NAMES[PERF_COUNTER_COUNT] = {
+            "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+        }; ///< Indexed by PerfCounter.
+
+#ifdef __linux__
+        /**
+         * @brief Builds the perf_event_open attributes of an event.
+         * @param counter The event.
+         * @param leader Whether the event leads the group.
+         * @return The attributes.
+         */
+        perf_event_attr MakeAttributes(PerfCounter counter, bool leader)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            switch (counter)
+            {
+            case PerfCounter::Cycles:       attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+            case PerfCounter::Instructions: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+            case PerfCounter::LLCMisses:    attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+            case PerfCounter::BranchMisses: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+            case PerfCounter::L1DMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            default: break;
+            }
+            attr.disabled = leader ? 1 : 0;  ///< Members follow the leader
+            attr.exclude_kernel = 1;         ///< User space only, allowed up to perf_event_paranoid 2
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return attr;
+        }
+
+        /**
+         * @brief Explains a perf_event_open failure.
+         * @param error The errno value.
+         * @return The reason.
+         */
+        string DescribeOpenError(int error)
+        {
+            string reason = string("perf_event_open: ") + std::strerror(error);
+            if (error == ENOENT || error == EOPNOTSUPP)
+                reason += " (no hardware PMU, e.g. in a virtual machine)";
+            else if (error == ENOSYS)
+                reason += " (blocked, e.g. by a container seccomp profile)";
+            else if (error == EACCES || error == EPERM)
+            {
+                int paranoid = 0;
+                std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+                if (file >> paranoid)
+                    reason += " (perf_event_paranoid is " + std::to_string(paranoid) + ")";
+            }
+            return reason;
+        }
+#endif
+    }
+
+    /**
+     * @brief Gets the events counted between two reads.
+     * @param end The later read.
+     * @param start The earlier read.
+     * @return The differences of the events valid in both reads.
+     */
+    PerfCounterSample operator-(const PerfCounterSample& end, const PerfCounterSample& start)
+    {
+        PerfCounterSample delta;
+        delta.mask = end.mask & start.mask;
+        for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i)
+        {
+            if (delta.mask & (1u << i))
+                delta.values[i] = end.values[i] >= start.values[i] ? end.values[i] - start.values[i] : 0; ///< Scaled values may dip
+        }
+        return delta;
+    }
+
+    /**
+     * @brief Closes the counters.
+     */
+    PerfCounters::~PerfCounters()
+    {
+        Close();
+    }
+
+    /**
+     * @brief Opens counters of the calling thread, stopped and at zero.
+     *
+     * If the group does not get scheduled, for example because the PMU has fewer
+     * counters than events are wanted, the last event is dropped until it does.
+     *
+     * @param counters Mask of the wanted events.
+     * @return True if at least one event is counted.
+     */
+    bool PerfCounters::Open(uint32_t counters)
+    {
+        Close();
+
+        vector<PerfCounter> wanted;
+        for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i)
+        {
+            if (counters & (1u << i))
+                wanted.push_back(static_cast<PerfCounter>(i));
+        }
+        if (wanted.empty())
+        {
+            m_error = "no counters requested";
+            return false;
+        }
+
+#ifdef __linux__
+        uint32_t requested = counters & PERF_COUNTERS_ALL;
+        string reason;
+        while (true)
+        {
+            if (OpenGroup(wanted) == 0)
+                return false; ///< m_error says why
+            if (reason.empty())
+                reason = m_error;
+            if (ProbeGroup())
+                break;
+
+            Close();
+            wanted.pop_back(); ///< Too many events for the PMU; try with fewer
+            reason = "the PMU cannot schedule all events together";
+            if (wanted.empty())
+            {
+                m_error = reason;
+                return false;
+            }
+        }
+
+        Reset();
+        if (m_mask != requested)
+            m_error = "not counting " + FormatCounterList(requested & ~m_mask) + (reason.empty() ? "" : ": " + reason);
+        return true;
+#else
+        m_error = "hardware counters need Linux perf_event_open";
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Closes the counters.
+     */
+    void PerfCounters::Close()
+    {
+#ifdef __linux__
+        for (auto it = m_fds.rbegin(); it != m_fds.rend(); ++it)
+            close(*it); ///< Members before the leader
+#endif
+        m_fds.clear();
+        m_counters.clear();
+        m_mask = 0;
+        m_error.clear();
+    }
+
+    /**
+     * @brief Checks whether any event is counted.
+     * @return True after a successful Open.
+     */
+    bool PerfCounters::IsOpen() const
+    {
+        return !m_fds.empty();
+    }
+
+    /**
+     * @brief Gets the events that could be opened.
+     * @return The mask.
+     */
+    uint32_t PerfCounters::GetOpenCounters() const
+    {
+        return m_mask;
+    }
+
+    /**
+     * @brief Gets why the wanted events could not all be opened.
+     * @return The reason, empty if all were opened.
+     */
+    const string& PerfCounters::GetError() const
+    {
+        return m_error;
+    }
+
+    /**
+     * @brief Sets all counters to zero.
+     */
+    void PerfCounters::Reset()
+    {
+#ifdef __linux__
+        if (!m_fds.empty())
+            ioctl(m_fds.front(), PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    /**
+     * @brief Starts counting.
+     */
+    void PerfCounters::Start()
+    {
+#ifdef __linux__
+        if (!m_fds.empty())
+            ioctl(m_fds.front(), PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    /**
+     * @brief Stops counting; the values are kept.
+     */
+    void PerfCounters::Stop()
+    {
+#ifdef __linux__
+        if (!m_fds.empty())
+            ioctl(m_fds.front(), PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    /**
+     * @brief Reads all counters at once.
+     *
+     * The group read returns the event count, the enabled and running times and
+     * one value per event in opening order.
+     *
+     * @param sample Receives the values.
+     * @return False if nothing is open or the group has not been scheduled yet.
+     */
+    bool PerfCounters::Read(PerfCounterSample& sample) const
+    {
+        sample = PerfCounterSample();
+#ifdef __linux__
+        if (m_fds.empty())
+            return false;
+
+        uint64_t buffer[3 + PERF_COUNTER_COUNT];
+        ssize_t expected = static_cast<ssize_t>((3 + m_fds.size()) * sizeof(uint64_t));
+        if (read(m_fds.front(), buffer, sizeof(buffer)) != expected || buffer[0] != m_fds.size())
+            return false;
+
+        uint64_t enabled = buffer[1];
+        uint64_t running = buffer[2];
+        if (running == 0 && enabled > 0)
+            return false; ///< Enabled but never scheduled: no data
+        if (running == 0)
+        {
+            sample.mask = m_mask; ///< Never enabled: zero is exact
+            return true;
+        }
+        double scale = running < enabled ? static_cast<double>(enabled) / static_cast<double>(running) : 1.0;
+
+        for (size_t i = 0; i < m_counters.size(); ++i)
+            sample.values[static_cast<size_t>(m_counters[i])] = static_cast<uint64_t>(buffer[3 + i] * scale);
+        sample.mask = m_mask;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Gets the name of an event as used on command lines and in reports.
+     * @param counter The event.
+     * @return The name, e.g. "llc_misses".
+     */
+    const char* PerfCounters::GetCounterName(PerfCounter counter)
+    {
+        size_t index = static_cast<size_t>(counter);
+        return index < PERF_COUNTER_COUNT ? COUNTER_NAMES[index] : "";
+    }
+
+    /**
+     * @brief Parses a comma-separated list of event names, or "all".
+     * @param list The list, e.g. "cycles,instructions".
+     * @return The mask of the events.
+     */
+    uint32_t PerfCounters::ParseCounterList(const string& list)
+    {
+        if (list == "all")
+            return PERF_COUNTERS_ALL;
+
+        uint32_t mask = 0;
+        std::stringstream stream(list);
+        string name;
+        while (std::getline(stream, name, ','))
+        {
+            size_t i = 0;
+            while (i < PERF_COUNTER_COUNT && name != COUNTER_NAMES[i])
+                ++i;
+            if (i == PERF_COUNTER_COUNT)
+                throw std::invalid_argument("Unknown performance counter: " + name);
+            mask |= 1u << i;
+        }
+        return mask;
+    }
+
+    /**
+     * @brief Formats the names of the events in a mask.
+     * @param counters The mask.
+     * @return The comma-separated names.
+     */
+    string PerfCounters::FormatCounterList(uint32_t counters)
+    {
+        string list;
+        for (size_t i = 0; i < PERF_COUNTER_COUNT; ++i)
+        {
+            if (counters & (1u << i))
+                list += (list.empty() ? "" : ",") + string(COUNTER_NAMES[i]);
+        }
+        return list;
+    }
+
+    /**
+     * @brief Opens a group of events, the first one leading.
+     *
+     * A member that fails is skipped; a leader that fails is replaced by the
+     * next event, and if none opens the reason of the first failure is kept.
+     *
+     * @param counters The events in order.
+     * @return The number opened.
+     */
+    size_t PerfCounters::OpenGroup(const vector<PerfCounter>& counters)
+    {
+#ifdef __linux__
+        string firstError;
+        for (PerfCounter counter : counters)
+        {
+            bool leader = m_fds.empty();
+            perf_event_attr attr = MakeAttributes(counter, leader);
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader ? -1 : m_fds.front(), 0));
+            if (fd < 0)
+            {
+                if (firstError.empty())
+                    firstError = DescribeOpenError(errno);
+                continue;
+            }
+            m_fds.push_back(fd);
+            m_counters.push_back(counter);
+            m_mask |= PerfCounterBit(counter);
+        }
+        m_error = firstError;
+        return m_fds.size();
+#else
+        (void)counters;
+        return 0;
+#endif
+    }
+
+    /**
+     * @brief Checks that the open group gets scheduled on the PMU.
+     *
+     * A group needing more counters than the PMU has is accepted by the kernel
+     * but never runs, so it is enabled around a little work and its running time checked.
+     *
+     * @return True if it counted while enabled.
+     */
+    bool PerfCounters::ProbeGroup()
+    {
+#ifdef __linux__
+        Reset();
+        Start();
+        volatile uint64_t work = 0;
+        for (int i = 0; i < 10000; ++i)
+            work = work + static_cast<uint64_t>(i);
+        Stop();
+
+        uint64_t buffer[3 + PERF_COUNTER_COUNT];
+        ssize_t expected = static_cast<ssize_t>((3 + m_fds.size()) * sizeof(uint64_t));
+        return read(m_fds.front(), buffer, sizeof(buffer)) == expected && buffer[2] > 0;
+#else
+        return false;
+#endif
+    }
+}
@@ -0,0 +1,472 @@
+#include "Profiler.hpp"
+#include "Exceptions.hpp"
+#include "SpscRing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define GRAF_PROFILER_RDTSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define GRAF_PROFILER_RDTSC 1
+#endif
+
+using json = nlohmann::json;
+
+/**
+ * @file Profiler.cpp
+ * @brief Implementation of the Profiler class for CPU instrumentation.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        /**
+         * @struct ProfileEvent
+         * @brief A finished zone as stored in a thread's ring.
+         */
+        struct ProfileEvent
+        {
+            const char*         name = nullptr; ///< Zone name.
+            uint64_t            start = 0;      ///< Start time in clock ticks.
+            uint64_t            end = 0;        ///< End time in clock ticks.
+            PerfCounterSample   counters;       ///< Hardware events during the zone, if counted.
+        };
+
+        /**
+         * @struct TraceZone
+         * @brief A collected zone together with the thread that recorded it.
+         */
+        struct TraceZone
+        {
+            ProfileEvent    event;          ///< The zone.
+            uint32_t        threadId = 0;   ///< Trace id of the recording thread.
+        };
+
+        const size_t RING_CAPACITY = 1 << 14;   ///< Zones a thread can record between two collects.
+        const size_t MAX_TRACE_ZONES = 1 << 20; ///< Zones kept in the trace before new ones are dropped.
+
+        /**
+         * @struct ThreadBuffer
+         * @brief The ring and metadata of one recording thread.
+         */
+        struct ThreadBuffer
+        {
+            uint32_t                                threadId = 0;   ///< Trace id, in registration order.
+            string                                  name;           ///< Name shown in the trace.
+            SpscRing<ProfileEvent, RING_CAPACITY>   ring;           ///< Zones not collected yet.
+        };
+
+        /**
+         * @struct ProfilerState
+         * @brief Process-wide profiler state.
+         */
+        struct ProfilerState
+        {
+            mutex                               stateMutex;     ///< Guards everything except the rings' producer side.
+            vector<unique_ptr<ThreadBuffer>>    threads;        ///< Buffers of all threads that ever recorded; never freed.
+            vector<TraceZone>                   zones;          ///< Collected zones.
+            bool                                keepTrace = true;   ///< Whether collected zones stay for WriteChromeTrace.
+            size_t                              discardedZones = 0; ///< Zones dropped from the front of the trace when it is not kept.
+            size_t                              lastCollectEnd = 0; ///< Size of the trace after the previous collect.
+            atomic<uint64_t>                    droppedZones{0};///< Zones lost to full rings or a full trace.
+            atomic<uint32_t>                    zoneCounters{0};///< Hardware events counted per zone, 0 for none.
+            uint64_t                            startTicks = Profiler::Now();               ///< Trace origin in clock ticks.
+            chrono::steady_clock::time_point    startTime = chrono::steady_clock::now();   ///< Trace origin in real time.
+        };
+
+        /**
+         * @brief Gets the process-wide profiler state, created on first use.
+         * @return The state.
+         */
+        ProfilerState& State()
+        {
+            static ProfilerState state;
+            return state;
+        }
+
+        thread_local ThreadBuffer* t_buffer = nullptr; ///< Ring of the calling thread, registered lazily.
+        thread_local PerfCounters  t_counters;          ///< Zone counters of the calling thread, opened lazily.
+        thread_local uint32_t      t_countersOpened = 0;///< Events t_counters was opened for, 0 before the first attempt.
+
+        /**
+         * @brief Gets the calling thread's buffer, registering it on first use.
+         * @return The buffer.
+         */
+        ThreadBuffer& GetThreadBuffer()
+        {
+            if (!t_buffer)
+            {
+                ProfilerState& state = State();
+                std::lock_guard<std::mutex> lock(state.stateMutex);
+                state.threads.push_back(std::make_unique<ThreadBuffer>());
+                t_buffer = state.threads.back().get();
+                t_buffer->threadId = static_cast<uint32_t>(state.threads.size());
+                t_buffer->name = "Thread " + std::to_string(t_buffer->threadId);
+            }
+            return *t_buffer;
+        }
+
+        /**
+         * @brief Measures the rate of the profiler clock against steady_clock.
+         * @param state The profiler state.
+         * @return Clock ticks per microsecond.
+         */
+        double MeasureTicksPerMicrosecond(const ProfilerState& state)
+        {
+            double elapsedUs = chrono::duration<double, std::micro>(chrono::steady_clock::now() - state.startTime).count();
+            uint64_t elapsedTicks = Profiler::Now() - state.startTicks;
+            return elapsedUs > 0.0 && elapsedTicks > 0 ? elapsedTicks / elapsedUs : 1.0;
+        }
+
+        /**
+         * @brief Adds a zone to the trace unless it is full; the caller holds the state mutex.
+         * @param state The profiler state.
+         * @param zone The zone.
+         */
+        void AddZoneLocked(ProfilerState& state, const TraceZone& zone)
+        {
+            if (state.zones.size() < MAX_TRACE_ZONES)
+                state.zones.push_back(zone);
+            else
+                state.droppedZones.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Drains every thread's ring into the trace; the caller holds the state mutex.
+         * @param state The profiler state.
+         */
+        void CollectLocked(ProfilerState& state)
+        {
+            if (!state.keepTrace)
+            {
+                ///< Drop what the previous collect delivered; zones added since then stay one more frame
+                state.zones.erase(state.zones.begin(), state.zones.begin() + state.lastCollectEnd);
+                state.discardedZones += state.lastCollectEnd;
+            }
+
+            ProfileEvent event;
+            for (auto& thread : state.threads)
+            {
+                while (thread->ring.TryPop(event))
+                    AddZoneLocked(state, {event, thread->threadId});
+            }
+            state.lastCollectEnd = state.zones.size();
+        }
+    }
+
+    /**
+     * @brief Checks whether zones are recorded in this build.
+     * @return True if GRAF_ENABLE_PROFILER was defined.
+     */
+    bool Profiler::IsEnabled()
+    {
+#ifdef GRAF_ENABLE_PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Reads the profiler clock.
+     *
+     * The time stamp counter costs a few cycles and is invariant on current x86
+     * processors; its rate is calibrated against steady_clock when a trace is written.
+     *
+     * @return The current time in clock ticks.
+     */
+    uint64_t Profiler::Now()
+    {
+#ifdef GRAF_PROFILER_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Stores a finished zone in the calling thread's ring.
+     * @param name Zone name with static lifetime.
+     * @param start Start time in clock ticks.
+     * @param end End time in clock ticks.
+     */
+    void Profiler::RecordZone(const char* name, uint64_t start, uint64_t end)
+    {
+        if (!GetThreadBuffer().ring.TryPush({name, start, end, {}}))
+            State().droppedZones.fetch_add(1, std::memory_order_relaxed); ///< Nobody collected in time
+    }
+
+    /**
+     * @brief Stores a finished zone with the hardware events counted during it.
+     * @param name Zone name with static lifetime.
+     * @param start Start time in clock ticks.
+     * @param end End time in clock ticks.
+     * @param startCounters The calling thread's counters read at the start.
+     */
+    void Profiler::RecordZone(const char* name, uint64_t start, uint64_t end, const PerfCounterSample& startCounters)
+    {
+        ProfileEvent event{name, start, end, {}};
+        PerfCounterSample endCounters;
+        if (t_counters.Read(endCounters))
+            event.counters = endCounters - startCounters;
+        if (!GetThreadBuffer().ring.TryPush(event))
+            State().droppedZones.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts hardware events in every zone recorded from now on.
+     *
+     * Opens the calling thread's counters right away, so an environment without
+     * counters is reported here rather than silently at the first zone.
+     *
+     * @param counters Mask of the events, 0 to stop counting.
+     * @param error Receives why counting is off or which events are missing.
+     * @return True if zones are counted.
+     */
+    bool Profiler::SetZoneCounters(uint32_t counters, string& error)
+    {
+        ProfilerState& state = State();
+        state.zoneCounters.store(0);
+        error.clear();
+        if (counters == 0)
+            return false;
+
+        bool opened = t_counters.Open(counters);
+        t_countersOpened = counters;
+        error = t_counters.GetError();
+        if (!opened)
+            return false;
+
+        t_counters.Start(); ///< Zone counters run continuously; zones take differences
+        state.zoneCounters.store(counters);
+        return true;
+    }
+
+    /**
+     * @brief Checks whether zones count hardware events.
+     * @return True after a successful SetZoneCounters.
+     */
+    bool Profiler::IsCountingZones()
+    {
+        return State().zoneCounters.load(std::memory_order_relaxed) != 0;
+    }
+
+    /**
+     * @brief Reads the calling thread's zone counters, opening them on first use.
+     *
+     * A thread whose counters cannot be opened records its zones without counters.
+     *
+     * @param sample Receives the values.
+     * @return False if the thread's counters cannot be read.
+     */
+    bool Profiler::ReadZoneCounters(PerfCounterSample& sample)
+    {
+        uint32_t counters = State().zoneCounters.load(std::memory_order_relaxed);
+        if (t_countersOpened != counters)
+        {
+            t_countersOpened = counters;
+            if (t_counters.Open(counters))
+                t_counters.Start();
+        }
+        return t_counters.Read(sample);
+    }
+
+    /**
+     * @brief Names the calling thread in exported traces.
+     * @param name The thread name.
+     */
+    void Profiler::SetThreadName(const string& name)
+    {
+        ThreadBuffer& buffer = GetThreadBuffer();
+        std::lock_guard<std::mutex> lock(State().stateMutex);
+        buffer.name = name;
+    }
+
+    /**
+     * @brief Adds a timeline that is not tied to a thread, such as the GPU.
+     * 
+     * The track gets a buffer like a thread, but its ring stays empty.
+     * 
+     * @param name The name shown in the trace.
+     * @return Id of the track for RecordTrackZone.
+     */
+    uint32_t Profiler::RegisterTrack(const string& name)
+    {
+        ProfilerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        state.threads.push_back(std::make_unique<ThreadBuffer>());
+        ThreadBuffer& track = *state.threads.back();
+        track.threadId = static_cast<uint32_t>(state.threads.size());
+        track.name = name;
+        return track.threadId;
+    }
+
+    /**
+     * @brief Adds a zone measured elsewhere to a track.
+     * @param track Id returned by RegisterTrack.
+     * @param name Zone name with static lifetime.
+     * @param start Start time in clock ticks.
+     * @param end End time in clock ticks.
+     */
+    void Profiler::RecordTrackZone(uint32_t track, const char* name, uint64_t start, uint64_t end)
+    {
+        ProfilerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        AddZoneLocked(state, {{name, start, end, {}}, track});
+    }
+
+    /**
+     * @brief Gets the rate of the profiler clock, measured since its first use.
+     * @return Clock ticks per microsecond.
+     */
+    double Profiler::GetTicksPerMicrosecond()
+    {
+        return MeasureTicksPerMicrosecond(State());
+    }
+
+    /**
+     * @brief Chooses whether collected zones are kept for WriteChromeTrace.
+     *
+     * When they are not, each collect drops the zones the previous one delivered,
+     * so the trace stops growing; SumZoneTimes still sees every zone once per frame.
+     *
+     * @param keep True to keep every zone (the default).
+     */
+    void Profiler::SetKeepTrace(bool keep)
+    {
+        ProfilerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        state.keepTrace = keep;
+    }
+
+    /**
+     * @brief Moves the zones of all threads from their rings into the trace.
+     */
+    void Profiler::Collect()
+    {
+        ProfilerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        CollectLocked(state);
+    }
+
+    /**
+     * @brief Collects outstanding zones and writes the trace in Chrome trace event format.
+     *
+     * Zones become complete ("X") events with microsecond timestamps relative to the
+     * first use of the profiler, with their hardware events as arguments if counted;
+     * every thread gets a thread_name metadata event.
+     *
+     * @param fileName Path of the JSON file to write.
+     * @exception GrafException Thrown if the file cannot be written.
+     */
+    void Profiler::WriteChromeTrace(const string& fileName)
+    {
+        ProfilerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        CollectLocked(state);
+
+        double ticksPerUs = MeasureTicksPerMicrosecond(state);
+
+        json events = json::array();
+        for (const auto& thread : state.threads)
+        {
+            events.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", thread->threadId},
+                              {"args", {{"name", thread->name}}}});
+        }
+
+        for (const auto& zone : state.zones)
+        {
+            double start = static_cast<int64_t>(zone.event.start - state.startTicks) / ticksPerUs;
+            double duration = (zone.event.end - zone.event.start) / ticksPerUs;
+            json event = {{"name", zone.event.name}, {"ph", "X"}, {"pid", 1}, {"tid", zone.threadId},
+                          {"ts", start}, {"dur", duration}};
+
+            const PerfCounterSample& counters = zone.event.counters;
+            if (counters.mask != 0)
+            {
+                json args;
+                for (size_t c = 0; c < PERF_COUNTER_COUNT; ++c)
+                {
+                    if (counters.Has(static_cast<PerfCounter>(c)))
+                        args[PerfCounters::GetCounterName(static_cast<PerfCounter>(c))] = counters.values[c];
+                }
+                if (counters.GetIpc() > 0.0)
+                    args["ipc"] = counters.GetIpc();
+                event["args"] = std::move(args);
+            }
+            events.push_back(std::move(event));
+        }
+
+        json trace = {{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}};
+
+        std::ofstream file(fileName);
+        file << trace.dump();
+        if (!file)
+            throw GrafException("Failed to write trace: " + fileName);
+    }
+
+    /**
+     * @brief Discards all collected zones.
+     */
+    void Profiler::Clear()
+    {
+        ProfilerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        CollectLocked(state);
+        state.zones.clear();
+        state.discardedZones = 0;
+        state.lastCollectEnd = 0;
+        state.droppedZones.store(0);
+    }
+
+    /**
+     * @brief Sums the durations of collected zones by name.
+     * @param firstZone Index of the first collected zone to include.
+     * @param totals Receives the milliseconds per zone name (added to existing values).
+     * @return The index past the last collected zone, to pass as firstZone next time.
+     */
+    size_t Profiler::SumZoneTimes(size_t firstZone, map<string, double>& totals)
+    {
+        ProfilerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+
+        double ticksPerMs = MeasureTicksPerMicrosecond(state) * 1000.0;
+        size_t first = std::max(firstZone, state.discardedZones) - state.discardedZones; ///< Zones already dropped are skipped
+        for (size_t i = first; i < state.zones.size(); ++i)
+        {
+            const ProfileEvent& event = state.zones[i].event;
+            totals[event.name] += (event.end - event.start) / ticksPerMs;
+        }
+        return state.discardedZones + state.zones.size();
+    }
+
+    /**
+     * @brief Gets the number of zones collected into the trace.
+     * @return The zone count, including zones dropped because the trace is not kept.
+     */
+    size_t Profiler::GetZoneCount()
+    {
+        ProfilerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        return state.discardedZones + state.zones.size();
+    }
+
+    /**
+     * @brief Gets the number of zones lost because a ring or the trace was full.
+     * @return The dropped zone count.
+     */
+    uint64_t Profiler::GetDroppedZones()
+    {
+        return State().droppedZones.load();
+    }
+}
@@ -0,0 +1,136 @@
+#include "RollingStats.hpp"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file RollingStats.cpp
+ * @brief Implementation of the RollingStats class for summarizing recent timing samples.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Constructs an empty statistics window.
+     * @param windowSize Maximum number of recent samples kept (at least 1).
+     */
+    RollingStats::RollingStats(size_t windowSize)
+        : m_windowSize(std::max<size_t>(windowSize, 1))
+    {
+        m_samples.reserve(m_windowSize);
+    }
+
+    /**
+     * @brief Adds a sample, evicting the oldest one when the window is full.
+     * @param value The sample value (e.g., milliseconds).
+     */
+    void RollingStats::AddSample(double value)
+    {
+        if (m_samples.size() < m_windowSize)
+            m_samples.push_back(value);
+        else
+            m_samples[m_next] = value; ///< Overwrite the oldest sample
+
+        m_next = (m_next + 1) % m_windowSize;
+        m_total++;
+    }
+
+    /**
+     * @brief Removes all samples and resets the total count.
+     */
+    void RollingStats::Clear()
+    {
+        m_samples.clear();
+        m_next = 0;
+        m_total = 0;
+    }
+
+    /**
+     * @brief Gets the number of samples added since construction or Clear.
+     * @return The total sample count.
+     */
+    size_t RollingStats::getTotalCount() const
+    {
+        return m_total;
+    }
+
+    /**
+     * @brief Gets the number of samples currently in the window.
+     * @return The window sample count.
+     */
+    size_t RollingStats::getCount() const
+    {
+        return m_samples.size();
+    }
+
+    /**
+     * @brief Gets the mean of the window.
+     * @return The mean, or 0 if empty.
+     */
+    double RollingStats::getMean() const
+    {
+        if (m_samples.empty())
+            return 0.0;
+
+        double sum = 0.0;
+        for (double sample : m_samples)
+            sum += sample;
+        return sum / m_samples.size();
+    }
+
+    /**
+     * @brief Gets the population variance of the window.
+     * @return The variance, or 0 if empty.
+     */
+    double RollingStats::getVariance() const
+    {
+        if (m_samples.empty())
+            return 0.0;
+
+        double mean = getMean();
+        double sum = 0.0;
+        for (double sample : m_samples)
+            sum += (sample - mean) * (sample - mean);
+        return sum / m_samples.size();
+    }
+
+    /**
+     * @brief Gets the largest sample in the window.
+     * @return The maximum, or 0 if empty.
+     */
+    double RollingStats::getMax() const
+    {
+        if (m_samples.empty())
+            return 0.0;
+
+        return *std::max_element(m_samples.begin(), m_samples.end());
+    }
+
+    /**
+     * @brief Gets a percentile of the window using the nearest-rank method.
+     * @param percentile The percentile in [0, 100].
+     * @return The percentile value, or 0 if empty.
+     */
+    double RollingStats::getPercentile(double percentile) const
+    {
+        if (m_samples.empty())
+            return 0.0;
+
+        m_sorted.assign(m_samples.begin(), m_samples.end());
+        size_t rank = static_cast<size_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * m_sorted.size()));
+        size_t index = rank > 0 ? rank - 1 : 0;
+        std::nth_element(m_sorted.begin(), m_sorted.begin() + index, m_sorted.end());
+        return m_sorted[index];
+    }
+
+    /**
+     * @brief Gets the most recently added sample.
+     * @return The latest sample, or 0 if empty.
+     */
+    double RollingStats::getLatest() const
+    {
+        if (m_samples.empty())
+            return 0.0;
+
+        return m_samples[(m_next + m_windowSize - 1) % m_windowSize];
+    }
+}
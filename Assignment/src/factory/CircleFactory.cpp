@@ -17,22 +17,22 @@ namespace graf
     CircleFactory::CircleFactory(int anglesInDegrees) : m_angles(anglesInDegrees) {}
 
     /**
-     * @brief Creates a vertex array object representing a circle.
+     * @brief Generates the vertex and index data of a circle.
      * 
      * This function generates a circle as a triangle fan, with the center at (0,0,0)
      * and a radius of 1 unit. The number of vertices is determined by dividing 360
      * degrees by the angle step specified in the constructor.
      * 
-     * @return A shared pointer to the VertexArrayObject containing the circle geometry.
-     * @exception BufferException Thrown if vertex or index data is invalid or VAO creation fails.
+     * @param vertices The vertex list to fill (replaced).
+     * @param indices The index list to fill (replaced).
      */
-    std::shared_ptr<VertexArrayObject> CircleFactory::createShape() 
+    void CircleFactory::generateMesh(VertexList& vertices, IndexList& indices) 
     {
         int vertexCount = 360 / m_angles; ///< Number of vertices in the circle.
         int faceCount = vertexCount - 2;  ///< Number of triangular faces (excluding center and edge).
 
-        VertexList vertices(vertexCount);
-        IndexList indices;
+        vertices.assign(vertexCount, Vertex{});
+        indices.clear();
         std::vector<std::pair<float, float>> textureCoords(vertexCount);
 
         // Generate vertex positions and texture coordinates
@@ -55,7 +55,5 @@ namespace graf
             indices.push_back(i + 2);     // Next vertex
             indices.push_back(i + 1);     // Current vertex
         }
-
-        return createVAOFromData(vertices, indices);
     }
 }
\ No newline at end of file
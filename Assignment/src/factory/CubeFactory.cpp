@@ -10,24 +10,24 @@
 namespace graf 
 {
     /**
-     * @brief Creates a vertex array object representing a cube.
+     * @brief Generates the vertex and index data of a cube.
      * 
      * This function generates a 3D cube with 6 quadrilateral faces, each split into
      * two triangles. The cube is centered at the origin with a side length of 1 unit.
      * Vertex positions and texture coordinates are defined for each face.
      * 
-     * @return A shared pointer to the VertexArrayObject containing the cube geometry.
-     * @exception BufferException Thrown if vertex or index data is invalid or VAO creation fails.
+     * @param vertices The vertex list to fill (replaced).
+     * @param indices The index list to fill (replaced).
      */
-    std::shared_ptr<VertexArrayObject> CubeFactory::createShape() 
+    void CubeFactory::generateMesh(VertexList& vertices, IndexList& indices) 
     {
         glm::vec3 positions[] = {
             {-0.5f,  0.5f, 0.5f}, { 0.5f,  0.5f, 0.5f}, { 0.5f, -0.5f, 0.5f}, {-0.5f, -0.5f, 0.5f}, // Front face
             {-0.5f,  0.5f,-0.5f}, { 0.5f,  0.5f,-0.5f}, { 0.5f, -0.5f,-0.5f}, {-0.5f, -0.5f,-0.5f}  // Back face
         };
 
-        VertexList vertices(24);
-        IndexList indices;
+        vertices.assign(24, Vertex{});
+        indices.clear();
 
         // Define each face with texture coordinates
         DefineFace(vertices, 0,  positions, {0, 1, 2, 3}, QUAD_TEXTURE_COORDS); // Front
@@ -38,6 +38,5 @@ namespace graf
         DefineFace(vertices, 20, positions, {3, 2, 6, 7}, QUAD_TEXTURE_COORDS); // Bottom
 
         GenerateFaceIndices(indices, 6);
-        return createVAOFromData(vertices, indices);
     }
 }
\ No newline at end of file
@@ -10,24 +10,24 @@
 namespace graf 
 {
     /**
-     * @brief Creates a vertex array object representing a frustum.
+     * @brief Generates the vertex and index data of a frustum.
      * 
      * This function generates a 3D frustum with 6 quadrilateral faces, each split into
      * two triangles. The frustum has a smaller square top (side length 1) at y = 0.5
      * and a larger square base (side length 2) at y = -0.5, centered at the origin.
      * 
-     * @return A shared pointer to the VertexArrayObject containing the frustum geometry.
-     * @exception BufferException Thrown if vertex or index data is invalid or VAO creation fails.
+     * @param vertices The vertex list to fill (replaced).
+     * @param indices The index list to fill (replaced).
      */
-    std::shared_ptr<VertexArrayObject> FrustumFactory::createShape() 
+    void FrustumFactory::generateMesh(VertexList& vertices, IndexList& indices) 
     {
         glm::vec3 positions[] = {
             {-0.5f,  0.5f,  0.5f}, { 0.5f,  0.5f,  0.5f}, { 1.0f, -0.5f,  1.0f}, {-1.0f, -0.5f,  1.0f}, // Front
             {-0.5f,  0.5f, -0.5f}, { 0.5f,  0.5f, -0.5f}, { 1.0f, -0.5f, -1.0f}, {-1.0f, -0.5f, -1.0f}  // Back
         };
 
-        VertexList vertices(24);
-        IndexList indices;
+        vertices.assign(24, Vertex{});
+        indices.clear();
 
         // Define each face with texture coordinates
         DefineFace(vertices, 0,  positions, {0, 1, 2, 3}, QUAD_TEXTURE_COORDS); // Front
@@ -38,6 +38,5 @@ namespace graf
         DefineFace(vertices, 20, positions, {0, 1, 5, 4}, QUAD_TEXTURE_COORDS); // Top
 
         GenerateFaceIndices(indices, 6);
-        return createVAOFromData(vertices, indices);
     }
 }
\ No newline at end of file
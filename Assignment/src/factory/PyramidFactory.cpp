@@ -10,16 +10,16 @@
 namespace graf 
 {
     /**
-     * @brief Creates a vertex array object representing a pyramid.
+     * @brief Generates the vertex and index data of a pyramid.
      * 
      * This function generates a 3D pyramid with 5 faces: 4 triangular side faces
      * and 1 square base. The apex is at (0, 0.5, 0), and the base is a 1x1 square
      * at y = -0.5, centered at the origin.
      * 
-     * @return A shared pointer to the VertexArrayObject containing the pyramid geometry.
-     * @exception BufferException Thrown if vertex or index data is invalid or VAO creation fails.
+     * @param vertices The vertex list to fill (replaced).
+     * @param indices The index list to fill (replaced).
      */
-    std::shared_ptr<VertexArrayObject> PyramidFactory::createShape() 
+    void PyramidFactory::generateMesh(VertexList& vertices, IndexList& indices) 
     {
         glm::vec3 positions[] = {
             { 0.0f,  0.5f,  0.0f}, // Apex (top)
@@ -29,8 +29,8 @@ namespace graf
             {-0.5f, -0.5f, -0.5f}  // Back-left base
         };
 
-        VertexList vertices(16);
-        IndexList indices = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 12, 14, 15};
+        vertices.assign(16, Vertex{});
+        indices = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 12, 14, 15};
 
         // Define each face with texture coordinates
         DefineFace(vertices, 0,  positions, {0, 1, 2}, TRIANGLE_TEXTURE_COORDS); // Front
@@ -38,7 +38,5 @@ namespace graf
         DefineFace(vertices, 6,  positions, {0, 3, 4}, TRIANGLE_TEXTURE_COORDS); // Back
         DefineFace(vertices, 9,  positions, {0, 4, 1}, TRIANGLE_TEXTURE_COORDS); // Left
         DefineFace(vertices, 12, positions, {1, 2, 3, 4}, QUAD_TEXTURE_COORDS);  // Base
-
-        return createVAOFromData(vertices, indices);
     }
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "ShapeFactory.hpp"
+#include "Profiler.hpp"
 #include "Exceptions.hpp"
 #include <string>
 
@@ -18,6 +19,23 @@ namespace graf
                                                                                         {0.0f, 0.0f}, 
                                                                                         {1.0f, 0.0f}}; ///< Texture coords for triangles: top-center, bottom-left, bottom-right
 
+    /**
+     * @brief Creates a vertex array object for a specific 3D shape.
+     * 
+     * Generates the mesh through the derived factory and uploads it to a new VAO.
+     * 
+     * @return The created VertexArrayObject, owning its buffers.
+     * @exception BufferException Thrown if the generated data is invalid or VAO creation fails.
+     */
+    VertexArrayObject ShapeFactory::createShape()
+    {
+        GRAF_PROFILE_SCOPE("ShapeFactory::createShape");
+        VertexList vertices;
+        IndexList indices;
+        generateMesh(vertices, indices);
+        return createVAOFromData(vertices, indices);
+    }
+
     /**
      * @brief Constructs a VAO from vertex and index data.
      * 
@@ -26,33 +44,30 @@ namespace graf
      * 
      * @param vertices List of vertex data defining the shape’s geometry.
      * @param indices List of indices defining the shape’s triangles.
-     * @return A shared pointer to the created VertexArrayObject.
-     * @exception BufferException Thrown if vertex or index data is empty, buffers are null, or VAO setup fails.
+     * @return The created VertexArrayObject, owning its buffers.
+     * @exception BufferException Thrown if vertex or index data is empty or VAO setup fails.
      */
-    std::shared_ptr<VertexArrayObject> ShapeFactory::createVAOFromData(const VertexList& vertices, const IndexList& indices) {
-        auto p_va = std::make_shared<VertexArrayObject>(); ///< VAO smart pointer
-        auto p_vb = std::make_shared<VertexBuffer>();      ///< Vertex buffer smart pointer
-        auto p_ib = std::make_shared<IndexBuffer>();       ///< Index buffer smart pointer
-
+    VertexArrayObject ShapeFactory::createVAOFromData(const VertexList& vertices, const IndexList& indices) {
+        GRAF_PROFILE_SCOPE("ShapeFactory::createVAOFromData");
         if (vertices.empty() || indices.empty())
             throw BufferException("Empty vertex or index data in createVAOFromData");
 
-        p_vb->Create(vertices.data(), sizeof(Vertex) * vertices.size()); ///< Upload vertex data
-        p_ib->Create(indices.data(), sizeof(unsigned int) * indices.size()); ///< Upload index data
-
-        if (!p_va || !p_vb || !p_ib)
-            throw BufferException("Null buffer in createVAOFromData");
+        VertexBuffer vb; ///< Freed on scope exit unless handed to the VAO
+        IndexBuffer ib;
+        vb.Create(vertices.data(), sizeof(Vertex) * vertices.size()); ///< Upload vertex data
+        ib.Create(indices.data(), sizeof(unsigned int) * indices.size()); ///< Upload index data
 
         try 
         {
-            p_va->Create();                                ///< Initialize VAO
-            p_va->SetVertexBuffer(p_vb);                   ///< Associate vertex buffer
-            p_va->SetIndexBuffer(p_ib);                    ///< Associate index buffer
-            p_va->AddVertexAttribute(VertexAttributeType::Position); ///< Add position attribute
-            p_va->AddVertexAttribute(VertexAttributeType::Texture);  ///< Add texture attribute
-            p_va->ActivateAttributes();                    ///< Enable attributes
-            p_va->Unbind();                                ///< Unbind VAO
-            return p_va;
+            VertexArrayObject va;
+            va.Create();                                   ///< Initialize VAO
+            va.SetVertexBuffer(std::move(vb));             ///< Hand over vertex buffer
+            va.SetIndexBuffer(std::move(ib));              ///< Hand over index buffer
+            va.AddVertexAttribute(VertexAttributeType::Position); ///< Add position attribute
+            va.AddVertexAttribute(VertexAttributeType::Texture);  ///< Add texture attribute
+            va.ActivateAttributes();                       ///< Enable attributes
+            va.Unbind();                                   ///< Unbind VAO
+            return va;
         } 
         catch (const std::exception& e) 
         {
@@ -1,4 +1,6 @@
 #include "ShapeFactoryManager.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
 
 /**
  * @file ShapeFactoryManager.cpp
@@ -29,20 +31,104 @@ namespace graf
      * corresponding factory and stores it in the cache before returning.
      * 
      * @param shapeType The type of shape to create (e.g., ShapeTypes::Cube).
-     * @return A shared pointer to the VertexArrayObject for the requested shape.
+     * @return The VertexArrayObject for the requested shape, owned by the cache.
      * @exception GrafException Thrown if the specified shape type is not supported.
      */
-    std::shared_ptr<graf::VertexArrayObject> ShapeFactoryManager::createShape(graf::ShapeTypes shapeType)
+    graf::VertexArrayObject* ShapeFactoryManager::createShape(graf::ShapeTypes shapeType)
     {
-        if (shapeCache.count(shapeType) > 0)
-            return shapeCache[shapeType]; ///< Return cached VAO if available
+        GRAF_PROFILE_SCOPE("ShapeFactoryManager::createShape");
+        auto cachedIt = shapeCache.find(shapeType);
+        RenderStats::sRecordCacheLookup(StatsCache::Shape, cachedIt != shapeCache.end());
+        if (cachedIt != shapeCache.end())
+            return &cachedIt->second; ///< Return cached VAO if available
 
         auto it = factories.find(shapeType);
         if (it == factories.end())
             throw graf::GrafException("Unknown shape type"); ///< Throw if factory not found
         
-        auto shape = it->second->createShape(); ///< Create new shape using factory
-        shapeCache[shapeType] = shape;          ///< Cache the created shape
-        return shape;
+        auto inserted = shapeCache.emplace(shapeType, it->second->createShape()); ///< Create and cache the shape
+        return &inserted.first->second;
     }
-}
\ No newline at end of file
+
+    /**
+     * @brief Looks up an already created shape without creating it.
+     * 
+     * @param shapeType The type of shape to look up.
+     * @return The cached VAO, or nullptr if the shape has not been created yet.
+     */
+    const graf::VertexArrayObject* ShapeFactoryManager::getCachedShape(graf::ShapeTypes shapeType) const
+    {
+        auto it = shapeCache.find(shapeType);
+        RenderStats::sRecordCacheLookup(StatsCache::Shape, it != shapeCache.end());
+        return it != shapeCache.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * @brief Creates and caches the VAOs of all supported shapes up front.
+     * 
+     * Schedules one mesh generation job per uncached shape, each followed by a
+     * main-thread upload job, and waits for all uploads. Upload errors are rethrown
+     * on the calling thread.
+     * 
+     * @param jobs The job system used for mesh generation and upload.
+     * @exception BufferException Thrown if a mesh upload fails.
+     */
+    void ShapeFactoryManager::Preload(JobSystem& jobs)
+    {
+        GRAF_PROFILE_SCOPE("ShapeFactoryManager::Preload");
+        struct PendingMesh
+        {
+            graf::ShapeTypes     type;
+            graf::ShapeFactory*  factory;
+            graf::VertexList     vertices;
+            graf::IndexList      indices;
+            std::exception_ptr   error;
+        };
+
+        std::vector<PendingMesh> meshes;
+        for (auto& [type, factory] : factories)
+        {
+            if (shapeCache.count(type) == 0)
+                meshes.push_back({type, factory.get(), {}, {}, nullptr});
+        }
+
+        std::vector<graf::JobHandle> uploads;
+        for (auto& mesh : meshes)
+        {
+            graf::JobHandle generate = jobs.Schedule([&mesh]() {
+                mesh.factory->generateMesh(mesh.vertices, mesh.indices); ///< CPU-only, runs on a worker
+            });
+
+            uploads.push_back(jobs.ScheduleOnMainThread([this, &mesh]() {
+                try
+                {
+                    shapeCache[mesh.type] = mesh.factory->createVAOFromData(mesh.vertices, mesh.indices); ///< GL upload
+                }
+                catch (...)
+                {
+                    mesh.error = std::current_exception();
+                }
+            }, {generate}));
+        }
+
+        jobs.WaitAll(uploads); ///< Runs the uploads, as this is the main thread
+
+        for (const auto& mesh : meshes)
+        {
+            if (mesh.error)
+                std::rethrow_exception(mesh.error);
+        }
+    }
+
+    /**
+     * @brief Releases the OpenGL resources of all cached shapes and empties the cache.
+     * 
+     * Deletes each VAO together with its vertex and index buffers.
+     */
+    void ShapeFactoryManager::Release()
+    {
+        for (auto& [shapeType, shape] : shapeCache)
+            shape.Release(); ///< Free VAO, VBO and IBO
+        shapeCache.clear();
+    }
+}
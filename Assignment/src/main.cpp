@@ -8,16 +8,28 @@
 #include "Exceptions.hpp"
 #include "ErrorCheck.hpp"
 #include "ShapeFactoryManager.hpp"
+#include "FramePacket.hpp"
+#include "JobSystem.hpp"
+#include "Scene.hpp"
+#include "SlotMap.hpp"
+#include "SceneRenderer.hpp"
+#include "FrameCapture.hpp"
+#include "GpuProfiler.hpp"
+#include "RenderStats.hpp"
+#include "GpuResourceTracker.hpp"
+#include "PerfOverlay.hpp"
+#include "MetricsExporter.hpp"
+#include "Profiler.hpp"
+#include "AllocationTracker.hpp"
 
-#include <iostream>
+#include <cmath>
+#include <cstdio>
 #include <fstream>
-#include <iomanip>
+#include <iostream>
 #include <random>
+#include <stdexcept>
 #include <glm/gtc/matrix_access.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-#include <nlohmann/json.hpp>
-
-using json = nlohmann::json;
 
 /**
  * @file main.cpp
@@ -27,43 +39,197 @@ using json = nlohmann::json;
  * featuring keyboard interaction to move and change the shape of an active object.
  */
 
-/**
- * @struct ObjectData
- * @brief Stores properties of a renderable 3D object.
- */
-struct ObjectData 
-{
-    glm::vec3 position;            ///< 3D position of the object in world space.
-    float angle = 0.0f;            ///< Rotation angle around the Y-axis in degrees.
-    std::string texture;           ///< File path of the texture applied to the object.
-    graf::ShapeTypes shape = graf::ShapeTypes::Cube; ///< Type of shape (e.g., Cube, Pyramid).
-};
-
-//Function Prototypes
-void saveObjectsToJson(const std::vector<ObjectData>& objects, const std::string& filename);
-std::vector<ObjectData> loadObjectsFromJson(const std::string& filename);
-void DrawObject(graf::ShaderProgram& program, std::shared_ptr<graf::VertexArrayObject> p_va,
-                const glm::vec3& position, float angle, float scale,
-                const glm::mat4& matProj, const std::string& texture);
-
 /**
  * @brief Main application entry point.
  * 
  * Initializes the OpenGL window, shader program, textures, and a grid of objects,
- * then enters a render loop with keyboard interaction.
+ * then enters a pipelined render loop: the simulation thread applies keyboard input,
+ * animates the objects and builds frame packets that the GL thread draws.
+ * 
+ * Options: `--present <vsync|adaptive|uncapped|limited>` selects the presentation
+ * mode (default vsync) and `--fps <N>` sets the limiter target (default: refresh rate).
+ * `--headless <W>x<H>` renders offscreen without a window and `--frames <N>` stops
+ * after N frames, which headless runs need since there is no window to close.
+ * `--record <directory>` captures every frame as PNG. F12 saves a screenshot and F11
+ * toggles recording into the "capture" directory. Delete removes the active object.
+ * 
+ * `--record-input <file>` saves all input with the tick it was applied at, and
+ * `--replay <file>` plays such a recording back with one fixed tick per frame and the
+ * recorded random seed, so two builds render the identical workload; `--timings <csv>`
+ * writes the per-frame times of the replay. `--seed <N>` fixes the seed of the
+ * texture choice. Recording and replaying start from the seeded 3x3 grid instead of
+ * objectdatas.json and leave the file untouched.
+ * `--trace <file>` writes the profiler zones as a Chrome trace on exit and
+ * `--gpu-profile 1` measures and reports the GPU time of every render pass.
+ * `--zone-counters <all|cycles,instructions,...>` adds the hardware events counted
+ * during every zone to the trace (Linux perf_event_open; skipped where unavailable).
+ * F3 toggles the performance overlay and `--overlay 1` shows it from the start.
+ * `--metrics-file <file>` rewrites the engine metrics in the Prometheus text format
+ * every `--metrics-interval <seconds>` (default 5) and `--metrics-socket <path>`
+ * serves them on a Unix domain socket.
+ * `--gpu-budget <MiB>` and `--texture-budget <MiB>` warn when the live OpenGL objects
+ * exceed that much memory; OpenGL objects still alive at exit are reported as leaks.
+ * `--alloc-sample <N>` samples the call stack of every Nth heap allocation and reports
+ * the most frequent call sites on exit. `--alloc-check <warmupFrames>` requires every
+ * frame after the warmup to be free of heap allocations: the first one that allocates
+ * is reported with its call sites and the program exits with a failure status.
  * 
  * @param argc Number of command-line arguments.
  * @param argv Array of command-line arguments.
- * @return Exit status: 0 for success, -1 for failure.
+ * @return Exit status: 0 for success, -1 for failure, EXIT_FAILURE if the allocation check failed.
  */
 int main(int argc, char** argv) 
 {
     try 
     {
+        graf::PresentMode presentMode = graf::PresentMode::VSync;
+        double targetFps = 0.0; ///< 0 selects the monitor refresh rate
+        bool headless = false;
+        unsigned int headlessWidth = 800, headlessHeight = 800;
+        uint64_t frameLimit = 0;
+        std::string recordDirectory;
+        std::string inputRecordFile, replayFile, timingsFile, traceFile;
+        std::string metricsFile, metricsSocket;
+        double metricsInterval = 5.0;
+        double gpuBudgetMiB = 0.0, textureBudgetMiB = 0.0;
+        bool hasSeed = false;
+        bool gpuProfile = false;
+        bool showOverlay = false;
+        uint32_t zoneCounters = 0;
+        uint32_t allocationSampleRate = 0;
+        bool allocationCheck = false;
+        uint64_t allocationWarmupFrames = 0;
+        uint64_t seed = 0;
+        try
+        {
+            for (int i = 1; i < argc; i += 2)
+            {
+                std::string option = argv[i];
+                if (i + 1 >= argc)
+                    throw std::invalid_argument("Missing value for " + option);
+                if (option == "--present")
+                    presentMode = graf::ParsePresentMode(argv[i + 1]);
+                else if (option == "--fps")
+                    targetFps = std::stod(argv[i + 1]);
+                else if (option == "--frames")
+                    frameLimit = std::stoull(argv[i + 1]);
+                else if (option == "--record")
+                    recordDirectory = argv[i + 1];
+                else if (option == "--record-input")
+                    inputRecordFile = argv[i + 1];
+                else if (option == "--replay")
+                    replayFile = argv[i + 1];
+                else if (option == "--timings")
+                    timingsFile = argv[i + 1];
+                else if (option == "--trace")
+                    traceFile = argv[i + 1];
+                else if (option == "--metrics-file")
+                    metricsFile = argv[i + 1];
+                else if (option == "--metrics-socket")
+                    metricsSocket = argv[i + 1];
+                else if (option == "--metrics-interval")
+                    metricsInterval = std::stod(argv[i + 1]);
+                else if (option == "--gpu-budget")
+                    gpuBudgetMiB = std::stod(argv[i + 1]);
+                else if (option == "--texture-budget")
+                    textureBudgetMiB = std::stod(argv[i + 1]);
+                else if (option == "--overlay")
+                    showOverlay = std::string(argv[i + 1]) != "0";
+                else if (option == "--gpu-profile")
+                    gpuProfile = std::string(argv[i + 1]) != "0";
+                else if (option == "--alloc-sample")
+                    allocationSampleRate = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+                else if (option == "--alloc-check")
+                {
+                    allocationCheck = true;
+                    allocationWarmupFrames = std::stoull(argv[i + 1]);
+                }
+                else if (option == "--zone-counters")
+                    zoneCounters = graf::PerfCounters::ParseCounterList(argv[i + 1]);
+                else if (option == "--seed")
+                {
+                    hasSeed = true;
+                    seed = std::stoull(argv[i + 1]);
+                }
+                else if (option == "--headless")
+                {
+                    headless = true;
+                    if (std::sscanf(argv[i + 1], "%ux%u", &headlessWidth, &headlessHeight) != 2)
+                        throw std::invalid_argument("Expected --headless <width>x<height>");
+                }
+                else
+                    throw std::invalid_argument("Unknown option " + option);
+            }
+        }
+        catch (const std::logic_error& e) ///< Unknown options, missing values and malformed numbers
+        {
+            std::cerr << e.what() << std::endl;
+            std::cerr << "Usage: " << argv[0] << " [--present vsync|adaptive|uncapped|limited] [--fps N] [--frames N] [--record directory] [--record-input file] [--replay file] [--timings csv] [--trace file] [--metrics-file file] [--metrics-socket path] [--metrics-interval seconds] [--gpu-budget MiB] [--texture-budget MiB] [--overlay 0|1] [--gpu-profile 0|1] [--alloc-sample N] [--alloc-check warmupFrames] [--zone-counters all|cycles,instructions,...] [--seed N] [--headless WxH]" << std::endl;
+            return -1;
+        }
+
+        graf::Profiler::SetKeepTrace(!traceFile.empty()); ///< Without a trace file the overlay only needs the latest zones
+        if (zoneCounters != 0)
+        {
+            std::string counterError;
+            if (!graf::Profiler::IsEnabled())
+                std::cerr << "Profiler zones are compiled out of this build; no zone counters" << std::endl;
+            else if (!graf::Profiler::SetZoneCounters(zoneCounters, counterError))
+                std::cerr << "Zone counters unavailable: " << counterError << std::endl;
+            else if (!counterError.empty())
+                std::cerr << "Zone counters: " << counterError << std::endl;
+        }
+
+        if ((allocationCheck || allocationSampleRate != 0) && !graf::AllocationTracker::IsEnabled())
+            std::cerr << "Heap allocations are not tracked in this build; no allocation check or sampling" << std::endl;
+        graf::AllocationTracker::SetSampleRate(allocationSampleRate);
+        graf::FrameAllocationMonitor allocationMonitor;
+        if (allocationCheck)
+            allocationMonitor.SetSteadyStateCheck(allocationWarmupFrames); ///< Samples every allocation once steady
+
+        graf::RenderStats::sRegisterMetrics(); ///< Cache, upload and mesh counters, read only when exported
+        graf::AllocationTracker::RegisterMetrics();
+        graf::GpuResourceTracker::sRegisterMetrics();
+        graf::GpuResourceTracker::sSetTotalBudget(static_cast<int64_t>(gpuBudgetMiB * 1024 * 1024));
+        graf::GpuResourceTracker::sSetBudget(graf::GpuResourceType::Texture, static_cast<int64_t>(textureBudgetMiB * 1024 * 1024));
+        graf::MetricsExporter metricsFileExporter, metricsSocketExporter;
+        if (!metricsFile.empty())
+            metricsFileExporter.StartFile(metricsFile, metricsInterval);
+        if (!metricsSocket.empty())
+            metricsSocketExporter.StartSocket(metricsSocket);
+
         graf::GLWindow glwindow;
-        glwindow.create(800, 800); ///< Create 800x800 OpenGL window
+        if (headless)
+        {
+            glwindow.createHeadless(headlessWidth, headlessHeight); ///< Offscreen context and framebuffer
+            if (presentMode != graf::PresentMode::VSync)
+                glwindow.SetPresentMode(presentMode, targetFps); ///< Headless defaults to uncapped
+        }
+        else
+        {
+            glwindow.create(800, 800); ///< Create 800x800 OpenGL window
+            glwindow.SetPresentMode(presentMode, targetFps);
+        }
+        glwindow.SetFrameLimit(frameLimit);
+
+        if (!replayFile.empty())
+        {
+            graf::InputRecording recording = graf::InputRecording::Load(replayFile);
+            seed = recording.seed; ///< Reproduce the recorded texture choice
+            glwindow.StartInputReplay(std::move(recording));
+        }
+        else
+        {
+            if (!hasSeed)
+                seed = std::random_device{}();
+            if (!inputRecordFile.empty())
+                glwindow.StartInputRecording(seed);
+        }
+
+        graf::JobSystem jobs; ///< Worker threads for parallel engine work
 
         graf::ShapeFactoryManager shapeFactoryManager; ///< Manager for creating shapes
+        shapeFactoryManager.Preload(jobs); ///< Generate all shape meshes in parallel
 
         graf::ShaderProgram program;
         program.Create(); ///< Initialize shader program
@@ -81,6 +247,22 @@ int main(int argc, char** argv)
             return -1; ///< Exit on shader failure
         }
 
+        graf::SceneRenderer renderer(program, shapeFactoryManager, jobs); ///< Records draws in parallel, replays on this thread
+
+        graf::GpuProfiler gpuProfiler; ///< Timestamp queries per pass, read back frames later
+        gpuProfiler.SetEnabled(gpuProfile);
+        renderer.SetGpuProfiler(&gpuProfiler);
+
+        graf::PerfOverlay overlay(glwindow); ///< Initialized on first show, free while hidden
+        overlay.SetGpuProfiler(&gpuProfiler);
+        overlay.SetSceneRenderer(&renderer);
+        overlay.SetVisible(showOverlay);
+
+        graf::FrameCapture capture(jobs); ///< Asynchronous PBO readback, encoded on workers
+        if (!recordDirectory.empty())
+            capture.StartRecording(recordDirectory);
+        int screenshotCount = 0;
+
         std::vector<std::string> textures = {
             "../images/container.jpg",
             "../images/container2.jpg",
@@ -90,8 +272,7 @@ int main(int argc, char** argv)
 
         try 
         {
-            for (const auto& texture : textures) 
-                graf::TextureManager::sAddTextureFromFile(texture); ///< Load all textures
+            graf::TextureManager::sAddTexturesFromFiles(textures, jobs); ///< Decode all textures in parallel
         }
         catch (const graf::TextureException& e) 
         {
@@ -99,82 +280,234 @@ int main(int argc, char** argv)
             return -1; ///< Exit on texture failure
         }
 
-        std::random_device rd;
-        std::mt19937 gen(rd());
+        std::mt19937 gen(static_cast<std::mt19937::result_type>(seed)); ///< Seeded so recordings replay identically
         std::uniform_int_distribution<> dist(0, textures.size() - 1); ///< Random distribution for texture selection
 
         glm::mat4 matProj = glm::perspective(glm::radians(90.0f), 1.0f, 1.0f, 100.0f); ///< 90-degree FOV projection matrix
 
         const std::string file_path = "objectdatas.json";
-        std::vector<ObjectData> objects = loadObjectsFromJson(file_path); ///< Load objects from JSON file
+        bool deterministic = !inputRecordFile.empty() || !replayFile.empty(); ///< Start from the seeded grid, not the last session's file
+        std::vector<graf::ObjectData> loadedObjects;
+        if (!deterministic)
+            loadedObjects = graf::loadObjectsFromJson(file_path, jobs); ///< Load objects from JSON file
 
-        if (objects.empty())
+        if (loadedObjects.empty())
         {
-            objects = {
+            loadedObjects = {
                 {{-2.0f,  2.0f, -3.0f}}, {{0.0f,  2.0f, -3.0f}}, {{2.0f,  2.0f, -3.0f}}, ///< Top row
                 {{-2.0f,  0.0f, -3.0f}}, {{0.0f,  0.0f, -3.0f}}, {{2.0f,  0.0f, -3.0f}}, ///< Middle row
                 {{-2.0f, -2.0f, -3.0f}}, {{0.0f, -2.0f, -3.0f}}, {{2.0f, -2.0f, -3.0f}}  ///< Bottom row
             }; ///< 3x3 grid of objects
     
-            for (auto& obj : objects)
+            for (auto& obj : loadedObjects)
                 obj.texture = textures[dist(gen)]; ///< Assign random texture to each object
         }
-        
+
+        graf::SlotMap<graf::ObjectData> objects; ///< Scene objects, addressed by handles that survive deletions
+        objects.Insert(loadedObjects.begin(), loadedObjects.end());
 
         float scale = 1.0f;  ///< Uniform scale factor for all objects
-        int activeIndex = 4; ///< Index of the initially active object (center)
+        graf::SlotHandle activeObject = objects.GetHandle(std::min<size_t>(4, objects.size() - 1)); ///< Initially active object (center)
+        graf::SlotMap<graf::ObjectData> previousObjects = objects; ///< Object state as of the previous tick
 
         glwindow.SetKeyboardFunction([&](int key, int scancode, int action) {
             if (action == GLFW_PRESS) 
             {
-                if (key >= GLFW_KEY_0 && key <= GLFW_KEY_8) activeIndex = key - GLFW_KEY_0; ///< Select active object (0-8)
+                if (key >= GLFW_KEY_0 && key <= GLFW_KEY_8 && static_cast<size_t>(key - GLFW_KEY_0) < objects.size())
+                    activeObject = objects.GetHandle(key - GLFW_KEY_0); ///< Select active object (0-8)
+
+                if (key == GLFW_KEY_DELETE && objects.size() > 1) ///< Delete the active object; the last one stays
+                {
+                    objects.Erase(activeObject);
+                    previousObjects.Erase(activeObject); ///< Same move in both, so positions keep matching
+                }
+                if (!objects.Contains(activeObject))
+                    activeObject = objects.GetHandle(0); ///< The handle went stale
 
-                if (key == GLFW_KEY_UP)    objects[activeIndex].position.y += 0.1f; ///< Move up
-                if (key == GLFW_KEY_DOWN)  objects[activeIndex].position.y -= 0.1f; ///< Move down
-                if (key == GLFW_KEY_LEFT)  objects[activeIndex].position.x -= 0.1f; ///< Move left
-                if (key == GLFW_KEY_RIGHT) objects[activeIndex].position.x += 0.1f; ///< Move right
+                graf::ObjectData& active = objects.At(activeObject);
+                if (key == GLFW_KEY_UP)    active.position.y += 0.1f; ///< Move up
+                if (key == GLFW_KEY_DOWN)  active.position.y -= 0.1f; ///< Move down
+                if (key == GLFW_KEY_LEFT)  active.position.x -= 0.1f; ///< Move left
+                if (key == GLFW_KEY_RIGHT) active.position.x += 0.1f; ///< Move right
+
+                if (key == GLFW_KEY_F12) ///< Save a screenshot of the next frame
+                    capture.Capture("screenshots/screenshot_" + std::to_string(screenshotCount++) + ".png");
+
+                if (key == GLFW_KEY_F3) ///< Toggle the performance overlay
+                    overlay.Toggle();
+
+                if (key == GLFW_KEY_F11) ///< Toggle capturing every frame
+                {
+                    if (capture.IsRecording())
+                        capture.StopRecording();
+                    else
+                        capture.StartRecording("capture");
+                }
 
                 if (key == GLFW_KEY_SPACE) ///< Cycle through shape types
                 {
-                    if (objects[activeIndex].shape == graf::ShapeTypes::Cube)
-                        objects[activeIndex].shape = graf::ShapeTypes::Square;
-                    else if (objects[activeIndex].shape == graf::ShapeTypes::Square)
-                        objects[activeIndex].shape = graf::ShapeTypes::Circle;
-                    else if (objects[activeIndex].shape == graf::ShapeTypes::Circle)
-                        objects[activeIndex].shape = graf::ShapeTypes::Pyramid;
-                    else if (objects[activeIndex].shape == graf::ShapeTypes::Pyramid)
-                        objects[activeIndex].shape = graf::ShapeTypes::Frustum;
-                    else if (objects[activeIndex].shape == graf::ShapeTypes::Frustum)
-                        objects[activeIndex].shape = graf::ShapeTypes::Cube;    
+                    if (active.shape == graf::ShapeTypes::Cube)
+                        active.shape = graf::ShapeTypes::Square;
+                    else if (active.shape == graf::ShapeTypes::Square)
+                        active.shape = graf::ShapeTypes::Circle;
+                    else if (active.shape == graf::ShapeTypes::Circle)
+                        active.shape = graf::ShapeTypes::Pyramid;
+                    else if (active.shape == graf::ShapeTypes::Pyramid)
+                        active.shape = graf::ShapeTypes::Frustum;
+                    else if (active.shape == graf::ShapeTypes::Frustum)
+                        active.shape = graf::ShapeTypes::Cube;    
                 }
             }
         });
         
-        glwindow.SetRenderFunction([&]() {
+        const float rotationSpeed = 0.6f; ///< Rotation of the active object in degrees per second
+
+        glwindow.SetTickFunction([&](double dt) {
+            previousObjects = objects;
+            objects.At(activeObject).angle += rotationSpeed * static_cast<float>(dt); ///< Rotate active object
+        }, 60.0);
+
+        glwindow.SetSimulationFunction([&](graf::FramePacket& packet) {
+            graf::BuildFramePacket(previousObjects.GetValues(), objects.GetValues(), packet.interpolation, matProj, scale,
+                                   packet, jobs); ///< Interpolate, cull and transform objects in parallel
+        });
+
+        glwindow.SetFrameRenderFunction([&](const graf::FramePacket& packet) {
             try
             {
-                glClearColor(0.0f, 0.4f, 0.7f, 1.0f); ///< Set background color (sky blue)
-                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); ///< Clear color and depth buffers
-                graf::CheckGLError("Clear buffers"); ///< Check for OpenGL errors
+                jobs.RunMainThreadJobs(); ///< Run GL work queued by other threads
 
-                program.Use(); ///< Activate shader program
-                for (size_t i = 0; i < objects.size(); ++i) 
                 {
-                    if (i == activeIndex) objects[i].angle += 0.01f; ///< Rotate active object
-                    DrawObject(program, shapeFactoryManager.createShape(objects[i].shape),
-                            objects[i].position, objects[i].angle, scale, matProj, objects[i].texture); ///< Draw each object
+                    graf::GpuZone zone(gpuProfiler, "Clear");
+                    glClearColor(0.0f, 0.4f, 0.7f, 1.0f); ///< Set background color (sky blue)
+                    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); ///< Clear color and depth buffers
+                    graf::CheckGLError("Clear buffers"); ///< Check for OpenGL errors
+                }
+                {
+                    graf::GpuZone zone(gpuProfiler, "Scene");
+                    renderer.Render(packet); ///< Draw all visible objects
+                }
+                overlay.Render(); ///< Drawn after the scene so it is also captured
+                {
+                    graf::GpuZone zone(gpuProfiler, "Capture");
+                    capture.EndFrame(); ///< Queue readback of this frame if requested
                 }
+                gpuProfiler.EndFrame(); ///< Collect GPU timings of earlier frames
             }
             catch (const std::exception& e) 
             {
                 std::cerr << "Render error: " << e.what() << std::endl;
             }
+            allocationMonitor.EndFrame(); ///< Everything any thread allocated since the last frame
         });
 
         glwindow.SetCloseFunction([&]() {
-            saveObjectsToJson(objects, file_path); ///< Save objects to JSON file on window close
+            if (!glwindow.IsHeadless() && !deterministic)
+                graf::saveObjectsToJson(objects.GetValues(), file_path); ///< Save objects to JSON file on window close
+
+            if (!inputRecordFile.empty())
+            {
+                const graf::InputRecording& recording = glwindow.GetInputRecording();
+                recording.Save(inputRecordFile);
+                std::cout << "Recorded " << recording.events.size() << " input events over "
+                          << recording.tickCount << " ticks" << std::endl;
+            }
+
+            if (!replayFile.empty() && !timingsFile.empty())
+            {
+                std::ofstream timings(timingsFile);
+                timings << "frame,ms\n";
+                const std::vector<double>& frameTimeLog = glwindow.GetFrameTimeLog();
+                for (size_t i = 0; i < frameTimeLog.size(); ++i)
+                    timings << i << "," << frameTimeLog[i] << "\n";
+                if (!timings)
+                    std::cerr << "Failed to write frame timings: " << timingsFile << std::endl;
+            }
+
+            capture.Flush(); ///< Finish pending captures while the context is alive
+            capture.Release();
+            if (capture.getCapturedFrames() > 0 || capture.getDroppedFrames() > 0)
+            {
+                std::cout << "Captured " << capture.getCapturedFrames() << " frames ("
+                          << capture.getDroppedFrames() << " skipped)" << std::endl;
+            }
+
+            if (gpuProfile)
+            {
+                std::cout << "GPU passes over " << gpuProfiler.getMeasuredFrames() << " frames ("
+                          << gpuProfiler.getDroppedFrames() << " dropped):" << std::endl;
+                for (const auto& name : gpuProfiler.getPassNames())
+                {
+                    const graf::RollingStats* pass = gpuProfiler.getPassStats(name);
+                    std::cout << "  " << name << ": mean " << pass->getMean() << " ms, p50 "
+                              << pass->getPercentile(50.0) << " ms, p95 " << pass->getPercentile(95.0)
+                              << " ms, max " << pass->getMax() << " ms" << std::endl;
+                }
+            }
+            if (overlay.getDrawTimes().getTotalCount() > 0)
+                std::cout << "Overlay: mean " << overlay.getDrawTimes().getMean() << " ms CPU per frame" << std::endl;
+            const graf::FrameArena& frameArena = renderer.getFrameArena();
+            std::cout << "Frame arena: high water " << frameArena.GetHighWater() / 1024.0 << " KiB, "
+                      << frameArena.GetCapacity() / 1024.0 << " KiB in " << frameArena.GetBlockCount() << " blocks of "
+                      << frameArena.GetThreadArenaCount() << " threads" << std::endl;
+            graf::GpuResourceTracker::sWriteSummary(std::cout);
+            overlay.Release();
+            gpuProfiler.Release();
+            shapeFactoryManager.Release(); ///< Delete every GL object while the context is alive
+            program.Release();
+            graf::TextureManager::sRelease();
+
+            if (!traceFile.empty())
+            {
+                if (graf::Profiler::IsEnabled())
+                {
+                    graf::Profiler::WriteChromeTrace(traceFile);
+                    std::cout << "Wrote " << graf::Profiler::GetZoneCount() << " profiler zones to " << traceFile
+                              << " (" << graf::Profiler::GetDroppedZones() << " dropped)" << std::endl;
+                }
+                else
+                {
+                    std::cerr << "Profiler zones are compiled out of this build; no trace written" << std::endl;
+                }
+            }
+
+            const graf::FramePacer& pacer = glwindow.GetFramePacer();
+            const graf::RollingStats& frameTimes = pacer.GetFrameTimes();
+            std::cout << "Frame time: mean " << frameTimes.getMean() << " ms, stddev "
+                      << std::sqrt(frameTimes.getVariance()) << " ms, p99 " << frameTimes.getPercentile(99.0)
+                      << " ms, " << pacer.GetMissedDeadlines() << " missed deadlines at "
+                      << pacer.GetTargetFps() << " fps" << std::endl;
+
+            const graf::RollingStats& latency = glwindow.GetInputLatency();
+            if (latency.getTotalCount() > 0)
+            {
+                std::cout << "Input latency: mean " << latency.getMean() << " ms, p95 "
+                          << latency.getPercentile(95.0) << " ms, max " << latency.getMax()
+                          << " ms over " << latency.getTotalCount() << " events ("
+                          << glwindow.GetDroppedInputEvents() << " dropped)" << std::endl;
+            }
+
+            if (graf::AllocationTracker::IsEnabled())
+            {
+                allocationMonitor.WriteReport(std::cout);
+                if (!allocationCheck && allocationSampleRate != 0)
+                    graf::AllocationTracker::WriteSampleReport(std::cout);
+            }
+
+            metricsFileExporter.Stop(); ///< Last write includes the save above
+            metricsSocketExporter.Stop();
         });
         glwindow.Render();  ///< Start the rendering loop
+
+        size_t leaks = graf::GpuResourceTracker::sReportLeaks(std::cerr); ///< Everything should be released by now
+        if (leaks > 0)
+            std::cerr << leaks << " OpenGL objects were not released" << std::endl;
+        if (allocationMonitor.HasFailed())
+        {
+            std::cerr << "Allocation check failed: " << allocationMonitor.GetAllocatingFrames()
+                      << " steady-state frames allocated" << std::endl;
+            exit(EXIT_FAILURE);
+        }
         exit(EXIT_SUCCESS); ///< Exit successfully
     }
     catch (const graf::GLWindowException& e) 
@@ -192,119 +525,4 @@ int main(int argc, char** argv)
         std::cerr << "Unexpected error: " << e.what() << std::endl;
         return -1; ///< Exit on unexpected failure
     }    
-}
-
-/**
- * @brief Saves the state of objects to a JSON file.
- * 
- * @param objects Vector of ObjectData containing the objects to save.
- * @param filename The path to the JSON file where data will be saved.
- */
-void saveObjectsToJson(const std::vector<ObjectData>& objects, const std::string& filename) 
-{
-    json j;
-    for (const auto& obj : objects) 
-    {
-        j.push_back({
-            {"position_x", obj.position.x},
-            {"position_y", obj.position.y},
-            {"position_z", obj.position.z},
-            {"angle", obj.angle},
-            {"texture", obj.texture},
-            {"shape_type", static_cast<int>(obj.shape)}
-        });
-    }
-
-    std::ofstream file(filename);
-    if (file.is_open()) 
-    {
-        file << std::setw(4) << j << std::endl;
-        file.close();
-    }
-    else 
-        std::cerr << "Failed to open file for writing: " << filename << std::endl;
-}
-
-/**
- * @brief Loads the state of objects from a JSON file.
- * 
- * @param filename The path to the JSON file to read from.
- * @return Vector of ObjectData loaded from the file, or empty if loading fails.
- */
-std::vector<ObjectData> loadObjectsFromJson(const std::string& filename) 
-{
-    std::vector<ObjectData> objects;
-    std::ifstream file(filename);
-    if (!file.is_open()) 
-    {
-        std::cerr << "Failed to open file for reading: " << filename << std::endl;
-        return objects; ///< Return empty vector on failure
-    }
-
-    json j;
-    try 
-    {
-        file >> j;
-        for (const auto& item : j) 
-        {
-            ObjectData obj;
-            obj.position.x = item["position_x"].get<float>();
-            obj.position.y = item["position_y"].get<float>();
-            obj.position.z = item["position_z"].get<float>();
-            obj.angle = item["angle"].get<float>();
-            obj.texture = item["texture"].get<std::string>();
-            obj.shape = static_cast<graf::ShapeTypes>(item["shape_type"].get<int>());
-            objects.push_back(obj);
-        }
-    }
-    catch (const json::exception& e) 
-    {
-        std::cerr << "JSON parsing error: " << e.what() << std::endl;
-    }
-
-    file.close();
-    return objects;
-}
-
-/**
- * @brief Renders a single 3D object with transformations and texture.
- * 
- * Applies translation, rotation, and scaling transformations to the object,
- * sets the shader uniform, binds the texture, and draws the object.
- * 
- * @param program The shader program to use for rendering.
- * @param p_va Shared pointer to the VertexArrayObject representing the object’s geometry.
- * @param position The object’s position in 3D space.
- * @param angle The rotation angle around the Y-axis in degrees.
- * @param scale The uniform scale factor for the object.
- * @param matProj The projection matrix for perspective rendering.
- * @param texture The file path of the texture to apply.
- * @exception BufferException Thrown if the VAO is null.
- * @exception std::exception Caught broadly for any other rendering errors.
- */
-void DrawObject(graf::ShaderProgram& program, std::shared_ptr<graf::VertexArrayObject> p_va,
-                const glm::vec3& position, float angle, float scale,
-                const glm::mat4& matProj, const std::string& texture) 
-{
-    try
-    {
-        if (!p_va) 
-            throw graf::BufferException("Null vertex array object"); ///< Validate VAO
-        
-        p_va->Bind(); ///< Bind VAO for rendering
-        glm::mat4 matTranslate = glm::translate(glm::mat4(1), position); ///< Translation matrix
-        glm::mat4 matRotation = glm::rotate(glm::mat4(1), glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f)); ///< Rotation matrix (Y-axis)
-        glm::mat4 matScale = glm::scale(glm::mat4(1), glm::vec3(scale, scale, 1.0f)); ///< Scaling matrix
-        glm::mat4 matWorld = matTranslate * matRotation * matScale; ///< Combined world transform
-
-        program.SetMat4("uWorldTransform", matProj * matWorld); ///< Set shader uniform
-        graf::TextureManager::sActivateTexture(texture); ///< Bind texture
-        p_va->Draw(); ///< Draw the object
-
-        p_va->Unbind(); ///< Unbind VAO
-    }
-    catch (const std::exception& e) 
-    {
-        std::cerr << "Draw object failed: " << e.what() << std::endl;
-    }
 }
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "MetricsExporter.hpp"
+#include "Metrics.hpp"
+#include "Exceptions.hpp"
+#include "Profiler.hpp"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @file MetricsExporter.cpp
+ * @brief Implementation of the MetricsExporter class that publishes the MetricsRegistry for scraping.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const int ACCEPT_POLL_MS = 200;    ///< Longest time Stop waits for the socket loop.
+        const int REQUEST_WAIT_MS = 50;    ///< Time a client gets to send an HTTP request line.
+    }
+
+    /**
+     * @brief Stops the exporter.
+     */
+    MetricsExporter::~MetricsExporter()
+    {
+        Stop();
+    }
+
+    /**
+     * @brief Starts rewriting a file periodically.
+     * @param path Path of the file.
+     * @param intervalSeconds Time between two writes.
+     * @exception GrafException Thrown if the exporter is already running.
+     */
+    void MetricsExporter::StartFile(const string& path, double intervalSeconds)
+    {
+        if (IsRunning())
+            throw GrafException("Metrics exporter is already running");
+
+        m_socketMode = false;
+        m_path = path;
+        m_interval = chrono::duration<double>(intervalSeconds > 0.0 ? intervalSeconds : 5.0);
+        m_stop = false;
+        m_thread = thread(&MetricsExporter::FileLoop, this);
+    }
+
+#ifdef _WIN32
+    void MetricsExporter::StartSocket(const string&)
+    {
+        throw GrafException("Metrics sockets are only supported on POSIX systems; use a metrics file");
+    }
+
+    void MetricsExporter::SocketLoop() {}
+    void MetricsExporter::Serve(int) {}
+#else
+    /**
+     * @brief Starts serving the metrics on a Unix domain socket.
+     *
+     * A stale socket file at the path is replaced.
+     *
+     * @param path Path of the socket.
+     * @exception GrafException Thrown if already running or the socket cannot be created.
+     */
+    void MetricsExporter::StartSocket(const string& path)
+    {
+        if (IsRunning())
+            throw GrafException("Metrics exporter is already running");
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+            throw GrafException("Metrics socket path is too long: " + path);
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        int listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenSocket < 0)
+            throw GrafException("Failed to create metrics socket: " + string(std::strerror(errno)));
+
+        unlink(path.c_str()); ///< Remove a socket left behind by an earlier run
+        if (bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listenSocket, 4) != 0)
+        {
+            string error = std::strerror(errno);
+            close(listenSocket);
+            throw GrafException("Failed to listen on metrics socket " + path + ": " + error);
+        }
+
+        m_socketMode = true;
+        m_path = path;
+        m_listenSocket = listenSocket;
+        m_stop = false;
+        m_thread = thread(&MetricsExporter::SocketLoop, this);
+    }
+
+    /**
+     * @brief Answers connections until stopped.
+     *
+     * Polls with a timeout so Stop is noticed without closing the socket under the loop.
+     */
+    void MetricsExporter::SocketLoop()
+    {
+        GRAF_PROFILE_THREAD("Metrics");
+        while (!m_stop)
+        {
+            pollfd listening{m_listenSocket, POLLIN, 0};
+            if (poll(&listening, 1, ACCEPT_POLL_MS) <= 0)
+                continue;
+
+            int client = accept(m_listenSocket, nullptr, nullptr);
+            if (client < 0)
+                continue;
+
+            Serve(client);
+            close(client);
+        }
+    }
+
+    /**
+     * @brief Sends the metrics to a connected client.
+     * @param client The client socket.
+     */
+    void MetricsExporter::Serve(int client)
+    {
+        GRAF_PROFILE_FUNCTION();
+        bool http = false;
+        pollfd request{client, POLLIN, 0};
+        if (poll(&request, 1, REQUEST_WAIT_MS) > 0)
+        {
+            char line[1024];
+            ssize_t received = recv(client, line, sizeof(line), 0);
+            http = received >= 4 && std::memcmp(line, "GET ", 4) == 0;
+        }
+
+        string body = MetricsRegistry::FormatText();
+        string response;
+        if (http)
+        {
+            response = "HTTP/1.0 200 OK\r\n"
+                       "Content-Type: text/plain; version=0.0.4\r\n"
+                       "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+        }
+        response += body;
+
+        size_t sent = 0;
+        while (sent < response.size())
+        {
+            ssize_t written = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (written <= 0)
+                return; ///< Client went away
+            sent += static_cast<size_t>(written);
+        }
+        m_exportCount++;
+    }
+#endif
+
+    /**
+     * @brief Stops the background thread; in file mode the file is written a last time.
+     */
+    void MetricsExporter::Stop()
+    {
+        if (!m_thread.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        m_thread.join();
+
+        if (m_socketMode)
+        {
+#ifndef _WIN32
+            close(m_listenSocket);
+            unlink(m_path.c_str());
+#endif
+            m_listenSocket = -1;
+        }
+        else
+        {
+            WriteFile(); ///< Include everything recorded up to shutdown
+        }
+    }
+
+    /**
+     * @brief Checks whether the exporter is running.
+     * @return True between a Start and Stop.
+     */
+    bool MetricsExporter::IsRunning() const
+    {
+        return m_thread.joinable();
+    }
+
+    /**
+     * @brief Gets the number of files written or scrapes answered.
+     * @return The export count.
+     */
+    size_t MetricsExporter::getExportCount() const
+    {
+        return m_exportCount.load();
+    }
+
+    /**
+     * @brief Writes the file until stopped.
+     */
+    void MetricsExporter::FileLoop()
+    {
+        GRAF_PROFILE_THREAD("Metrics");
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop)
+        {
+            lock.unlock();
+            WriteFile();
+            lock.lock();
+            m_wake.wait_for(lock, m_interval, [this]() { return m_stop.load(); });
+        }
+    }
+
+    /**
+     * @brief Writes the metrics to the file through a temporary file.
+     */
+    void MetricsExporter::WriteFile()
+    {
+        GRAF_PROFILE_FUNCTION();
+        string temporary = m_path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::trunc);
+            MetricsRegistry::WriteText(file);
+            if (!file)
+            {
+                std::cerr << "Failed to write metrics file: " << temporary << std::endl;
+                return;
+            }
+        }
+
+        std::error_code error;
+        std::filesystem::rename(temporary, m_path, error); ///< Readers see the old or the new file, never a partial one
+        if (error)
+            std::cerr << "Failed to replace metrics file " << m_path << ": " << error.message() << std::endl;
+        else
+            m_exportCount++;
+    }
+}
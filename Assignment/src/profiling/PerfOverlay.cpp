@@ -0,0 +1,319 @@
+#include "PerfOverlay.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
+#include <imgui.h>
+#include <imgui_impl_glfw.h>
+#include <imgui_impl_opengl3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+/**
+ * @file PerfOverlay.cpp
+ * @brief Implementation of the PerfOverlay class, an in-app performance display built with Dear ImGui.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const size_t MAX_CPU_ZONES = 12; ///< Most expensive CPU zones listed.
+
+        /**
+         * @brief Formats a byte count with a binary unit.
+         * @param bytes The byte count.
+         * @param text Receives the text.
+         * @param size Size of text.
+         */
+        void FormatBytes(double bytes, char* text, size_t size)
+        {
+            const char* units[] = {"B", "KiB", "MiB", "GiB"};
+            int unit = 0;
+            while (bytes >= 1024.0 && unit < 3)
+            {
+                bytes /= 1024.0;
+                ++unit;
+            }
+            std::snprintf(text, size, "%.1f %s", bytes, units[unit]);
+        }
+
+        /**
+         * @brief Adds a table row with the hit rate of a cache.
+         * @param name Row label.
+         * @param cache The cache.
+         */
+        void CacheRow(const char* name, StatsCache cache)
+        {
+            uint64_t hits = RenderStats::sGetCacheHits(cache);
+            uint64_t lookups = hits + RenderStats::sGetCacheMisses(cache);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(name);
+            ImGui::TableNextColumn();
+            if (lookups > 0)
+                ImGui::Text("%.1f%%", 100.0 * hits / lookups);
+            else
+                ImGui::TextUnformatted("-");
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(lookups));
+        }
+    }
+
+    /**
+     * @brief Constructs a hidden overlay for a window.
+     * @param window The window whose frames are displayed; must outlive the overlay.
+     */
+    PerfOverlay::PerfOverlay(GLWindow& window)
+        : m_window(window),
+          m_frameTimes(FRAME_HISTORY, 0.0f)
+    {
+    }
+
+    /**
+     * @brief Sets the source of the per-pass GPU times, also used to time the overlay.
+     * @param profiler The GPU profiler, or nullptr.
+     */
+    void PerfOverlay::SetGpuProfiler(GpuProfiler* profiler)
+    {
+        m_gpuProfiler = profiler;
+    }
+
+    /**
+     * @brief Sets the source of the draw call, triangle and state change counts.
+     * @param renderer The scene renderer, or nullptr.
+     */
+    void PerfOverlay::SetSceneRenderer(const SceneRenderer* renderer)
+    {
+        m_sceneRenderer = renderer;
+    }
+
+    /**
+     * @brief Shows the overlay if hidden and hides it if shown.
+     */
+    void PerfOverlay::Toggle()
+    {
+        bool visible = m_visible.load();
+        while (!m_visible.compare_exchange_weak(visible, !visible)) {}
+    }
+
+    /**
+     * @brief Shows or hides the overlay.
+     * @param visible Whether the overlay is drawn.
+     */
+    void PerfOverlay::SetVisible(bool visible)
+    {
+        m_visible.store(visible);
+    }
+
+    /**
+     * @brief Checks whether the overlay is drawn.
+     * @return True if visible.
+     */
+    bool PerfOverlay::IsVisible() const
+    {
+        return m_visible.load();
+    }
+
+    /**
+     * @brief Draws the overlay on top of the current frame if it is visible.
+     *
+     * When the overlay becomes visible, the statistics that only make sense per
+     * frame restart from the current state.
+     */
+    void PerfOverlay::Render()
+    {
+        bool visible = m_visible.load();
+        bool shown = visible && !m_wasVisible;
+        m_wasVisible = visible;
+        if (!visible)
+            return; ///< Hidden: no ImGui work at all
+
+        auto start = std::chrono::steady_clock::now();
+        if (m_gpuProfiler)
+            m_gpuProfiler->BeginZone("Overlay");
+
+        if (!m_initialized)
+            Initialize();
+
+        if (shown)
+        {
+            m_zoneCursor = Profiler::GetZoneCount();
+            m_lastBytesUploaded = RenderStats::sGetBytesUploaded();
+            m_lastFrameCount = m_window.GetFramePacer().GetFrameTimes().getTotalCount();
+        }
+
+        ImGui_ImplOpenGL3_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+        BuildWindow();
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+        if (m_gpuProfiler)
+            m_gpuProfiler->EndZone();
+
+        m_drawTimes.AddSample(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    /**
+     * @brief Shuts down Dear ImGui; call before the context is destroyed.
+     */
+    void PerfOverlay::Release()
+    {
+        if (!m_initialized)
+            return;
+
+        ImGui_ImplOpenGL3_Shutdown();
+        ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext();
+        m_initialized = false;
+    }
+
+    /**
+     * @brief Gets the CPU time spent building and drawing the overlay.
+     * @return Milliseconds per drawn frame.
+     */
+    const RollingStats& PerfOverlay::getDrawTimes() const
+    {
+        return m_drawTimes;
+    }
+
+    /**
+     * @brief Creates the Dear ImGui context and initializes the backends.
+     *
+     * The GLFW backend chains the window's existing input callbacks, so GLWindow
+     * keeps receiving every event.
+     */
+    void PerfOverlay::Initialize()
+    {
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGui::GetIO().IniFilename = nullptr; ///< Do not write imgui.ini next to the executable
+        ImGui::StyleColorsDark();
+
+        ImGui_ImplGlfw_InitForOpenGL(m_window.GetNativeWindow(), true);
+        ImGui_ImplOpenGL3_Init("#version 330 core");
+        m_initialized = true;
+    }
+
+    /**
+     * @brief Updates the history and submits the widgets of one frame.
+     */
+    void PerfOverlay::BuildWindow()
+    {
+        const FramePacer& pacer = m_window.GetFramePacer();
+        const RollingStats& frameTimes = pacer.GetFrameTimes();
+        for (; m_lastFrameCount < frameTimes.getTotalCount(); ++m_lastFrameCount)
+        {
+            m_frameTimes[m_frameTimeCursor] = static_cast<float>(frameTimes.getLatest()); ///< One sample per presented frame
+            m_frameTimeCursor = (m_frameTimeCursor + 1) % FRAME_HISTORY;
+        }
+
+        m_cpuZones.clear();
+        m_zoneCursor = Profiler::SumZoneTimes(m_zoneCursor, m_cpuZones);
+
+        uint64_t bytesUploaded = RenderStats::sGetBytesUploaded();
+        m_frameBytesUploaded = bytesUploaded - m_lastBytesUploaded;
+        m_lastBytesUploaded = bytesUploaded;
+
+        ImGui::SetNextWindowPos(ImVec2(10.0f, 10.0f), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowBgAlpha(0.85f);
+        ImGui::Begin("Performance", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+        double mean = frameTimes.getMean();
+        char graphLabel[64];
+        std::snprintf(graphLabel, sizeof(graphLabel), "%.2f ms (%.0f fps)", mean, mean > 0.0 ? 1000.0 / mean : 0.0);
+        float graphMax = std::max(static_cast<float>(frameTimes.getPercentile(99.0)) * 1.25f, 1.0f);
+        ImGui::PlotLines("##frametimes", m_frameTimes.data(), static_cast<int>(FRAME_HISTORY),
+                         static_cast<int>(m_frameTimeCursor), graphLabel, 0.0f, graphMax, ImVec2(320.0f, 70.0f));
+        ImGui::Text("p99 %.2f ms  max %.2f ms  missed %llu", frameTimes.getPercentile(99.0), frameTimes.getMax(),
+                    static_cast<unsigned long long>(pacer.GetMissedDeadlines()));
+
+        if (ImGui::CollapsingHeader("CPU zones", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            if (!Profiler::IsEnabled())
+            {
+                ImGui::TextDisabled("Compiled out of this build");
+            }
+            else if (ImGui::BeginTable("cpu", 2, ImGuiTableFlags_RowBg))
+            {
+                vector<pair<double, const string*>> zones;
+                for (const auto& zone : m_cpuZones)
+                    zones.emplace_back(zone.second, &zone.first);
+                std::sort(zones.begin(), zones.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+                for (size_t i = 0; i < zones.size() && i < MAX_CPU_ZONES; ++i)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(zones[i].second->c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f ms", zones[i].first);
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        if (ImGui::CollapsingHeader("GPU passes", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            if (!m_gpuProfiler || !m_gpuProfiler->IsEnabled())
+            {
+                ImGui::TextDisabled("GPU profiling is off");
+            }
+            else if (ImGui::BeginTable("gpu", 3, ImGuiTableFlags_RowBg))
+            {
+                for (const auto& name : m_gpuProfiler->getPassNames())
+                {
+                    const RollingStats* pass = m_gpuProfiler->getPassStats(name);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f ms", pass->getMean());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("p95 %.3f", pass->getPercentile(95.0));
+                }
+                ImGui::EndTable();
+            }
+        }
+
+        if (m_sceneRenderer && ImGui::CollapsingHeader("Scene", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            const SceneStats& scene = m_sceneRenderer->getLastFrameStats();
+            ImGui::Text("Items %zu in %zu command buffers", scene.items, scene.commandBuffers);
+            ImGui::Text("Draw calls %zu  triangles %zu", scene.drawCalls, scene.triangles);
+            ImGui::Text("State changes %zu", scene.stateChanges);
+        }
+
+        if (ImGui::CollapsingHeader("Memory", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            char textures[32], meshes[32], frameUpload[32], totalUpload[32];
+            FormatBytes(static_cast<double>(RenderStats::sGetTextureMemory()), textures, sizeof(textures));
+            FormatBytes(static_cast<double>(RenderStats::sGetMeshMemory()), meshes, sizeof(meshes));
+            FormatBytes(static_cast<double>(m_frameBytesUploaded), frameUpload, sizeof(frameUpload));
+            FormatBytes(static_cast<double>(bytesUploaded), totalUpload, sizeof(totalUpload));
+            ImGui::Text("Textures %s  meshes %s", textures, meshes);
+            ImGui::Text("Uploaded %s this frame, %s total", frameUpload, totalUpload);
+        }
+
+        if (ImGui::CollapsingHeader("Caches", ImGuiTreeNodeFlags_DefaultOpen) &&
+            ImGui::BeginTable("caches", 3, ImGuiTableFlags_RowBg))
+        {
+            CacheRow("Shapes", StatsCache::Shape);
+            CacheRow("Textures", StatsCache::Texture);
+            CacheRow("Shader sources", StatsCache::ShaderSource);
+            ImGui::EndTable();
+        }
+
+        ImGui::Separator();
+        ImGui::Text("Overlay %.3f ms CPU", m_drawTimes.getMean());
+        if (m_gpuProfiler && m_gpuProfiler->getPassStats("Overlay"))
+        {
+            ImGui::SameLine();
+            ImGui::Text(", %.3f ms GPU", m_gpuProfiler->getPassStats("Overlay")->getMean());
+        }
+
+        ImGui::End();
+    }
+}
@@ -0,0 +1,182 @@
+#include <glad/glad.h>
+#include "CommandBuffer.hpp"
+
+/**
+ * @file CommandBuffer.cpp
+ * @brief Implementation of the CommandBuffer class for recording draw commands off the GL thread.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Clears all recorded commands while keeping the storage.
+     */
+    void CommandBuffer::Reset()
+    {
+        m_data.clear();
+        m_commandCount = 0;
+        m_drawCount = 0;
+        m_triangleCount = 0;
+        m_stateChangeCount = 0;
+    }
+
+    /**
+     * @brief Appends a command header and its payload.
+     * 
+     * The payload is copied byte-wise, so no alignment is required in the stream.
+     * 
+     * @param type The command type.
+     * @param payload Pointer to the payload bytes.
+     * @param size Size of the payload in bytes.
+     */
+    void CommandBuffer::Write(CommandType type, const void* payload, size_t size)
+    {
+        size_t offset = m_data.size();
+        m_data.resize(offset + 1 + size);
+        m_data[offset] = static_cast<uint8_t>(type);
+        std::memcpy(&m_data[offset + 1], payload, size);
+        m_commandCount++;
+    }
+
+    /**
+     * @brief Records binding a vertex array object.
+     * @param vao The OpenGL VAO handle.
+     */
+    void CommandBuffer::BindVertexArray(unsigned int vao)
+    {
+        Write(CommandType::BindVertexArray, &vao, sizeof(vao));
+        m_stateChangeCount++;
+    }
+
+    /**
+     * @brief Records binding a 2D texture.
+     * @param texture The OpenGL texture handle.
+     */
+    void CommandBuffer::BindTexture(unsigned int texture)
+    {
+        Write(CommandType::BindTexture, &texture, sizeof(texture));
+        m_stateChangeCount++;
+    }
+
+    /**
+     * @brief Records setting a 4x4 matrix uniform of the current program.
+     * @param location The uniform location.
+     * @param value The matrix value.
+     */
+    void CommandBuffer::SetMat4(int location, const glm::mat4& value)
+    {
+        uint8_t payload[sizeof(int) + sizeof(glm::mat4)];
+        std::memcpy(payload, &location, sizeof(int));
+        std::memcpy(payload + sizeof(int), &value[0][0], sizeof(glm::mat4));
+        Write(CommandType::SetMat4, payload, sizeof(payload));
+    }
+
+    /**
+     * @brief Records an indexed triangle draw using the bound VAO.
+     * @param indexCount The number of indices to draw.
+     */
+    void CommandBuffer::DrawElements(int indexCount)
+    {
+        Write(CommandType::DrawElements, &indexCount, sizeof(indexCount));
+        m_drawCount++;
+        m_triangleCount += indexCount / 3;
+    }
+
+    /**
+     * @brief Executes all recorded commands in order.
+     * 
+     * Decodes the stream in a single pass and issues the matching OpenGL calls.
+     */
+    void CommandBuffer::Replay() const
+    {
+        const uint8_t* cursor = m_data.data();
+        const uint8_t* end = cursor + m_data.size();
+
+        while (cursor < end)
+        {
+            CommandType type = static_cast<CommandType>(*cursor++);
+            switch (type)
+            {
+                case CommandType::BindVertexArray:
+                {
+                    unsigned int vao;
+                    std::memcpy(&vao, cursor, sizeof(vao));
+                    glBindVertexArray(vao);
+                    cursor += sizeof(vao);
+                    break;
+                }
+                case CommandType::BindTexture:
+                {
+                    unsigned int texture;
+                    std::memcpy(&texture, cursor, sizeof(texture));
+                    glBindTexture(GL_TEXTURE_2D, texture);
+                    cursor += sizeof(texture);
+                    break;
+                }
+                case CommandType::SetMat4:
+                {
+                    int location;
+                    float matrix[16];
+                    std::memcpy(&location, cursor, sizeof(location));
+                    std::memcpy(matrix, cursor + sizeof(location), sizeof(matrix));
+                    glUniformMatrix4fv(location, 1, GL_FALSE, matrix);
+                    cursor += sizeof(location) + sizeof(matrix);
+                    break;
+                }
+                case CommandType::DrawElements:
+                {
+                    int indexCount;
+                    std::memcpy(&indexCount, cursor, sizeof(indexCount));
+                    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+                    cursor += sizeof(indexCount);
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the number of recorded commands.
+     * @return The command count.
+     */
+    size_t CommandBuffer::getCommandCount() const
+    {
+        return m_commandCount;
+    }
+
+    /**
+     * @brief Gets the size of the recorded command stream.
+     * @return The size in bytes.
+     */
+    size_t CommandBuffer::getSize() const
+    {
+        return m_data.size();
+    }
+
+    /**
+     * @brief Gets the number of recorded draw calls.
+     * @return The draw count.
+     */
+    size_t CommandBuffer::getDrawCount() const
+    {
+        return m_drawCount;
+    }
+
+    /**
+     * @brief Gets the number of triangles the recorded draws submit.
+     * @return The triangle count.
+     */
+    size_t CommandBuffer::getTriangleCount() const
+    {
+        return m_triangleCount;
+    }
+
+    /**
+     * @brief Gets the number of recorded VAO and texture binds.
+     * @return The state change count.
+     */
+    size_t CommandBuffer::getStateChangeCount() const
+    {
+        return m_stateChangeCount;
+    }
+}
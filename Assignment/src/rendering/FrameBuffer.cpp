@@ -0,0 +1,143 @@
+#include "FrameBuffer.hpp"
+#include "Exceptions.hpp"
+#include "ErrorCheck.hpp"
+#include "GpuResourceTracker.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+
+/**
+ * @file FrameBuffer.cpp
+ * @brief Implementation of the FrameBuffer class for managing offscreen OpenGL render targets.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Creates the framebuffer and its attachments.
+     *
+     * Allocates an RGBA8 color renderbuffer and a depth/stencil renderbuffer of the
+     * given size and attaches them to a new framebuffer object.
+     *
+     * @param width Width of the render target in pixels.
+     * @param height Height of the render target in pixels.
+     * @exception BufferException Thrown if the size is invalid or the framebuffer is incomplete.
+     */
+    void FrameBuffer::Create(int width, int height)
+    {
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxSize);
+        if (width <= 0 || height <= 0 || width > maxSize || height > maxSize)
+            throw BufferException("Invalid framebuffer size");
+
+        m_width = width;
+        m_height = height;
+
+        m_fbo = FramebufferHandle("FrameBuffer", GRAF_GL_SITE);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_fbo.getId());
+
+        m_color = RenderbufferHandle("FrameBuffer color", GRAF_GL_SITE);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_color.getId());
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        GpuResourceTracker::sSetSize(GpuResourceType::Renderbuffer, m_color.getId(), static_cast<int64_t>(width) * height * 4);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color.getId());
+
+        m_depth = RenderbufferHandle("FrameBuffer depth", GRAF_GL_SITE);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_depth.getId());
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        GpuResourceTracker::sSetSize(GpuResourceType::Renderbuffer, m_depth.getId(), static_cast<int64_t>(width) * height * 4);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depth.getId());
+
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            Release();
+            throw BufferException("Framebuffer is incomplete");
+        }
+
+        CheckGLError("Frame Buffer Creation"); ///< Check for OpenGL errors
+    }
+
+    /**
+     * @brief Binds the framebuffer for drawing and reading and sets the viewport to cover it.
+     */
+    void FrameBuffer::Bind()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_fbo.getId());
+        glViewport(0, 0, m_width, m_height);
+    }
+
+    /**
+     * @brief Binds the default framebuffer again.
+     */
+    void FrameBuffer::Unbind()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    /**
+     * @brief Releases the framebuffer’s OpenGL resources.
+     *
+     * Deletes the attachments and the framebuffer object and resets the handles.
+     */
+    void FrameBuffer::Release()
+    {
+        m_depth.Reset();
+        m_color.Reset();
+        m_fbo.Reset();
+    }
+
+    /**
+     * @brief Reads the color attachment back to client memory.
+     *
+     * OpenGL returns rows bottom to top, so the rows are flipped in place to the
+     * top-to-bottom order image files expect.
+     *
+     * @param pixels Receives width * height * 4 bytes.
+     * @exception GrafException Thrown if the read fails.
+     */
+    void FrameBuffer::ReadPixels(vector<unsigned char>& pixels)
+    {
+        size_t rowSize = static_cast<size_t>(m_width) * 4;
+        pixels.resize(rowSize * m_height);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fbo.getId());
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        CheckGLError("Frame Buffer Read");
+
+        for (int y = 0; y < m_height / 2; ++y)
+        {
+            unsigned char* top = pixels.data() + rowSize * y;
+            unsigned char* bottom = pixels.data() + rowSize * (m_height - 1 - y);
+            std::swap_ranges(top, top + rowSize, bottom);
+        }
+    }
+
+    /**
+     * @brief Gets the OpenGL handle of the framebuffer.
+     * @return The framebuffer handle.
+     */
+    unsigned int FrameBuffer::getId() const
+    {
+        return m_fbo.getId();
+    }
+
+    /**
+     * @brief Gets the width of the render target.
+     * @return Width in pixels.
+     */
+    int FrameBuffer::getWidth() const
+    {
+        return m_width;
+    }
+
+    /**
+     * @brief Gets the height of the render target.
+     * @return Height in pixels.
+     */
+    int FrameBuffer::getHeight() const
+    {
+        return m_height;
+    }
+}
@@ -0,0 +1,281 @@
+#include "FrameCapture.hpp"
+#include "ErrorCheck.hpp"
+#include "ImageWriter.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+/**
+ * @file FrameCapture.cpp
+ * @brief Implementation of the FrameCapture class for asynchronous screenshots and frame recording.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Constructs a capture facility.
+     *
+     * The pixel buffers are created lazily on the first capture, so constructing
+     * the object does not require a current OpenGL context.
+     *
+     * @param jobs The job system that encodes captured frames.
+     * @param bufferCount Number of pixel buffer objects in the ring (at least 2).
+     */
+    FrameCapture::FrameCapture(JobSystem& jobs, size_t bufferCount)
+        : m_jobs(jobs),
+          m_slots(std::max<size_t>(bufferCount, 2))
+    {
+    }
+
+    /**
+     * @brief Requests a screenshot of the next finished frame.
+     * @param fileName Path of the file to write.
+     * @param format File format.
+     */
+    void FrameCapture::Capture(const string& fileName, CaptureFormat format)
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_screenshots.emplace_back(fileName, format);
+    }
+
+    /**
+     * @brief Starts capturing every frame into a directory.
+     * @param directory Output directory, created if missing.
+     * @param format File format.
+     */
+    void FrameCapture::StartRecording(const string& directory, CaptureFormat format)
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_recording = true;
+        m_recordDirectory = directory;
+        m_recordFormat = format;
+        m_recordedFrames = 0;
+    }
+
+    /**
+     * @brief Stops capturing every frame.
+     */
+    void FrameCapture::StopRecording()
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_recording = false;
+    }
+
+    /**
+     * @brief Checks whether every frame is being captured.
+     * @return True while recording.
+     */
+    bool FrameCapture::IsRecording() const
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        return m_recording;
+    }
+
+    /**
+     * @brief Takes the next pending request for this frame.
+     *
+     * Screenshots take precedence; while recording, every frame gets the next
+     * numbered file name.
+     *
+     * @param fileName Receives the destination file.
+     * @param format Receives the file format.
+     * @return False if nothing should be captured this frame.
+     */
+    bool FrameCapture::NextRequest(string& fileName, CaptureFormat& format)
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        if (!m_screenshots.empty())
+        {
+            fileName = m_screenshots.front().first;
+            format = m_screenshots.front().second;
+            m_screenshots.pop_front();
+            return true;
+        }
+
+        if (!m_recording)
+            return false;
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "frame_%06zu.%s", m_recordedFrames++,
+                      m_recordFormat == CaptureFormat::Png ? "png" : "rgba");
+        fileName = m_recordDirectory + "/" + name;
+        format = m_recordFormat;
+        return true;
+    }
+
+    /**
+     * @brief Starts the readback of the finished frame and collects completed ones.
+     *
+     * The copy into the pixel buffer is queued on the GPU and returns immediately;
+     * the pixels are mapped in a later frame once the fence has signalled.
+     */
+    void FrameCapture::EndFrame()
+    {
+        CollectFinished(false);
+
+        string fileName;
+        CaptureFormat format;
+        if (!NextRequest(fileName, format))
+            return;
+
+        if (m_inFlight.size() == m_slots.size() || m_pendingEncodes.load() >= MAX_PENDING_ENCODES)
+        {
+            m_droppedFrames++; ///< Skip rather than stall the GL thread
+            return;
+        }
+
+        size_t index = 0;
+        while (std::find(m_inFlight.begin(), m_inFlight.end(), index) != m_inFlight.end())
+            ++index; ///< First slot not in flight
+
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+
+        ReadbackSlot& slot = m_slots[index];
+        slot.width = viewport[2];
+        slot.height = viewport[3];
+        slot.fileName = fileName;
+        slot.format = format;
+
+        size_t size = static_cast<size_t>(slot.width) * slot.height * 4;
+        if (!slot.pbo)
+            slot.pbo = BufferHandle("FrameCapture", GRAF_GL_SITE);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo.getId());
+        if (slot.capacity < size)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ); ///< Grow for larger frames
+            slot.capacity = size;
+            GpuResourceTracker::sSetSize(GpuResourceType::Buffer, slot.pbo.getId(), static_cast<int64_t>(size));
+        }
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(viewport[0], viewport[1], slot.width, slot.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr); ///< Asynchronous into the PBO
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.fence.Insert();
+        CheckGLError("Frame capture readback");
+
+        m_inFlight.push_back(index);
+    }
+
+    /**
+     * @brief Maps finished readbacks in submission order and schedules their encoding.
+     *
+     * The pixels are copied out of the mapped buffer so it can be reused at once;
+     * flipping the rows and encoding happen on a worker.
+     *
+     * @param wait Whether to block until every readback has finished.
+     */
+    void FrameCapture::CollectFinished(bool wait)
+    {
+        while (!m_inFlight.empty())
+        {
+            ReadbackSlot& slot = m_slots[m_inFlight.front()];
+            FenceStatus status = slot.fence.Wait(wait ? 1000000000ull : 0); ///< Poll unless flushing
+            if (status == FenceStatus::Pending)
+                break; ///< Later slots were queued after this one
+
+            slot.fence.Reset();
+            m_inFlight.pop_front();
+
+            if (status == FenceStatus::Failed)
+            {
+                std::cerr << "Frame capture failed: " << slot.fileName << std::endl;
+                continue;
+            }
+
+            size_t rowSize = static_cast<size_t>(slot.width) * 4;
+            vector<unsigned char> pixels(rowSize * slot.height);
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo.getId());
+            const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, pixels.size(), GL_MAP_READ_BIT);
+            if (mapped)
+            {
+                std::memcpy(pixels.data(), mapped, pixels.size());
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+            if (!mapped)
+            {
+                std::cerr << "Frame capture failed: " << slot.fileName << std::endl;
+                continue;
+            }
+
+            m_capturedFrames++;
+            m_pendingEncodes.fetch_add(1);
+            m_encodes.push_back(m_jobs.Schedule([this, pixels = std::move(pixels), width = slot.width,
+                                                 height = slot.height, fileName = slot.fileName,
+                                                 format = slot.format]() mutable {
+                size_t rowSize = static_cast<size_t>(width) * 4;
+                for (int y = 0; y < height / 2; ++y) ///< OpenGL rows are bottom to top
+                {
+                    unsigned char* top = pixels.data() + rowSize * y;
+                    std::swap_ranges(top, top + rowSize, pixels.data() + rowSize * (height - 1 - y));
+                }
+
+                try
+                {
+                    if (format == CaptureFormat::Png)
+                        WritePng(fileName, width, height, pixels);
+                    else
+                        WriteRaw(fileName, pixels);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Frame capture failed: " << e.what() << std::endl;
+                }
+                m_pendingEncodes.fetch_sub(1);
+            }));
+        }
+
+        m_encodes.erase(std::remove_if(m_encodes.begin(), m_encodes.end(),
+                                       [](const JobHandle& handle) { return handle.IsDone(); }),
+                        m_encodes.end());
+    }
+
+    /**
+     * @brief Waits for all outstanding readbacks and encodes.
+     */
+    void FrameCapture::Flush()
+    {
+        CollectFinished(true);
+        m_jobs.WaitAll(m_encodes);
+        m_encodes.clear();
+    }
+
+    /**
+     * @brief Releases the pixel buffers and fences; call before the context is destroyed.
+     */
+    void FrameCapture::Release()
+    {
+        for (auto& slot : m_slots)
+        {
+            slot.fence.Reset();
+            slot.pbo.Reset();
+            slot.capacity = 0;
+        }
+        m_inFlight.clear();
+    }
+
+    /**
+     * @brief Gets the number of frames written or queued for writing.
+     * @return The captured frame count.
+     */
+    size_t FrameCapture::getCapturedFrames() const
+    {
+        return m_capturedFrames;
+    }
+
+    /**
+     * @brief Gets the number of requested frames skipped to avoid stalling.
+     * @return The dropped frame count.
+     */
+    size_t FrameCapture::getDroppedFrames() const
+    {
+        return m_droppedFrames;
+    }
+}
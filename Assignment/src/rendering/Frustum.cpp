@@ -0,0 +1,73 @@
+#include "Frustum.hpp"
+
+/**
+ * @file Frustum.cpp
+ * @brief Implementation of the Frustum class for view frustum culling.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Extracts the frustum planes from a view-projection matrix.
+     * 
+     * Uses the Gribb-Hartmann method: each plane is the sum or difference of the
+     * fourth row and one of the first three rows of the matrix.
+     * 
+     * @param viewProjection The combined projection and view matrix.
+     */
+    Frustum::Frustum(const glm::mat4& viewProjection)
+    {
+        glm::vec4 rows[4];
+        for (int i = 0; i < 4; i++)
+            rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); ///< glm is column-major
+
+        m_planes[0] = rows[3] + rows[0]; ///< Left
+        m_planes[1] = rows[3] - rows[0]; ///< Right
+        m_planes[2] = rows[3] + rows[1]; ///< Bottom
+        m_planes[3] = rows[3] - rows[1]; ///< Top
+        m_planes[4] = rows[3] + rows[2]; ///< Near
+        m_planes[5] = rows[3] - rows[2]; ///< Far
+
+        for (auto& plane : m_planes)
+            plane /= glm::length(glm::vec3(plane)); ///< Normalize so distances are in world units
+    }
+
+    /**
+     * @brief Tests whether a bounding sphere is at least partially inside the frustum.
+     * @param center The sphere center in world space.
+     * @param radius The sphere radius.
+     * @return True if the sphere intersects or lies inside the frustum.
+     */
+    bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const
+    {
+        for (const auto& plane : m_planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+                return false; ///< Completely behind one plane
+        }
+        return true;
+    }
+
+    /**
+     * @brief Tests whether an axis-aligned box is at least partially inside the frustum.
+     * 
+     * Tests the corner of the box furthest along each plane's normal; if even that
+     * corner is behind a plane, the whole box is.
+     * 
+     * @param boxMin The minimum corner in world space.
+     * @param boxMax The maximum corner in world space.
+     * @return True if the box intersects or lies inside the frustum.
+     */
+    bool Frustum::IntersectsBox(const glm::vec3& boxMin, const glm::vec3& boxMax) const
+    {
+        for (const auto& plane : m_planes)
+        {
+            glm::vec3 corner(plane.x >= 0.0f ? boxMax.x : boxMin.x,
+                             plane.y >= 0.0f ? boxMax.y : boxMin.y,
+                             plane.z >= 0.0f ? boxMax.z : boxMin.z);
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+                return false; ///< Completely behind one plane
+        }
+        return true;
+    }
+}
@@ -0,0 +1,89 @@
+#include "GLHandle.hpp"
+#include <glad/glad.h>
+
+/**
+ * @file GLHandle.cpp
+ * @brief Implementation of the FenceHandle class; GLHandle is defined in the header.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Deletes the owned fence.
+     */
+    FenceHandle::~FenceHandle()
+    {
+        Reset();
+    }
+
+    /**
+     * @brief Takes over the fence of another handle, which becomes empty.
+     * @param other The handle to move from.
+     */
+    FenceHandle::FenceHandle(FenceHandle&& other) noexcept
+        : m_sync(std::exchange(other.m_sync, nullptr))
+    {
+    }
+
+    /**
+     * @brief Deletes the owned fence and takes over the fence of another handle.
+     * @param other The handle to move from.
+     * @return This handle.
+     */
+    FenceHandle& FenceHandle::operator=(FenceHandle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_sync = std::exchange(other.m_sync, nullptr);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Replaces the owned fence by one signalled when all commands issued so far have finished.
+     */
+    void FenceHandle::Insert()
+    {
+        Reset();
+        m_sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    /**
+     * @brief Waits for the fence to be signalled.
+     * @param timeoutNs Longest wait in nanoseconds; 0 polls without flushing, otherwise commands are flushed first.
+     * @return The state of the fence; an empty handle counts as signalled.
+     */
+    FenceStatus FenceHandle::Wait(uint64_t timeoutNs) const
+    {
+        if (!m_sync)
+            return FenceStatus::Signalled;
+
+        GLenum status = glClientWaitSync(static_cast<GLsync>(m_sync), timeoutNs > 0 ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                                         timeoutNs);
+        if (status == GL_TIMEOUT_EXPIRED)
+            return FenceStatus::Pending;
+        return status == GL_WAIT_FAILED ? FenceStatus::Failed : FenceStatus::Signalled;
+    }
+
+    /**
+     * @brief Deletes the owned fence, leaving the handle empty.
+     */
+    void FenceHandle::Reset()
+    {
+        if (m_sync)
+        {
+            glDeleteSync(static_cast<GLsync>(m_sync));
+            m_sync = nullptr;
+        }
+    }
+
+    /**
+     * @brief Checks whether the handle owns a fence.
+     * @return True if not empty.
+     */
+    FenceHandle::operator bool() const
+    {
+        return m_sync != nullptr;
+    }
+}
@@ -0,0 +1,278 @@
+#include "GpuProfiler.hpp"
+#include "Profiler.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+
+/**
+ * @file GpuProfiler.cpp
+ * @brief Implementation of the GpuProfiler class for measuring GPU time per render pass.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const size_t NO_ZONE = static_cast<size_t>(-1);   ///< Open-zone marker for zones begun while disabled.
+        const size_t QUERY_BATCH = 16;                    ///< Queries created at once when the pool is empty.
+    }
+
+    /**
+     * @brief Constructs a disabled profiler.
+     *
+     * Queries are created lazily, so no OpenGL context is needed yet.
+     *
+     * @param frameLatency Frames whose queries may be in flight at once (at least 2).
+     */
+    GpuProfiler::GpuProfiler(size_t frameLatency)
+        : m_frames(std::max<size_t>(frameLatency, 2))
+    {
+    }
+
+    /**
+     * @brief Enables or disables issuing queries; results in flight are still collected.
+     * @param enabled Whether zones are measured.
+     */
+    void GpuProfiler::SetEnabled(bool enabled)
+    {
+        m_enabled = enabled;
+    }
+
+    /**
+     * @brief Checks whether zones are measured.
+     * @return True if enabled.
+     */
+    bool GpuProfiler::IsEnabled() const
+    {
+        return m_enabled;
+    }
+
+    /**
+     * @brief Starts a zone; zones must be closed in reverse order.
+     *
+     * The first zone of a frame also pairs the current GL time with the profiler
+     * clock so the frame's results can be placed on the CPU timeline.
+     *
+     * @param name Pass name with static lifetime.
+     */
+    void GpuProfiler::BeginZone(const char* name)
+    {
+        if (!m_enabled)
+        {
+            m_openZones.push_back(NO_ZONE); ///< Keep EndZone balanced
+            return;
+        }
+
+        Frame& frame = m_frames[m_current];
+        if (frame.zones.empty())
+        {
+            GLint64 gpuNow = 0;
+            glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+            frame.gpuReference = gpuNow;
+            frame.cpuReference = Profiler::Now();
+        }
+
+        Zone zone;
+        zone.name = name;
+        zone.beginQuery = AcquireQuery();
+        glQueryCounter(zone.beginQuery, GL_TIMESTAMP);
+        frame.lastQuery = zone.beginQuery;
+
+        m_openZones.push_back(frame.zones.size());
+        frame.zones.push_back(zone);
+    }
+
+    /**
+     * @brief Ends the innermost open zone.
+     */
+    void GpuProfiler::EndZone()
+    {
+        if (m_openZones.empty())
+            return;
+
+        size_t index = m_openZones.back();
+        m_openZones.pop_back();
+        if (index == NO_ZONE)
+            return;
+
+        Frame& frame = m_frames[m_current];
+        Zone& zone = frame.zones[index];
+        zone.endQuery = AcquireQuery();
+        glQueryCounter(zone.endQuery, GL_TIMESTAMP);
+        frame.lastQuery = zone.endQuery;
+    }
+
+    /**
+     * @brief Finishes the current frame and collects the results of completed frames.
+     *
+     * Frames are read in submission order and collection stops at the first frame
+     * the GPU has not finished. If the next slot is still waiting for results, its
+     * frame is dropped so recording never has to wait.
+     */
+    void GpuProfiler::EndFrame()
+    {
+        Frame& current = m_frames[m_current];
+        while (!m_openZones.empty())
+            EndZone(); ///< Close zones left open at the frame boundary
+
+        if (!current.zones.empty())
+            m_pending.push_back(m_current);
+
+        while (!m_pending.empty() && IsFrameAvailable(m_frames[m_pending.front()]))
+        {
+            Frame& frame = m_frames[m_pending.front()];
+            ReadFrame(frame);
+            RecycleFrame(frame);
+            m_pending.pop_front();
+            m_measuredFrames++;
+        }
+
+        m_current = (m_current + 1) % m_frames.size();
+        if (!m_pending.empty() && m_pending.front() == m_current)
+        {
+            RecycleFrame(m_frames[m_current]); ///< Still in flight after a full ring
+            m_pending.pop_front();
+            m_droppedFrames++;
+        }
+    }
+
+    /**
+     * @brief Deletes all queries; call before the context is destroyed.
+     */
+    void GpuProfiler::Release()
+    {
+        m_allQueries.clear(); ///< The handles delete the queries
+        m_freeQueries.clear();
+        m_openZones.clear();
+        m_pending.clear();
+        for (auto& frame : m_frames)
+            frame.zones.clear();
+    }
+
+    /**
+     * @brief Takes a query from the pool, creating more if needed.
+     * @return The query object.
+     */
+    unsigned int GpuProfiler::AcquireQuery()
+    {
+        if (m_freeQueries.empty())
+        {
+            for (size_t i = 0; i < QUERY_BATCH; ++i)
+            {
+                m_allQueries.emplace_back("GpuProfiler", GRAF_GL_SITE);
+                m_freeQueries.push_back(m_allQueries.back().getId());
+            }
+        }
+
+        unsigned int query = m_freeQueries.back();
+        m_freeQueries.pop_back();
+        return query;
+    }
+
+    /**
+     * @brief Checks without blocking whether all queries of a frame have finished.
+     *
+     * Timestamps complete in submission order, so the last query issued decides.
+     *
+     * @param frame The frame.
+     * @return True if the results can be read.
+     */
+    bool GpuProfiler::IsFrameAvailable(const Frame& frame) const
+    {
+        GLint available = GL_FALSE;
+        glGetQueryObjectiv(frame.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        return available == GL_TRUE;
+    }
+
+    /**
+     * @brief Reads a finished frame into the statistics and the CPU trace.
+     * @param frame The frame.
+     */
+    void GpuProfiler::ReadFrame(const Frame& frame)
+    {
+        bool trace = Profiler::IsEnabled();
+        double ticksPerNs = 0.0;
+        if (trace)
+        {
+            if (m_track == 0)
+                m_track = Profiler::RegisterTrack("GPU");
+            ticksPerNs = Profiler::GetTicksPerMicrosecond() / 1000.0;
+        }
+
+        map<string, double> frameTotals; ///< Milliseconds per pass name in this frame
+        for (const auto& zone : frame.zones)
+        {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(zone.beginQuery, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(zone.endQuery, GL_QUERY_RESULT, &end);
+            if (end < begin)
+                continue;
+
+            frameTotals[zone.name] += (end - begin) / 1.0e6;
+
+            if (trace)
+            {
+                double offset = (static_cast<int64_t>(begin) - frame.gpuReference) * ticksPerNs;
+                uint64_t start = frame.cpuReference + static_cast<int64_t>(offset);
+                Profiler::RecordTrackZone(m_track, zone.name, start, start + static_cast<uint64_t>((end - begin) * ticksPerNs));
+            }
+        }
+
+        for (const auto& total : frameTotals)
+            m_passStats[total.first].AddSample(total.second);
+    }
+
+    /**
+     * @brief Returns the queries of a frame to the pool and clears it.
+     * @param frame The frame.
+     */
+    void GpuProfiler::RecycleFrame(Frame& frame)
+    {
+        for (const auto& zone : frame.zones)
+        {
+            m_freeQueries.push_back(zone.beginQuery);
+            m_freeQueries.push_back(zone.endQuery);
+        }
+        frame.zones.clear();
+    }
+
+    /**
+     * @brief Gets the GPU time statistics of a pass in milliseconds per frame.
+     * @param name The pass name.
+     * @return The statistics, or nullptr if the pass was never measured.
+     */
+    const RollingStats* GpuProfiler::getPassStats(const string& name) const
+    {
+        auto it = m_passStats.find(name);
+        return it != m_passStats.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * @brief Gets the names of all measured passes.
+     * @return The pass names in alphabetical order.
+     */
+    vector<string> GpuProfiler::getPassNames() const
+    {
+        vector<string> names;
+        for (const auto& pass : m_passStats)
+            names.push_back(pass.first);
+        return names;
+    }
+
+    /**
+     * @brief Gets the number of frames whose results were read back.
+     * @return The measured frame count.
+     */
+    size_t GpuProfiler::getMeasuredFrames() const
+    {
+        return m_measuredFrames;
+    }
+
+    /**
+     * @brief Gets the number of frames dropped because their results arrived too late.
+     * @return The dropped frame count.
+     */
+    size_t GpuProfiler::getDroppedFrames() const
+    {
+        return m_droppedFrames;
+    }
+}
@@ -0,0 +1,334 @@
+#include "GpuResourceTracker.hpp"
+#include "Metrics.hpp"
+#include <glad/glad.h>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+/**
+ * @file GpuResourceTracker.cpp
+ * @brief Implementation of the GpuResourceTracker class that creates, deletes and accounts for OpenGL objects.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const size_t TYPE_COUNT = static_cast<size_t>(GpuResourceType::Count); ///< Number of categories.
+
+        /**
+         * @struct TrackerState
+         * @brief Process-wide tracker state.
+         */
+        struct TrackerState
+        {
+            using Key = pair<int, unsigned int>; ///< Category and handle.
+
+            mutex                       stateMutex;                 ///< Guards everything below.
+            map<Key, GpuResourceInfo>   live;                       ///< Live objects by category and handle.
+            size_t                      liveCount[TYPE_COUNT] = {}; ///< Live objects per category.
+            int64_t                     liveBytes[TYPE_COUNT] = {}; ///< Live bytes per category.
+            int64_t                     totalBytes = 0;             ///< Live bytes of all categories.
+            int64_t                     budget[TYPE_COUNT] = {};    ///< Byte budget per category, 0 for none.
+            int64_t                     totalBudget = 0;            ///< Byte budget of all categories, 0 for none.
+            bool                        overBudget[TYPE_COUNT] = {};///< Whether a category's warning is active.
+            bool                        overTotalBudget = false;    ///< Whether the total warning is active.
+        };
+
+        /**
+         * @brief Gets the process-wide tracker state, created on first use.
+         * @return The state.
+         */
+        TrackerState& State()
+        {
+            static TrackerState state;
+            return state;
+        }
+
+        /**
+         * @brief Warns once when a budget is first exceeded and re-arms below it.
+         * @param name Name of the budget.
+         * @param bytes Current usage.
+         * @param budget The budget, 0 for none.
+         * @param warned Whether the warning is active; updated.
+         */
+        void CheckBudget(const char* name, int64_t bytes, int64_t budget, bool& warned)
+        {
+            if (budget <= 0)
+                return;
+
+            if (bytes > budget && !warned)
+            {
+                std::cerr << "GPU memory budget exceeded for " << name << ": " << bytes / 1024 << " KiB of "
+                          << budget / 1024 << " KiB" << std::endl;
+                warned = true;
+            }
+            else if (bytes <= budget)
+            {
+                warned = false;
+            }
+        }
+
+        /**
+         * @brief Changes the bytes of a category and checks the budgets; the caller holds the state mutex.
+         * @param state The tracker state.
+         * @param type The category.
+         * @param delta Bytes added (positive) or removed (negative).
+         */
+        void AddBytesLocked(TrackerState& state, GpuResourceType type, int64_t delta)
+        {
+            size_t index = static_cast<size_t>(type);
+            state.liveBytes[index] += delta;
+            state.totalBytes += delta;
+            if (delta > 0)
+            {
+                CheckBudget(GpuResourceTracker::sGetTypeName(type), state.liveBytes[index], state.budget[index],
+                            state.overBudget[index]);
+                CheckBudget("all objects", state.totalBytes, state.totalBudget, state.overTotalBudget);
+            }
+            else
+            {
+                state.overBudget[index] = state.overBudget[index] && state.liveBytes[index] > state.budget[index];
+                state.overTotalBudget = state.overTotalBudget && state.totalBytes > state.totalBudget;
+            }
+        }
+    }
+
+    /**
+     * @brief Creates an OpenGL object and records it.
+     * @param type Category of the object.
+     * @param owner Tag of the owner, e.g. the class or asset name.
+     * @param site Creation site, normally GRAF_GL_SITE.
+     * @param shaderType Shader stage for GpuResourceType::Shader, ignored otherwise.
+     * @return The new handle, or 0 if creation failed.
+     */
+    unsigned int GpuResourceTracker::sCreate(GpuResourceType type, const string& owner, const char* site, unsigned int shaderType)
+    {
+        GLuint id = 0;
+        switch (type)
+        {
+            case GpuResourceType::Buffer:       glGenBuffers(1, &id);           break;
+            case GpuResourceType::VertexArray:  glGenVertexArrays(1, &id);      break;
+            case GpuResourceType::Texture:      glGenTextures(1, &id);          break;
+            case GpuResourceType::Shader:       id = glCreateShader(shaderType); break;
+            case GpuResourceType::Program:      id = glCreateProgram();         break;
+            case GpuResourceType::Framebuffer:  glGenFramebuffers(1, &id);      break;
+            case GpuResourceType::Renderbuffer: glGenRenderbuffers(1, &id);     break;
+            case GpuResourceType::Query:        glGenQueries(1, &id);           break;
+            default:                                                            break;
+        }
+        if (id == 0)
+            return 0; ///< Nothing to track; callers report the failure
+
+        TrackerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        GpuResourceInfo& info = state.live[{static_cast<int>(type), id}];
+        info.type = type;
+        info.id = id;
+        info.bytes = 0;
+        info.owner = owner;
+        info.site = site;
+        state.liveCount[static_cast<size_t>(type)]++;
+        return id;
+    }
+
+    /**
+     * @brief Deletes a recorded OpenGL object and resets the handle.
+     * @param type Category of the object.
+     * @param id The handle; set to 0. Nothing happens if it is already 0.
+     */
+    void GpuResourceTracker::sDelete(GpuResourceType type, unsigned int& id)
+    {
+        if (id == 0)
+            return;
+
+        GLuint handle = id;
+        switch (type)
+        {
+            case GpuResourceType::Buffer:       glDeleteBuffers(1, &handle);       break;
+            case GpuResourceType::VertexArray:  glDeleteVertexArrays(1, &handle);  break;
+            case GpuResourceType::Texture:      glDeleteTextures(1, &handle);      break;
+            case GpuResourceType::Shader:       glDeleteShader(handle);            break;
+            case GpuResourceType::Program:      glDeleteProgram(handle);           break;
+            case GpuResourceType::Framebuffer:  glDeleteFramebuffers(1, &handle);  break;
+            case GpuResourceType::Renderbuffer: glDeleteRenderbuffers(1, &handle); break;
+            case GpuResourceType::Query:        glDeleteQueries(1, &handle);       break;
+            default:                                                               break;
+        }
+
+        TrackerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        auto it = state.live.find({static_cast<int>(type), id});
+        if (it != state.live.end())
+        {
+            AddBytesLocked(state, type, -it->second.bytes);
+            state.liveCount[static_cast<size_t>(type)]--;
+            state.live.erase(it);
+        }
+        id = 0;
+    }
+
+    /**
+     * @brief Sets the GPU memory attributed to an object, e.g. after uploading its storage.
+     * @param type Category of the object.
+     * @param id The handle.
+     * @param bytes The size in bytes.
+     */
+    void GpuResourceTracker::sSetSize(GpuResourceType type, unsigned int id, int64_t bytes)
+    {
+        TrackerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        auto it = state.live.find({static_cast<int>(type), id});
+        if (it == state.live.end())
+            return;
+
+        int64_t delta = bytes - it->second.bytes;
+        it->second.bytes = bytes;
+        AddBytesLocked(state, type, delta);
+    }
+
+    /**
+     * @brief Sets the byte budget of a category.
+     * @param type The category.
+     * @param bytes The budget, or 0 for none.
+     */
+    void GpuResourceTracker::sSetBudget(GpuResourceType type, int64_t bytes)
+    {
+        TrackerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        size_t index = static_cast<size_t>(type);
+        state.budget[index] = bytes;
+        state.overBudget[index] = false;
+        CheckBudget(sGetTypeName(type), state.liveBytes[index], bytes, state.overBudget[index]);
+    }
+
+    /**
+     * @brief Sets the byte budget of all categories together.
+     * @param bytes The budget, or 0 for none.
+     */
+    void GpuResourceTracker::sSetTotalBudget(int64_t bytes)
+    {
+        TrackerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        state.totalBudget = bytes;
+        state.overTotalBudget = false;
+        CheckBudget("all objects", state.totalBytes, bytes, state.overTotalBudget);
+    }
+
+    /**
+     * @brief Gets the number of live objects of a category.
+     * @param type The category.
+     * @return The live count.
+     */
+    size_t GpuResourceTracker::sGetLiveCount(GpuResourceType type)
+    {
+        TrackerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        return state.liveCount[static_cast<size_t>(type)];
+    }
+
+    /**
+     * @brief Gets the GPU memory of the live objects of a category.
+     * @param type The category.
+     * @return The size in bytes.
+     */
+    int64_t GpuResourceTracker::sGetLiveBytes(GpuResourceType type)
+    {
+        TrackerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        return state.liveBytes[static_cast<size_t>(type)];
+    }
+
+    /**
+     * @brief Gets all live objects.
+     * @return The objects, ordered by category and handle.
+     */
+    vector<GpuResourceInfo> GpuResourceTracker::sGetLiveResources()
+    {
+        TrackerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        vector<GpuResourceInfo> resources;
+        resources.reserve(state.live.size());
+        for (const auto& entry : state.live)
+            resources.push_back(entry.second);
+        return resources;
+    }
+
+    /**
+     * @brief Gets the display name of a category.
+     * @param type The category.
+     * @return The name, e.g. "buffer".
+     */
+    const char* GpuResourceTracker::sGetTypeName(GpuResourceType type)
+    {
+        switch (type)
+        {
+            case GpuResourceType::Buffer:       return "buffer";
+            case GpuResourceType::VertexArray:  return "vertex_array";
+            case GpuResourceType::Texture:      return "texture";
+            case GpuResourceType::Shader:       return "shader";
+            case GpuResourceType::Program:      return "program";
+            case GpuResourceType::Framebuffer:  return "framebuffer";
+            case GpuResourceType::Renderbuffer: return "renderbuffer";
+            case GpuResourceType::Query:        return "query";
+            default:                            return "unknown";
+        }
+    }
+
+    /**
+     * @brief Writes the live counts and bytes per category.
+     * @param out The output stream.
+     */
+    void GpuResourceTracker::sWriteSummary(ostream& out)
+    {
+        TrackerState& state = State();
+        std::lock_guard<std::mutex> lock(state.stateMutex);
+        out << "GPU objects:";
+        for (size_t t = 0; t < TYPE_COUNT; ++t)
+        {
+            if (state.liveCount[t] == 0)
+                continue;
+            out << " " << sGetTypeName(static_cast<GpuResourceType>(t)) << " " << state.liveCount[t];
+            if (state.liveBytes[t] > 0)
+                out << " (" << state.liveBytes[t] / 1024 << " KiB)";
+        }
+        out << ", " << state.totalBytes / 1024 << " KiB total" << std::endl;
+    }
+
+    /**
+     * @brief Writes every live object as a leak; call after all owners have released.
+     * @param out The output stream.
+     * @return The number of leaked objects.
+     */
+    size_t GpuResourceTracker::sReportLeaks(ostream& out)
+    {
+        vector<GpuResourceInfo> leaks = sGetLiveResources();
+        for (const auto& leak : leaks)
+        {
+            out << "Leaked GPU " << sGetTypeName(leak.type) << " " << leak.id << " (" << leak.bytes
+                << " bytes) owned by " << leak.owner << ", created at " << leak.site << std::endl;
+        }
+        return leaks.size();
+    }
+
+    /**
+     * @brief Publishes the live counts and bytes in the MetricsRegistry.
+     *
+     * Calling it more than once has no further effect.
+     */
+    void GpuResourceTracker::sRegisterMetrics()
+    {
+        static std::once_flag registered;
+        std::call_once(registered, []() {
+            for (size_t t = 0; t < TYPE_COUNT; ++t)
+            {
+                GpuResourceType type = static_cast<GpuResourceType>(t);
+                string labels = string("type=\"") + sGetTypeName(type) + "\"";
+                MetricsRegistry::RegisterGaugeFunction("graf_gpu_live_objects", "Live OpenGL objects by type.", labels,
+                                                       [type]() { return static_cast<double>(sGetLiveCount(type)); });
+                MetricsRegistry::RegisterGaugeFunction("graf_gpu_live_bytes", "GPU memory of live OpenGL objects by type.", labels,
+                                                       [type]() { return static_cast<double>(sGetLiveBytes(type)); });
+            }
+        });
+    }
+}
@@ -0,0 +1,64 @@
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+
+#include "ImageWriter.hpp"
+#include "Exceptions.hpp"
+#include <filesystem>
+#include <fstream>
+#include <stb/stb_image_write.h>
+
+/**
+ * @file ImageWriter.cpp
+ * @brief Implementation of the image writing functions.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        /**
+         * @brief Creates the parent directories of an output file.
+         * @param fileName Path of the file about to be written.
+         */
+        void CreateParentDirectories(const std::string& fileName)
+        {
+            std::filesystem::path parent = std::filesystem::path(fileName).parent_path();
+            if (!parent.empty())
+                std::filesystem::create_directories(parent); ///< Allow output into new folders
+        }
+    }
+
+    /**
+     * @brief Writes RGBA pixels to a PNG file using stb_image_write.
+     * @param fileName Path of the PNG file to write.
+     * @param width Image width in pixels.
+     * @param height Image height in pixels.
+     * @param pixels Top-to-bottom RGBA rows, width * height * 4 bytes.
+     * @exception TextureException Thrown if the size does not match or the file cannot be written.
+     */
+    void WritePng(const std::string& fileName, int width, int height, const std::vector<unsigned char>& pixels)
+    {
+        if (width <= 0 || height <= 0 || pixels.size() != static_cast<size_t>(width) * height * 4)
+            throw TextureException("Invalid image size for: " + fileName);
+
+        CreateParentDirectories(fileName);
+
+        if (!stbi_write_png(fileName.c_str(), width, height, 4, pixels.data(), width * 4))
+            throw TextureException("Failed to write image: " + fileName);
+    }
+
+    /**
+     * @brief Writes pixels to a file as raw bytes without a header.
+     * @param fileName Path of the file to write.
+     * @param pixels The bytes to write.
+     * @exception TextureException Thrown if the file cannot be written.
+     */
+    void WriteRaw(const std::string& fileName, const std::vector<unsigned char>& pixels)
+    {
+        CreateParentDirectories(fileName);
+
+        std::ofstream file(fileName, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+        if (!file)
+            throw TextureException("Failed to write image: " + fileName);
+    }
+}
@@ -1,6 +1,8 @@
-#include "Indexbuffer.hpp"
+#include "IndexBuffer.hpp"
 #include "Exceptions.hpp"
 #include "ErrorCheck.hpp"
+#include "RenderStats.hpp"
+#include "GpuResourceTracker.hpp"
 #include <glad/glad.h>
 
 /**
@@ -10,6 +12,30 @@
 
 namespace graf
 {
+    /**
+     * @brief Releases the buffer if it is still owned.
+     */
+    IndexBuffer::~IndexBuffer()
+    {
+        Release();
+    }
+
+    /**
+     * @brief Releases the owned buffer and takes over the buffer of another instance.
+     * @param other The buffer to move from.
+     * @return This buffer.
+     */
+    IndexBuffer& IndexBuffer::operator=(IndexBuffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Release(); ///< Keeps the memory statistics balanced
+            m_buffer = std::move(other.m_buffer);
+            m_IndexCount = std::exchange(other.m_IndexCount, 0);
+        }
+        return *this;
+    }
+
     /**
      * @brief Binds the index buffer for use in rendering.
      * 
@@ -18,7 +44,7 @@ namespace graf
      */
     void IndexBuffer::Bind()
     {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_buffer.getId());
     }
     
     /**
@@ -36,16 +62,22 @@ namespace graf
         if (data == nullptr || size <= 0)
             throw BufferException("Invalid buffer data or size");
 
-        glGenBuffers(1, &m_id);
-        if (m_id == 0)
+        Release(); ///< Replace previous contents
+
+        m_buffer = BufferHandle("IndexBuffer", GRAF_GL_SITE);
+        if (!m_buffer)
             throw BufferException("Failed to generate index buffer");
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_id);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_buffer.getId());
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW); ///< Upload data to GPU
 
         CheckGLError("Index Buffer Creation"); ///< Check for OpenGL errors
 
         m_IndexCount = size / 4; ///< Calculate index count assuming 4-byte unsigned ints
+        GpuResourceTracker::sSetSize(GpuResourceType::Buffer, m_buffer.getId(), size);
+
+        RenderStats::sAddUpload(size);
+        RenderStats::sAddMeshMemory(size);
     }
 
     /**
@@ -57,6 +89,15 @@ namespace graf
         return m_IndexCount;
     }
 
+    /**
+     * @brief Gets the OpenGL id, e.g. to bind the buffer into other vertex arrays.
+     * @return The id, or 0 if no buffer was created.
+     */
+    unsigned int IndexBuffer::getId() const
+    {
+        return m_buffer.getId();
+    }
+
     /**
      * @brief Releases the index buffer’s OpenGL resources.
      * 
@@ -64,10 +105,11 @@ namespace graf
      */
     void IndexBuffer::Release()
     {
-        if (m_id != 0) 
+        if (m_buffer) 
         {
-            glDeleteBuffers(1, &m_id); ///< Free GPU memory
-            m_id = 0;                  ///< Reset handle to indicate deletion
+            m_buffer.Reset(); ///< Free GPU memory
+            RenderStats::sAddMeshMemory(-static_cast<int64_t>(m_IndexCount) * 4);
+            m_IndexCount = 0;
         }
     }
 
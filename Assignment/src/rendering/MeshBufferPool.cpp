@@ -0,0 +1,310 @@
+#include "MeshBufferPool.hpp"
+#include "Exceptions.hpp"
+#include "ErrorCheck.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
+#include "GpuResourceTracker.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+
+/**
+ * @file MeshBufferPool.cpp
+ * @brief Implementation of the MeshBufferPool class.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Constructs an empty pool; pages are created on the first allocations.
+     * @param layout The vertex attributes.
+     * @param vertexStride Size of a vertex in bytes.
+     * @param alignment Granularity of allocations in bytes, a multiple of the vertex stride.
+     * @param pageSize Size of a page in bytes; larger meshes get a page of their own.
+     */
+    MeshBufferPool::MeshBufferPool(const vector<MeshAttribute>& layout, size_t vertexStride, size_t alignment, size_t pageSize)
+        : m_layout(layout), m_vertexStride(vertexStride), m_alignment(alignment), m_pageSize(pageSize)
+    {
+        if (vertexStride == 0 || alignment % vertexStride != 0)
+            throw BufferException("Mesh pool alignment must be a multiple of the vertex stride");
+        m_pageSize = (max(m_pageSize, m_alignment) / m_alignment) * m_alignment;
+    }
+
+    /**
+     * @brief Deletes the pages.
+     */
+    MeshBufferPool::~MeshBufferPool()
+    {
+        Release();
+    }
+
+    /**
+     * @brief Sets the index buffer bound to the vertex arrays of all pages, e.g. a shared quad index buffer.
+     * @param indexBuffer The buffer id, 0 for none.
+     */
+    void MeshBufferPool::SetIndexBuffer(unsigned int indexBuffer)
+    {
+        m_indexBuffer = indexBuffer;
+        for (const auto& page : m_pages)
+        {
+            if (!page)
+                continue;
+            glBindVertexArray(page->vertexArray.getId());
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+        }
+        glBindVertexArray(0);
+    }
+
+    /**
+     * @brief Reserves a range for a mesh.
+     *
+     * Takes the first free range that fits from the existing pages and creates a
+     * page when none does.
+     *
+     * @param bytes Size of the mesh in bytes.
+     * @return The range.
+     */
+    MeshAllocation MeshBufferPool::Allocate(size_t bytes)
+    {
+        size_t size = ((max<size_t>(bytes, 1) + m_alignment - 1) / m_alignment) * m_alignment;
+        if (size > UINT32_MAX)
+            throw BufferException("Mesh of " + to_string(bytes) + " bytes is too large for the pool");
+
+        MeshAllocation allocation;
+        allocation.size = static_cast<uint32_t>(size);
+        for (uint32_t i = 0; i < m_pages.size(); ++i)
+        {
+            if (m_pages[i] && TakeRange(*m_pages[i], allocation.size, allocation.offset))
+            {
+                allocation.page = i;
+                break;
+            }
+        }
+        if (!allocation.IsValid())
+        {
+            allocation.page = CreatePage(max(size, m_pageSize));
+            TakeRange(*m_pages[allocation.page], allocation.size, allocation.offset);
+        }
+
+        m_pages[allocation.page]->used += allocation.size;
+        m_allocationCount++;
+        return allocation;
+    }
+
+    /**
+     * @brief Returns a range to its page and clears the allocation.
+     *
+     * The range is merged with adjacent free ranges. A page left empty is deleted
+     * if another page is already empty.
+     *
+     * @param allocation The range; an empty allocation is ignored.
+     */
+    void MeshBufferPool::Free(MeshAllocation& allocation)
+    {
+        if (!allocation.IsValid() || allocation.page >= m_pages.size() || !m_pages[allocation.page])
+        {
+            allocation = MeshAllocation();
+            return;
+        }
+
+        Page& page = *m_pages[allocation.page];
+        uint32_t offset = allocation.offset, size = allocation.size;
+        auto next = page.freeRanges.lower_bound(offset);
+        if (next != page.freeRanges.begin())
+        {
+            auto previous = std::prev(next);
+            if (previous->first + previous->second == offset) ///< Merge with the range before
+            {
+                offset = previous->first;
+                size += previous->second;
+                page.freeRanges.erase(previous);
+            }
+        }
+        if (next != page.freeRanges.end() && offset + size == next->first) ///< Merge with the range after
+        {
+            size += next->second;
+            page.freeRanges.erase(next);
+        }
+        page.freeRanges[offset] = size;
+        page.used -= allocation.size;
+        m_allocationCount--;
+
+        if (page.used == 0)
+        {
+            bool otherEmpty = false;
+            for (uint32_t i = 0; i < m_pages.size(); ++i)
+                otherEmpty |= i != allocation.page && m_pages[i] && m_pages[i]->used == 0;
+            if (otherEmpty)
+            {
+                RenderStats::sAddMeshMemory(-static_cast<int64_t>(page.size));
+                m_pages[allocation.page].reset(); ///< Keep one empty page for the next allocations
+            }
+        }
+        allocation = MeshAllocation();
+    }
+
+    /**
+     * @brief Writes vertices into a range.
+     * @param allocation The range.
+     * @param data The vertices.
+     * @param bytes Their size, at most the size of the range.
+     */
+    void MeshBufferPool::Upload(const MeshAllocation& allocation, const void* data, size_t bytes)
+    {
+        if (!allocation.IsValid() || bytes > allocation.size)
+            throw BufferException("Mesh upload does not fit its pool allocation");
+        if (bytes == 0)
+            return;
+
+        GRAF_PROFILE_SCOPE("MeshBufferPool::Upload");
+        glBindBuffer(GL_ARRAY_BUFFER, m_pages[allocation.page]->buffer.getId());
+        glBufferSubData(GL_ARRAY_BUFFER, allocation.offset, static_cast<GLsizeiptr>(bytes), data);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        RenderStats::sAddUpload(bytes);
+    }
+
+    /**
+     * @brief Gets the vertex array of a page.
+     * @param page The page index of an allocation.
+     * @return The vertex array id.
+     */
+    unsigned int MeshBufferPool::getVertexArray(uint32_t page) const
+    {
+        return m_pages[page]->vertexArray.getId();
+    }
+
+    /**
+     * @brief Gets the index of the first vertex of a range in its page.
+     * @param allocation The range.
+     * @return The base vertex for glDrawElementsBaseVertex.
+     */
+    int MeshBufferPool::getBaseVertex(const MeshAllocation& allocation) const
+    {
+        return static_cast<int>(allocation.offset / m_vertexStride);
+    }
+
+    /**
+     * @brief Deletes all pages; allocations still held become invalid.
+     */
+    void MeshBufferPool::Release()
+    {
+        RenderStats::sAddMeshMemory(-static_cast<int64_t>(getCapacity()));
+        m_pages.clear();
+        m_allocationCount = 0;
+    }
+
+    /**
+     * @brief Gets the number of pages.
+     * @return The count.
+     */
+    size_t MeshBufferPool::getPageCount() const
+    {
+        return static_cast<size_t>(count_if(m_pages.begin(), m_pages.end(), [](const unique_ptr<Page>& page) { return page != nullptr; }));
+    }
+
+    /**
+     * @brief Gets the size of all pages.
+     * @return The byte count.
+     */
+    size_t MeshBufferPool::getCapacity() const
+    {
+        size_t capacity = 0;
+        for (const auto& page : m_pages)
+            capacity += page ? page->size : 0;
+        return capacity;
+    }
+
+    /**
+     * @brief Gets the size of all allocated ranges.
+     * @return The byte count.
+     */
+    size_t MeshBufferPool::getUsed() const
+    {
+        size_t used = 0;
+        for (const auto& page : m_pages)
+            used += page ? page->used : 0;
+        return used;
+    }
+
+    /**
+     * @brief Gets the number of allocated ranges.
+     * @return The count.
+     */
+    size_t MeshBufferPool::getAllocationCount() const
+    {
+        return m_allocationCount;
+    }
+
+    /**
+     * @brief Creates a page and its vertex array.
+     *
+     * The slot of a deleted page is reused, so page indices stay small.
+     *
+     * @param size Size in bytes.
+     * @return The page index.
+     */
+    uint32_t MeshBufferPool::CreatePage(size_t size)
+    {
+        GRAF_PROFILE_SCOPE("MeshBufferPool::CreatePage");
+        unique_ptr<Page> page(new Page);
+        page->size = size;
+        page->buffer = BufferHandle("MeshBufferPool", GRAF_GL_SITE);
+        page->vertexArray = VertexArrayHandle("MeshBufferPool", GRAF_GL_SITE);
+        if (!page->buffer || !page->vertexArray)
+            throw BufferException("Failed to create a mesh pool page");
+
+        glBindVertexArray(page->vertexArray.getId());
+        glBindBuffer(GL_ARRAY_BUFFER, page->buffer.getId());
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_DYNAMIC_DRAW); ///< Storage only, filled by uploads
+        for (const MeshAttribute& attribute : m_layout)
+        {
+            glEnableVertexAttribArray(attribute.location);
+            const void* offset = reinterpret_cast<const void*>(attribute.offset);
+            if (attribute.integer)
+                glVertexAttribIPointer(attribute.location, attribute.components, attribute.type, static_cast<GLsizei>(m_vertexStride), offset);
+            else
+                glVertexAttribPointer(attribute.location, attribute.components, attribute.type, GL_FALSE, static_cast<GLsizei>(m_vertexStride), offset);
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        CheckGLError("Mesh pool page creation");
+
+        GpuResourceTracker::sSetSize(GpuResourceType::Buffer, page->buffer.getId(), static_cast<int64_t>(size));
+        RenderStats::sAddMeshMemory(static_cast<int64_t>(size));
+        page->freeRanges[0] = static_cast<uint32_t>(size);
+
+        for (uint32_t i = 0; i < m_pages.size(); ++i)
+        {
+            if (!m_pages[i])
+            {
+                m_pages[i] = std::move(page);
+                return i;
+            }
+        }
+        m_pages.push_back(std::move(page));
+        return static_cast<uint32_t>(m_pages.size() - 1);
+    }
+
+    /**
+     * @brief Takes a range from the free ranges of a page.
+     * @param page The page.
+     * @param size Size in bytes, a multiple of the alignment.
+     * @param offset Receives the offset of the range.
+     * @return False if no free range is large enough.
+     */
+    bool MeshBufferPool::TakeRange(Page& page, uint32_t size, uint32_t& offset)
+    {
+        for (auto it = page.freeRanges.begin(); it != page.freeRanges.end(); ++it)
+        {
+            if (it->second < size)
+                continue;
+            offset = it->first;
+            uint32_t remaining = it->second - size;
+            page.freeRanges.erase(it);
+            if (remaining > 0)
+                page.freeRanges[offset + size] = remaining;
+            return true;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,136 @@
+#include "RenderStats.hpp"
+#include "Metrics.hpp"
+#include <atomic>
+#include <mutex>
+
+/**
+ * @file RenderStats.cpp
+ * @brief Implementation of the RenderStats class with process-wide rendering counters.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const size_t CACHE_COUNT = static_cast<size_t>(StatsCache::Count); ///< Number of counted caches.
+
+        std::atomic<uint64_t> s_bytesUploaded{0};           ///< Bytes uploaded to the GPU.
+        std::atomic<int64_t>  s_meshMemory{0};              ///< Bytes in vertex and index buffers.
+        std::atomic<int64_t>  s_textureMemory{0};           ///< Bytes in textures.
+        std::atomic<uint64_t> s_cacheHits[CACHE_COUNT];     ///< Hits per cache.
+        std::atomic<uint64_t> s_cacheMisses[CACHE_COUNT];   ///< Misses per cache.
+    }
+
+    /**
+     * @brief Records data uploaded to the GPU.
+     * @param bytes Number of bytes uploaded.
+     */
+    void RenderStats::sAddUpload(size_t bytes)
+    {
+        s_bytesUploaded.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adjusts the memory held by vertex and index buffers.
+     * @param bytes Bytes allocated (positive) or freed (negative).
+     */
+    void RenderStats::sAddMeshMemory(int64_t bytes)
+    {
+        s_meshMemory.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adjusts the memory held by textures.
+     * @param bytes Bytes allocated (positive) or freed (negative).
+     */
+    void RenderStats::sAddTextureMemory(int64_t bytes)
+    {
+        s_textureMemory.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records a cache lookup.
+     * @param cache The cache that was queried.
+     * @param hit Whether the entry was found.
+     */
+    void RenderStats::sRecordCacheLookup(StatsCache cache, bool hit)
+    {
+        auto& counter = hit ? s_cacheHits[static_cast<size_t>(cache)] : s_cacheMisses[static_cast<size_t>(cache)];
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the total number of bytes uploaded to the GPU.
+     * @return The byte count.
+     */
+    uint64_t RenderStats::sGetBytesUploaded()
+    {
+        return s_bytesUploaded.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the memory currently held by vertex and index buffers.
+     * @return The size in bytes.
+     */
+    int64_t RenderStats::sGetMeshMemory()
+    {
+        return s_meshMemory.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the memory currently held by textures, including mipmaps.
+     * @return The size in bytes.
+     */
+    int64_t RenderStats::sGetTextureMemory()
+    {
+        return s_textureMemory.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the number of hits of a cache.
+     * @param cache The cache.
+     * @return The hit count.
+     */
+    uint64_t RenderStats::sGetCacheHits(StatsCache cache)
+    {
+        return s_cacheHits[static_cast<size_t>(cache)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the number of misses of a cache.
+     * @param cache The cache.
+     * @return The miss count.
+     */
+    uint64_t RenderStats::sGetCacheMisses(StatsCache cache)
+    {
+        return s_cacheMisses[static_cast<size_t>(cache)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Publishes the counters in the MetricsRegistry, read at export time.
+     *
+     * The counters stay plain atomics so the hot paths are not charged twice; the
+     * registry reads them only when metrics are exported.
+     */
+    void RenderStats::sRegisterMetrics()
+    {
+        static std::once_flag registered;
+        std::call_once(registered, []() {
+            MetricsRegistry::RegisterCounterFunction("graf_uploaded_bytes_total", "Bytes uploaded to the GPU.", "",
+                                                     []() { return static_cast<double>(sGetBytesUploaded()); });
+            MetricsRegistry::RegisterGaugeFunction("graf_mesh_resident_bytes", "GPU memory held by vertex and index buffers.", "",
+                                                   []() { return static_cast<double>(sGetMeshMemory()); });
+
+            const char* names[CACHE_COUNT] = {"shape", "texture", "shader_source"};
+            for (size_t c = 0; c < CACHE_COUNT; ++c)
+            {
+                StatsCache cache = static_cast<StatsCache>(c);
+                std::string labels = std::string("cache=\"") + names[c] + "\",result=";
+                MetricsRegistry::RegisterCounterFunction("graf_cache_lookups_total", "Cache lookups by cache and result.",
+                                                         labels + "\"hit\"", [cache]() { return static_cast<double>(sGetCacheHits(cache)); });
+                MetricsRegistry::RegisterCounterFunction("graf_cache_lookups_total", "Cache lookups by cache and result.",
+                                                         labels + "\"miss\"", [cache]() { return static_cast<double>(sGetCacheMisses(cache)); });
+            }
+        });
+    }
+}
@@ -0,0 +1,198 @@
+#include <glad/glad.h>
+#include "SceneRenderer.hpp"
+#include "Profiler.hpp"
+#include "ErrorCheck.hpp"
+#include "Metrics.hpp"
+#include "VertexArrayObject.hpp"
+#include <algorithm>
+#include <iostream>
+
+/**
+ * @file SceneRenderer.cpp
+ * @brief Implementation of the SceneRenderer class for drawing frame packets.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Constructs a renderer for the given program and shapes.
+     * 
+     * Resolves the transform uniform location once so recording never looks up names.
+     * 
+     * @param program The shader program used for all draws.
+     * @param shapes The manager providing the cached shape VAOs.
+     * @param jobs The job system used for recording.
+     */
+    SceneRenderer::SceneRenderer(ShaderProgram& program, ShapeFactoryManager& shapes, JobSystem& jobs)
+        : m_program(program), m_shapes(shapes), m_jobs(jobs),
+          m_transformLocation(program.GetUniformLocation("uWorldTransform"))
+    {
+    }
+
+    /**
+     * @brief Sets how many items each command buffer records.
+     * @param itemsPerBuffer Items per recording job (at least 1).
+     */
+    void SceneRenderer::SetItemsPerCommandBuffer(size_t itemsPerBuffer)
+    {
+        m_itemsPerBuffer = std::max<size_t>(itemsPerBuffer, 1);
+    }
+
+    /**
+     * @brief Measures the GPU time of every replayed command buffer as a "DrawGroup" zone.
+     * @param profiler The profiler to use, or nullptr to stop measuring.
+     */
+    void SceneRenderer::SetGpuProfiler(GpuProfiler* profiler)
+    {
+        m_gpuProfiler = profiler;
+    }
+
+    /**
+     * @brief Gets the work submitted by the most recent Render call.
+     * @return The statistics.
+     */
+    const SceneStats& SceneRenderer::getLastFrameStats() const
+    {
+        return m_lastFrameStats;
+    }
+
+    /**
+     * @brief Gets the arena holding the transient data of the last frame.
+     * @return The arena.
+     */
+    const FrameArena& SceneRenderer::getFrameArena() const
+    {
+        return m_frameArena;
+    }
+
+    /**
+     * @brief Fills the render queue of a packet, sorted by shape and then texture.
+     * @param packet The packet to sort.
+     * @param queue The queue to fill, with room for every item of the packet.
+     */
+    void SceneRenderer::BuildQueue(const FramePacket& packet, QueueEntry* queue)
+    {
+        size_t itemCount = packet.items.size();
+        for (size_t i = 0; i < itemCount; ++i)
+        {
+            const DrawItem& item = packet.items[i];
+            queue[i].key = (static_cast<uint64_t>(item.shape) << 32) | item.texture; ///< Group by VAO, then texture
+            queue[i].index = static_cast<uint32_t>(i);
+        }
+        std::sort(queue, queue + itemCount, [](const QueueEntry& a, const QueueEntry& b) { return a.key < b.key; });
+    }
+
+    /**
+     * @brief Draws all items of a frame packet.
+     * 
+     * Sorts the render queue, records the command buffers in parallel and replays
+     * them in queue order. The previous frame's transient data is dropped first,
+     * as its command buffers have been replayed by then.
+     * 
+     * @param packet The packet to draw.
+     */
+    void SceneRenderer::Render(const FramePacket& packet)
+    {
+        GRAF_PROFILE_SCOPE("SceneRenderer::Render");
+        size_t itemCount = packet.items.size();
+        m_frameArena.Reset();
+        ArenaVector<QueueEntry> queue(itemCount, ArenaAllocator<QueueEntry>(m_frameArena));
+        BuildQueue(packet, queue.data());
+
+        size_t bufferCount = (itemCount + m_itemsPerBuffer - 1) / m_itemsPerBuffer;
+        if (m_commandBuffers.size() < bufferCount)
+            m_commandBuffers.resize(bufferCount);
+
+        m_jobs.ParallelFor(0, bufferCount, 1, [&](size_t begin, size_t end) {
+            for (size_t b = begin; b < end; ++b)
+            {
+                size_t first = b * m_itemsPerBuffer;
+                Record(packet, queue.data(), first, std::min(first + m_itemsPerBuffer, itemCount), m_commandBuffers[b]);
+            }
+        });
+
+        m_lastFrameStats = SceneStats();
+        m_lastFrameStats.items = itemCount;
+        m_lastFrameStats.commandBuffers = bufferCount;
+        for (size_t b = 0; b < bufferCount; ++b)
+        {
+            m_lastFrameStats.drawCalls += m_commandBuffers[b].getDrawCount();
+            m_lastFrameStats.triangles += m_commandBuffers[b].getTriangleCount();
+            m_lastFrameStats.stateChanges += m_commandBuffers[b].getStateChangeCount();
+        }
+
+        static MetricCounter& drawMetric = MetricsRegistry::GetCounter("graf_draw_calls_total", "Draw calls issued.");
+        static MetricCounter& triangleMetric = MetricsRegistry::GetCounter("graf_triangles_total", "Triangles submitted.");
+        static MetricGauge& itemMetric = MetricsRegistry::GetGauge("graf_scene_items", "Items drawn in the last frame.");
+        drawMetric.Increment(m_lastFrameStats.drawCalls); ///< Once per frame, not per draw
+        triangleMetric.Increment(m_lastFrameStats.triangles);
+        itemMetric.Set(static_cast<double>(itemCount));
+
+        m_program.Use(); ///< Activate shader program
+        for (size_t b = 0; b < bufferCount; ++b)
+        {
+            if (m_gpuProfiler)
+            {
+                GpuZone zone(*m_gpuProfiler, "DrawGroup");
+                m_commandBuffers[b].Replay();
+            }
+            else
+            {
+                m_commandBuffers[b].Replay(); ///< Tight submission loop on the GL thread
+            }
+        }
+
+        glBindVertexArray(0); ///< Unbind the last VAO
+        CheckGLError("Command buffer replay"); ///< Check for OpenGL errors once per frame
+    }
+
+    /**
+     * @brief Records a range of the render queue into a command buffer.
+     * 
+     * The buffer starts with no known state, so its first item always binds its VAO
+     * and texture; later items only bind what changes.
+     * 
+     * @param packet The packet that owns the items.
+     * @param queue The sorted render queue.
+     * @param begin First queue entry.
+     * @param end One past the last queue entry.
+     * @param buffer The buffer to record into (reset first).
+     */
+    void SceneRenderer::Record(const FramePacket& packet, const QueueEntry* queue, size_t begin, size_t end, CommandBuffer& buffer) const
+    {
+        GRAF_PROFILE_SCOPE("SceneRenderer::Record");
+        buffer.Reset();
+
+        const VertexArrayObject* boundVao = nullptr;
+        unsigned int boundTexture = 0;
+        bool textureBound = false;
+
+        for (size_t q = begin; q < end; ++q)
+        {
+            const DrawItem& item = packet.items[queue[q].index];
+
+            const VertexArrayObject* vao = m_shapes.getCachedShape(item.shape);
+            if (!vao)
+            {
+                std::cerr << "Draw object failed: shape not loaded" << std::endl;
+                continue;
+            }
+
+            if (vao != boundVao)
+            {
+                buffer.BindVertexArray(vao->getId());
+                boundVao = vao;
+            }
+
+            if (!textureBound || item.texture != boundTexture)
+            {
+                buffer.BindTexture(item.texture);
+                boundTexture = item.texture;
+                textureBound = true;
+            }
+
+            buffer.SetMat4(m_transformLocation, item.transform);
+            buffer.DrawElements(vao->getIndexCount());
+        }
+    }
+}
@@ -1,4 +1,6 @@
 #include "ShaderProgram.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
 #include <glad/glad.h>
 #include <iostream>
 #include <vector>
@@ -23,17 +25,35 @@ namespace graf
      */
     void ShaderProgram::Create()
     {
-        m_id = glCreateProgram(); ///< Create program handle
+        Release();
+        m_program = ProgramHandle("ShaderProgram", GRAF_GL_SITE); ///< Create program handle
     }
 
     /**
      * @brief Links the attached shaders into a complete program.
      * 
-     * Links all attached shaders to form an executable shader program in OpenGL.
+     * Links all attached shaders to form an executable shader program in OpenGL,
+     * then detaches and deletes them since the program keeps its own copy.
      */
     void ShaderProgram::Link()
     {
-        glLinkProgram(m_id);
+        GRAF_PROFILE_SCOPE("ShaderProgram::Link");
+        glLinkProgram(m_program.getId());
+
+        for (const auto& shader : m_shaders)
+            glDetachShader(m_program.getId(), shader.getId());
+        m_shaders.clear(); ///< Frees the shader objects
+    }
+
+    /**
+     * @brief Releases the program's OpenGL resources.
+     * 
+     * Deletes the program and any shaders attached but not linked yet.
+     */
+    void ShaderProgram::Release()
+    {
+        m_shaders.clear();
+        m_program.Reset();
     }
 
     /**
@@ -43,7 +63,8 @@ namespace graf
      */
     void ShaderProgram::Use()
     {
-        glUseProgram(m_id);
+        GRAF_PROFILE_SCOPE("ShaderProgram::Use");
+        glUseProgram(m_program.getId());
     }
 
     /**
@@ -57,11 +78,25 @@ namespace graf
      */
     void ShaderProgram::AttachShader(const string& fileName, unsigned int shaderType)    
     {
-        unsigned int shaderId = glCreateShader(shaderType); ///< Create shader object
+        GRAF_PROFILE_SCOPE("ShaderProgram::AttachShader");
+        AttachShaderSource(getShaderFromFile(fileName), shaderType, fileName);
+    }
 
-        string source = getShaderFromFile(fileName);
+    /**
+     * @brief Attaches a shader compiled from source code in memory.
+     * 
+     * If compilation fails, logs the error and cleans up without throwing an exception.
+     * 
+     * @param source The GLSL source code.
+     * @param shaderType The type of shader (e.g., GL_VERTEX_SHADER, GL_FRAGMENT_SHADER).
+     * @param name Name of the shader in error messages and the resource tracker.
+     */
+    void ShaderProgram::AttachShaderSource(const string& source, unsigned int shaderType, const string& name)
+    {
+        ShaderHandle shader(name, GRAF_GL_SITE, shaderType); ///< Create shader object, freed on early return
+        unsigned int shaderId = shader.getId();
 
-        const char* sourceTemp = &source[0];
+        const char* sourceTemp = source.c_str();
         glShaderSource(shaderId, 1, &sourceTemp, NULL); ///< Set shader source code
         glCompileShader(shaderId);                      ///< Compile the shader
         
@@ -74,14 +109,24 @@ namespace graf
 
             char* errorLog = new char[maxLength];
             glGetShaderInfoLog(shaderId, maxLength, &maxLength, &errorLog[0]);
-            cout << "ShaderError:" << errorLog << endl; ///< Log compilation error
+            cout << "ShaderError:" << name << ": " << errorLog << endl; ///< Log compilation error
             
-            glDeleteShader(shaderId); ///< Clean up shader object
             delete[] errorLog;        ///< Free error log memory
             return;                   ///< Exit without attaching
         }
 
-        glAttachShader(m_id, shaderId); ///< Attach compiled shader to program
+        glAttachShader(m_program.getId(), shaderId); ///< Attach compiled shader to program
+        m_shaders.push_back(std::move(shader)); ///< Deleted once linked
+    }
+
+    /**
+     * @brief Assigns a vertex attribute to a location; takes effect at the next Link.
+     * @param location The attribute location.
+     * @param attributeName The name of the attribute in the vertex shader.
+     */
+    void ShaderProgram::BindAttributeLocation(unsigned int location, const string& attributeName)
+    {
+        glBindAttribLocation(m_program.getId(), location, attributeName.c_str());
     }
 
     /**
@@ -94,6 +139,7 @@ namespace graf
      */
     string ShaderProgram::getShaderFromFile(const string& fileName) {
         auto it = shaderCache.find(fileName);
+        RenderStats::sRecordCacheLookup(StatsCache::ShaderSource, it != shaderCache.end());
         if (it != shaderCache.end()) return it->second; ///< Return cached source
 
         ifstream file(fileName);
@@ -122,7 +168,7 @@ namespace graf
      */
     void ShaderProgram::AddUniform(const string& varName)
     {
-        m_uniforms[varName] = glGetUniformLocation(m_id, varName.data());
+        m_uniforms[varName] = glGetUniformLocation(m_program.getId(), varName.data());
     }
 
     /**
@@ -192,4 +238,16 @@ namespace graf
             glUniformMatrix4fv(varLocation, 1, false, &value[0][0]); ///< Set mat4 uniform
         }
     }
+
+    /**
+     * @brief Gets the location of a uniform added with AddUniform.
+     * 
+     * @param varName The name of the uniform variable.
+     * @return The uniform location, or -1 if the uniform was not added.
+     */
+    int ShaderProgram::GetUniformLocation(const string& varName) const
+    {
+        auto it = m_uniforms.find(varName);
+        return it != m_uniforms.end() ? static_cast<int>(it->second) : -1;
+    }
 }
\ No newline at end of file
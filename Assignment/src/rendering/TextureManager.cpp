@@ -1,7 +1,11 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "TextureManager.hpp"
+#include "Profiler.hpp"
+#include "RenderStats.hpp"
+#include "Metrics.hpp"
 #include "Exceptions.hpp"
-#include "Errorcheck.hpp"
+#include "ErrorCheck.hpp"
+#include "JobSystem.hpp"
 #include <glad/glad.h>
 #include <stb/stb_image.h>
 #include <filesystem>
@@ -25,17 +29,50 @@ namespace graf
      */
     void TextureManager::sActivateTexture(const string& textureName)
     {
+        GRAF_PROFILE_SCOPE("TextureManager::sActivateTexture");
         auto manager = sGetInstance(); ///< Get singleton instance
 
         auto it = manager->m_textureMap.find(textureName);
+        RenderStats::sRecordCacheLookup(StatsCache::Texture, it != manager->m_textureMap.end());
         
         if (it == manager->m_textureMap.end()) 
             throw TextureException("Texture not found: " + textureName); ///< Throw if texture not loaded
         
-        glBindTexture(GL_TEXTURE_2D, it->second); ///< Bind texture to GL_TEXTURE_2D target
+        glBindTexture(GL_TEXTURE_2D, it->second.getId()); ///< Bind texture to GL_TEXTURE_2D target
         CheckGLError("Texture activation");       ///< Check for OpenGL errors
     }
 
+    /**
+     * @brief Looks up the OpenGL handle of a loaded texture.
+     * 
+     * @param textureName The name (file path) of the texture.
+     * @return The OpenGL texture handle.
+     * @exception TextureException Thrown if the texture is not found in the manager.
+     */
+    unsigned int TextureManager::sGetTextureHandle(const string& textureName)
+    {
+        auto manager = sGetInstance();
+
+        auto it = manager->m_textureMap.find(textureName);
+        RenderStats::sRecordCacheLookup(StatsCache::Texture, it != manager->m_textureMap.end());
+
+        if (it == manager->m_textureMap.end())
+            throw TextureException("Texture not found: " + textureName); ///< Throw if texture not loaded
+
+        return it->second.getId();
+    }
+
+    /**
+     * @brief Binds a texture by its OpenGL handle.
+     * 
+     * @param textureId The OpenGL texture handle obtained from sGetTextureHandle.
+     */
+    void TextureManager::sBindTexture(unsigned int textureId)
+    {
+        glBindTexture(GL_TEXTURE_2D, textureId); ///< Bind texture to GL_TEXTURE_2D target
+        CheckGLError("Texture activation");      ///< Check for OpenGL errors
+    }
+
     /**
      * @brief Loads a texture from a file and adds it to the manager.
      * 
@@ -47,33 +84,140 @@ namespace graf
      */
     void TextureManager::sAddTextureFromFile(const string& fileName)
     {
+        GRAF_PROFILE_SCOPE("TextureManager::sAddTextureFromFile");
         if (!std::filesystem::exists(fileName)) 
             throw TextureException("Texture file does not exist: " + fileName); ///< Check file existence
         
         auto manager = sGetInstance();
-        if (manager->m_textureMap.find(fileName) != manager->m_textureMap.end()) 
+        bool loaded = manager->m_textureMap.find(fileName) != manager->m_textureMap.end();
+        RenderStats::sRecordCacheLookup(StatsCache::Texture, loaded);
+        if (loaded) 
             return; ///< Skip if texture already loaded
         
-        int width, height, nrChannels;
-        stbi_set_flip_vertically_on_load(true); ///< Flip image vertically during load
-        unsigned char *data = stbi_load(fileName.data(), &width, &height, &nrChannels, 0); 
+        DecodedImage image = DecodeImage(fileName);
+        UploadImage(fileName, image);
+    }
+
+    /**
+     * @brief Loads several textures, decoding the image files in parallel.
+     * 
+     * Schedules a decode job per new file, each continued by a main-thread upload
+     * job, and waits for all uploads. The first error is rethrown on the calling thread.
+     * 
+     * @param fileNames The paths to the image files.
+     * @param jobs The job system used for decoding and upload.
+     * @exception TextureException Thrown if a file doesn’t exist or fails to load.
+     */
+    void TextureManager::sAddTexturesFromFiles(const vector<string>& fileNames, JobSystem& jobs)
+    {
+        GRAF_PROFILE_SCOPE("TextureManager::sAddTexturesFromFiles");
+        struct PendingTexture
+        {
+            string              fileName;
+            DecodedImage        image;
+            std::exception_ptr  error;
+        };
+
+        auto manager = sGetInstance();
+        std::vector<PendingTexture> pending;
+        for (const auto& fileName : fileNames)
+        {
+            if (!std::filesystem::exists(fileName)) 
+                throw TextureException("Texture file does not exist: " + fileName); ///< Check file existence
+
+            bool loaded = manager->m_textureMap.count(fileName) > 0;
+            RenderStats::sRecordCacheLookup(StatsCache::Texture, loaded);
+            if (!loaded)
+                pending.push_back({fileName, {}, nullptr});
+        }
+
+        std::vector<JobHandle> uploads;
+        for (auto& texture : pending)
+        {
+            JobHandle decode = jobs.Schedule([&texture]() {
+                try
+                {
+                    texture.image = DecodeImage(texture.fileName); ///< CPU-only, runs on a worker
+                }
+                catch (...)
+                {
+                    texture.error = std::current_exception();
+                }
+            });
+
+            uploads.push_back(jobs.ScheduleOnMainThread([&texture]() {
+                if (!texture.error)
+                    UploadImage(texture.fileName, texture.image); ///< GL upload
+            }, {decode}));
+        }
+
+        jobs.WaitAll(uploads); ///< Runs the uploads, as this is the main thread
+
+        for (auto& texture : pending)
+        {
+            if (texture.image.data)
+                stbi_image_free(texture.image.data); ///< Release pixels left over by a failed upload
+            if (texture.error)
+                std::rethrow_exception(texture.error);
+        }
+    }
+
+    /**
+     * @brief Decodes an image file into memory.
+     * 
+     * Uses stb_image's per-thread flip flag so concurrent decodes don't interfere.
+     * 
+     * @param fileName The path to the image file.
+     * @return The decoded image; the caller owns its pixel data.
+     * @exception TextureException Thrown if decoding fails.
+     */
+    TextureManager::DecodedImage TextureManager::DecodeImage(const string& fileName)
+    {
+        GRAF_PROFILE_SCOPE("TextureManager::DecodeImage");
+        DecodedImage image;
+        stbi_set_flip_vertically_on_load_thread(true); ///< Flip image vertically during load
+        image.data = stbi_load(fileName.data(), &image.width, &image.height, &image.channels, 0); 
         
-        if (!data) 
+        if (!image.data) 
         {
             throw TextureException("Failed to load texture: " + fileName + 
                                    " Error: " + std::string(stbi_failure_reason())); ///< Throw on load failure
         }
+        return image;
+    }
 
-        unsigned int texture;
-        glGenTextures(1, &texture);       ///< Generate texture ID
-        glBindTexture(GL_TEXTURE_2D, texture); ///< Bind texture
+    /**
+     * @brief Uploads a decoded image as an OpenGL texture and registers it.
+     * 
+     * Frees the image's pixel data after uploading.
+     * 
+     * @param fileName The name under which the texture is registered.
+     * @param image The decoded image.
+     */
+    void TextureManager::UploadImage(const string& fileName, DecodedImage& image)
+    {
+        GRAF_PROFILE_SCOPE("TextureManager::UploadImage");
+        TextureHandle texture(fileName, GRAF_GL_SITE); ///< Generate texture ID
+        glBindTexture(GL_TEXTURE_2D, texture.getId()); ///< Bind texture
         
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data); ///< Upload texture data
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image.width, image.height, 0, GL_RGB, GL_UNSIGNED_BYTE, image.data); ///< Upload texture data
         glGenerateMipmap(GL_TEXTURE_2D); ///< Generate mipmaps for texture
 
-        stbi_image_free(data); ///< Free image data
+        int64_t size = static_cast<int64_t>(image.width) * image.height * 3;
+        RenderStats::sAddUpload(static_cast<size_t>(size));
+        RenderStats::sAddTextureMemory(size * 4 / 3); ///< The mip chain adds a third
+        GpuResourceTracker::sSetSize(GpuResourceType::Texture, texture.getId(), size * 4 / 3);
+
+        static MetricCounter& loadMetric = MetricsRegistry::GetCounter("graf_texture_loads_total", "Textures uploaded.");
+        static MetricGauge& residentMetric = MetricsRegistry::GetGauge(
+            "graf_texture_resident_bytes", "Estimated GPU memory held by textures, including mipmaps.");
+        loadMetric.Increment();
+        residentMetric.Add(static_cast<double>(size * 4 / 3));
 
-        sGetInstance()->m_textureMap[fileName] = texture; ///< Store texture ID in map
+        stbi_image_free(image.data); ///< Free image data
+        image.data = nullptr;
+
+        sGetInstance()->m_textureMap[fileName] = std::move(texture); ///< Store texture in map, replacing an older one
     }
 
     /**
@@ -92,15 +236,26 @@ namespace graf
     /**
      * @brief Destructor for cleaning up texture resources.
      * 
-     * Deletes all OpenGL texture objects stored in the texture map.
+     * The texture handles delete their OpenGL objects; the map is normally
+     * already empty because sRelease ran while the context was alive.
      */
     TextureManager::~TextureManager() 
     {
-        for (const auto& [name, id] : m_textureMap) 
-        {
-            if (id != 0) 
-                glDeleteTextures(1, &id); ///< Free each texture ID
-        }
+    }
+
+    /**
+     * @brief Deletes all loaded textures while the OpenGL context is still alive.
+     * 
+     * The singleton itself lives until the end of the program, after the context
+     * is gone, so its destructor cannot be relied on to free the textures.
+     */
+    void TextureManager::sRelease()
+    {
+        if (!ms_instance)
+            return;
+
+        RenderStats::sAddTextureMemory(-GpuResourceTracker::sGetLiveBytes(GpuResourceType::Texture)); ///< All textures belong to the manager
+        ms_instance->m_textureMap.clear(); ///< The handles free each texture
     }
 
     /**
@@ -1,7 +1,5 @@
 #include <glad/glad.h>
 #include "VertexArrayObject.hpp"
-#include "VertexBuffer.hpp"
-#include "IndexBuffer.hpp"
 #include "Exceptions.hpp"
 #include "ErrorCheck.hpp"
 
@@ -15,18 +13,21 @@ namespace graf
     /**
      * @brief Creates a new OpenGL vertex array object.
      * 
-     * Generates a VAO handle and initializes its stride to zero.
+     * Generates a VAO handle and initializes its stride to zero; a VAO created
+     * earlier is released first.
      * 
      * @exception BufferException Thrown if VAO generation fails due to OpenGL error.
      */
     void VertexArrayObject::Create()
     {
-        glGenVertexArrays(1, &m_id); ///< Generate VAO ID
-        if (m_id == 0)
+        Release();
+        m_vao = VertexArrayHandle("VertexArrayObject", GRAF_GL_SITE); ///< Generate VAO ID
+        if (!m_vao)
             throw BufferException("Failed to generate Vertex Array Object"); ///< Check generation success
             
         CheckGLError("VAO generation"); ///< Verify no OpenGL errors
         m_stride = 0; ///< Initialize stride
+        m_attributes.clear();
     }
 
     /**
@@ -36,27 +37,25 @@ namespace graf
      */
     void VertexArrayObject::Bind()
     {
-        glBindVertexArray(m_id);
+        glBindVertexArray(m_vao.getId());
     }
 
     /**
-     * @brief Sets the vertex buffer for the VAO.
+     * @brief Takes ownership of the vertex buffer for the VAO.
      * 
-     * Associates the provided vertex buffer with the VAO and binds it.
+     * Moves the provided vertex buffer into the VAO and binds it; a buffer set
+     * earlier is released.
      * 
-     * @param p_vb Shared pointer to the VertexBuffer to set.
-     * @exception BufferException Thrown if the vertex buffer is null or binding fails.
+     * @param vb The VertexBuffer to take over.
+     * @exception BufferException Thrown if binding fails.
      */
-    void VertexArrayObject::SetVertexBuffer(std::shared_ptr<VertexBuffer> p_vb)
+    void VertexArrayObject::SetVertexBuffer(VertexBuffer&& vb)
     {
-        if (!p_vb) 
-            throw BufferException("Null vertex buffer"); ///< Validate input
-
-        mp_vb = p_vb; ///< Store vertex buffer pointer
+        m_vb = std::move(vb); ///< Take ownership of the vertex buffer
         try 
         {
             Bind(); ///< Bind VAO
-            mp_vb->Bind(); ///< Bind vertex buffer
+            m_vb.Bind(); ///< Bind vertex buffer
             CheckGLError("Vertex buffer binding"); ///< Check for errors
         } 
         catch (const GrafException& e) 
@@ -75,31 +74,47 @@ namespace graf
      */
     void VertexArrayObject::Draw()
     {
-        if (!mp_ib) 
+        if (m_ib.getIndexCount() == 0) 
             throw BufferException("No index buffer bound for drawing"); ///< Validate index buffer
         
-        glDrawElements(GL_TRIANGLES, mp_ib->getIndexCount(), GL_UNSIGNED_INT, 0); ///< Draw triangles
+        glDrawElements(GL_TRIANGLES, m_ib.getIndexCount(), GL_UNSIGNED_INT, 0); ///< Draw triangles
         CheckGLError("Draw call"); ///< Check for OpenGL errors
     }
 
     /**
-     * @brief Sets the index buffer for the VAO.
+     * @brief Gets the OpenGL handle of the VAO.
+     * @return The VAO handle.
+     */
+    unsigned int VertexArrayObject::getId() const
+    {
+        return m_vao.getId();
+    }
+
+    /**
+     * @brief Gets the number of indices drawn by Draw.
+     * @return The index count, or 0 if no index buffer is set.
+     */
+    int VertexArrayObject::getIndexCount() const
+    {
+        return m_ib.getIndexCount();
+    }
+
+    /**
+     * @brief Takes ownership of the index buffer for the VAO.
      * 
-     * Associates the provided index buffer with the VAO and binds it.
+     * Moves the provided index buffer into the VAO and binds it; a buffer set
+     * earlier is released.
      * 
-     * @param p_ib Shared pointer to the IndexBuffer to set.
-     * @exception BufferException Thrown if the index buffer is null or binding fails.
+     * @param ib The IndexBuffer to take over.
+     * @exception BufferException Thrown if binding fails.
      */
-    void VertexArrayObject::SetIndexBuffer(std::shared_ptr<IndexBuffer> p_ib)
+    void VertexArrayObject::SetIndexBuffer(IndexBuffer&& ib)
     {
-        if (!p_ib) 
-            throw BufferException("Null index buffer"); ///< Validate input
-        
-        mp_ib = p_ib; ///< Store index buffer pointer
+        m_ib = std::move(ib); ///< Take ownership of the index buffer
         try
         {
             Bind(); ///< Bind VAO
-            mp_ib->Bind(); ///< Bind index buffer          
+            m_ib.Bind(); ///< Bind index buffer          
             CheckGLError("Index buffer binding"); ///< Check for errors
         }
         catch (const GrafException& e) 
@@ -188,12 +203,13 @@ namespace graf
     /**
      * @brief Releases the VAO’s OpenGL resources.
      * 
-     * Deletes the VAO and releases the associated vertex buffer.
+     * Deletes the VAO and releases the associated vertex and index buffers.
      */
     void VertexArrayObject::Release()
     {
-        glDeleteVertexArrays(1, &m_id); ///< Free VAO
-        mp_vb->Release(); ///< Release vertex buffer
+        m_vao.Reset(); ///< Free VAO
+        m_vb.Release(); ///< Release vertex buffer
+        m_ib.Release(); ///< Release index buffer
     }
 
     /**
@@ -204,7 +220,7 @@ namespace graf
     void VertexArrayObject::Unbind()
     {
         glBindVertexArray(0); ///< Unbind VAO
-        mp_ib->Unbind(); ///< Unbind index buffer
-        mp_vb->Unbind(); ///< Unbind vertex buffer
+        m_ib.Unbind(); ///< Unbind index buffer
+        m_vb.Unbind(); ///< Unbind vertex buffer
     }
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "VertexBuffer.hpp"
 #include "Exceptions.hpp"
 #include "ErrorCheck.hpp"
+#include "RenderStats.hpp"
+#include "GpuResourceTracker.hpp"
 #include <glad/glad.h>
 
 /**
@@ -10,6 +12,30 @@
 
 namespace graf
 {
+    /**
+     * @brief Releases the buffer if it is still owned.
+     */
+    VertexBuffer::~VertexBuffer()
+    {
+        Release();
+    }
+
+    /**
+     * @brief Releases the owned buffer and takes over the buffer of another instance.
+     * @param other The buffer to move from.
+     * @return This buffer.
+     */
+    VertexBuffer& VertexBuffer::operator=(VertexBuffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Release(); ///< Keeps the memory statistics balanced
+            m_buffer = std::move(other.m_buffer);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
     /**
      * @brief Creates an OpenGL vertex buffer with the specified data.
      * 
@@ -25,14 +51,21 @@ namespace graf
         if (data == nullptr || size <= 0)
             throw BufferException("Invalid vertex buffer data or size"); ///< Validate input
 
-        glGenBuffers(1, &m_id); ///< Generate buffer ID
-        if (m_id == 0)
+        Release(); ///< Replace previous contents
+
+        m_buffer = BufferHandle("VertexBuffer", GRAF_GL_SITE); ///< Generate buffer ID
+        if (!m_buffer)
             throw BufferException("Failed to generate vertex buffer"); ///< Check generation success
 
-        glBindBuffer(GL_ARRAY_BUFFER, m_id); ///< Bind buffer to GL_ARRAY_BUFFER target
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer.getId()); ///< Bind buffer to GL_ARRAY_BUFFER target
         glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW); ///< Upload data to GPU
 
         CheckGLError("Vertex Buffer Creation"); ///< Check for OpenGL errors
+
+        m_size = size;
+        GpuResourceTracker::sSetSize(GpuResourceType::Buffer, m_buffer.getId(), size);
+        RenderStats::sAddUpload(size);
+        RenderStats::sAddMeshMemory(size);
     }
 
     /**
@@ -43,7 +76,7 @@ namespace graf
      */
     void VertexBuffer::Bind()
     {
-        glBindBuffer(GL_ARRAY_BUFFER, m_id);
+        glBindBuffer(GL_ARRAY_BUFFER, m_buffer.getId());
     }
 
     /**
@@ -64,10 +97,11 @@ namespace graf
      */
     void VertexBuffer::Release()
     {
-        if (m_id != 0) 
+        if (m_buffer) 
         {
-            glDeleteBuffers(1, &m_id); ///< Free GPU memory
-            m_id = 0;                  ///< Reset handle to indicate deletion
+            m_buffer.Reset(); ///< Free GPU memory
+            RenderStats::sAddMeshMemory(-m_size);
+            m_size = 0;
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "Scene.hpp"
+#include "TextureManager.hpp"
+#include "Frustum.hpp"
+#include "FrameArena.hpp"
+#include "Metrics.hpp"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+/**
+ * @file Scene.cpp
+ * @brief Implementation of scene persistence and frame packet building.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const float  OBJECT_BOUNDING_RADIUS = 1.5f; ///< Bounding sphere radius of the unit shapes; the frustum's base corners at (±1, -0.5, ±1) are the farthest vertices.
+        const size_t OBJECTS_PER_JOB        = 256;  ///< Grain size for per-object parallel work.
+    }
+
+    /**
+     * @brief Saves the state of objects to a JSON file.
+     * 
+     * @param objects Vector of ObjectData containing the objects to save.
+     * @param filename The path to the JSON file where data will be saved.
+     */
+    void saveObjectsToJson(const std::vector<ObjectData>& objects, const std::string& filename) 
+    {
+        auto start = std::chrono::steady_clock::now();
+        json j;
+        for (const auto& obj : objects) 
+        {
+            j.push_back({
+                {"position_x", obj.position.x},
+                {"position_y", obj.position.y},
+                {"position_z", obj.position.z},
+                {"angle", obj.angle},
+                {"texture", obj.texture},
+                {"shape_type", static_cast<int>(obj.shape)}
+            });
+        }
+
+        std::ofstream file(filename);
+        if (file.is_open()) 
+        {
+            file << std::setw(4) << j << std::endl;
+            file.close();
+        }
+        else 
+        {
+            std::cerr << "Failed to open file for writing: " << filename << std::endl;
+            return;
+        }
+
+        static MetricHistogram& saveMetric = MetricsRegistry::GetHistogram(
+            "graf_scene_save_seconds", "Time to write the object list to JSON.", MetricsRegistry::GetDurationBuckets());
+        saveMetric.Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    /**
+     * @brief Loads the state of objects from a JSON file.
+     * 
+     * @param filename The path to the JSON file to read from.
+     * @param jobs The job system used to convert the entries.
+     * @return Vector of ObjectData loaded from the file, or empty if loading fails.
+     */
+    std::vector<ObjectData> loadObjectsFromJson(const std::string& filename, JobSystem& jobs) 
+    {
+        std::vector<ObjectData> objects;
+        std::ifstream file(filename);
+        if (!file.is_open()) 
+        {
+            std::cerr << "Failed to open file for reading: " << filename << std::endl;
+            return objects; ///< Return empty vector on failure
+        }
+
+        json j;
+        try 
+        {
+            file >> j;
+            if (!j.is_array())
+            {
+                std::cerr << "JSON parsing error: object list must be an array" << std::endl;
+                return objects; ///< Return empty vector on unexpected layout
+            }
+
+            const json& items = j; ///< Const access so concurrent lookups never insert
+            objects.resize(items.size());
+            std::vector<std::string> errors(items.size());
+
+            jobs.ParallelFor(0, items.size(), OBJECTS_PER_JOB, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    try
+                    {
+                        const json& item = items[i];
+                        ObjectData& obj = objects[i];
+                        obj.position.x = item.at("position_x").get<float>();
+                        obj.position.y = item.at("position_y").get<float>();
+                        obj.position.z = item.at("position_z").get<float>();
+                        obj.angle = item.at("angle").get<float>();
+                        obj.texture = item.at("texture").get<std::string>();
+                        obj.shape = static_cast<ShapeTypes>(item.at("shape_type").get<int>());
+                    }
+                    catch (const json::exception& e)
+                    {
+                        errors[i] = e.what(); ///< Reported after the loop, on the calling thread
+                    }
+                }
+            });
+
+            for (const auto& error : errors)
+            {
+                if (!error.empty())
+                {
+                    std::cerr << "JSON parsing error: " << error << std::endl;
+                    objects.clear();
+                    break;
+                }
+            }
+        }
+        catch (const json::exception& e) 
+        {
+            std::cerr << "JSON parsing error: " << e.what() << std::endl;
+            objects.clear();
+        }
+
+        file.close();
+        return objects;
+    }
+
+    /**
+     * @brief Builds the world transform of an object.
+     * 
+     * Applies translation, rotation around the Y-axis, and scaling in that order.
+     * 
+     * @param position The object’s position in 3D space.
+     * @param angle The rotation angle around the Y-axis in degrees.
+     * @param scale The uniform scale factor for the object.
+     * @return The combined world transform.
+     */
+    glm::mat4 BuildWorldMatrix(const glm::vec3& position, float angle, float scale)
+    {
+        glm::mat4 matTranslate = glm::translate(glm::mat4(1), position); ///< Translation matrix
+        glm::mat4 matRotation = glm::rotate(glm::mat4(1), glm::radians(angle), glm::vec3(0.0f, 1.0f, 0.0f)); ///< Rotation matrix (Y-axis)
+        glm::mat4 matScale = glm::scale(glm::mat4(1), glm::vec3(scale, scale, 1.0f)); ///< Scaling matrix
+        return matTranslate * matRotation * matScale; ///< Combined world transform
+    }
+
+    /**
+     * @brief Fills a frame packet with the visible objects of a scene.
+     * 
+     * Every object is culled and transformed into its slot of the packet in parallel,
+     * then the visible slots are compacted in place on the calling thread.
+     * 
+     * @param objects The scene objects.
+     * @param viewProjection The combined projection and view matrix.
+     * @param scale The uniform scale factor applied to all objects.
+     * @param packet The packet to fill; its previous items are replaced.
+     * @param jobs The job system used for the per-object work.
+     */
+    void BuildFramePacket(const std::vector<ObjectData>& objects, const glm::mat4& viewProjection,
+                          float scale, FramePacket& packet, JobSystem& jobs)
+    {
+        BuildFramePacket(objects, objects, 1.0f, viewProjection, scale, packet, jobs);
+    }
+
+    /**
+     * @brief Fills a frame packet with objects interpolated between two simulation ticks.
+     * 
+     * Every object is blended, culled and transformed into its slot of the packet in
+     * parallel, then the visible slots are compacted in place on the calling thread.
+     * 
+     * @param previous The scene objects as of the tick before the latest one.
+     * @param objects The scene objects as of the latest tick.
+     * @param alpha Blend factor in [0, 1]; 0 is the previous state, 1 the current one.
+     * @param viewProjection The combined projection and view matrix.
+     * @param scale The uniform scale factor applied to all objects.
+     * @param packet The packet to fill; its previous items are replaced.
+     * @param jobs The job system used for the per-object work.
+     */
+    void BuildFramePacket(const std::vector<ObjectData>& previous, const std::vector<ObjectData>& objects,
+                          float alpha, const glm::mat4& viewProjection, float scale,
+                          FramePacket& packet, JobSystem& jobs)
+    {
+        static thread_local LinearArena scratch(16 * 1024); ///< Transient data of the calling thread's current frame
+        scratch.Reset();
+        unsigned char* visible = scratch.AllocateArray<unsigned char>(objects.size()); ///< Shared with the jobs, which run on other threads
+
+        Frustum frustum(viewProjection);
+        float radius = OBJECT_BOUNDING_RADIUS * std::max(scale, 1.0f); ///< The scale leaves z unchanged, so shrinking does not shrink the bounds
+
+        packet.viewProjection = viewProjection;
+        packet.items.resize(objects.size());
+
+        jobs.ParallelFor(0, objects.size(), OBJECTS_PER_JOB, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const ObjectData& obj = objects[i];
+                const ObjectData& prev = i < previous.size() ? previous[i] : obj;
+                glm::vec3 position = glm::mix(prev.position, obj.position, alpha);
+                float angle = prev.angle + (obj.angle - prev.angle) * alpha;
+
+                visible[i] = frustum.IntersectsSphere(position, radius);
+                if (!visible[i])
+                    continue;
+
+                try
+                {
+                    DrawItem& item = packet.items[i];
+                    item.shape = obj.shape;
+                    item.transform = viewProjection * BuildWorldMatrix(position, angle, scale);
+                    item.texture = TextureManager::sGetTextureHandle(obj.texture);
+                }
+                catch (const std::exception& e)
+                {
+                    visible[i] = false; ///< Skip the object, as a failed draw would
+                    std::cerr << "Draw object failed: " << e.what() << std::endl;
+                }
+            }
+        });
+
+        size_t visibleCount = 0;
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            if (visible[i])
+                packet.items[visibleCount++] = packet.items[i]; ///< Stable compaction
+        }
+        packet.items.resize(visibleCount);
+    }
+}
@@ -0,0 +1,145 @@
+#include "SceneGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+/**
+ * @file SceneGenerator.cpp
+ * @brief Implementation of the synthetic scene generator.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const float  HEIGHT_RATIO     = 0.25f;  ///< Vertical size of the volume relative to its width.
+        const float  CLUSTER_SPREAD   = 0.05f;  ///< Standard deviation of a cluster relative to the extent.
+        const float  MOTION_RADIUS    = 1.5f;   ///< Radius of the circle an animated object follows.
+        const float  MOTION_SPEED     = 1.0f;   ///< Angular speed of the circling in radians per second.
+        const float  SPIN_SPEED       = 90.0f;  ///< Spin of an animated object in degrees per second.
+        const char*  SHAPE_NAMES[SHAPE_TYPE_COUNT] = {"circle", "square", "cube", "pyramid", "frustum"}; ///< Indexed by ShapeTypes.
+    }
+
+    /**
+     * @brief Generates a scene; the same settings and textures always give the same scene.
+     * @param settings The scene parameters.
+     * @param textures Texture files to assign, which must be loaded before drawing.
+     * @return The scene.
+     */
+    GeneratedScene GenerateScene(const SceneGeneratorSettings& settings, const std::vector<std::string>& textures)
+    {
+        size_t textureCount = std::min(std::max<size_t>(settings.textureCount, 1), textures.size());
+        if (textureCount == 0)
+            throw std::invalid_argument("Scene generation needs at least one texture");
+
+        const auto& weights = settings.shapeWeights;
+        if (std::any_of(weights.begin(), weights.end(), [](float w) { return w < 0.0f; }) ||
+            std::all_of(weights.begin(), weights.end(), [](float w) { return w == 0.0f; }))
+            throw std::invalid_argument("Scene generation needs non-negative shape weights, one of them positive");
+
+        std::mt19937_64 gen(settings.seed);
+        std::discrete_distribution<int> shape(weights.begin(), weights.end());
+        std::uniform_int_distribution<size_t> texture(0, textureCount - 1);
+        std::uniform_real_distribution<float> horizontal(-settings.extent, settings.extent);
+        std::uniform_real_distribution<float> vertical(-settings.extent * HEIGHT_RATIO, settings.extent * HEIGHT_RATIO);
+        std::uniform_real_distribution<float> angle(0.0f, 360.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        std::vector<glm::vec3> clusters(std::max<size_t>(settings.clusterCount, 1));
+        for (auto& centre : clusters)
+            centre = glm::vec3(horizontal(gen), vertical(gen), horizontal(gen));
+        std::uniform_int_distribution<size_t> cluster(0, clusters.size() - 1);
+        std::normal_distribution<float> offset(0.0f, settings.extent * CLUSTER_SPREAD);
+
+        size_t gridSide = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(settings.objectCount))));
+        float gridSpacing = gridSide > 1 ? 2.0f * settings.extent / static_cast<float>(gridSide - 1) : 0.0f;
+
+        GeneratedScene scene;
+        scene.objects.resize(settings.objectCount);
+        for (size_t i = 0; i < settings.objectCount; ++i)
+        {
+            ObjectData& obj = scene.objects[i];
+            switch (settings.distribution)
+            {
+            case SpatialDistribution::Uniform:
+                obj.position = glm::vec3(horizontal(gen), vertical(gen), horizontal(gen));
+                break;
+            case SpatialDistribution::Clustered:
+                obj.position = clusters[cluster(gen)] + glm::vec3(offset(gen), offset(gen), offset(gen));
+                break;
+            case SpatialDistribution::Grid:
+                obj.position = glm::vec3(-settings.extent + gridSpacing * static_cast<float>(i % gridSide), 0.0f,
+                                         -settings.extent + gridSpacing * static_cast<float>(i / gridSide));
+                break;
+            }
+            obj.angle = angle(gen);
+            obj.shape = static_cast<ShapeTypes>(shape(gen));
+            obj.texture = textures[texture(gen)];
+
+            if (unit(gen) < settings.motionFraction)
+            {
+                scene.moving.push_back(i);
+                scene.anchors.push_back(obj.position);
+                scene.phases.push_back(unit(gen) * 6.2831853f);
+            }
+        }
+        return scene;
+    }
+
+    /**
+     * @brief Moves the animated objects of a scene to their state at a point in time.
+     * @param scene The scene to update.
+     * @param time Seconds since the start of the animation.
+     */
+    void AnimateScene(GeneratedScene& scene, double time)
+    {
+        float t = static_cast<float>(time);
+        for (size_t k = 0; k < scene.moving.size(); ++k)
+        {
+            ObjectData& obj = scene.objects[scene.moving[k]];
+            float phase = scene.phases[k] + MOTION_SPEED * t;
+            obj.position = scene.anchors[k] + MOTION_RADIUS * glm::vec3(std::cos(phase), 0.0f, std::sin(phase));
+            obj.angle = std::fmod(glm::degrees(scene.phases[k]) + SPIN_SPEED * t, 360.0f);
+        }
+    }
+
+    /**
+     * @brief Parses a spatial distribution from its command-line name.
+     * @param name One of "uniform", "clustered" or "grid".
+     * @return The distribution.
+     */
+    SpatialDistribution ParseSpatialDistribution(const std::string& name)
+    {
+        if (name == "uniform")   return SpatialDistribution::Uniform;
+        if (name == "clustered") return SpatialDistribution::Clustered;
+        if (name == "grid")      return SpatialDistribution::Grid;
+        throw std::invalid_argument("Unknown spatial distribution: " + name);
+    }
+
+    /**
+     * @brief Parses shape weights such as "cube=4,pyramid=1"; unnamed shapes get weight 0.
+     * @param mix Comma-separated name=weight pairs.
+     * @return The weights, indexed by ShapeTypes.
+     */
+    std::array<float, SHAPE_TYPE_COUNT> ParseShapeMix(const std::string& mix)
+    {
+        std::array<float, SHAPE_TYPE_COUNT> weights{};
+        std::stringstream stream(mix);
+        std::string pair;
+        while (std::getline(stream, pair, ','))
+        {
+            size_t separator = pair.find('=');
+            if (separator == std::string::npos)
+                throw std::invalid_argument("Expected <shape>=<weight> in shape mix: " + pair);
+
+            std::string name = pair.substr(0, separator);
+            auto it = std::find(std::begin(SHAPE_NAMES), std::end(SHAPE_NAMES), name);
+            if (it == std::end(SHAPE_NAMES))
+                throw std::invalid_argument("Unknown shape in shape mix: " + name);
+            weights[static_cast<size_t>(it - std::begin(SHAPE_NAMES))] = std::stof(pair.substr(separator + 1));
+        }
+        return weights;
+    }
+}
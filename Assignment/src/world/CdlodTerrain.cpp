@@ -0,0 +1,580 @@
+#include "CdlodTerrain.hpp"
+#include "Exceptions.hpp"
+#include "ErrorCheck.hpp"
+#include "Frustum.hpp"
+#include "GpuResourceTracker.hpp"
+#include "Profiler.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file CdlodTerrain.cpp
+ * @brief Implementation of the CdlodTerrain class.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const int32_t KEY_BIAS = 1 << 28;           ///< Makes node indices non-negative for packing.
+        const uint64_t KEY_MASK = (1ull << 29) - 1; ///< Bits of a packed node index.
+        const int MAX_GRID_SIZE = 128;              ///< Largest grid; vertex coordinates are stored as bytes.
+    }
+
+    /**
+     * @brief Creates the grid mesh and the height texture; no tile is generated before the first Update.
+     *
+     * The level count is the smallest one whose coarsest range reaches the view
+     * distance. A level's morphing ends at its range and starts morphStart of the
+     * way there from the next finer level's range.
+     *
+     * @param jobs The job system that generates the tiles.
+     * @param program The program drawing the terrain.
+     * @param settings The terrain parameters.
+     * @exception WorldException Thrown if the grid size is not a power of two of at least 2 and at most 128.
+     */
+    CdlodTerrain::CdlodTerrain(JobSystem& jobs, ShaderProgram& program, const CdlodTerrainSettings& settings)
+        : m_jobs(jobs), m_program(program), m_settings(settings), m_terrain(settings.terrain)
+    {
+        int grid = m_settings.gridSize;
+        if (grid < 2 || grid > MAX_GRID_SIZE || (grid & (grid - 1)) != 0)
+            throw WorldException("The terrain grid size must be a power of two from 2 to 128, not " + to_string(grid));
+        m_settings.leafSize = max(m_settings.leafSize, 1.0f);
+        m_settings.lodRatio = max(m_settings.lodRatio, 1.5f);
+        m_settings.morphStart = clamp(m_settings.morphStart, 0.0f, 0.95f);
+        m_settings.maxTiles = max<size_t>(m_settings.maxTiles, 1);
+
+        while (m_topLevel < MAX_LEVELS - 1 && m_settings.lodRatio * NodeWidth(m_topLevel) < m_settings.viewDistance)
+            ++m_topLevel;
+        for (int32_t level = 0; level <= m_topLevel; ++level)
+        {
+            float range = m_settings.lodRatio * NodeWidth(level);
+            float finerRange = level > 0 ? m_ranges.back() : 0.0f;
+            m_ranges.push_back(range);
+            m_morphRanges.emplace_back(finerRange + (range - finerRange) * m_settings.morphStart, range);
+        }
+
+        vector<uint8_t> vertices;
+        for (int y = 0; y <= grid; ++y)
+        {
+            for (int x = 0; x <= grid; ++x)
+                vertices.insert(vertices.end(), {static_cast<uint8_t>(x), static_cast<uint8_t>(y)});
+        }
+        vector<uint32_t> indices;
+        int half = grid / 2;
+        for (int quadrant = 0; quadrant < 4; ++quadrant)
+        {
+            int firstX = (quadrant & 1) * half, firstY = (quadrant >> 1) * half;
+            for (int y = firstY; y < firstY + half; ++y)
+            {
+                for (int x = firstX; x < firstX + half; ++x)
+                {
+                    uint32_t corner = static_cast<uint32_t>(y * (grid + 1) + x);
+                    uint32_t above = corner + static_cast<uint32_t>(grid + 1);
+                    indices.insert(indices.end(), {corner, corner + 1, above + 1, corner, above + 1, above});
+                }
+            }
+        }
+
+        m_gridArray = VertexArrayHandle("CdlodTerrain", GRAF_GL_SITE);
+        m_gridVertices = BufferHandle("CdlodTerrain", GRAF_GL_SITE);
+        m_heightTexture = TextureHandle("CdlodTerrain", GRAF_GL_SITE);
+        if (!m_gridArray || !m_gridVertices || !m_heightTexture)
+            throw BufferException("Failed to create the terrain's GL objects");
+
+        glBindVertexArray(m_gridArray.getId());
+        glBindBuffer(GL_ARRAY_BUFFER, m_gridVertices.getId());
+        glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size()), vertices.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_UNSIGNED_BYTE, GL_FALSE, 2, nullptr);
+        m_gridIndices.Create(indices.data(), static_cast<int>(indices.size() * sizeof(uint32_t))); ///< Binds to the vertex array
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        GpuResourceTracker::sSetSize(GpuResourceType::Buffer, m_gridVertices.getId(), static_cast<int64_t>(vertices.size()));
+
+        m_tileSamples = grid + 3;
+        GLsizei layers = static_cast<GLsizei>(m_settings.maxTiles);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_heightTexture.getId());
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R32F, m_tileSamples, m_tileSamples, layers, 0, GL_RED, GL_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        GpuResourceTracker::sSetSize(GpuResourceType::Texture, m_heightTexture.getId(),
+                                     static_cast<int64_t>(m_tileSamples) * m_tileSamples * layers * static_cast<int64_t>(sizeof(float)));
+        for (size_t layer = m_settings.maxTiles; layer > 0; --layer)
+            m_freeLayers.push_back(static_cast<uint32_t>(layer - 1));
+
+        for (const char* uniform : {"uViewProjection", "uCamera", "uNode", "uMorph", "uGridSize", "uHeights", "uFog"})
+            m_program.AddUniform(uniform);
+        float fogDistance = max(m_settings.viewDistance, 1.0f);
+        m_program.Use();
+        glUniform1i(m_program.GetUniformLocation("uHeights"), 0);
+        m_program.SetFloat("uGridSize", static_cast<float>(grid));
+        m_program.SetVec4("uFog", glm::vec4(m_settings.fogColor, 1.0f / (fogDistance * fogDistance)));
+        CheckGLError("CdlodTerrain Creation");
+    }
+
+    /**
+     * @brief Waits for the generation jobs and releases the GL objects.
+     */
+    CdlodTerrain::~CdlodTerrain()
+    {
+        Release();
+    }
+
+    /**
+     * @brief Streams the terrain for a view: uploads finished tiles, selects nodes and schedules generation.
+     *
+     * The quadtree roots are the coarsest nodes within the view distance; the
+     * selection descends from each of them.
+     *
+     * @param viewProjection The combined projection and view matrix.
+     * @param camera The camera position.
+     */
+    void CdlodTerrain::Update(const glm::mat4& viewProjection, const glm::vec3& camera)
+    {
+        GRAF_PROFILE_SCOPE("CdlodTerrain::Update");
+        ++m_frame;
+        PruneJobs();
+        ApplyResults();
+
+        m_selected.clear();
+        m_stats.culledNodes = 0;
+        Frustum frustum(viewProjection);
+        float rootWidth = NodeWidth(m_topLevel);
+        float reach = m_settings.viewDistance;
+        int32_t firstX = static_cast<int32_t>(floor((camera.x - reach) / rootWidth));
+        int32_t lastX = static_cast<int32_t>(floor((camera.x + reach) / rootWidth));
+        int32_t firstY = static_cast<int32_t>(floor((camera.y - reach) / rootWidth));
+        int32_t lastY = static_cast<int32_t>(floor((camera.y + reach) / rootWidth));
+        for (int32_t x = firstX; x <= lastX; ++x)
+        {
+            for (int32_t y = firstY; y <= lastY; ++y)
+            {
+                NodeKey root{x, y, m_topLevel};
+                if (IsInRange(root, camera, reach))
+                    SelectNode(root, camera, frustum);
+            }
+        }
+
+        ScheduleGeneration();
+        UnloadTiles();
+
+        m_stats.levels = m_topLevel + 1;
+        m_stats.residentTiles = 0;
+        m_stats.pendingTiles = 0;
+        for (const auto& entry : m_tiles)
+        {
+            if (entry.second.state == TileState::Ready)
+                ++m_stats.residentTiles;
+            else
+                ++m_stats.pendingTiles;
+        }
+        m_stats.generationJobs = m_jobsInFlight;
+        m_stats.selectedNodes = m_selected.size();
+        m_stats.generatedTiles = m_generatedTiles;
+        m_stats.tileCapacity = m_settings.maxTiles;
+    }
+
+    /**
+     * @brief Draws the nodes selected by the last Update.
+     *
+     * All nodes share the grid mesh and the height texture, so a node costs two
+     * uniform changes and one draw, or one per quadrant if it is drawn in part.
+     *
+     * @param viewProjection The combined projection and view matrix.
+     * @param camera The camera position.
+     */
+    void CdlodTerrain::Render(const glm::mat4& viewProjection, const glm::vec3& camera)
+    {
+        GRAF_PROFILE_SCOPE("CdlodTerrain::Render");
+        m_program.Use();
+        m_program.SetMat4("uViewProjection", viewProjection);
+        m_program.SetVec3("uCamera", camera);
+        int nodeLocation = m_program.GetUniformLocation("uNode");
+        int morphLocation = m_program.GetUniformLocation("uMorph");
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_heightTexture.getId());
+        glBindVertexArray(m_gridArray.getId());
+
+        GLsizei quadrantIndices = static_cast<GLsizei>(m_settings.gridSize * m_settings.gridSize / 4 * 6);
+        m_stats.drawCalls = 0;
+        m_stats.triangles = 0;
+        for (const DrawItem& item : m_selected)
+        {
+            float width = NodeWidth(item.key.level);
+            const glm::vec2& morph = m_morphRanges[item.key.level];
+            glUniform4f(nodeLocation, static_cast<float>(item.key.x) * width, static_cast<float>(item.key.y) * width, width,
+                        static_cast<float>(item.layer));
+            glUniform2f(morphLocation, morph.x, morph.y);
+            if (item.quadrants == 0xF)
+            {
+                glDrawElements(GL_TRIANGLES, quadrantIndices * 4, GL_UNSIGNED_INT, nullptr);
+                ++m_stats.drawCalls;
+                m_stats.triangles += static_cast<uint64_t>(quadrantIndices) * 4 / 3;
+                continue;
+            }
+            for (uint32_t quadrant = 0; quadrant < 4; ++quadrant)
+            {
+                if ((item.quadrants & (1u << quadrant)) == 0)
+                    continue;
+                const void* offset = reinterpret_cast<const void*>(quadrant * quadrantIndices * sizeof(uint32_t));
+                glDrawElements(GL_TRIANGLES, quadrantIndices, GL_UNSIGNED_INT, offset);
+                ++m_stats.drawCalls;
+                m_stats.triangles += static_cast<uint64_t>(quadrantIndices) / 3;
+            }
+        }
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    }
+
+    /**
+     * @brief Gets the terrain's height function.
+     * @return The height field.
+     */
+    const HeightField& CdlodTerrain::GetTerrain() const
+    {
+        return m_terrain;
+    }
+
+    /**
+     * @brief Gets the streaming state and the work of the last frame.
+     * @return The statistics.
+     */
+    const CdlodTerrainStats& CdlodTerrain::GetStats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * @brief Waits for the generation jobs and deletes all GL objects; must be called while the context is current.
+     */
+    void CdlodTerrain::Release()
+    {
+        m_jobs.WaitAll(m_tileJobs);
+        m_tileJobs.clear();
+        m_results.clear();
+        m_pendingResults.clear();
+        m_jobsInFlight = 0;
+        m_tiles.clear();
+        m_selected.clear();
+        m_freeLayers.clear();
+        m_gridIndices.Release();
+        m_gridVertices.Reset();
+        m_gridArray.Reset();
+        m_heightTexture.Reset();
+    }
+
+    /**
+     * @brief Packs a node position into a hash map key.
+     * @param key The node.
+     * @return The key.
+     */
+    uint64_t CdlodTerrain::PackKey(const NodeKey& key)
+    {
+        return (static_cast<uint64_t>(key.level) << 58) |
+               ((static_cast<uint64_t>(key.x + KEY_BIAS) & KEY_MASK) << 29) |
+               (static_cast<uint64_t>(key.y + KEY_BIAS) & KEY_MASK);
+    }
+
+    /**
+     * @brief Gets the width of the nodes of a level.
+     * @param level The level.
+     * @return The width in world units.
+     */
+    float CdlodTerrain::NodeWidth(int32_t level) const
+    {
+        return ldexp(m_settings.leafSize, level);
+    }
+
+    /**
+     * @brief Gets the bounding box of a node, tight once its tile is resident.
+     *
+     * Without a tile the box spans every height the terrain can have.
+     *
+     * @param key The node.
+     * @param boxMin Receives the minimum corner.
+     * @param boxMax Receives the maximum corner.
+     */
+    void CdlodTerrain::NodeBounds(const NodeKey& key, glm::vec3& boxMin, glm::vec3& boxMax) const
+    {
+        float width = NodeWidth(key.level);
+        boxMin = glm::vec3(static_cast<float>(key.x) * width, static_cast<float>(key.y) * width, 0.0f);
+        boxMax = glm::vec3(boxMin.x + width, boxMin.y + width, m_terrain.GetMaxHeight());
+        auto it = m_tiles.find(PackKey(key));
+        if (it != m_tiles.end() && it->second.state == TileState::Ready)
+        {
+            boxMin.z = it->second.minHeight;
+            boxMax.z = it->second.maxHeight;
+        }
+    }
+
+    /**
+     * @brief Checks whether a node's bounding box comes within a distance of the camera.
+     * @param key The node.
+     * @param camera The camera position.
+     * @param distance The distance.
+     * @return True if any point of the box is within the distance.
+     */
+    bool CdlodTerrain::IsInRange(const NodeKey& key, const glm::vec3& camera, float distance) const
+    {
+        glm::vec3 boxMin, boxMax;
+        NodeBounds(key, boxMin, boxMax);
+        glm::vec3 offset = glm::max(glm::max(boxMin - camera, camera - boxMax), glm::vec3(0.0f));
+        return glm::dot(offset, offset) <= distance * distance;
+    }
+
+    /**
+     * @brief Selects the nodes covering a quadtree node and requests the missing tiles.
+     *
+     * A node within the next finer level's range is split: children within that
+     * range are selected recursively and the other quadrants are drawn with this
+     * node. Every node on the way down is requested, so a node's parent is usually
+     * resident and drawn while the node's tile is still generating.
+     *
+     * @param key The node.
+     * @param camera The camera position.
+     * @param frustum The view frustum.
+     * @return True if the node is covered by drawable nodes or culled.
+     */
+    bool CdlodTerrain::SelectNode(const NodeKey& key, const glm::vec3& camera, const Frustum& frustum)
+    {
+        glm::vec3 boxMin, boxMax;
+        NodeBounds(key, boxMin, boxMax);
+        if (!frustum.IntersectsBox(boxMin, boxMax))
+        {
+            ++m_stats.culledNodes;
+            return true;
+        }
+
+        const Tile& tile = RequestTile(key, camera);
+        bool ready = tile.state == TileState::Ready; ///< The reference may not survive the requests of the children
+        uint32_t layer = tile.layer;
+
+        uint32_t quadrants = 0xF;
+        bool covered = true;
+        size_t mark = m_selected.size();
+        if (key.level > 0 && IsInRange(key, camera, m_ranges[key.level - 1]))
+        {
+            quadrants = 0;
+            for (uint32_t child = 0; child < 4; ++child)
+            {
+                NodeKey childKey{key.x * 2 + static_cast<int32_t>(child & 1), key.y * 2 + static_cast<int32_t>(child >> 1), key.level - 1};
+                if (IsInRange(childKey, camera, m_ranges[key.level - 1]))
+                {
+                    covered = SelectNode(childKey, camera, frustum) && covered;
+                    continue;
+                }
+                NodeBounds(childKey, boxMin, boxMax);
+                if (frustum.IntersectsBox(boxMin, boxMax))
+                    quadrants |= 1u << child;
+            }
+        }
+
+        if (covered && (quadrants == 0 || ready))
+        {
+            if (quadrants != 0)
+                m_selected.push_back({key, layer, quadrants});
+            return true;
+        }
+        if (!ready)
+            return false; ///< Draws the children that are ready, leaving gaps until the rest are
+
+        m_selected.resize(mark); ///< Draws this node until all children are ready
+        m_selected.push_back({key, layer, 0xF});
+        return true;
+    }
+
+    /**
+     * @brief Gets a tile, requesting it if it is not resident yet, and marks it used.
+     * @param key The node.
+     * @param camera The camera position.
+     * @return The tile.
+     */
+    CdlodTerrain::Tile& CdlodTerrain::RequestTile(const NodeKey& key, const glm::vec3& camera)
+    {
+        auto inserted = m_tiles.try_emplace(PackKey(key));
+        Tile& tile = inserted.first->second;
+        if (inserted.second)
+        {
+            tile.key = key;
+            tile.id = m_nextTileId++;
+        }
+        float width = NodeWidth(key.level);
+        glm::vec2 centre((static_cast<float>(key.x) + 0.5f) * width, (static_cast<float>(key.y) + 0.5f) * width);
+        tile.priority = glm::length(centre - glm::vec2(camera));
+        tile.lastUsedFrame = m_frame;
+        return tile;
+    }
+
+    /**
+     * @brief Starts generation jobs for queued tiles up to the job limit, coarsest and nearest first.
+     *
+     * Coarse tiles go first because they are the fallback of everything below
+     * them. A job samples the height field once per texel, including a border of
+     * one sample for the normals, and records the range of the grid vertices'
+     * heights for the node's bounding box.
+     */
+    void CdlodTerrain::ScheduleGeneration()
+    {
+        GRAF_PROFILE_SCOPE("CdlodTerrain::ScheduleGeneration");
+        size_t limit = m_settings.maxJobs > 0 ? m_settings.maxJobs : max<size_t>(2 * m_jobs.GetWorkerCount(), 1);
+        if (m_jobsInFlight >= limit)
+            return;
+
+        m_queue.clear();
+        for (auto& entry : m_tiles)
+        {
+            if (entry.second.state == TileState::Queued)
+                m_queue.push_back(&entry.second);
+        }
+
+        size_t count = min(limit - m_jobsInFlight, m_queue.size());
+        partial_sort(m_queue.begin(), m_queue.begin() + count, m_queue.end(), [](const Tile* a, const Tile* b) {
+            if (a->key.level != b->key.level)
+                return a->key.level > b->key.level;
+            return a->priority < b->priority;
+        });
+        for (size_t i = 0; i < count; ++i)
+        {
+            Tile& tile = *m_queue[i];
+            tile.state = TileState::Generating;
+            ++m_jobsInFlight;
+
+            NodeKey key = tile.key;
+            uint64_t id = tile.id;
+            m_tileJobs.push_back(m_jobs.Schedule([this, key, id]() {
+                GRAF_PROFILE_SCOPE("CdlodTerrain::GenerateTile");
+                int samples = m_tileSamples, grid = m_settings.gridSize;
+                float width = NodeWidth(key.level);
+                float spacing = width / static_cast<float>(grid);
+                glm::vec2 origin(static_cast<float>(key.x) * width - spacing, static_cast<float>(key.y) * width - spacing);
+
+                TileResult result;
+                result.key = PackKey(key);
+                result.tileId = id;
+                result.heights.resize(static_cast<size_t>(samples) * samples);
+                result.minHeight = INFINITY;
+                result.maxHeight = -INFINITY;
+                for (int y = 0; y < samples; ++y)
+                {
+                    for (int x = 0; x < samples; ++x)
+                    {
+                        float height = m_terrain.GetHeight(origin.x + static_cast<float>(x) * spacing, origin.y + static_cast<float>(y) * spacing);
+                        result.heights[static_cast<size_t>(y) * samples + x] = height;
+                        if (x >= 1 && x <= grid + 1 && y >= 1 && y <= grid + 1)
+                        {
+                            result.minHeight = min(result.minHeight, height);
+                            result.maxHeight = max(result.maxHeight, height);
+                        }
+                    }
+                }
+
+                lock_guard<mutex> lock(m_resultMutex);
+                m_results.push_back(std::move(result));
+            }));
+        }
+    }
+
+    /**
+     * @brief Uploads finished tiles within the budget.
+     *
+     * Results for tiles that were unloaded since their job started are dropped.
+     * When every layer is taken, the least recently used tile is evicted; if all
+     * are in use, the remaining results wait.
+     */
+    void CdlodTerrain::ApplyResults()
+    {
+        GRAF_PROFILE_SCOPE("CdlodTerrain::ApplyResults");
+        {
+            lock_guard<mutex> lock(m_resultMutex);
+            for (TileResult& result : m_results)
+                m_pendingResults.push_back(std::move(result));
+            m_results.clear();
+        }
+
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_heightTexture.getId());
+        size_t uploaded = 0;
+        size_t applied = 0;
+        for (; applied < m_pendingResults.size() && uploaded < m_settings.uploadBudget; ++applied)
+        {
+            TileResult& result = m_pendingResults[applied];
+            auto it = m_tiles.find(result.key);
+            if (it == m_tiles.end() || it->second.id != result.tileId)
+            {
+                --m_jobsInFlight;
+                continue;
+            }
+            if (m_freeLayers.empty() && !EvictTile())
+                break;
+
+            --m_jobsInFlight;
+            Tile& tile = it->second;
+            tile.layer = m_freeLayers.back();
+            m_freeLayers.pop_back();
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(tile.layer), m_tileSamples, m_tileSamples, 1,
+                            GL_RED, GL_FLOAT, result.heights.data());
+            tile.minHeight = result.minHeight;
+            tile.maxHeight = result.maxHeight;
+            tile.state = TileState::Ready;
+            ++uploaded;
+            ++m_generatedTiles;
+        }
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        m_pendingResults.erase(m_pendingResults.begin(), m_pendingResults.begin() + static_cast<ptrdiff_t>(applied));
+        m_stats.uploadedTiles = uploaded;
+    }
+
+    /**
+     * @brief Unloads the least recently used tile that was not needed in the last frame.
+     * @return False if every resident tile is in use.
+     */
+    bool CdlodTerrain::EvictTile()
+    {
+        auto oldest = m_tiles.end();
+        for (auto it = m_tiles.begin(); it != m_tiles.end(); ++it)
+        {
+            const Tile& tile = it->second;
+            if (tile.state == TileState::Ready && tile.lastUsedFrame + 1 < m_frame &&
+                (oldest == m_tiles.end() || tile.lastUsedFrame < oldest->second.lastUsedFrame))
+                oldest = it;
+        }
+        if (oldest == m_tiles.end())
+            return false;
+        m_freeLayers.push_back(oldest->second.layer);
+        m_tiles.erase(oldest);
+        return true;
+    }
+
+    /**
+     * @brief Unloads tiles that were not needed for a while and frees their layers.
+     */
+    void CdlodTerrain::UnloadTiles()
+    {
+        GRAF_PROFILE_SCOPE("CdlodTerrain::UnloadTiles");
+        for (auto it = m_tiles.begin(); it != m_tiles.end();)
+        {
+            if (m_frame - it->second.lastUsedFrame > m_settings.unloadDelay)
+            {
+                if (it->second.state == TileState::Ready)
+                    m_freeLayers.push_back(it->second.layer);
+                it = m_tiles.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+
+    /**
+     * @brief Drops the handles of finished jobs.
+     */
+    void CdlodTerrain::PruneJobs()
+    {
+        m_tileJobs.erase(remove_if(m_tileJobs.begin(), m_tileJobs.end(), [](const JobHandle& job) { return job.IsDone(); }),
+                         m_tileJobs.end());
+    }
+}
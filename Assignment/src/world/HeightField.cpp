@@ -0,0 +1,73 @@
+#define STB_PERLIN_IMPLEMENTATION
+
+#include "HeightField.hpp"
+#include <stb_perlin.h>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file HeightField.cpp
+ * @brief Implementation of the HeightField class.
+ */
+
+namespace graf
+{
+    /**
+     * @brief Constructs a height field.
+     *
+     * stb_perlin's fractal functions take no seed, so the seed selects a slice of
+     * the 3D noise instead; the noise repeats every 256 units, so the slices of
+     * seeds that differ in their low 8 bits never coincide.
+     *
+     * @param settings The parameters.
+     */
+    HeightField::HeightField(const HeightFieldSettings& settings)
+        : m_settings(settings),
+          m_seedOffset(static_cast<float>(settings.seed % 256) + 0.5f),
+          m_frequency(1.0f / max(settings.featureSize, 1.0f))
+    {
+    }
+
+    /**
+     * @brief Gets the height at a position.
+     * @param x First horizontal coordinate.
+     * @param y Second horizontal coordinate.
+     * @return The height, at least 0.
+     */
+    float HeightField::GetHeight(float x, float y) const
+    {
+        float fx = x * m_frequency, fy = y * m_frequency;
+        float hills = stb_perlin_fbm_noise3(fx, fy, m_seedOffset, m_settings.lacunarity, m_settings.gain, m_settings.octaves);
+
+        float mask = stb_perlin_noise3(fx * 0.125f, fy * 0.125f, m_seedOffset + 17.0f, 0, 0, 0); ///< Where mountain ranges are
+        mask = std::clamp(mask * 2.0f + 0.2f, 0.0f, 1.0f);
+        float mountains = 0.0f;
+        if (mask > 0.0f)
+        {
+            mountains = stb_perlin_ridge_noise3(fx * 0.5f, fy * 0.5f, m_seedOffset + 31.0f, m_settings.lacunarity,
+                                                m_settings.gain, 1.0f, max(m_settings.octaves - 1, 1));
+            mountains = std::clamp(mountains * 0.6f, 0.0f, 1.0f) * mask * mask;
+        }
+
+        float height = m_settings.baseHeight + hills * m_settings.hillHeight + mountains * m_settings.mountainHeight;
+        return std::clamp(height, 0.0f, GetMaxHeight());
+    }
+
+    /**
+     * @brief Gets the highest height the field can return.
+     * @return The bound.
+     */
+    float HeightField::GetMaxHeight() const
+    {
+        return m_settings.baseHeight + fabs(m_settings.hillHeight) + fabs(m_settings.mountainHeight);
+    }
+
+    /**
+     * @brief Gets the parameters.
+     * @return The settings.
+     */
+    const HeightFieldSettings& HeightField::GetSettings() const
+    {
+        return m_settings;
+    }
+}
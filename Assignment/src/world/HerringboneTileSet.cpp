@@ -0,0 +1,332 @@
+#define STB_HERRINGBONE_WANG_TILE_IMPLEMENTATION
+
+#include "HerringboneTileSet.hpp"
+#include "Exceptions.hpp"
+#include <stb_image.h>
+#include <stb_herringbone_wang_tile.h>
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @file HerringboneTileSet.cpp
+ * @brief Implementation of the HerringboneTileSet class.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        /// Type of a horizontal edge by (x - y) & 3, following stb's edge diagram; class 2 lies inside vertical tiles.
+        const int HORIZONTAL_EDGE_TYPE[4] = {2, 3, 0, 0};
+        /// Type of a vertical edge by (x - y) & 3; class 1 lies inside horizontal tiles.
+        const int VERTICAL_EDGE_TYPE[4] = {1, 1, 4, 5};
+
+        /**
+         * @brief Hashes a lattice position.
+         * @param seed The map seed.
+         * @param x Column.
+         * @param y Row.
+         * @param salt Separates the hashes of different uses of the same position.
+         * @return The hash.
+         */
+        uint32_t HashPosition(uint32_t seed, int32_t x, int32_t y, uint32_t salt)
+        {
+            uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y)) ^
+                         (static_cast<uint64_t>(seed) * 0x9E3779B97F4A7C15ull) ^ (static_cast<uint64_t>(salt) << 61);
+            h ^= h >> 30;
+            h *= 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 27;
+            h *= 0x94D049BB133111EBull;
+            h ^= h >> 31;
+            return static_cast<uint32_t>(h);
+        }
+
+        /**
+         * @brief Divides and rounds towards negative infinity.
+         * @param value The dividend.
+         * @param divisor The divisor, positive.
+         * @return The quotient.
+         */
+        int32_t FloorDiv(int32_t value, int32_t divisor)
+        {
+            int32_t quotient = value / divisor;
+            return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+        }
+    }
+
+    /**
+     * @brief Loads a template image.
+     *
+     * stb parses the tiles and their colors from the markings of the template;
+     * the tiles are then copied with their pixels replaced by palette indices
+     * and indexed by their colors.
+     *
+     * @param templateFile Path of a template PNG made with stb_herringbone_wang_tile.
+     * @exception WorldException Thrown if the image cannot be loaded or is not a template.
+     */
+    HerringboneTileSet::HerringboneTileSet(const string& templateFile)
+    {
+        int width = 0, height = 0;
+        unsigned char* pixels = stbi_load(templateFile.c_str(), &width, &height, nullptr, 3);
+        if (pixels == nullptr)
+            throw WorldException("Failed to load tile template " + templateFile + ": " + stbi_failure_reason());
+
+        stbhw_tileset tileset;
+        int built = stbhw_build_tileset_from_image(&tileset, pixels, width * 3, width, height);
+        stbi_image_free(pixels);
+        if (!built)
+            throw WorldException("Not a herringbone tile template " + templateFile + ": " + stbhw_get_last_error());
+
+        m_cornerColors = tileset.is_corner != 0;
+        m_shortSide = tileset.short_side_len;
+        for (int type = 0; type < 6; ++type)
+            m_colorCount[type] = max(tileset.num_color[type], 1);
+
+        auto copyTiles = [this](stbhw_tile** source, int count, vector<Tile>& tiles, unordered_map<uint32_t, vector<uint32_t>>& lookup) {
+            size_t cellCount = static_cast<size_t>(m_shortSide) * m_shortSide * 2;
+            for (int i = 0; i < count; ++i)
+            {
+                const stbhw_tile* tile = source[i];
+                Tile copy;
+                const signed char colors[6] = {tile->a, tile->b, tile->c, tile->d, tile->e, tile->f};
+                for (int k = 0; k < 6; ++k)
+                    copy.colors[k] = static_cast<int8_t>(max<int>(colors[k], 0));
+                copy.cells.resize(cellCount);
+                for (size_t cell = 0; cell < cellCount; ++cell)
+                {
+                    array<uint8_t, 3> rgb = {tile->pixels[cell * 3], tile->pixels[cell * 3 + 1], tile->pixels[cell * 3 + 2]};
+                    auto entry = find(m_palette.begin(), m_palette.end(), rgb);
+                    if (entry == m_palette.end())
+                    {
+                        if (m_palette.size() >= VOID_CELL)
+                            throw WorldException("Tile template has too many colors");
+                        entry = m_palette.insert(m_palette.end(), rgb);
+                    }
+                    copy.cells[cell] = static_cast<uint8_t>(entry - m_palette.begin());
+                }
+                lookup[PackColors(copy.colors)].push_back(static_cast<uint32_t>(tiles.size()));
+                tiles.push_back(std::move(copy));
+            }
+        };
+        try
+        {
+            copyTiles(tileset.h_tiles, tileset.num_h_tiles, m_horizontalTiles, m_horizontalLookup);
+            copyTiles(tileset.v_tiles, tileset.num_v_tiles, m_verticalTiles, m_verticalLookup);
+        }
+        catch (...)
+        {
+            stbhw_free_tileset(&tileset);
+            throw;
+        }
+        stbhw_free_tileset(&tileset);
+
+        if (m_horizontalTiles.empty() || m_verticalTiles.empty())
+            throw WorldException("Tile template has no tiles: " + templateFile);
+    }
+
+    /**
+     * @brief Generates the cells of a rectangle of the map; thread-safe.
+     *
+     * Walks the herringbone rows overlapping the rectangle as stb lays them out:
+     * in row j, a horizontal tile starts at every column i with i = j modulo 4,
+     * followed one short side later by a vertical tile two rows tall.
+     *
+     * @param seed Selects the map.
+     * @param x First column of the rectangle.
+     * @param y First row of the rectangle.
+     * @param width Columns of the rectangle.
+     * @param height Rows of the rectangle.
+     * @param cells Receives the palette indices, row by row.
+     * @param stride Distance between rows of cells.
+     */
+    void HerringboneTileSet::Generate(uint32_t seed, int32_t x, int32_t y, int width, int height, uint8_t* cells, size_t stride) const
+    {
+        const int32_t side = m_shortSide;
+        int32_t firstRow = FloorDiv(y, side) - 1;                  ///< Vertical tiles of the row above reach down
+        int32_t lastRow = FloorDiv(y + height - 1, side);
+        int32_t firstColumn = FloorDiv(x, side) - 4;
+        int32_t lastColumn = FloorDiv(x + width - 1, side);
+
+        int8_t colors[6];
+        for (int32_t j = firstRow; j <= lastRow; ++j)
+        {
+            int32_t i = firstColumn + (((j - firstColumn) % 4) + 4) % 4; ///< First column with i = j modulo 4
+            for (; i <= lastColumn; i += 4)
+            {
+                if (m_cornerColors)
+                {
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        colors[k] = CornerColor(seed, i + k, j);
+                        colors[k + 3] = CornerColor(seed, i + k, j + 1);
+                    }
+                }
+                else
+                {
+                    colors[0] = EdgeColor(seed, true, i, j);
+                    colors[1] = EdgeColor(seed, true, i + 1, j);
+                    colors[2] = EdgeColor(seed, false, i, j);
+                    colors[3] = EdgeColor(seed, false, i + 2, j);
+                    colors[4] = EdgeColor(seed, true, i, j + 1);
+                    colors[5] = EdgeColor(seed, true, i + 1, j + 1);
+                }
+                const Tile& horizontal = ChooseTile(m_horizontalTiles, m_horizontalLookup, colors, HashPosition(seed, i, j, 1));
+                Blit(horizontal, side * 2, side, i * side, j * side, x, y, width, height, cells, stride);
+
+                int32_t v = i + 3;
+                if (m_cornerColors)
+                {
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        colors[k] = CornerColor(seed, v, j + k);
+                        colors[k + 3] = CornerColor(seed, v + 1, j + k);
+                    }
+                }
+                else
+                {
+                    colors[0] = EdgeColor(seed, true, v, j);
+                    colors[1] = EdgeColor(seed, false, v, j);
+                    colors[2] = EdgeColor(seed, false, v + 1, j);
+                    colors[3] = EdgeColor(seed, false, v, j + 1);
+                    colors[4] = EdgeColor(seed, false, v + 1, j + 1);
+                    colors[5] = EdgeColor(seed, true, v, j + 2);
+                }
+                const Tile& vertical = ChooseTile(m_verticalTiles, m_verticalLookup, colors, HashPosition(seed, v, j, 2));
+                Blit(vertical, side, side * 2, v * side, j * side, x, y, width, height, cells, stride);
+            }
+        }
+    }
+
+    /**
+     * @brief Gets the colors the cell values index.
+     * @return Red, green and blue of each palette entry.
+     */
+    const vector<array<uint8_t, 3>>& HerringboneTileSet::GetPalette() const
+    {
+        return m_palette;
+    }
+
+    /**
+     * @brief Gets the length of the short side of the tiles.
+     * @return The length in cells.
+     */
+    int HerringboneTileSet::GetShortSide() const
+    {
+        return m_shortSide;
+    }
+
+    /**
+     * @brief Gets the number of tile variants.
+     * @return The count of horizontal and vertical tiles.
+     */
+    size_t HerringboneTileSet::GetTileCount() const
+    {
+        return m_horizontalTiles.size() + m_verticalTiles.size();
+    }
+
+    /**
+     * @brief Packs six colors into a lookup key.
+     * @param colors The colors, each below 8.
+     * @return The key.
+     */
+    uint32_t HerringboneTileSet::PackColors(const int8_t colors[6])
+    {
+        uint32_t key = 0;
+        for (int k = 0; k < 6; ++k)
+            key = key << 3 | (static_cast<uint32_t>(colors[k]) & 7u);
+        return key;
+    }
+
+    /**
+     * @brief Gets the color of a lattice corner.
+     * @param seed The map seed.
+     * @param x Corner column in short-side units.
+     * @param y Corner row in short-side units.
+     * @return The color.
+     */
+    int8_t HerringboneTileSet::CornerColor(uint32_t seed, int32_t x, int32_t y) const
+    {
+        int type = (x - y + 1) & 3;
+        return static_cast<int8_t>(HashPosition(seed, x, y, 0) % static_cast<uint32_t>(m_colorCount[type]));
+    }
+
+    /**
+     * @brief Gets the color of a lattice edge.
+     * @param seed The map seed.
+     * @param horizontal Whether the edge runs along x.
+     * @param x Column of the edge's first corner in short-side units.
+     * @param y Row of the edge's first corner in short-side units.
+     * @return The color.
+     */
+    int8_t HerringboneTileSet::EdgeColor(uint32_t seed, bool horizontal, int32_t x, int32_t y) const
+    {
+        int type = horizontal ? HORIZONTAL_EDGE_TYPE[(x - y) & 3] : VERTICAL_EDGE_TYPE[(x - y) & 3];
+        return static_cast<int8_t>(HashPosition(seed, x, y, horizontal ? 3 : 4) % static_cast<uint32_t>(m_colorCount[type]));
+    }
+
+    /**
+     * @brief Chooses the variant placed at a tile position.
+     *
+     * Templates contain every combination of colors, so a full match normally
+     * exists; an incomplete hand-made tileset falls back to the tile matching
+     * the most colors rather than failing like stb's generator.
+     *
+     * @param tiles The horizontal or vertical tiles.
+     * @param lookup Indices of those tiles by packed colors.
+     * @param colors The colors the tile must match.
+     * @param hash Hash of the tile position.
+     * @return The tile; the best partial match if no tile matches all colors.
+     */
+    const HerringboneTileSet::Tile& HerringboneTileSet::ChooseTile(const vector<Tile>& tiles,
+                                                                   const unordered_map<uint32_t, vector<uint32_t>>& lookup,
+                                                                   const int8_t colors[6], uint32_t hash)
+    {
+        auto variants = lookup.find(PackColors(colors));
+        if (variants != lookup.end())
+            return tiles[variants->second[hash % variants->second.size()]];
+
+        size_t best = hash % tiles.size();
+        int bestMatches = -1;
+        for (size_t i = 0; i < tiles.size(); ++i)
+        {
+            size_t index = (hash + i) % tiles.size();
+            int matches = 0;
+            for (int k = 0; k < 6; ++k)
+                matches += tiles[index].colors[k] == colors[k] ? 1 : 0;
+            if (matches > bestMatches)
+            {
+                best = index;
+                bestMatches = matches;
+            }
+        }
+        return tiles[best];
+    }
+
+    /**
+     * @brief Copies the clipped part of a tile into a rectangle of cells.
+     * @param tile The tile.
+     * @param tileWidth Columns of the tile.
+     * @param tileHeight Rows of the tile.
+     * @param tileX First map column of the tile.
+     * @param tileY First map row of the tile.
+     * @param x First column of the rectangle.
+     * @param y First row of the rectangle.
+     * @param width Columns of the rectangle.
+     * @param height Rows of the rectangle.
+     * @param cells The rectangle's cells.
+     * @param stride Distance between rows of cells.
+     */
+    void HerringboneTileSet::Blit(const Tile& tile, int tileWidth, int tileHeight, int32_t tileX, int32_t tileY,
+                                  int32_t x, int32_t y, int width, int height, uint8_t* cells, size_t stride)
+    {
+        int32_t left = max(tileX, x), right = min(tileX + tileWidth, x + width);
+        int32_t top = max(tileY, y), bottom = min(tileY + tileHeight, y + height);
+        if (left >= right || top >= bottom)
+            return;
+        for (int32_t row = top; row < bottom; ++row)
+        {
+            const uint8_t* source = &tile.cells[static_cast<size_t>(row - tileY) * tileWidth + (left - tileX)];
+            memcpy(cells + static_cast<size_t>(row - y) * stride + (left - x), source, static_cast<size_t>(right - left));
+        }
+    }
+}
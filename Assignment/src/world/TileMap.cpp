@@ -0,0 +1,524 @@
+#include "TileMap.hpp"
+#include "Exceptions.hpp"
+#include "ErrorCheck.hpp"
+#include "Frustum.hpp"
+#include "Profiler.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @file TileMap.cpp
+ * @brief Implementation of the TileMap class.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const float CHUNK_THICKNESS = 0.5f;     ///< Half height of a chunk's bounds, so flat chunks are not culled as degenerate boxes.
+
+        /**
+         * @brief Appends the four vertices of a rectangle of cells.
+         * @param vertices Receives the vertices.
+         * @param x0 First column.
+         * @param y0 First row.
+         * @param x1 Column past the last.
+         * @param y1 Row past the last.
+         * @param rgb Color of the cells.
+         */
+        void AppendQuad(vector<uint8_t>& vertices, int x0, int y0, int x1, int y1, const array<uint8_t, 3>& rgb)
+        {
+            const int corners[4][2] = { {x0, y0}, {x1, y0}, {x1, y1}, {x0, y1} };
+            for (const auto& corner : corners)
+            {
+                uint16_t position[2] = {static_cast<uint16_t>(corner[0]), static_cast<uint16_t>(corner[1])};
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(position);
+                vertices.insert(vertices.end(), bytes, bytes + sizeof(position));
+                vertices.insert(vertices.end(), {rgb[0], rgb[1], rgb[2], 255});
+            }
+        }
+    }
+
+    /**
+     * @brief Loads the tile set and creates the mesh pool; no chunk is generated before the first Update.
+     * @param jobs The job system that generates the chunks.
+     * @param program The program drawing the chunks.
+     * @param settings The map parameters.
+     * @exception WorldException Thrown if the tile template cannot be loaded.
+     */
+    TileMap::TileMap(JobSystem& jobs, ShaderProgram& program, const TileMapSettings& settings)
+        : m_jobs(jobs), m_program(program), m_settings(settings), m_tileSet(settings.templateFile),
+          m_pool({ {0, 2, GL_UNSIGNED_SHORT, true, 0}, {1, 4, GL_UNSIGNED_BYTE, true, 4} },
+                 BYTES_PER_VERTEX, BYTES_PER_QUAD, 4 * 1024 * 1024)
+    {
+        m_settings.stripChunks = max(m_settings.stripChunks, 1);
+        m_settings.prefetchChunks = max(m_settings.prefetchChunks, 0);
+
+        vector<uint32_t> indices(static_cast<size_t>(MAX_QUADS_PER_CHUNK) * 6);
+        for (uint32_t quad = 0; quad < MAX_QUADS_PER_CHUNK; ++quad)
+        {
+            uint32_t* index = &indices[quad * 6];
+            uint32_t first = quad * 4;
+            index[0] = first; index[1] = first + 1; index[2] = first + 2;
+            index[3] = first; index[4] = first + 2; index[5] = first + 3;
+        }
+        m_quadIndices.Create(indices.data(), static_cast<int>(indices.size() * sizeof(uint32_t)));
+        m_quadIndices.Unbind();
+        m_pool.SetIndexBuffer(m_quadIndices.getId());
+        CheckGLError("TileMap Creation");
+    }
+
+    /**
+     * @brief Waits for the generation jobs and releases the GL objects.
+     */
+    TileMap::~TileMap()
+    {
+        Release();
+    }
+
+    /**
+     * @brief Streams the map for a view: uploads finished chunks, selects visible ones and schedules generation.
+     *
+     * The chunks overlapping the frustum's footprint on the map plane, limited to
+     * the view distance, are tested against the frustum one by one; the visible
+     * ones and a margin around them are requested and kept resident.
+     *
+     * @param viewProjection The combined projection and view matrix.
+     * @param camera The camera position.
+     */
+    void TileMap::Update(const glm::mat4& viewProjection, const glm::vec3& camera)
+    {
+        GRAF_PROFILE_SCOPE("TileMap::Update");
+        ++m_frame;
+        PruneJobs();
+        ApplyResults();
+
+        m_visible.clear();
+        glm::vec2 areaMin, areaMax;
+        if (FindVisibleArea(viewProjection, areaMin, areaMax))
+        {
+            glm::vec2 reachMin = glm::vec2(camera) - m_settings.viewDistance, reachMax = glm::vec2(camera) + m_settings.viewDistance;
+            areaMin = glm::max(glm::max(areaMin, reachMin), glm::vec2(0.0f));
+            areaMax = glm::min(glm::min(areaMax, reachMax), glm::vec2(static_cast<float>(m_settings.width), static_cast<float>(m_settings.height)));
+        }
+        else
+        {
+            areaMax = areaMin - 1.0f; ///< Empty
+        }
+
+        if (areaMin.x < areaMax.x && areaMin.y < areaMax.y)
+        {
+            Frustum frustum(viewProjection);
+            int32_t lastChunkX = (m_settings.width - 1) / CHUNK_SIZE, lastChunkY = (m_settings.height - 1) / CHUNK_SIZE;
+            int32_t firstX = static_cast<int32_t>(areaMin.x) / CHUNK_SIZE, lastX = static_cast<int32_t>(areaMax.x) / CHUNK_SIZE;
+            int32_t firstY = static_cast<int32_t>(areaMin.y) / CHUNK_SIZE, lastY = static_cast<int32_t>(areaMax.y) / CHUNK_SIZE;
+            int32_t margin = m_settings.prefetchChunks;
+            for (int32_t y = max(firstY - margin, 0); y <= min(lastY + margin, lastChunkY); ++y)
+            {
+                for (int32_t x = max(firstX - margin, 0); x <= min(lastX + margin, lastChunkX); ++x)
+                {
+                    glm::vec3 boxMin(static_cast<float>(x * CHUNK_SIZE), static_cast<float>(y * CHUNK_SIZE), -CHUNK_THICKNESS);
+                    glm::vec3 boxMax(boxMin.x + CHUNK_SIZE, boxMin.y + CHUNK_SIZE, CHUNK_THICKNESS);
+                    bool inArea = x >= firstX && x <= lastX && y >= firstY && y <= lastY;
+                    bool visible = inArea && frustum.IntersectsBox(boxMin, boxMax);
+
+                    auto inserted = m_chunks.try_emplace(PackKey(x, y));
+                    Chunk& chunk = inserted.first->second;
+                    if (inserted.second)
+                    {
+                        chunk.x = x;
+                        chunk.y = y;
+                        chunk.id = m_nextChunkId++;
+                    }
+                    glm::vec2 centre = glm::vec2(boxMin + boxMax) * 0.5f;
+                    chunk.priority = glm::length(centre - glm::vec2(camera)) + (visible ? 0.0f : m_settings.viewDistance);
+                    chunk.lastUsedFrame = m_frame;
+                    if (visible)
+                        m_visible.push_back(inserted.first->first);
+                }
+            }
+        }
+
+        ScheduleGeneration();
+        UnloadChunks();
+
+        m_stats.residentChunks = 0;
+        m_stats.pendingChunks = 0;
+        for (const auto& entry : m_chunks)
+        {
+            if (entry.second.ready)
+                ++m_stats.residentChunks;
+            else
+                ++m_stats.pendingChunks;
+        }
+        m_stats.generationJobs = m_stripJobs.size();
+        m_stats.visibleChunks = m_visible.size();
+        m_stats.generatedChunks = m_generatedChunks;
+        m_stats.poolCapacity = m_pool.getCapacity();
+        m_stats.poolUsed = m_pool.getUsed();
+    }
+
+    /**
+     * @brief Draws the visible chunks selected by the last Update.
+     *
+     * Chunks are sorted by pool page so each page's vertex array is bound once;
+     * each chunk is one draw with its origin as the only uniform change.
+     *
+     * @param viewProjection The combined projection and view matrix.
+     */
+    void TileMap::Render(const glm::mat4& viewProjection)
+    {
+        GRAF_PROFILE_SCOPE("TileMap::Render");
+        m_drawItems.clear();
+        for (uint64_t key : m_visible)
+        {
+            auto it = m_chunks.find(key);
+            if (it == m_chunks.end() || !it->second.ready || it->second.quadCount == 0)
+                continue;
+            const Chunk& chunk = it->second;
+            m_drawItems.push_back({chunk.allocation.page, m_pool.getBaseVertex(chunk.allocation), &chunk});
+        }
+        sort(m_drawItems.begin(), m_drawItems.end(),
+             [](const DrawItem& a, const DrawItem& b) { return a.page != b.page ? a.page < b.page : a.baseVertex < b.baseVertex; });
+
+        m_program.Use();
+        m_program.SetMat4("uViewProjection", viewProjection);
+        int originLocation = m_program.GetUniformLocation("uChunkOrigin");
+
+        m_stats.drawnChunks = m_drawItems.size();
+        m_stats.drawCalls = 0;
+        m_stats.vertexArrayBinds = 0;
+        m_stats.quads = 0;
+        uint32_t boundPage = MeshAllocation::INVALID_PAGE;
+        for (const DrawItem& item : m_drawItems)
+        {
+            if (item.page != boundPage)
+            {
+                glBindVertexArray(m_pool.getVertexArray(item.page));
+                boundPage = item.page;
+                ++m_stats.vertexArrayBinds;
+            }
+            glUniform2f(originLocation, static_cast<float>(item.chunk->x * CHUNK_SIZE), static_cast<float>(item.chunk->y * CHUNK_SIZE));
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(item.chunk->quadCount) * 6, GL_UNSIGNED_INT, nullptr, item.baseVertex);
+            ++m_stats.drawCalls;
+            m_stats.quads += item.chunk->quadCount;
+        }
+        glBindVertexArray(0);
+    }
+
+    /**
+     * @brief Gets the tile set the map is generated from.
+     * @return The tile set.
+     */
+    const HerringboneTileSet& TileMap::GetTileSet() const
+    {
+        return m_tileSet;
+    }
+
+    /**
+     * @brief Gets the streaming state and the work of the last frame.
+     * @return The statistics.
+     */
+    const TileMapStats& TileMap::GetStats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * @brief Checks whether every chunk in view is generated and uploaded.
+     * @return True if nothing is pending.
+     */
+    bool TileMap::IsSettled() const
+    {
+        return m_stats.pendingChunks == 0 && m_chunksInFlight == 0;
+    }
+
+    /**
+     * @brief Waits for the generation jobs and deletes all GL objects; must be called while the context is current.
+     */
+    void TileMap::Release()
+    {
+        m_jobs.WaitAll(m_stripJobs);
+        m_stripJobs.clear();
+        m_results.clear();
+        m_pendingResults.clear();
+        m_chunksInFlight = 0;
+        m_chunks.clear();
+        m_visible.clear();
+        m_drawItems.clear();
+        m_pool.Release();
+        m_quadIndices.Release();
+    }
+
+    /**
+     * @brief Packs a chunk position into a hash map key.
+     * @param x Chunk column.
+     * @param y Chunk row.
+     * @return The key.
+     */
+    uint64_t TileMap::PackKey(int32_t x, int32_t y)
+    {
+        return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(y);
+    }
+
+    /**
+     * @brief Finds the area of the map plane inside the view frustum.
+     *
+     * The frustum's intersection with the plane z = 0 is a convex polygon whose
+     * vertices lie on the frustum's twelve edges, so its bounds are those of the
+     * points where the edges cross the plane.
+     *
+     * @param viewProjection The combined projection and view matrix.
+     * @param areaMin Receives the minimum corner.
+     * @param areaMax Receives the maximum corner.
+     * @return False if the frustum does not reach the plane.
+     */
+    bool TileMap::FindVisibleArea(const glm::mat4& viewProjection, glm::vec2& areaMin, glm::vec2& areaMax)
+    {
+        glm::mat4 inverse = glm::inverse(viewProjection);
+        glm::vec3 corners[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            glm::vec4 ndc((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, (i & 4) ? 1.0f : -1.0f, 1.0f);
+            glm::vec4 world = inverse * ndc;
+            corners[i] = glm::vec3(world) / world.w;
+        }
+
+        static const int EDGES[12][2] = {
+            {0, 1}, {2, 3}, {4, 5}, {6, 7},     ///< Along x
+            {0, 2}, {1, 3}, {4, 6}, {5, 7},     ///< Along y
+            {0, 4}, {1, 5}, {2, 6}, {3, 7}      ///< Near to far
+        };
+        areaMin = glm::vec2(INFINITY);
+        areaMax = glm::vec2(-INFINITY);
+        bool found = false;
+        for (const auto& edge : EDGES)
+        {
+            const glm::vec3& a = corners[edge[0]];
+            const glm::vec3& b = corners[edge[1]];
+            if ((a.z > 0.0f) == (b.z > 0.0f))
+                continue;
+            float t = a.z / (a.z - b.z);
+            glm::vec2 point = glm::vec2(a + (b - a) * t);
+            areaMin = glm::min(areaMin, point);
+            areaMax = glm::max(areaMax, point);
+            found = true;
+        }
+        return found;
+    }
+
+    /**
+     * @brief Starts strip jobs for requested chunks up to the job limit, nearest first.
+     *
+     * A strip starts at the nearest unscheduled chunk and extends along its row
+     * over adjacent unscheduled chunks, so strips follow the view's rows.
+     */
+    void TileMap::ScheduleGeneration()
+    {
+        GRAF_PROFILE_SCOPE("TileMap::ScheduleGeneration");
+        size_t limit = m_settings.maxJobs > 0 ? m_settings.maxJobs : max<size_t>(2 * m_jobs.GetWorkerCount(), 1);
+        size_t chunkLimit = limit * static_cast<size_t>(m_settings.stripChunks);
+        if (m_chunksInFlight >= chunkLimit)
+            return;
+
+        m_queue.clear();
+        for (auto& entry : m_chunks)
+        {
+            if (!entry.second.ready && !entry.second.scheduled)
+                m_queue.push_back(&entry.second);
+        }
+        sort(m_queue.begin(), m_queue.end(), [](const Chunk* a, const Chunk* b) { return a->priority < b->priority; });
+
+        vector<Chunk*> strip;
+        for (Chunk* seed : m_queue)
+        {
+            if (m_chunksInFlight >= chunkLimit)
+                break;
+            if (seed->scheduled)
+                continue;
+
+            int32_t first = seed->x, last = seed->x;
+            auto pending = [this](int32_t x, int32_t y) {
+                auto it = m_chunks.find(PackKey(x, y));
+                return it != m_chunks.end() && !it->second.ready && !it->second.scheduled;
+            };
+            while (last - first + 1 < m_settings.stripChunks && pending(last + 1, seed->y))
+                ++last;
+            while (last - first + 1 < m_settings.stripChunks && pending(first - 1, seed->y))
+                --first;
+
+            strip.clear();
+            for (int32_t x = first; x <= last; ++x)
+                strip.push_back(&m_chunks.find(PackKey(x, seed->y))->second);
+            ScheduleStrip(strip);
+        }
+    }
+
+    /**
+     * @brief Starts a job that generates and meshes adjacent chunks of a row.
+     *
+     * The job generates the cells of the whole strip in one pass and then meshes
+     * each chunk; cells beyond the map's edge are left out of the meshes.
+     *
+     * @param strip The chunks, ordered by column without gaps.
+     */
+    void TileMap::ScheduleStrip(const vector<Chunk*>& strip)
+    {
+        vector<pair<uint64_t, uint64_t>> chunks; ///< Keys and ids
+        for (Chunk* chunk : strip)
+        {
+            chunk->scheduled = true;
+            chunks.emplace_back(PackKey(chunk->x, chunk->y), chunk->id);
+        }
+        m_chunksInFlight += strip.size();
+
+        int32_t firstX = strip.front()->x, row = strip.front()->y;
+        m_stripJobs.push_back(m_jobs.Schedule([this, firstX, row, chunks = std::move(chunks)]() {
+            GRAF_PROFILE_SCOPE("TileMap::GenerateStrip");
+            int width = static_cast<int>(chunks.size()) * CHUNK_SIZE;
+            int32_t x = firstX * CHUNK_SIZE, y = row * CHUNK_SIZE;
+            vector<uint8_t> cells(static_cast<size_t>(width) * CHUNK_SIZE);
+            m_tileSet.Generate(m_settings.seed, x, y, width, CHUNK_SIZE, cells.data(), static_cast<size_t>(width));
+
+            int visibleWidth = min(width, m_settings.width - x);
+            int visibleHeight = min(static_cast<int>(CHUNK_SIZE), m_settings.height - y); ///< Cast, so min does not bind the undefined constant
+            for (int cellY = 0; cellY < CHUNK_SIZE; ++cellY)
+            {
+                for (int cellX = 0; cellX < width; ++cellX)
+                {
+                    if (cellX >= visibleWidth || cellY >= visibleHeight)
+                        cells[static_cast<size_t>(cellY) * width + cellX] = HerringboneTileSet::VOID_CELL;
+                }
+            }
+
+            vector<ChunkMesh> meshes(chunks.size());
+            for (size_t i = 0; i < chunks.size(); ++i)
+            {
+                meshes[i].key = chunks[i].first;
+                meshes[i].chunkId = chunks[i].second;
+                MeshChunk(cells.data() + i * CHUNK_SIZE, static_cast<size_t>(width), m_tileSet.GetPalette(), meshes[i]);
+            }
+
+            lock_guard<mutex> lock(m_resultMutex);
+            for (ChunkMesh& mesh : meshes)
+                m_results.push_back(std::move(mesh));
+        }));
+    }
+
+    /**
+     * @brief Builds the mesh of one chunk from its cells.
+     *
+     * Greedily covers the cells with rectangles of equal value: each rectangle
+     * grows along the row as far as the value repeats, then row by row while the
+     * whole span does. Walls and floors of dungeon templates form long runs, so
+     * this takes a small fraction of the quads of one per cell.
+     *
+     * @param cells The cells of the strip.
+     * @param stride Distance between rows of cells.
+     * @param palette Colors of the cell values.
+     * @param mesh Receives the vertices.
+     */
+    void TileMap::MeshChunk(const uint8_t* cells, size_t stride, const vector<array<uint8_t, 3>>& palette, ChunkMesh& mesh)
+    {
+        GRAF_PROFILE_SCOPE("TileMap::MeshChunk");
+        bool covered[CHUNK_SIZE][CHUNK_SIZE] = {};
+        mesh.vertices.clear();
+        for (int y = 0; y < CHUNK_SIZE; ++y)
+        {
+            const uint8_t* row = cells + static_cast<size_t>(y) * stride;
+            for (int x = 0; x < CHUNK_SIZE; ++x)
+            {
+                uint8_t value = row[x];
+                if (covered[y][x] || value == HerringboneTileSet::VOID_CELL)
+                    continue;
+
+                int right = x + 1;
+                while (right < CHUNK_SIZE && row[right] == value && !covered[y][right])
+                    ++right;
+                int top = y + 1;
+                for (; top < CHUNK_SIZE; ++top)
+                {
+                    const uint8_t* next = cells + static_cast<size_t>(top) * stride;
+                    bool matches = true;
+                    for (int i = x; i < right && matches; ++i)
+                        matches = next[i] == value && !covered[top][i];
+                    if (!matches)
+                        break;
+                }
+                for (int j = y; j < top; ++j)
+                    fill(&covered[j][x], &covered[j][right], true);
+                AppendQuad(mesh.vertices, x, y, right, top, palette[value]);
+            }
+        }
+    }
+
+    /**
+     * @brief Uploads finished meshes within the byte budget.
+     *
+     * Meshes of chunks that were unloaded since their job started are dropped.
+     * At least one mesh is applied per frame.
+     */
+    void TileMap::ApplyResults()
+    {
+        GRAF_PROFILE_SCOPE("TileMap::ApplyResults");
+        {
+            lock_guard<mutex> lock(m_resultMutex);
+            for (ChunkMesh& mesh : m_results)
+                m_pendingResults.push_back(std::move(mesh));
+            m_results.clear();
+        }
+
+        size_t uploaded = 0;
+        size_t applied = 0;
+        for (; applied < m_pendingResults.size() && uploaded < m_settings.uploadBudget; ++applied)
+        {
+            ChunkMesh& mesh = m_pendingResults[applied];
+            --m_chunksInFlight;
+            auto it = m_chunks.find(mesh.key);
+            if (it == m_chunks.end() || it->second.id != mesh.chunkId)
+                continue;
+
+            Chunk& chunk = it->second;
+            chunk.quadCount = static_cast<uint32_t>(mesh.vertices.size() / BYTES_PER_QUAD);
+            if (chunk.quadCount > 0)
+            {
+                chunk.allocation = m_pool.Allocate(mesh.vertices.size());
+                m_pool.Upload(chunk.allocation, mesh.vertices.data(), mesh.vertices.size());
+                uploaded += mesh.vertices.size();
+            }
+            chunk.ready = true;
+            chunk.scheduled = false;
+            ++m_generatedChunks;
+        }
+        m_pendingResults.erase(m_pendingResults.begin(), m_pendingResults.begin() + static_cast<ptrdiff_t>(applied));
+        m_stats.uploadedBytes = uploaded;
+    }
+
+    /**
+     * @brief Unloads chunks that were not needed for a while.
+     */
+    void TileMap::UnloadChunks()
+    {
+        GRAF_PROFILE_SCOPE("TileMap::UnloadChunks");
+        for (auto it = m_chunks.begin(); it != m_chunks.end();)
+        {
+            if (m_frame - it->second.lastUsedFrame > m_settings.unloadDelay)
+            {
+                m_pool.Free(it->second.allocation);
+                it = m_chunks.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+
+    /**
+     * @brief Drops the handles of finished jobs.
+     */
+    void TileMap::PruneJobs()
+    {
+        m_stripJobs.erase(remove_if(m_stripJobs.begin(), m_stripJobs.end(), [](const JobHandle& job) { return job.IsDone(); }),
+                          m_stripJobs.end());
+    }
+}
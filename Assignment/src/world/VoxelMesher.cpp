@@ -0,0 +1,307 @@
+#define STBVOX_CONFIG_MODE 20
+#define STBVOX_CONFIG_FOG_SMOOTHSTEP
+#define STB_VOXEL_RENDER_IMPLEMENTATION
+
+#include "VoxelMesher.hpp"
+#include "Profiler.hpp"
+#include <stb_voxel_render.h>
+#include <algorithm>
+#include <cstring>
+
+/**
+ * @file VoxelMesher.cpp
+ * @brief Implementation of the VoxelMesher class and the stb_voxel_render configuration of the voxel world.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const int PADDED_AREA = VoxelMesher::PADDED_SIZE * VoxelMesher::PADDED_SIZE;   ///< Voxels of one padded x slice.
+        const int PADDED_VOLUME = PADDED_AREA * VoxelMesher::PADDED_SIZE;               ///< Voxels of the padded input.
+        const size_t OUTPUT_QUADS = 8192;       ///< Quads the stb output buffer holds before it is copied out.
+        const float SAND_LEVEL = 38.0f;         ///< Surfaces below this height are sand.
+        const float SNOW_LEVEL = 150.0f;        ///< Surfaces above this height are snow.
+        const float DIRT_DEPTH = 3.0f;          ///< Depth of the dirt or sand layer under the surface.
+
+        /**
+         * @brief Gets stb's geometry of every block type: Air is empty, everything else a solid cube.
+         * @return 256 geometry values indexed by block type.
+         */
+        unsigned char* GetBlockGeometry()
+        {
+            static unsigned char geometry[256] = {};
+            static bool initialized = [] {
+                for (int i = 1; i < 256; ++i)
+                    geometry[i] = STBVOX_MAKE_GEOMETRY(STBVOX_GEOM_solid, 0, 0);
+                return true;
+            }();
+            (void)initialized;
+            return geometry;
+        }
+
+        /**
+         * @brief Hashes a voxel position to vary the block colors slightly.
+         * @param x Voxel x.
+         * @param y Voxel y.
+         * @param z Voxel z.
+         * @return A value in [0, 15].
+         */
+        int ColorJitter(int32_t x, int32_t y, int32_t z)
+        {
+            uint32_t h = static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u ^ static_cast<uint32_t>(z) * 83492791u;
+            h ^= h >> 13;
+            h *= 0x5bd1e995u;
+            return static_cast<int>((h >> 15) & 15u);
+        }
+    }
+
+    /**
+     * @brief Constructs a mesher.
+     */
+    VoxelMesher::VoxelMesher()
+        : m_maker(new stbvox_mesh_maker),
+          m_blocks(PADDED_VOLUME), m_lighting(PADDED_VOLUME), m_colors(PADDED_VOLUME * 3),
+          m_output(OUTPUT_QUADS * BYTES_PER_QUAD), m_heights(PADDED_AREA)
+    {
+        stbvox_init_mesh_maker(m_maker.get());
+    }
+
+    /**
+     * @brief Frees the mesher's buffers.
+     */
+    VoxelMesher::~VoxelMesher() = default;
+
+    /**
+     * @brief Samples the terrain heights of a column of chunks; all chunks of the column share them.
+     *
+     * Each voxel column takes the height at its centre, so a coarse voxel stands
+     * for the average terrain under it.
+     *
+     * @param terrain The height field.
+     * @param level Detail level; voxels are 2^level world units wide.
+     * @param columnX Column index along x at that level.
+     * @param columnY Column index along y at that level.
+     */
+    void VoxelMesher::BeginColumn(const HeightField& terrain, int level, int32_t columnX, int32_t columnY)
+    {
+        GRAF_PROFILE_SCOPE("VoxelMesher::BeginColumn");
+        m_level = level;
+        m_columnX = columnX;
+        m_columnY = columnY;
+
+        float voxelSize = static_cast<float>(1 << level);
+        int32_t voxelX = columnX * CHUNK_SIZE - 1, voxelY = columnY * CHUNK_SIZE - 1; ///< First padded voxel at this level
+        m_minHeight = terrain.GetMaxHeight();
+        m_maxHeight = 0.0f;
+        for (int x = 0; x < PADDED_SIZE; ++x)
+        {
+            for (int y = 0; y < PADDED_SIZE; ++y)
+            {
+                float height = terrain.GetHeight((static_cast<float>(voxelX + x) + 0.5f) * voxelSize,
+                                                 (static_cast<float>(voxelY + y) + 0.5f) * voxelSize);
+                m_heights[x * PADDED_SIZE + y] = height;
+                m_minHeight = min(m_minHeight, height);
+                m_maxHeight = max(m_maxHeight, height);
+            }
+        }
+    }
+
+    /**
+     * @brief Generates and meshes one chunk of the current column.
+     *
+     * A voxel is solid where its centre is below the surface, and everything
+     * below height 0 is solid so the world has no visible bottom. The blocks are
+     * written into the padded input, edits are applied on top, and stb meshes the
+     * inner CHUNK_SIZE^3 voxels. Light is full in air and zero in solid voxels,
+     * which stb averages at each vertex into ambient occlusion.
+     *
+     * @param chunkZ Vertical chunk index.
+     * @param edits Edits overriding the generated blocks; only level 0 applies them.
+     * @param mesh Receives the mesh.
+     */
+    void VoxelMesher::MeshChunk(int32_t chunkZ, const vector<VoxelEdit>& edits, VoxelChunkMesh& mesh)
+    {
+        GRAF_PROFILE_SCOPE("VoxelMesher::MeshChunk");
+        mesh.chunkZ = chunkZ;
+        mesh.quadCount = 0;
+        mesh.vertices.clear();
+
+        int32_t voxelX = m_columnX * CHUNK_SIZE - 1, voxelY = m_columnY * CHUNK_SIZE - 1, voxelZ = chunkZ * CHUNK_SIZE - 1;
+        float voxelSize = static_cast<float>(1 << m_level);
+        bool edited = false;
+        if (m_level == 0)
+        {
+            for (const VoxelEdit& edit : edits)
+            {
+                if (edit.x >= voxelX && edit.x < voxelX + PADDED_SIZE && edit.y >= voxelY && edit.y < voxelY + PADDED_SIZE &&
+                    edit.z >= voxelZ && edit.z < voxelZ + PADDED_SIZE)
+                {
+                    edited = true;
+                    break;
+                }
+            }
+        }
+        float bottom = static_cast<float>(voxelZ) * voxelSize;              ///< Lowest padded voxel
+        float top = static_cast<float>(voxelZ + PADDED_SIZE) * voxelSize;   ///< Above the highest padded voxel
+        if (!edited && (bottom >= m_maxHeight || top <= m_minHeight))
+            return; ///< All air or all solid, so there are no faces
+
+        for (int x = 0; x < PADDED_SIZE; ++x)
+        {
+            for (int y = 0; y < PADDED_SIZE; ++y)
+            {
+                float height = m_heights[x * PADDED_SIZE + y];
+                int index = x * PADDED_AREA + y * PADDED_SIZE;
+                for (int z = 0; z < PADDED_SIZE; ++z, ++index)
+                {
+                    float centre = (static_cast<float>(voxelZ + z) + 0.5f) * voxelSize;
+                    m_blocks[index] = static_cast<uint8_t>(GetGeneratedBlock(height, centre, voxelSize));
+                }
+            }
+        }
+
+        if (m_level == 0)
+        {
+            for (const VoxelEdit& edit : edits)
+            {
+                int x = edit.x - voxelX, y = edit.y - voxelY, z = edit.z - voxelZ;
+                if (x >= 0 && x < PADDED_SIZE && y >= 0 && y < PADDED_SIZE && z >= 0 && z < PADDED_SIZE)
+                    m_blocks[x * PADDED_AREA + y * PADDED_SIZE + z] = static_cast<uint8_t>(edit.block);
+            }
+        }
+
+        for (int x = 0; x < PADDED_SIZE; ++x)
+        {
+            for (int y = 0; y < PADDED_SIZE; ++y)
+            {
+                int index = x * PADDED_AREA + y * PADDED_SIZE;
+                for (int z = 0; z < PADDED_SIZE; ++z, ++index)
+                {
+                    uint8_t block = m_blocks[index];
+                    m_lighting[index] = block == 0 ? 255 : 0;
+                    if (block == 0)
+                        continue;
+                    uint8_t* rgb = &m_colors[index * 3];
+                    GetBlockColor(static_cast<VoxelBlock>(block), rgb);
+                    int jitter = ColorJitter(voxelX + x, voxelY + y, voxelZ + z) - 8;
+                    for (int c = 0; c < 3; ++c)
+                        rgb[c] = static_cast<uint8_t>(std::clamp(rgb[c] + jitter, 0, 255));
+                }
+            }
+        }
+
+        stbvox_mesh_maker* maker = m_maker.get();
+        int origin = PADDED_AREA + PADDED_SIZE + 1; ///< Voxel (0, 0, 0) of the chunk in the padded input
+        stbvox_input_description* input = stbvox_get_input_description(maker);
+        memset(input, 0, sizeof(*input));
+        input->blocktype = m_blocks.data() + origin;
+        input->lighting = m_lighting.data() + origin;
+        input->rgb = reinterpret_cast<stbvox_rgb*>(m_colors.data()) + origin;
+        input->block_geometry = GetBlockGeometry();
+
+        stbvox_set_input_stride(maker, PADDED_AREA, PADDED_SIZE);
+        stbvox_set_input_range(maker, 0, 0, 0, CHUNK_SIZE, CHUNK_SIZE, CHUNK_SIZE);
+        stbvox_set_mesh_coordinates(maker, (voxelX + 1) << m_level, (voxelY + 1) << m_level, (voxelZ + 1) << m_level);
+        stbvox_reset_buffers(maker);
+        stbvox_set_buffer(maker, 0, 0, m_output.data(), m_output.size());
+
+        bool done = false;
+        while (!done)
+        {
+            done = stbvox_make_mesh(maker) != 0;
+            size_t bytes = static_cast<size_t>(stbvox_get_quad_count(maker, 0)) * BYTES_PER_QUAD;
+            mesh.vertices.insert(mesh.vertices.end(), m_output.begin(), m_output.begin() + bytes);
+            if (!done) ///< The buffer is full; stb continues where it stopped
+            {
+                stbvox_reset_buffers(maker);
+                stbvox_set_buffer(maker, 0, 0, m_output.data(), m_output.size());
+            }
+        }
+        mesh.quadCount = static_cast<uint32_t>(mesh.vertices.size() / BYTES_PER_QUAD);
+
+        stbvox_get_transform(maker, mesh.transform);
+        for (int axis = 0; axis < 3; ++axis)
+            mesh.transform[0][axis] *= voxelSize; ///< Mesh units are voxels of this level
+    }
+
+    /**
+     * @brief Gets the generated block of a voxel.
+     *
+     * The top voxel under the surface is grass, sand on beaches or snow on high
+     * ground, followed by a few units of dirt and then stone.
+     *
+     * @param surfaceHeight Terrain height at the voxel's centre.
+     * @param centre Height of the voxel's centre.
+     * @param voxelSize Width of the voxel.
+     * @return The block.
+     */
+    VoxelBlock VoxelMesher::GetGeneratedBlock(float surfaceHeight, float centre, float voxelSize)
+    {
+        if (centre < 0.0f)
+            return VoxelBlock::Stone;
+        float depth = surfaceHeight - centre;
+        if (depth <= 0.0f)
+            return VoxelBlock::Air;
+
+        bool beach = surfaceHeight < SAND_LEVEL;
+        if (depth < voxelSize)
+        {
+            if (beach)
+                return VoxelBlock::Sand;
+            return surfaceHeight > SNOW_LEVEL ? VoxelBlock::Snow : VoxelBlock::Grass;
+        }
+        if (depth < DIRT_DEPTH + voxelSize)
+            return beach ? VoxelBlock::Sand : VoxelBlock::Dirt;
+        return VoxelBlock::Stone;
+    }
+
+    /**
+     * @brief Gets the vertex shader matching the vertex format.
+     * @return The GLSL source.
+     */
+    string VoxelMesher::GetVertexShader()
+    {
+        return stbvox_get_vertex_shader();
+    }
+
+    /**
+     * @brief Gets the fragment shader matching the vertex format, with distance fog.
+     * @return The GLSL source.
+     */
+    string VoxelMesher::GetFragmentShader()
+    {
+        return stbvox_get_fragment_shader();
+    }
+
+    /**
+     * @brief Gets the face normals indexed by the shaders' normal_table uniform.
+     * @param normals Receives 32 normals.
+     */
+    void VoxelMesher::GetNormalTable(float normals[32][3])
+    {
+        stbvox_uniform_info info;
+        stbvox_get_uniform_info(&info, STBVOX_UNIFORM_normals);
+        memcpy(normals, info.default_value, sizeof(float) * 32 * 3);
+    }
+
+    /**
+     * @brief Gets the color of a block type.
+     * @param block The block type.
+     * @param rgb Receives the red, green and blue components.
+     */
+    void VoxelMesher::GetBlockColor(VoxelBlock block, uint8_t rgb[3])
+    {
+        static const uint8_t COLORS[static_cast<int>(VoxelBlock::Count)][3] = {
+            {  0,   0,   0}, ///< Air
+            {118, 118, 122}, ///< Stone
+            {121,  85,  58}, ///< Dirt
+            { 88, 142,  54}, ///< Grass
+            {214, 196, 134}, ///< Sand
+            {236, 238, 244}, ///< Snow
+            {160,  62,  48}  ///< Brick
+        };
+        int index = static_cast<int>(block) < static_cast<int>(VoxelBlock::Count) ? static_cast<int>(block) : 0;
+        memcpy(rgb, COLORS[index], 3);
+    }
+}
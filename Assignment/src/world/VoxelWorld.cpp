@@ -0,0 +1,731 @@
+#include "VoxelWorld.hpp"
+#include "Exceptions.hpp"
+#include "ErrorCheck.hpp"
+#include "Frustum.hpp"
+#include "Profiler.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+/**
+ * @file VoxelWorld.cpp
+ * @brief Implementation of the VoxelWorld class.
+ */
+
+namespace graf
+{
+    namespace
+    {
+        const int32_t MAX_LEVEL = 12;               ///< Coarsest level of the quadtree.
+        const int32_t KEY_BIAS = 1 << 28;           ///< Makes column indices non-negative for packing.
+        const uint64_t KEY_MASK = (1ull << 29) - 1; ///< Bits of a packed column index.
+        const float SPLIT_HYSTERESIS = 1.15f;       ///< Keeps loaded children a little longer, so columns do not flicker at the split distance.
+
+        /**
+         * @brief Divides and rounds towards negative infinity.
+         * @param value The dividend.
+         * @param divisor The divisor, positive.
+         * @return The quotient.
+         */
+        int32_t FloorDiv(int32_t value, int32_t divisor)
+        {
+            int32_t quotient = value / divisor;
+            return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+        }
+
+        /**
+         * @brief Packs a voxel position into a key.
+         * @param voxel The voxel.
+         * @return The key.
+         */
+        uint64_t PackVoxel(const glm::ivec3& voxel)
+        {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(voxel.x) & 0xFFFFFu) << 44) |
+                   (static_cast<uint64_t>(static_cast<uint32_t>(voxel.y) & 0xFFFFFu) << 24) |
+                   (static_cast<uint64_t>(static_cast<uint32_t>(voxel.z) & 0xFFFFFFu));
+        }
+    }
+
+    /**
+     * @brief Creates the shaders and the mesh pool; no terrain is generated before the first Update.
+     *
+     * The vertex format is stb's mode 20: a packed 32-bit position and occlusion
+     * word, then four bytes of face color and normal, both read as integers.
+     * Every chunk is drawn with the same quad index buffer and a base vertex.
+     *
+     * @param jobs The job system that meshes the chunks.
+     * @param settings The world parameters.
+     * @exception GrafException Thrown if a GL object cannot be created.
+     */
+    VoxelWorld::VoxelWorld(JobSystem& jobs, const VoxelWorldSettings& settings)
+        : m_jobs(jobs), m_settings(settings), m_terrain(settings.terrain), m_topLevel(0),
+          m_pool({ {0, 1, GL_UNSIGNED_INT, true, 0}, {1, 4, GL_UNSIGNED_BYTE, true, 4} },
+                 VoxelMesher::BYTES_PER_VERTEX, VoxelMesher::BYTES_PER_QUAD)
+    {
+        m_settings.worldHeight = max(m_settings.worldHeight, 1);
+        m_settings.detail = max(m_settings.detail, 1.0f);
+        while (m_topLevel < MAX_LEVEL && ColumnWidth(m_topLevel + 1) <= m_settings.viewDistance * 0.5f)
+            ++m_topLevel;
+
+        m_program.Create();
+        m_program.AttachShaderSource(VoxelMesher::GetVertexShader(), GL_VERTEX_SHADER, "stb_voxel_render.vert");
+        m_program.AttachShaderSource(VoxelMesher::GetFragmentShader(), GL_FRAGMENT_SHADER, "stb_voxel_render.frag");
+        m_program.BindAttributeLocation(0, "attr_vertex");
+        m_program.BindAttributeLocation(1, "attr_face");
+        m_program.Link();
+        for (const char* uniform : {"model_view", "camera_pos", "transform", "ambient", "normal_table"})
+            m_program.AddUniform(uniform);
+
+        float normals[32][3];
+        VoxelMesher::GetNormalTable(normals);
+        glm::vec3 light = glm::normalize(glm::vec3(0.3f, -0.5f, 0.8f));
+        float fogDistance = max(m_settings.viewDistance, 1.0f);
+        float ambient[4][4] = {
+            {light.x, light.y, light.z, 0.0f},                  ///< Direction of the sun
+            {0.55f, 0.52f, 0.45f, 0.0f},                        ///< Sun color
+            {0.42f, 0.46f, 0.52f, 0.0f},                        ///< Sky color
+            {m_settings.fogColor.r, m_settings.fogColor.g, m_settings.fogColor.b, 1.0f / (fogDistance * fogDistance)}
+        };
+        m_program.Use();
+        glUniform3fv(m_program.GetUniformLocation("normal_table"), 32, &normals[0][0]);
+        glUniform4fv(m_program.GetUniformLocation("ambient"), 4, &ambient[0][0]);
+
+        vector<uint32_t> indices(static_cast<size_t>(VoxelMesher::MAX_QUADS_PER_CHUNK) * 6);
+        for (uint32_t quad = 0; quad < VoxelMesher::MAX_QUADS_PER_CHUNK; ++quad)
+        {
+            uint32_t* index = &indices[quad * 6];
+            uint32_t first = quad * 4;
+            index[0] = first; index[1] = first + 1; index[2] = first + 2;
+            index[3] = first; index[4] = first + 2; index[5] = first + 3;
+        }
+        m_quadIndices.Create(indices.data(), static_cast<int>(indices.size() * sizeof(uint32_t)));
+        m_quadIndices.Unbind();
+        m_pool.SetIndexBuffer(m_quadIndices.getId());
+        CheckGLError("VoxelWorld Creation");
+    }
+
+    /**
+     * @brief Waits for the meshing jobs and releases the GL objects.
+     */
+    VoxelWorld::~VoxelWorld()
+    {
+        Release();
+    }
+
+    /**
+     * @brief Streams the world for a camera position: uploads finished meshes, selects columns and schedules meshing.
+     *
+     * The quadtree roots are the coarsest columns within the view distance; the
+     * selection descends from each of them.
+     *
+     * @param camera The camera position.
+     */
+    void VoxelWorld::Update(const glm::vec3& camera)
+    {
+        GRAF_PROFILE_SCOPE("VoxelWorld::Update");
+        ++m_frame;
+        PruneJobs();
+        ApplyResults();
+
+        m_selected.clear();
+        float rootWidth = ColumnWidth(m_topLevel);
+        float reach = m_settings.viewDistance;
+        int32_t firstX = static_cast<int32_t>(floor((camera.x - reach) / rootWidth));
+        int32_t lastX = static_cast<int32_t>(floor((camera.x + reach) / rootWidth));
+        int32_t firstY = static_cast<int32_t>(floor((camera.y - reach) / rootWidth));
+        int32_t lastY = static_cast<int32_t>(floor((camera.y + reach) / rootWidth));
+        for (int32_t x = firstX; x <= lastX; ++x)
+        {
+            for (int32_t y = firstY; y <= lastY; ++y)
+            {
+                ColumnKey root{x, y, m_topLevel};
+                if (ColumnDistance(root, camera) <= reach)
+                    SelectColumns(root, camera);
+            }
+        }
+
+        ScheduleMeshing();
+        UnloadColumns();
+
+        m_stats.residentColumns = 0;
+        m_stats.pendingColumns = 0;
+        for (const auto& entry : m_columns)
+        {
+            if (entry.second.ready)
+                ++m_stats.residentColumns;
+            if (entry.second.state != ColumnState::Ready || !entry.second.dirtyChunks.empty())
+                ++m_stats.pendingColumns;
+        }
+        m_stats.meshJobs = m_jobsInFlight;
+        m_stats.selectedColumns = m_selected.size();
+        m_stats.meshedColumns = m_meshedColumns;
+        m_stats.remeshedChunks = m_remeshedChunks;
+        m_stats.poolCapacity = m_pool.getCapacity();
+        m_stats.poolUsed = m_pool.getUsed();
+    }
+
+    /**
+     * @brief Draws the columns selected by the last Update.
+     *
+     * Chunks outside the frustum are skipped, and the rest are sorted by pool
+     * page so each page's vertex array is bound once.
+     *
+     * @param viewProjection The combined projection and view matrix.
+     * @param camera The camera position.
+     */
+    void VoxelWorld::Render(const glm::mat4& viewProjection, const glm::vec3& camera)
+    {
+        GRAF_PROFILE_SCOPE("VoxelWorld::Render");
+        Frustum frustum(viewProjection);
+        m_drawItems.clear();
+        m_stats.culledChunks = 0;
+        for (uint64_t key : m_selected)
+        {
+            auto it = m_columns.find(key);
+            if (it == m_columns.end())
+                continue;
+            for (const ChunkDraw& chunk : it->second.chunks)
+            {
+                if (!frustum.IntersectsBox(chunk.boundsMin, chunk.boundsMax))
+                {
+                    ++m_stats.culledChunks;
+                    continue;
+                }
+                m_drawItems.push_back({chunk.allocation.page, m_pool.getBaseVertex(chunk.allocation), chunk.quadCount, &chunk});
+            }
+        }
+        sort(m_drawItems.begin(), m_drawItems.end(),
+             [](const DrawItem& a, const DrawItem& b) { return a.page != b.page ? a.page < b.page : a.baseVertex < b.baseVertex; });
+
+        m_program.Use();
+        m_program.SetMat4("model_view", viewProjection);
+        m_program.SetVec4("camera_pos", glm::vec4(camera, 0.0f));
+        int transformLocation = m_program.GetUniformLocation("transform");
+
+        m_stats.drawnChunks = m_drawItems.size();
+        m_stats.drawCalls = 0;
+        m_stats.vertexArrayBinds = 0;
+        m_stats.quads = 0;
+        uint32_t boundPage = MeshAllocation::INVALID_PAGE;
+        for (const DrawItem& item : m_drawItems)
+        {
+            if (item.page != boundPage)
+            {
+                glBindVertexArray(m_pool.getVertexArray(item.page));
+                boundPage = item.page;
+                ++m_stats.vertexArrayBinds;
+            }
+            glUniform3fv(transformLocation, 3, &item.chunk->transform[0][0]);
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(item.quadCount) * 6, GL_UNSIGNED_INT, nullptr, item.baseVertex);
+            ++m_stats.drawCalls;
+            m_stats.quads += item.quadCount;
+        }
+        glBindVertexArray(0);
+    }
+
+    /**
+     * @brief Sets the block of a level 0 voxel and remeshes the affected chunks.
+     * @param voxel The voxel.
+     * @param block The new block.
+     * @return False if the voxel already had that block or is outside the world's height.
+     */
+    bool VoxelWorld::SetBlock(const glm::ivec3& voxel, VoxelBlock block)
+    {
+        if (voxel.z < 0 || voxel.z >= ChunksPerColumn(0) * VoxelMesher::CHUNK_SIZE || GetBlock(voxel) == block)
+            return false;
+
+        ColumnKey column{FloorDiv(voxel.x, VoxelMesher::CHUNK_SIZE), FloorDiv(voxel.y, VoxelMesher::CHUNK_SIZE), 0};
+        m_edits[PackKey(column)][PackVoxel(voxel)] = {voxel.x, voxel.y, voxel.z, block};
+        InvalidateVoxel(voxel);
+        return true;
+    }
+
+    /**
+     * @brief Sets the blocks of all voxels whose centres are inside a sphere.
+     * @param center Centre of the sphere.
+     * @param radius Radius of the sphere.
+     * @param block The new block, Air to dig a hole.
+     * @return The number of voxels changed.
+     */
+    size_t VoxelWorld::SetSphere(const glm::vec3& center, float radius, VoxelBlock block)
+    {
+        GRAF_PROFILE_SCOPE("VoxelWorld::SetSphere");
+        glm::ivec3 first(glm::floor(center - radius)), last(glm::floor(center + radius));
+        size_t changed = 0;
+        for (int32_t x = first.x; x <= last.x; ++x)
+        {
+            for (int32_t y = first.y; y <= last.y; ++y)
+            {
+                for (int32_t z = first.z; z <= last.z; ++z)
+                {
+                    glm::vec3 offset = glm::vec3(x, y, z) + 0.5f - center;
+                    if (glm::dot(offset, offset) <= radius * radius && SetBlock(glm::ivec3(x, y, z), block))
+                        ++changed;
+                }
+            }
+        }
+        return changed;
+    }
+
+    /**
+     * @brief Gets the block of a level 0 voxel, edited or generated.
+     * @param voxel The voxel.
+     * @return The block.
+     */
+    VoxelBlock VoxelWorld::GetBlock(const glm::ivec3& voxel) const
+    {
+        ColumnKey column{FloorDiv(voxel.x, VoxelMesher::CHUNK_SIZE), FloorDiv(voxel.y, VoxelMesher::CHUNK_SIZE), 0};
+        auto columnEdits = m_edits.find(PackKey(column));
+        if (columnEdits != m_edits.end())
+        {
+            auto edit = columnEdits->second.find(PackVoxel(voxel));
+            if (edit != columnEdits->second.end())
+                return edit->second.block;
+        }
+        float height = m_terrain.GetHeight(static_cast<float>(voxel.x) + 0.5f, static_cast<float>(voxel.y) + 0.5f);
+        return VoxelMesher::GetGeneratedBlock(height, static_cast<float>(voxel.z) + 0.5f, 1.0f);
+    }
+
+    /**
+     * @brief Gets the generated terrain.
+     * @return The height field.
+     */
+    const HeightField& VoxelWorld::GetTerrain() const
+    {
+        return m_terrain;
+    }
+
+    /**
+     * @brief Gets the streaming state and the work of the last frame.
+     * @return The statistics.
+     */
+    const VoxelWorldStats& VoxelWorld::GetStats() const
+    {
+        return m_stats;
+    }
+
+    /**
+     * @brief Checks whether every selected column is meshed and uploaded.
+     * @return True if nothing is pending.
+     */
+    bool VoxelWorld::IsSettled() const
+    {
+        return m_stats.pendingColumns == 0 && m_jobsInFlight == 0;
+    }
+
+    /**
+     * @brief Waits for the meshing jobs and deletes all GL objects; must be called while the context is current.
+     */
+    void VoxelWorld::Release()
+    {
+        m_jobs.WaitAll(m_meshJobs);
+        m_meshJobs.clear();
+        m_results.clear();
+        m_pendingResults.clear();
+        m_jobsInFlight = 0;
+        m_columns.clear();
+        m_selected.clear();
+        m_drawItems.clear();
+        m_pool.Release();
+        m_quadIndices.Release();
+        m_program.Release();
+    }
+
+    /**
+     * @brief Packs a column key into a hash map key.
+     * @param key The column key.
+     * @return The packed key.
+     */
+    uint64_t VoxelWorld::PackKey(const ColumnKey& key)
+    {
+        return (static_cast<uint64_t>(key.level) << 58) |
+               ((static_cast<uint64_t>(key.x + KEY_BIAS) & KEY_MASK) << 29) |
+               (static_cast<uint64_t>(key.y + KEY_BIAS) & KEY_MASK);
+    }
+
+    /**
+     * @brief Gets the width of the columns of a level.
+     * @param level The level.
+     * @return The width in world units.
+     */
+    float VoxelWorld::ColumnWidth(int32_t level)
+    {
+        return static_cast<float>(VoxelMesher::CHUNK_SIZE << level);
+    }
+
+    /**
+     * @brief Gets the distance from the camera to a column's bounds.
+     *
+     * The bounds span the terrain's whole height range, as the heights of a
+     * column are only known once it is meshed.
+     *
+     * @param key The column.
+     * @param camera The camera position.
+     * @return The distance, 0 inside.
+     */
+    float VoxelWorld::ColumnDistance(const ColumnKey& key, const glm::vec3& camera) const
+    {
+        float width = ColumnWidth(key.level);
+        glm::vec3 boxMin(static_cast<float>(key.x) * width, static_cast<float>(key.y) * width, 0.0f);
+        glm::vec3 boxMax(boxMin.x + width, boxMin.y + width, m_terrain.GetMaxHeight());
+        glm::vec3 nearest = glm::clamp(camera, boxMin, boxMax);
+        return glm::length(camera - nearest);
+    }
+
+    /**
+     * @brief Gets the number of chunks stacked in a column of a level.
+     * @param level The level.
+     * @return The count.
+     */
+    int32_t VoxelWorld::ChunksPerColumn(int32_t level) const
+    {
+        int32_t chunkHeight = VoxelMesher::CHUNK_SIZE << level;
+        return (m_settings.worldHeight + chunkHeight - 1) / chunkHeight;
+    }
+
+    /**
+     * @brief Selects the columns covering a quadtree node and requests the missing ones.
+     *
+     * Every node on the way down is requested too, so a node's parent is usually
+     * resident and drawn while the node is still meshing; when the camera moves,
+     * coarser columns are ready before finer ones are needed. A node is split
+     * when the camera is closer than detail column widths, or a little further if
+     * its children are drawable already.
+     *
+     * @param key The node.
+     * @param camera The camera position.
+     * @return True if the node is covered by drawable columns.
+     */
+    bool VoxelWorld::SelectColumns(const ColumnKey& key, const glm::vec3& camera)
+    {
+        Column& column = RequestColumn(key, camera);
+        bool ready = column.ready; ///< The reference may not survive the requests of the children
+
+        bool split = false;
+        if (key.level > 0)
+        {
+            float distance = ColumnDistance(key, camera);
+            float splitDistance = m_settings.detail * ColumnWidth(key.level);
+            split = distance < splitDistance;
+            if (!split && distance < splitDistance * SPLIT_HYSTERESIS)
+            {
+                split = true;
+                for (int child = 0; child < 4 && split; ++child)
+                {
+                    Column* childColumn = FindColumn({key.x * 2 + (child & 1), key.y * 2 + (child >> 1), key.level - 1});
+                    split = childColumn && childColumn->ready;
+                }
+            }
+        }
+
+        if (!split)
+        {
+            if (ready)
+                m_selected.push_back(PackKey(key));
+            return ready;
+        }
+
+        size_t mark = m_selected.size();
+        bool covered = true;
+        for (int child = 0; child < 4; ++child)
+            covered = SelectColumns({key.x * 2 + (child & 1), key.y * 2 + (child >> 1), key.level - 1}, camera) && covered;
+        if (covered)
+            return true;
+        if (!ready)
+            return false; ///< Draws the children that are ready, leaving gaps until the rest are
+
+        m_selected.resize(mark); ///< Draws this column until all children are ready
+        m_selected.push_back(PackKey(key));
+        return true;
+    }
+
+    /**
+     * @brief Gets a column if it is resident or requested.
+     * @param key The column.
+     * @return The column, or nullptr.
+     */
+    VoxelWorld::Column* VoxelWorld::FindColumn(const ColumnKey& key)
+    {
+        auto it = m_columns.find(PackKey(key));
+        return it != m_columns.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * @brief Gets a column, requesting it if it is not resident yet, and marks it used.
+     * @param key The column.
+     * @param camera The camera position.
+     * @return The column.
+     */
+    VoxelWorld::Column& VoxelWorld::RequestColumn(const ColumnKey& key, const glm::vec3& camera)
+    {
+        auto inserted = m_columns.try_emplace(PackKey(key));
+        Column& column = inserted.first->second;
+        if (inserted.second)
+        {
+            column.key = key;
+            column.id = m_nextColumnId++;
+        }
+        column.priority = ColumnDistance(key, camera);
+        column.lastUsedFrame = m_frame;
+        return column;
+    }
+
+    /**
+     * @brief Starts meshing jobs for queued and edited columns up to the job limit.
+     *
+     * Edited columns go first so edits show quickly, then coarse columns before
+     * fine ones, since a coarse column fills the gaps of many fine ones, and
+     * near columns before far ones.
+     */
+    void VoxelWorld::ScheduleMeshing()
+    {
+        GRAF_PROFILE_SCOPE("VoxelWorld::ScheduleMeshing");
+        size_t limit = m_settings.maxMeshJobs > 0 ? m_settings.maxMeshJobs : max<size_t>(2 * m_jobs.GetWorkerCount(), 1);
+        if (m_jobsInFlight >= limit)
+            return;
+
+        m_queue.clear();
+        for (auto& entry : m_columns)
+        {
+            Column& column = entry.second;
+            if (column.state == ColumnState::Queued || (column.state == ColumnState::Ready && !column.dirtyChunks.empty()))
+                m_queue.push_back(&column);
+        }
+
+        size_t count = min(limit - m_jobsInFlight, m_queue.size());
+        partial_sort(m_queue.begin(), m_queue.begin() + count, m_queue.end(), [](const Column* a, const Column* b) {
+            bool editA = a->state == ColumnState::Ready, editB = b->state == ColumnState::Ready;
+            if (editA != editB)
+                return editA;
+            if (a->key.level != b->key.level)
+                return a->key.level > b->key.level;
+            return a->priority < b->priority;
+        });
+        for (size_t i = 0; i < count; ++i)
+        {
+            Column& column = *m_queue[i];
+            if (column.state == ColumnState::Ready)
+                ScheduleColumn(column, std::move(column.dirtyChunks));
+            else
+                ScheduleColumn(column, {});
+            column.dirtyChunks.clear();
+        }
+    }
+
+    /**
+     * @brief Starts a job that meshes a column or some of its chunks.
+     *
+     * The job copies everything it reads besides the terrain, which is immutable,
+     * so the column may be edited or unloaded while it runs. Each worker keeps
+     * its own mesher for the lifetime of the thread.
+     *
+     * @param column The column.
+     * @param chunks The chunks to mesh; empty for all.
+     */
+    void VoxelWorld::ScheduleColumn(Column& column, vector<int32_t> chunks)
+    {
+        column.state = ColumnState::Meshing;
+        ++m_jobsInFlight;
+
+        bool partial = !chunks.empty();
+        if (!partial)
+        {
+            chunks.resize(static_cast<size_t>(ChunksPerColumn(column.key.level)));
+            iota(chunks.begin(), chunks.end(), 0);
+        }
+        vector<VoxelEdit> edits;
+        if (column.key.level == 0)
+            edits = GatherEdits(column.key);
+
+        ColumnKey key = column.key;
+        uint64_t id = column.id;
+        m_meshJobs.push_back(m_jobs.Schedule([this, key, id, partial, chunks = std::move(chunks), edits = std::move(edits)]() {
+            GRAF_PROFILE_SCOPE("VoxelWorld::MeshColumn");
+            static thread_local VoxelMesher mesher;
+            MeshResult result;
+            result.key = PackKey(key);
+            result.columnId = id;
+            result.partial = partial;
+            mesher.BeginColumn(m_terrain, key.level, key.x, key.y);
+            for (int32_t chunkZ : chunks)
+            {
+                VoxelChunkMesh mesh;
+                mesher.MeshChunk(chunkZ, edits, mesh);
+                if (partial || mesh.quadCount > 0) ///< Empty meshes of a partial result clear the old ones
+                    result.chunks.push_back(std::move(mesh));
+            }
+
+            lock_guard<mutex> lock(m_resultMutex);
+            m_results.push_back(std::move(result));
+        }));
+    }
+
+    /**
+     * @brief Uploads finished meshes within the byte budget.
+     *
+     * Results of columns that were unloaded, or unloaded and requested again,
+     * since their job started are dropped. At least one result is applied per
+     * frame, so a mesh larger than the budget still gets uploaded.
+     */
+    void VoxelWorld::ApplyResults()
+    {
+        GRAF_PROFILE_SCOPE("VoxelWorld::ApplyResults");
+        {
+            lock_guard<mutex> lock(m_resultMutex);
+            for (MeshResult& result : m_results)
+                m_pendingResults.push_back(std::move(result));
+            m_results.clear();
+        }
+
+        size_t uploaded = 0;
+        size_t applied = 0;
+        for (; applied < m_pendingResults.size() && uploaded < m_settings.uploadBudget; ++applied)
+        {
+            MeshResult& result = m_pendingResults[applied];
+            --m_jobsInFlight;
+            auto it = m_columns.find(result.key);
+            if (it == m_columns.end() || it->second.id != result.columnId)
+                continue;
+
+            Column& column = it->second;
+            if (!result.partial)
+                FreeColumn(column);
+            float chunkSize = ColumnWidth(column.key.level);
+            for (VoxelChunkMesh& mesh : result.chunks)
+            {
+                if (result.partial)
+                {
+                    auto old = find_if(column.chunks.begin(), column.chunks.end(),
+                                       [&mesh](const ChunkDraw& chunk) { return chunk.chunkZ == mesh.chunkZ; });
+                    if (old != column.chunks.end())
+                    {
+                        m_pool.Free(old->allocation);
+                        column.chunks.erase(old);
+                    }
+                }
+                if (mesh.quadCount == 0)
+                    continue;
+
+                ChunkDraw chunk;
+                chunk.chunkZ = mesh.chunkZ;
+                chunk.quadCount = mesh.quadCount;
+                chunk.allocation = m_pool.Allocate(mesh.vertices.size());
+                m_pool.Upload(chunk.allocation, mesh.vertices.data(), mesh.vertices.size());
+                memcpy(chunk.transform, mesh.transform, sizeof(chunk.transform));
+                chunk.boundsMin = glm::vec3(static_cast<float>(column.key.x), static_cast<float>(column.key.y),
+                                            static_cast<float>(mesh.chunkZ)) * chunkSize;
+                chunk.boundsMax = chunk.boundsMin + chunkSize;
+                column.chunks.push_back(chunk);
+                uploaded += mesh.vertices.size();
+            }
+
+            column.state = ColumnState::Ready;
+            column.ready = true;
+            if (result.partial)
+                m_remeshedChunks += result.chunks.size();
+            else
+                ++m_meshedColumns;
+        }
+        m_pendingResults.erase(m_pendingResults.begin(), m_pendingResults.begin() + static_cast<ptrdiff_t>(applied));
+        m_stats.uploadedBytes = uploaded;
+    }
+
+    /**
+     * @brief Unloads columns that were not used for a while.
+     *
+     * Columns with edits waiting to be meshed are unloaded like the others; the
+     * edits are kept and applied when the column is meshed again.
+     */
+    void VoxelWorld::UnloadColumns()
+    {
+        GRAF_PROFILE_SCOPE("VoxelWorld::UnloadColumns");
+        for (auto it = m_columns.begin(); it != m_columns.end();)
+        {
+            if (m_frame - it->second.lastUsedFrame > m_settings.unloadDelay)
+            {
+                FreeColumn(it->second);
+                it = m_columns.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+
+    /**
+     * @brief Frees the pool ranges of a column's chunks.
+     * @param column The column.
+     */
+    void VoxelWorld::FreeColumn(Column& column)
+    {
+        for (ChunkDraw& chunk : column.chunks)
+            m_pool.Free(chunk.allocation);
+        column.chunks.clear();
+    }
+
+    /**
+     * @brief Marks the level 0 chunks whose padded input contains a voxel for remeshing.
+     *
+     * A voxel on a chunk border also changes the faces and occlusion of the
+     * neighbouring chunks, so up to eight chunks are affected. Columns that were
+     * never meshed pick the edit up with their first mesh.
+     *
+     * @param voxel The edited voxel.
+     */
+    void VoxelWorld::InvalidateVoxel(const glm::ivec3& voxel)
+    {
+        const int32_t size = VoxelMesher::CHUNK_SIZE;
+        int32_t chunkCount = ChunksPerColumn(0);
+        for (int32_t x = FloorDiv(voxel.x - 1, size); x <= FloorDiv(voxel.x + 1, size); ++x)
+        {
+            for (int32_t y = FloorDiv(voxel.y - 1, size); y <= FloorDiv(voxel.y + 1, size); ++y)
+            {
+                Column* column = FindColumn({x, y, 0});
+                if (!column || column->state == ColumnState::Queued)
+                    continue;
+                int32_t firstZ = max(FloorDiv(voxel.z - 1, size), 0);
+                int32_t lastZ = min(FloorDiv(voxel.z + 1, size), chunkCount - 1);
+                for (int32_t z = firstZ; z <= lastZ; ++z)
+                {
+                    if (find(column->dirtyChunks.begin(), column->dirtyChunks.end(), z) == column->dirtyChunks.end())
+                        column->dirtyChunks.push_back(z);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Collects the edits of a level 0 column and its eight neighbours.
+     *
+     * The neighbours' edits matter for the padding voxels along the borders.
+     *
+     * @param key The column.
+     * @return The edits.
+     */
+    vector<VoxelEdit> VoxelWorld::GatherEdits(const ColumnKey& key) const
+    {
+        vector<VoxelEdit> edits;
+        for (int32_t dx = -1; dx <= 1; ++dx)
+        {
+            for (int32_t dy = -1; dy <= 1; ++dy)
+            {
+                auto it = m_edits.find(PackKey({key.x + dx, key.y + dy, 0}));
+                if (it == m_edits.end())
+                    continue;
+                for (const auto& edit : it->second)
+                    edits.push_back(edit.second);
+            }
+        }
+        return edits;
+    }
+
+    /**
+     * @brief Drops the handles of finished jobs.
+     */
+    void VoxelWorld::PruneJobs()
+    {
+        m_meshJobs.erase(remove_if(m_meshJobs.begin(), m_meshJobs.end(), [](const JobHandle& job) { return job.IsDone(); }),
+                         m_meshJobs.end());
+    }
+}